@@ -1145,13 +1145,18 @@ function(ROOT_PATH_TO_STRING resultvar path)
 endfunction(ROOT_PATH_TO_STRING)
 
 #----------------------------------------------------------------------------
-# ROOT_ADD_UNITTEST_DIR(<libraries ...>)
+# ROOT_ADD_UNITTEST_DIR(<libraries ...> [FILTER regexp])
 #----------------------------------------------------------------------------
 function(ROOT_ADD_UNITTEST_DIR)
-  ROOT_GLOB_FILES(test_files ${CMAKE_CURRENT_SOURCE_DIR}/*.cxx)
+  CMAKE_PARSE_ARGUMENTS(ARG "" "FILTER" "" ${ARGN})
+  if(ARG_FILTER)
+    ROOT_GLOB_FILES(test_files ${CMAKE_CURRENT_SOURCE_DIR}/*.cxx FILTER ${ARG_FILTER})
+  else()
+    ROOT_GLOB_FILES(test_files ${CMAKE_CURRENT_SOURCE_DIR}/*.cxx)
+  endif()
   # Get the component from the path. Eg. core to form coreTests test suite name.
   ROOT_PATH_TO_STRING(test_name ${CMAKE_CURRENT_SOURCE_DIR}/)
-  ROOT_ADD_GTEST(${test_name}Unit ${test_files} LIBRARIES ${ARGN})
+  ROOT_ADD_GTEST(${test_name}Unit ${test_files} LIBRARIES ${ARG_UNPARSED_ARGUMENTS})
 endfunction()
 
 #----------------------------------------------------------------------------
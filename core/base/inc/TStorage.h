@@ -74,6 +74,10 @@ public:
    static void SetReAllocHooks(ReAllocFun_t func1, ReAllocCFun_t func2);
    static void SetCustomNewDelete();
    static void EnableStatistics(int size= -1, int ix= -1);
+   static Bool_t EnableObjectPool(ULong_t maxMBytes = 4096);
+   static Bool_t IsObjectPoolEnabled();
+   static Bool_t GetObjectPoolStatistics(Long64_t &nallocs, Long64_t &nfrees, Long64_t &reserved);
+   static void PrintObjectPoolStatistics(Option_t *option = "");
 
    static Bool_t HasCustomNewDelete();
 
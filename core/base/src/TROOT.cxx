@@ -1887,6 +1887,9 @@ void TROOT::InitSystem()
 
       fgMemCheck = gEnv->GetValue("Root.MemCheck", 0);
 
+      if (Int_t poolsize = gEnv->GetValue("Root.ObjectPool", 0))
+         TStorage::EnableObjectPool(poolsize);
+
 #if defined(R__HAS_COCOA)
       // create and delete a dummy TUrl so that TObjectStat table does not contain
       // objects that are deleted after recording is turned-off (in next line),
@@ -28,9 +28,21 @@ occur.
 
 Set the compile option R__NOSTATS to de-activate all memory checking
 and statistics gathering in the system.
+
+The small TObjects can be allocated from a thread-caching pool instead
+of the heap, see EnableObjectPool(); the pool then provides allocation
+statistics per object size, see PrintObjectPoolStatistics().
 */
 
 #include <stdlib.h>
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 
 #include "TROOT.h"
 #include "TObjectTable.h"
@@ -88,6 +100,193 @@ static Int_t    gTraceCapacity = 10, gTraceIndex = 0,
 ROOT::Internal::FreeIfTMapFile_t *ROOT::Internal::gFreeIfTMapFile = nullptr;
 void *ROOT::Internal::gMmallocDesc = 0; //is used and set in TMapFile
 
+//------------------------------------------------------------------------------
+// Thread-caching pool for the objects allocated via TStorage::ObjectAlloc(),
+// see TStorage::EnableObjectPool().
+//
+// The pool reserves one contiguous range of address space (which is only
+// backed by memory once used) such that ObjectDealloc() can tell pooled
+// objects from the others with two comparisons. The range is cut in pages,
+// each page holding slots of a single size. Each thread keeps free lists of
+// slots per size; they exchange batches of slots with shared free lists, the
+// "depot", protected by a mutex. Allocation statistics are accumulated in
+// the thread caches and moved to the global counters at the same time.
+
+namespace {
+namespace ObjectPool {
+
+const size_t kGranularity = 16;        // slot sizes are multiples of this
+const size_t kMaxSize     = 1024;      // larger objects come from operator new
+const size_t kNSizes      = kMaxSize / kGranularity;
+const size_t kPageSize    = 64 * 1024; // all slots in a page have the same size
+const UInt_t kBatch       = 64;        // slots exchanged at once with the depot
+
+struct TFreeSlot {
+   TFreeSlot *fNext;
+};
+
+struct TSlotList {
+   TFreeSlot *fHead = nullptr;
+   UInt_t     fCount = 0;
+
+   void Push(void *p)
+   {
+      TFreeSlot *slot = static_cast<TFreeSlot *>(p);
+      slot->fNext = fHead;
+      fHead = slot;
+      ++fCount;
+   }
+   void *Pop()
+   {
+      TFreeSlot *slot = fHead;
+      fHead = slot->fNext;
+      --fCount;
+      return slot;
+   }
+};
+
+struct TThreadCache {
+   TSlotList fFree[kNSizes];
+   Long64_t  fAllocs[kNSizes] = {};
+   Long64_t  fFrees[kNSizes] = {};
+};
+
+std::atomic<bool> gEnabled(false);       // set (release) once the variables below are set up
+char             *gBegin = nullptr;      // reserved address range
+char             *gEnd = nullptr;
+char             *gNextPage = nullptr;   // first page not yet in use
+unsigned char    *gPageSize = nullptr;   // size index + 1 of each page in use
+
+std::mutex        gDepotMutex;           // protects all the variables below
+TSlotList         gDepot[kNSizes];
+Long64_t          gAllocs[kNSizes] = {};
+Long64_t          gFrees[kNSizes] = {};
+Long64_t          gPages[kNSizes] = {};
+TThreadCache      gOrphanCache;          // for threads whose cache was destroyed
+
+inline size_t SizeIndex(size_t size) { return size ? (size - 1) / kGranularity : 0; }
+inline size_t SlotSize(size_t index) { return (index + 1) * kGranularity; }
+inline bool   Contains(const void *p) { return p >= gBegin && p < gEnd; }
+
+// Move the statistics of one size of a cache to the global counters.
+// Must be called with gDepotMutex held.
+void FlushStats(TThreadCache &cache, size_t index)
+{
+   gAllocs[index] += cache.fAllocs[index];
+   gFrees[index] += cache.fFrees[index];
+   cache.fAllocs[index] = 0;
+   cache.fFrees[index] = 0;
+}
+
+// Give a batch of free slots of the given size to the cache, taking a new
+// page if the depot is empty. Must be called with gDepotMutex held.
+void Refill(TThreadCache &cache, size_t index)
+{
+   FlushStats(cache, index);
+   TSlotList &depot = gDepot[index];
+   if (!depot.fHead) {
+      if (gNextPage + kPageSize > gEnd)
+         return; // the reserved range is exhausted
+      char *page = gNextPage;
+      gNextPage += kPageSize;
+      gPageSize[(page - gBegin) / kPageSize] = index + 1;
+      ++gPages[index];
+      const size_t slot = SlotSize(index);
+      for (size_t offset = kPageSize / slot * slot; offset >= slot; offset -= slot)
+         depot.Push(page + offset - slot);
+   }
+   for (UInt_t i = 0; i < kBatch && depot.fHead; ++i)
+      cache.fFree[index].Push(depot.Pop());
+}
+
+// Give back slots of the given size from the cache to the depot, keeping
+// at most keep of them. Must be called with gDepotMutex held.
+void Drain(TThreadCache &cache, size_t index, UInt_t keep)
+{
+   FlushStats(cache, index);
+   while (cache.fFree[index].fCount > keep)
+      gDepot[index].Push(cache.fFree[index].Pop());
+}
+
+struct TThreadCacheGuard {
+   TThreadCache *fCache = nullptr;
+   ~TThreadCacheGuard();
+};
+
+thread_local TThreadCache *tCache = nullptr;
+thread_local bool tCacheDestroyed = false;
+thread_local TThreadCacheGuard tCacheGuard;
+
+TThreadCacheGuard::~TThreadCacheGuard()
+{
+   if (!fCache)
+      return;
+   {
+      std::lock_guard<std::mutex> lock(gDepotMutex);
+      for (size_t index = 0; index < kNSizes; ++index)
+         Drain(*fCache, index, 0);
+   }
+   delete fCache;
+   tCache = nullptr;
+   tCacheDestroyed = true;
+}
+
+// Return the cache of the calling thread, or nullptr if it was already
+// destroyed (objects deleted by thread_local or static destructors).
+inline TThreadCache *LocalCache()
+{
+   if (R__likely(tCache != nullptr))
+      return tCache;
+   if (tCacheDestroyed)
+      return nullptr;
+   tCache = new TThreadCache;
+   tCacheGuard.fCache = tCache;
+   return tCache;
+}
+
+// Return a slot of at least size bytes, or nullptr if the pool is exhausted.
+void *Allocate(size_t size)
+{
+   const size_t index = SizeIndex(size);
+   std::unique_lock<std::mutex> lock(gDepotMutex, std::defer_lock);
+   TThreadCache *cache = LocalCache();
+   if (!cache) {
+      lock.lock();
+      cache = &gOrphanCache;
+   }
+   if (!cache->fFree[index].fHead) {
+      if (!lock.owns_lock())
+         lock.lock();
+      Refill(*cache, index);
+      if (!cache->fFree[index].fHead)
+         return nullptr;
+   }
+   ++cache->fAllocs[index];
+   return cache->fFree[index].Pop();
+}
+
+// Return a slot to the pool.
+void Release(void *p)
+{
+   const size_t index = gPageSize[(static_cast<char *>(p) - gBegin) / kPageSize] - 1;
+   std::unique_lock<std::mutex> lock(gDepotMutex, std::defer_lock);
+   TThreadCache *cache = LocalCache();
+   if (!cache) {
+      lock.lock();
+      cache = &gOrphanCache;
+   }
+   ++cache->fFrees[index];
+   cache->fFree[index].Push(p);
+   if (cache->fFree[index].fCount > 2 * kBatch) {
+      if (!lock.owns_lock())
+         lock.lock();
+      Drain(*cache, index, kBatch);
+   }
+}
+
+} // namespace ObjectPool
+} // namespace
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -327,7 +526,11 @@ Int_t *TStorage::ReAllocInt(Int_t *ovp, size_t size, size_t oldsize)
 
 void *TStorage::ObjectAlloc(size_t sz)
 {
-   void* space =  ::operator new(sz);
+   void *space = nullptr;
+   if (R__unlikely(ObjectPool::gEnabled.load(std::memory_order_acquire)) && sz <= ObjectPool::kMaxSize)
+      space = ObjectPool::Allocate(sz);
+   if (!space)
+      space = ::operator new(sz);
    memset(space, kObjectAllocMemValue, sz);
    return space;
 }
@@ -358,8 +561,10 @@ void *TStorage::ObjectAlloc(size_t , void *vp)
 
 void TStorage::ObjectDealloc(void *vp)
 {
-
-   ::operator delete(vp);
+   if (R__unlikely(ObjectPool::Contains(vp)))
+      ObjectPool::Release(vp);
+   else
+      ::operator delete(vp);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -377,7 +582,10 @@ void TStorage::ObjectDealloc(void *vp, void *ptr)
 
 void TStorage::ObjectDealloc(void *vp, size_t size)
 {
-   ::operator delete(vp, size);
+   if (R__unlikely(ObjectPool::Contains(vp)))
+      ObjectPool::Release(vp);
+   else
+      ::operator delete(vp, size);
 }
 #endif
 
@@ -458,6 +666,164 @@ void TStorage::EnableStatistics(int size, int ix)
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Allocate the TObjects of up to ObjectPool::kMaxSize (1024) bytes created
+/// with new from a thread-caching pool instead of the global heap. Each
+/// thread recycles the memory of the objects it deletes without locking;
+/// the slots are exchanged by batches between the threads. Objects of the
+/// same size are packed in 64 kB pages, which reduces the fragmentation of
+/// long running jobs creating and deleting many small objects. The pool
+/// also keeps allocation statistics, see PrintObjectPoolStatistics().
+///
+/// maxMBytes of address space are reserved for the pool; they are only
+/// backed by memory once used. When they are exhausted, objects are again
+/// allocated from the heap. The pool cannot be disabled once enabled;
+/// objects created before enabling it are not affected. Return kFALSE if
+/// the pool could not be set up. The pool can also be enabled with the
+/// resource Root.ObjectPool, giving maxMBytes.
+
+Bool_t TStorage::EnableObjectPool(ULong_t maxMBytes)
+{
+   std::lock_guard<std::mutex> lock(ObjectPool::gDepotMutex);
+   if (ObjectPool::gEnabled)
+      return kTRUE;
+#ifndef WIN32
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+   const size_t npages = (size_t)maxMBytes * 1024 * 1024 / ObjectPool::kPageSize;
+   if (npages == 0)
+      return kFALSE;
+   void *region = mmap(nullptr, npages * ObjectPool::kPageSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+   if (region == MAP_FAILED) {
+      ::Error("TStorage::EnableObjectPool", "cannot reserve %lu MB of address space", maxMBytes);
+      return kFALSE;
+   }
+   ObjectPool::gPageSize = (unsigned char *)calloc(npages, 1);
+   ObjectPool::gBegin = (char *)region;
+   ObjectPool::gEnd = ObjectPool::gBegin + npages * ObjectPool::kPageSize;
+   ObjectPool::gNextPage = ObjectPool::gBegin;
+   // publish the region set up above to the threads allocating without the lock
+   ObjectPool::gEnabled.store(true, std::memory_order_release);
+   return kTRUE;
+#else
+   ::Warning("TStorage::EnableObjectPool", "the object pool is not supported on this platform");
+   if (maxMBytes) { }
+   return kFALSE;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return kTRUE if the objects are allocated from the pool (see EnableObjectPool()).
+
+Bool_t TStorage::IsObjectPoolEnabled()
+{
+   return ObjectPool::gEnabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Get the number of allocations and deletions of objects from the pool (see
+/// EnableObjectPool()) and the memory reserved for them, summed over all the
+/// slot sizes. The counts of the calling thread are exact, those of the other
+/// threads can lag as explained in PrintObjectPoolStatistics(). Returns
+/// kFALSE, with all numbers set to 0, if the pool is not enabled.
+
+Bool_t TStorage::GetObjectPoolStatistics(Long64_t &nallocs, Long64_t &nfrees, Long64_t &reserved)
+{
+   using namespace ObjectPool;
+
+   nallocs = nfrees = reserved = 0;
+   if (!gEnabled)
+      return kFALSE;
+
+   std::lock_guard<std::mutex> lock(gDepotMutex);
+   TThreadCache *cache = LocalCache();
+   for (size_t index = 0; index < kNSizes; ++index) {
+      if (cache)
+         FlushStats(*cache, index);
+      nallocs += gAllocs[index];
+      nfrees += gFrees[index];
+      reserved += gPages[index] * (Long64_t)kPageSize;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the statistics of the object pool (see EnableObjectPool()): for
+/// each slot size, the memory reserved in pages, the number of allocations
+/// and deletions, the live objects and the allocation rate since the
+/// previous call. The counts of the other threads are updated whenever they
+/// exchange slots with the shared pool, hence can lag by a few hundred
+/// allocations per size and thread.
+///
+/// With option "class", the live objects are also listed by class with
+/// TObjectTable::Print() if the object table is enabled (Root.ObjectStat
+/// set to 1 in .rootrc). The pool itself does not record the class of the
+/// objects.
+
+void TStorage::PrintObjectPoolStatistics(Option_t *option)
+{
+   using namespace ObjectPool;
+
+   if (!gEnabled) {
+      Printf("The object pool is not enabled, see TStorage::EnableObjectPool()");
+      return;
+   }
+
+   static Long64_t lastAllocs[kNSizes];
+   static std::chrono::steady_clock::time_point lastTime = std::chrono::steady_clock::now();
+
+   Long64_t allocs[kNSizes], frees[kNSizes], pages[kNSizes];
+   {
+      std::lock_guard<std::mutex> lock(gDepotMutex);
+      if (TThreadCache *cache = LocalCache())
+         for (size_t index = 0; index < kNSizes; ++index)
+            FlushStats(*cache, index);
+      std::copy(gAllocs, gAllocs + kNSizes, allocs);
+      std::copy(gFrees, gFrees + kNSizes, frees);
+      std::copy(gPages, gPages + kNSizes, pages);
+   }
+
+   const auto now = std::chrono::steady_clock::now();
+   const double elapsed = std::chrono::duration<double>(now - lastTime).count();
+   lastTime = now;
+
+   Printf("Object pool statistics");
+   Printf("%8s%12s%14s%14s%12s%14s%12s", "size", "reserved", "alloc", "free", "live", "live bytes", "alloc/s");
+   Printf("======================================================================================");
+   Long64_t totReserved = 0, totAllocs = 0, totFrees = 0, totLive = 0, totBytes = 0;
+   double totRate = 0;
+   for (size_t index = 0; index < kNSizes; ++index) {
+      if (!pages[index])
+         continue;
+      const Long64_t reserved = pages[index] * (Long64_t)kPageSize;
+      const Long64_t nlive = allocs[index] - frees[index];
+      const Long64_t bytes = nlive * (Long64_t)SlotSize(index);
+      const double rate = elapsed > 0 ? (allocs[index] - lastAllocs[index]) / elapsed : 0.;
+      Printf("%8d%12lld%14lld%14lld%12lld%14lld%12.0f", (int)SlotSize(index), reserved, allocs[index], frees[index],
+             nlive, bytes, rate);
+      totReserved += reserved;
+      totAllocs += allocs[index];
+      totFrees += frees[index];
+      totLive += nlive;
+      totBytes += bytes;
+      totRate += rate;
+      lastAllocs[index] = allocs[index];
+   }
+   Printf("--------------------------------------------------------------------------------------");
+   Printf("%8s%12lld%14lld%14lld%12lld%14lld%12.0f", "Total:", totReserved, totAllocs, totFrees, totLive, totBytes,
+          totRate);
+   Printf("======================================================================================");
+
+   if (!option || !strstr(option, "class"))
+      return;
+   if (gObjectTable)
+      gObjectTable->Print();
+   else
+      Printf("Set Root.ObjectStat to 1 in .rootrc to list the live objects by class");
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 ULong_t TStorage::GetHeapBegin()
@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+
+#include "TNamed.h"
+#include "TStorage.h"
+
+#include <thread>
+#include <vector>
+
+TEST(TStorage, ObjectPool)
+{
+   Long64_t allocs, frees, reserved;
+   EXPECT_FALSE(TStorage::GetObjectPoolStatistics(allocs, frees, reserved));
+   EXPECT_EQ(0, allocs);
+
+   ASSERT_TRUE(TStorage::EnableObjectPool(64));
+   EXPECT_TRUE(TStorage::IsObjectPoolEnabled());
+   ASSERT_TRUE(TStorage::GetObjectPoolStatistics(allocs, frees, reserved));
+   const Long64_t allocs0 = allocs, frees0 = frees;
+
+   TNamed *n = new TNamed("Name", "Title");
+   EXPECT_TRUE(n->IsOnHeap());
+   EXPECT_STREQ("Name", n->GetName());
+   TStorage::GetObjectPoolStatistics(allocs, frees, reserved);
+   EXPECT_EQ(allocs0 + 1, allocs);
+   EXPECT_EQ(frees0, frees);
+   EXPECT_GT(reserved, 0);
+   delete n;
+   TStorage::GetObjectPoolStatistics(allocs, frees, reserved);
+   EXPECT_EQ(frees0 + 1, frees);
+
+   // Objects deleted in another thread than the one which created them.
+   std::vector<TNamed *> objects;
+   for (int i = 0; i < 1000; ++i)
+      objects.push_back(new TNamed(TString::Format("n%d", i).Data(), ""));
+   TStorage::GetObjectPoolStatistics(allocs, frees, reserved);
+   EXPECT_EQ(allocs0 + 1001, allocs);
+   EXPECT_EQ(1000, allocs - frees - (allocs0 - frees0));
+   std::thread worker([&objects]() {
+      for (auto obj : objects)
+         delete obj;
+      for (int i = 0; i < 1000; ++i)
+         delete new TNamed("tmp", "");
+   });
+   worker.join();
+
+   // The counts of the worker are flushed when its cache is destroyed at exit.
+   TStorage::GetObjectPoolStatistics(allocs, frees, reserved);
+   EXPECT_EQ(allocs0 + 2001, allocs);
+   EXPECT_EQ(frees0 + 2001, frees);
+
+   // Objects on the stack are still recognized as such, and not counted.
+   TNamed onStack("Stack", "");
+   EXPECT_FALSE(onStack.IsOnHeap());
+   TStorage::GetObjectPoolStatistics(allocs, frees, reserved);
+   EXPECT_EQ(allocs0 + 2001, allocs);
+
+   TStorage::PrintObjectPoolStatistics("class");
+}
@@ -0,0 +1,96 @@
+/* @(#)root/core/cont:$Id$ */
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TBitUtils
+#define ROOT_TBitUtils
+
+#include "RtypesCore.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace ROOT {
+namespace Internal {
+
+/// \name Word-level bit manipulation helpers
+/// Used by the bit containers (TBits, TEntryListBlock) to count and find
+/// set bits a machine word at a time instead of a bit or a byte at a time.
+/// They use the compiler builtins (hence the popcnt / tzcnt instructions
+/// when the target supports them) where available.
+///@{
+
+/// Return the number of bits set in word.
+inline UInt_t PopCount(ULong64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return __builtin_popcountll(word);
+#else
+   word = word - ((word >> 1) & 0x5555555555555555ULL);
+   word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+   word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+   return (UInt_t)((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/// Return the index of the lowest bit set in word, which must not be zero.
+inline UInt_t CountTrailingZeros(ULong64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return __builtin_ctzll(word);
+#else
+   UInt_t n = 0;
+   while (!(word & 1)) {
+      word >>= 1;
+      ++n;
+   }
+   return n;
+#endif
+}
+
+/// Return the number of bits set in the nbytes bytes starting at buffer.
+inline UInt_t PopCount(const void *buffer, std::size_t nbytes)
+{
+   const unsigned char *bytes = static_cast<const unsigned char *>(buffer);
+   UInt_t count = 0;
+   std::size_t i = 0;
+   for (; i + sizeof(ULong64_t) <= nbytes; i += sizeof(ULong64_t)) {
+      ULong64_t word;
+      std::memcpy(&word, bytes + i, sizeof(word));
+      count += PopCount(word);
+   }
+   for (; i < nbytes; ++i)
+      count += PopCount((ULong64_t)bytes[i]);
+   return count;
+}
+
+/// Return the offset of the first non-zero byte among the nbytes bytes
+/// starting at buffer, or nbytes if they are all zero.
+inline std::size_t FirstNonZeroByte(const void *buffer, std::size_t nbytes)
+{
+   const unsigned char *bytes = static_cast<const unsigned char *>(buffer);
+   std::size_t i = 0;
+   for (; i + sizeof(ULong64_t) <= nbytes; i += sizeof(ULong64_t)) {
+      ULong64_t word;
+      std::memcpy(&word, bytes + i, sizeof(word));
+      if (word)
+         break;
+   }
+   for (; i < nbytes; ++i)
+      if (bytes[i])
+         return i;
+   return nbytes;
+}
+
+///@}
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -0,0 +1,193 @@
+/* @(#)root/core/cont:$Id$ */
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TFlatStringMap
+#define ROOT_TFlatStringMap
+
+#include "RStringView.h"
+#include "TString.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ROOT {
+namespace Internal {
+
+/**
+\class ROOT::Internal::TFlatStringMap
+\brief A flat, open-addressing hash map keyed by strings.
+
+\tparam Value_t Type of the mapped values.
+\ingroup Containers
+All the entries are stored in a single array of slots (linear probing), each
+slot keeping the precomputed hash of its key next to the key and the value.
+A lookup therefore touches a few contiguous slots and compares the strings
+only when the hashes match, instead of following the buckets of a
+THashTable and calling the virtual Hash() and GetName() of each TObject.
+The hash is the one of TString::Hash, i.e. the one of TNamed::Hash.
+
+Removed entries leave a tombstone that is reclaimed by the next rehash.
+Pointers to values are invalidated by insertions of new keys.
+*/
+template <typename Value_t>
+class TFlatStringMap {
+private:
+   enum EState : unsigned char { kEmpty, kUsed, kErased };
+
+   struct TSlot {
+      UInt_t fHash = 0;           ///< Precomputed hash of fKey
+      EState fState = kEmpty;     ///< Whether the slot is free, used or a tombstone
+      std::string fKey;           ///< The key
+      Value_t fValue = Value_t(); ///< The mapped value
+   };
+
+   std::vector<TSlot> fSlots; ///< Slots; the size is zero or a power of two
+   std::size_t fSize = 0;     ///< Number of used slots
+   std::size_t fFilled = 0;   ///< Number of used slots and tombstones
+
+   static UInt_t HashOf(std::string_view key) { return TString::Hash(key.data(), key.size()); }
+
+   /// Return the slot holding key or, if absent, the slot where it should be
+   /// inserted (the first tombstone on the probe sequence, if any).
+   std::size_t Probe(std::string_view key, UInt_t hash, bool &found) const
+   {
+      const std::size_t mask = fSlots.size() - 1;
+      std::size_t idx = hash & mask;
+      std::size_t firstErased = fSlots.size();
+      while (true) {
+         const TSlot &slot = fSlots[idx];
+         if (slot.fState == kEmpty) {
+            found = false;
+            return firstErased < fSlots.size() ? firstErased : idx;
+         }
+         if (slot.fState == kErased) {
+            if (firstErased == fSlots.size())
+               firstErased = idx;
+         } else if (slot.fHash == hash && key == std::string_view(slot.fKey)) {
+            found = true;
+            return idx;
+         }
+         idx = (idx + 1) & mask;
+      }
+   }
+
+   void Rehash(std::size_t capacity)
+   {
+      std::vector<TSlot> old;
+      old.swap(fSlots);
+      fSlots.resize(capacity);
+      fFilled = fSize;
+      const std::size_t mask = capacity - 1;
+      for (auto &slot : old) {
+         if (slot.fState != kUsed)
+            continue;
+         std::size_t idx = slot.fHash & mask;
+         while (fSlots[idx].fState != kEmpty)
+            idx = (idx + 1) & mask;
+         fSlots[idx] = std::move(slot);
+      }
+   }
+
+   /// Make room for one more entry, keeping the load factor below 3/4.
+   /// Return true if the slots were rehashed.
+   bool Reserve()
+   {
+      if (fSlots.empty()) {
+         Rehash(16);
+      } else if (4 * (fFilled + 1) > 3 * fSlots.size()) {
+         // Only grow if the table is mostly made of live entries; otherwise
+         // rehashing in place is enough to get rid of the tombstones.
+         Rehash(2 * fSize + 2 > fSlots.size() ? 2 * fSlots.size() : fSlots.size());
+      } else {
+         return false;
+      }
+      return true;
+   }
+
+public:
+   /// Return a pointer to the value mapped to key, or nullptr if absent.
+   Value_t *Find(std::string_view key)
+   {
+      if (fSize == 0)
+         return nullptr;
+      bool found;
+      std::size_t idx = Probe(key, HashOf(key), found);
+      return found ? &fSlots[idx].fValue : nullptr;
+   }
+
+   /// Return a pointer to the value mapped to key, or nullptr if absent.
+   const Value_t *Find(std::string_view key) const { return const_cast<TFlatStringMap *>(this)->Find(key); }
+
+   /// Return the value mapped to key, inserting a default constructed one if absent.
+   Value_t &operator[](std::string_view key)
+   {
+      const UInt_t hash = HashOf(key);
+      bool found = false;
+      std::size_t idx = fSlots.empty() ? 0 : Probe(key, hash, found);
+      if (found)
+         return fSlots[idx].fValue;
+      // Only an insertion may rehash, so that looking up an existing key
+      // keeps the pointers to the values valid.
+      if (Reserve())
+         idx = Probe(key, hash, found);
+      TSlot &slot = fSlots[idx];
+      if (slot.fState == kEmpty)
+         ++fFilled;
+      slot.fHash = hash;
+      slot.fState = kUsed;
+      slot.fKey.assign(key.data(), key.size());
+      slot.fValue = Value_t();
+      ++fSize;
+      return slot.fValue;
+   }
+
+   /// Remove the entry for key; return false if there was none.
+   bool Erase(std::string_view key)
+   {
+      if (fSize == 0)
+         return false;
+      bool found;
+      std::size_t idx = Probe(key, HashOf(key), found);
+      if (!found)
+         return false;
+      TSlot &slot = fSlots[idx];
+      slot.fState = kErased;
+      slot.fKey.clear();
+      slot.fValue = Value_t();
+      --fSize;
+      return true;
+   }
+
+   /// Remove all the entries and release the storage.
+   void Clear()
+   {
+      std::vector<TSlot>().swap(fSlots);
+      fSize = 0;
+      fFilled = 0;
+   }
+
+   /// Call func(key, value) for all the entries, in no particular order.
+   template <typename F>
+   void ForEach(F &&func)
+   {
+      for (auto &slot : fSlots)
+         if (slot.fState == kUsed)
+            func(std::string_view(slot.fKey), slot.fValue);
+   }
+
+   std::size_t size() const { return fSize; }
+   bool empty() const { return fSize == 0; }
+};
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
@@ -28,12 +28,23 @@
 
 class TClass;
 
+namespace ROOT {
+namespace Internal {
+   class TClonesArrayPool;
+}
+}
+
 
 class TClonesArray : public TObjArray {
 
 protected:
    TClass       *fClass;       //!Pointer to the class of the elements
    TObjArray    *fKeep;        //!Saved copies of pointers to objects
+   ROOT::Internal::TClonesArrayPool *fPool; //!Blocks the objects are allocated from, if any (see SetPoolAllocation)
+
+   void            *AllocateSlot();
+   TObject         *NewSlotObject();
+   void             ReleaseSlot(TObject *obj);
 
 public:
    enum {
@@ -70,6 +81,8 @@ public:
    TObject         *ConstructedAt(Int_t idx, Option_t *clear_options);
    void             SetClass(const char *classname,Int_t size=1000);
    void             SetClass(const TClass *cl,Int_t size=1000);
+   void             SetPoolAllocation(Int_t blockSize = 256);
+   Bool_t           HasPoolAllocation() const { return fPool != 0; }
 
    void             AbsorbObjects(TClonesArray *tc);
    void             AbsorbObjects(TClonesArray *tc, Int_t idx1, Int_t idx2);
@@ -22,6 +22,7 @@ occupied by the upper bits that are 0.
 
 #include "Riostream.h"
 #include "TObject.h"
+#include "ROOT/TBitUtils.hxx"
 
 #include <string.h>
 
@@ -117,42 +118,21 @@ void TBits::Compact()
 
 UInt_t TBits::CountBits(UInt_t startBit) const
 {
-   static const Int_t nbits[256] = {
-             0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,
-             1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,
-             1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,
-             2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
-             1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,
-             2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
-             2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
-             3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,
-             1,2,2,3,2,3,3,4,2,3,3,4,3,4,4,5,
-             2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
-             2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
-             3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,
-             2,3,3,4,3,4,4,5,3,4,4,5,4,5,5,6,
-             3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,
-             3,4,4,5,4,5,5,6,4,5,5,6,5,6,6,7,
-             4,5,5,6,5,6,6,7,5,6,6,7,6,7,7,8};
-
    UInt_t i,count = 0;
    if (startBit == 0) {
-      for(i=0; i<fNbytes; i++) {
-         count += nbits[fAllBits[i]];
-      }
-      return count;
+      return ROOT::Internal::PopCount(fAllBits, fNbytes);
    }
    if (startBit >= fNbits) return count;
    UInt_t startByte = startBit/8;
    UInt_t ibit = startBit%8;
    if (ibit) {
       for (i=ibit;i<8;i++) {
-         if (fAllBits[startByte] & (1<<ibit)) count++;
+         if (fAllBits[startByte] & (1<<i)) count++;
       }
       startByte++;
    }
-   for(i=startByte; i<fNbytes; i++) {
-      count += nbits[fAllBits[i]];
+   if (startByte < fNbytes) {
+      count += ROOT::Internal::PopCount(fAllBits + startByte, fNbytes - startByte);
    }
    return count;
 }
@@ -366,12 +346,6 @@ UInt_t TBits::FirstSetBit(UInt_t startBit) const
              4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0};
 
    UInt_t i;
-   if (startBit == 0) {
-      for(i=0; i<fNbytes; i++) {
-         if (fAllBits[i] != 0) return 8*i + fbits[fAllBits[i]];
-      }
-      return fNbits;
-   }
    if (startBit >= fNbits) return fNbits;
    UInt_t startByte = startBit/8;
    UInt_t ibit = startBit%8;
@@ -381,9 +355,9 @@ UInt_t TBits::FirstSetBit(UInt_t startBit) const
       }
       startByte++;
    }
-   for(i=startByte; i<fNbytes; i++) {
-      if (fAllBits[i] != 0) return 8*i + fbits[fAllBits[i]];
-   }
+   // skip the empty words
+   i = startByte + ROOT::Internal::FirstNonZeroByte(fAllBits + startByte, fNbytes - startByte);
+   if (i < fNbytes) return 8*i + fbits[fAllBits[i]];
    return fNbits;
 }
 
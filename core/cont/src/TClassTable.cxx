@@ -588,7 +588,12 @@ TProtoClass *TClassTable::GetProto(const char *cname)
    }
 
    TClassRec *r = FindElement(cname);
-   if (r) return r->fProto;
+   if (r) {
+      // The TProtoClass might not have been read from the ROOT PCM yet.
+      if (!r->fProto && gCling && gCling->LoadDeferredProtoClasses(r->fName))
+         r = FindElement(cname);
+      if (r) return r->fProto;
+   }
    return 0;
 }
 
@@ -604,7 +609,12 @@ TProtoClass *TClassTable::GetProtoNorm(const char *cname)
    }
 
    TClassRec *r = FindElementImpl(cname,kFALSE);
-   if (r) return r->fProto;
+   if (r) {
+      // The TProtoClass might not have been read from the ROOT PCM yet.
+      if (!r->fProto && gCling && gCling->LoadDeferredProtoClasses(r->fName))
+         r = FindElementImpl(cname,kFALSE);
+      if (r) return r->fProto;
+   }
    return 0;
 }
 
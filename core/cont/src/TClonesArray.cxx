@@ -121,6 +121,19 @@ When investigating misuse of TClonesArray, please make sure of the following:
      TClonesArrays are not destroyed and created on every event. They
      must only be constructed/destructed at the beginning/end of the
      run.
+
+### Pool allocation
+
+By default the memory of each object is allocated individually, the first
+time its slot is used. After calling SetPoolAllocation(blockSize), the
+memory of new slots is instead carved out of contiguous blocks of
+blockSize objects owned by the TClonesArray, and the slots released by
+Expand(), ExpandCreate() etc. are recycled for the next ones. This divides
+the number of allocations by blockSize and keeps the objects close to each
+other in memory, which helps arrays whose size varies a lot from entry to
+entry. Objects moved to another TClonesArray by AbsorbObjects() keep their
+blocks alive. The objects must not be deleted with operator delete, which
+is not allowed for the objects of a TClonesArray anyway.
 */
 
 #include "TClonesArray.h"
@@ -132,9 +145,131 @@ When investigating misuse of TClonesArray, please make sure of the following:
 #include "TObjectTable.h"
 
 #include <stdlib.h>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
 
 ClassImp(TClonesArray);
 
+namespace ROOT {
+namespace Internal {
+
+/// Contiguous blocks of object slots of a TClonesArray; shared between the
+/// arrays holding objects allocated from them (see AbsorbObjects).
+class TClonesArrayBlocks {
+private:
+   std::vector<char *> fBlocks; ///< Blocks of fBlockBytes bytes each
+   size_t fBlockBytes;          ///< Size in bytes of each block
+
+public:
+   TClonesArrayBlocks(size_t blockBytes) : fBlockBytes(blockBytes) {}
+   ~TClonesArrayBlocks()
+   {
+      for (auto block : fBlocks)
+         ::operator delete(block);
+   }
+
+   char *AddBlock()
+   {
+      fBlocks.push_back(static_cast<char *>(::operator new(fBlockBytes)));
+      return fBlocks.back();
+   }
+
+   const std::vector<char *> &GetBlocks() const { return fBlocks; }
+   size_t GetBlockBytes() const { return fBlockBytes; }
+};
+
+/// The slot allocator of a TClonesArray in pool allocation mode.
+/// Released slots are kept in a free list and reused before carving new
+/// slots out of the current block.
+class TClonesArrayPool {
+private:
+   size_t fSlotBytes;   ///< Size of a slot, rounded up for alignment
+   size_t fBlockSize;   ///< Number of slots per block
+   std::shared_ptr<TClonesArrayBlocks> fOwn; ///< Blocks allocated by this pool
+   std::vector<std::shared_ptr<TClonesArrayBlocks>> fForeign; ///< Blocks of absorbed objects
+   std::vector<void *> fFree; ///< Released slots
+   char *fNext = nullptr;     ///< Next unused slot of the current block
+   char *fEnd = nullptr;      ///< End of the current block
+   std::vector<std::pair<const char *, const char *>> fRanges; ///< Address ranges of all the blocks, sorted
+
+   /// Register the address range of a block, if not known yet.
+   void AddRange(const char *begin, size_t bytes)
+   {
+      auto it = std::lower_bound(fRanges.begin(), fRanges.end(), std::make_pair(begin, begin));
+      if (it == fRanges.end() || it->first != begin)
+         fRanges.insert(it, std::make_pair(begin, begin + bytes));
+   }
+
+   void AddRanges(const TClonesArrayBlocks &blocks)
+   {
+      for (auto block : blocks.GetBlocks())
+         AddRange(block, blocks.GetBlockBytes());
+   }
+
+public:
+   TClonesArrayPool(size_t objectSize, size_t blockSize)
+   {
+      const size_t align = alignof(std::max_align_t);
+      fSlotBytes = (objectSize + align - 1) / align * align;
+      fBlockSize = blockSize;
+      fOwn = std::make_shared<TClonesArrayBlocks>(fSlotBytes * fBlockSize);
+   }
+
+   void *Allocate()
+   {
+      if (!fFree.empty()) {
+         void *ptr = fFree.back();
+         fFree.pop_back();
+         return ptr;
+      }
+      if (fNext == fEnd) {
+         fNext = fOwn->AddBlock();
+         fEnd = fNext + fSlotBytes * fBlockSize;
+         AddRange(fNext, fSlotBytes * fBlockSize);
+      }
+      void *ptr = fNext;
+      fNext += fSlotBytes;
+      return ptr;
+   }
+
+   void Release(void *ptr) { fFree.push_back(ptr); }
+
+   /// Return true if ptr is in one of the blocks of the pool, by binary search
+   /// of the block ranges.
+   bool Contains(const void *ptr) const
+   {
+      const char *p = static_cast<const char *>(ptr);
+      auto it = std::upper_bound(fRanges.begin(), fRanges.end(), p,
+                                 [](const char *q, const std::pair<const char *, const char *> &range) {
+                                    return q < range.first;
+                                 });
+      return it != fRanges.begin() && p < (--it)->second;
+   }
+
+   /// Keep alive the blocks of another pool, whose objects are moved to this one.
+   void Share(const TClonesArrayPool &other)
+   {
+      auto keep = [this](const std::shared_ptr<TClonesArrayBlocks> &blocks) {
+         if (blocks == fOwn)
+            return;
+         // the blocks may have grown since they were last shared
+         AddRanges(*blocks);
+         for (auto &known : fForeign)
+            if (known == blocks)
+               return;
+         fForeign.push_back(blocks);
+      };
+      keep(other.fOwn);
+      for (auto &blocks : other.fForeign)
+         keep(blocks);
+   }
+};
+
+} // namespace Internal
+} // namespace ROOT
+
 /// Internal Utility routine to correctly release the memory for an object
 static inline void R__ReleaseMemory(TClass *cl, TObject *obj)
 {
@@ -148,7 +283,46 @@ static inline void R__ReleaseMemory(TClass *cl, TObject *obj)
       if (TObject::GetObjectStat() && gObjectTable) {
          gObjectTable->RemoveQuietly(obj);
       }
-      ::operator delete(obj);
+      TStorage::ObjectDealloc(obj);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the memory for a new object, from the pool if pool allocation is
+/// enabled. The object is not constructed.
+
+void *TClonesArray::AllocateSlot()
+{
+   if (fPool)
+      return fPool->Allocate();
+   return TStorage::ObjectAlloc(fClass->Size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a new default constructed object, allocated from the pool if pool
+/// allocation is enabled.
+
+TObject *TClonesArray::NewSlotObject()
+{
+   if (fPool)
+      return (TObject*)fClass->New(fPool->Allocate());
+   return (TObject*)fClass->New();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destruct the object, if needed, and release its memory.
+
+void TClonesArray::ReleaseSlot(TObject *obj)
+{
+   if (obj && fPool && fPool->Contains(obj)) {
+      if (obj->TestBit(TObject::kNotDeleted)) {
+         fClass->Destructor(obj, kTRUE);
+      } else if (TObject::GetObjectStat() && gObjectTable) {
+         gObjectTable->RemoveQuietly(obj);
+      }
+      fPool->Release(obj);
+   } else {
+      R__ReleaseMemory(fClass, obj);
    }
 }
 
@@ -160,6 +334,7 @@ TClonesArray::TClonesArray() : TObjArray()
 {
    fClass      = 0;
    fKeep       = 0;
+   fPool       = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -175,6 +350,7 @@ TClonesArray::TClonesArray() : TObjArray()
 TClonesArray::TClonesArray(const char *classname, Int_t s, Bool_t) : TObjArray(s)
 {
    fKeep = 0;
+   fPool = 0;
    SetClass(classname,s);
 }
 
@@ -191,6 +367,7 @@ TClonesArray::TClonesArray(const char *classname, Int_t s, Bool_t) : TObjArray(s
 TClonesArray::TClonesArray(const TClass *cl, Int_t s, Bool_t) : TObjArray(s)
 {
    fKeep = 0;
+   fPool = 0;
    SetClass(cl,s);
 }
 
@@ -200,6 +377,7 @@ TClonesArray::TClonesArray(const TClass *cl, Int_t s, Bool_t) : TObjArray(s)
 TClonesArray::TClonesArray(const TClonesArray& tc): TObjArray(tc)
 {
    fKeep = new TObjArray(tc.fSize);
+   fPool = 0;
    fClass = tc.fClass;
 
    BypassStreamer(kTRUE);
@@ -229,7 +407,7 @@ TClonesArray& TClonesArray::operator=(const TClonesArray& tc)
 
    for (i = 0; i < fSize; i++)
       if (fKeep->fCont[i]) {
-         R__ReleaseMemory(fClass,fKeep->fCont[i]);
+         ReleaseSlot(fKeep->fCont[i]);
          fKeep->fCont[i] = nullptr;
          fCont[i] = nullptr;
       }
@@ -253,11 +431,13 @@ TClonesArray::~TClonesArray()
 {
    if (fKeep) {
       for (Int_t i = 0; i < fKeep->fSize; i++) {
-         R__ReleaseMemory(fClass,fKeep->fCont[i]);
+         ReleaseSlot(fKeep->fCont[i]);
          fKeep->fCont[i] = nullptr;
       }
    }
    SafeDelete(fKeep);
+   delete fPool;
+   fPool = 0;
 
    // Protect against erroneously setting of owner bit
    SetOwner(kFALSE);
@@ -460,7 +640,7 @@ void TClonesArray::Expand(Int_t newSize)
       // Expand() will shrink correctly
       for (int i = newSize; i < fSize; i++)
          if (fKeep->fCont[i]) {
-            R__ReleaseMemory(fClass,fKeep->fCont[i]);
+            ReleaseSlot(fKeep->fCont[i]);
             fKeep->fCont[i] = nullptr;
          }
    }
@@ -489,7 +669,7 @@ void TClonesArray::ExpandCreate(Int_t n)
    Int_t i;
    for (i = 0; i < n; i++) {
       if (!fKeep->fCont[i]) {
-         fKeep->fCont[i] = (TObject*)fClass->New();
+         fKeep->fCont[i] = NewSlotObject();
       } else if (!fKeep->fCont[i]->TestBit(kNotDeleted)) {
          // The object has been deleted (or never initialized)
          fClass->New(fKeep->fCont[i]);
@@ -499,7 +679,7 @@ void TClonesArray::ExpandCreate(Int_t n)
 
    for (i = n; i < fSize; i++)
       if (fKeep->fCont[i]) {
-         R__ReleaseMemory(fClass,fKeep->fCont[i]);
+         ReleaseSlot(fKeep->fCont[i]);
          fKeep->fCont[i] = nullptr;
          fCont[i] = nullptr;
       }
@@ -526,7 +706,7 @@ void TClonesArray::ExpandCreateFast(Int_t n)
    Int_t i;
    for (i = 0; i < n; i++) {
       if (i >= oldSize || !fKeep->fCont[i]) {
-         fKeep->fCont[i] = (TObject*)fClass->New();
+         fKeep->fCont[i] = NewSlotObject();
       } else if (!fKeep->fCont[i]->TestBit(kNotDeleted)) {
          // The object has been deleted (or never initialized)
          fClass->New(fKeep->fCont[i]);
@@ -666,6 +846,25 @@ void TClonesArray::SetClass(const char *classname, Int_t s)
    SetClass(TClass::GetClass(classname),s);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Allocate the memory of the objects of this array from contiguous blocks
+/// of blockSize objects instead of individually (see the class description).
+/// Objects that already have their memory are not affected. Once enabled,
+/// pool allocation stays enabled for the lifetime of the array.
+
+void TClonesArray::SetPoolAllocation(Int_t blockSize)
+{
+   if (fPool)
+      return;
+   if (!fClass) {
+      Error("SetPoolAllocation", "invalid class specified in TClonesArray ctor");
+      return;
+   }
+   if (blockSize < 1)
+      blockSize = 1;
+   fPool = new ROOT::Internal::TClonesArrayPool(fClass->Size(), blockSize);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// A TClonesArray is always the owner of the object it contains.
@@ -770,7 +969,7 @@ void TClonesArray::Streamer(TBuffer &b)
       if (CanBypassStreamer() && !b.TestBit(TBuffer::kCannotHandleMemberWiseStreaming)) {
          for (Int_t i = 0; i < nobjects; i++) {
             if (!fKeep->fCont[i]) {
-               fKeep->fCont[i] = (TObject*)fClass->New();
+               fKeep->fCont[i] = NewSlotObject();
             } else if (!fKeep->fCont[i]->TestBit(kNotDeleted)) {
                // The object has been deleted (or never initialized)
                fClass->New(fKeep->fCont[i]);
@@ -786,7 +985,7 @@ void TClonesArray::Streamer(TBuffer &b)
             b >> nch;
             if (nch) {
                if (!fKeep->fCont[i])
-                  fKeep->fCont[i] = (TObject*)fClass->New();
+                  fKeep->fCont[i] = NewSlotObject();
                else if (!fKeep->fCont[i]->TestBit(kNotDeleted)) {
                   // The object has been deleted (or never initialized)
                   fClass->New(fKeep->fCont[i]);
@@ -870,7 +1069,7 @@ TObject *&TClonesArray::operator[](Int_t idx)
       Expand(TMath::Max(idx+1, GrowBy(fSize)));
 
    if (!fKeep->fCont[idx]) {
-      fKeep->fCont[idx] = (TObject*) TStorage::ObjectAlloc(fClass->Size());
+      fKeep->fCont[idx] = (TObject*) AllocateSlot();
       // Reset the bit so that:
       //    obj = myClonesArray[i];
       //    obj->TestBit(TObject::kNotDeleted)
@@ -969,11 +1168,18 @@ void TClonesArray::AbsorbObjects(TClonesArray *tc, Int_t idx1, Int_t idx2)
    if(newSize > fSize)
       Expand(newSize);
 
+   // the objects allocated from the pool of tc must outlive it
+   if (tc->fPool) {
+      if (!fPool)
+         SetPoolAllocation();
+      fPool->Share(*tc->fPool);
+   }
+
    // move
    for (Int_t i = idx1; i <= idx2; i++) {
       Int_t newindex = oldSize+i -idx1;
       fCont[newindex] = tc->fCont[i];
-      R__ReleaseMemory(fClass,fKeep->fCont[newindex]);
+      ReleaseSlot(fKeep->fCont[newindex]);
       (*fKeep)[newindex] = (*(tc->fKeep))[i];
       tc->fCont[i] = 0;
       (*(tc->fKeep))[i] = 0;
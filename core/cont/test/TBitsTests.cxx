@@ -0,0 +1,29 @@
+#include "gtest/gtest.h"
+#include "TBits.h"
+
+TEST(TBits, CountAndFind)
+{
+   TBits bits(1000);
+   const UInt_t set[] = {3, 64, 65, 130, 700, 999};
+   for (auto b : set)
+      bits.SetBitNumber(b);
+
+   EXPECT_EQ(bits.CountBits(), 6u);
+   EXPECT_EQ(bits.CountBits(4), 5u);
+   EXPECT_EQ(bits.CountBits(65), 4u);
+   EXPECT_EQ(bits.CountBits(66), 3u);
+   EXPECT_EQ(bits.CountBits(1000), 0u);
+
+   EXPECT_EQ(bits.FirstSetBit(), 3u);
+   EXPECT_EQ(bits.FirstSetBit(4), 64u);
+   EXPECT_EQ(bits.FirstSetBit(66), 130u);
+   EXPECT_EQ(bits.FirstSetBit(131), 700u);
+   EXPECT_EQ(bits.FirstSetBit(701), 999u);
+   EXPECT_EQ(bits.FirstSetBit(1000), bits.GetNbits());
+
+   // Walk over all the set bits.
+   UInt_t n = 0;
+   for (UInt_t b = bits.FirstSetBit(); b < bits.GetNbits(); b = bits.FirstSetBit(b + 1))
+      EXPECT_EQ(b, set[n++]);
+   EXPECT_EQ(n, 6u);
+}
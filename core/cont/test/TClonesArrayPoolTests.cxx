@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include "TClonesArray.h"
+#include "TNamed.h"
+
+#include <new>
+#include <set>
+
+TEST(TClonesArrayPool, ReuseSlots)
+{
+   TClonesArray arr("TNamed", 10);
+   arr.SetPoolAllocation(4);
+   EXPECT_TRUE(arr.HasPoolAllocation());
+
+   for (Int_t i = 0; i < 10; ++i)
+      new (arr[i]) TNamed(TString::Format("n%d", i).Data(), "");
+   ASSERT_EQ(arr.GetEntriesFast(), 10);
+   TObject *first = arr.At(0);
+   EXPECT_STREQ(static_cast<TNamed *>(arr.At(9))->GetName(), "n9");
+
+   // Clear keeps the slots; the same memory is used again.
+   arr.Clear("C");
+   new (arr[0]) TNamed("again", "");
+   EXPECT_EQ(arr.At(0), first);
+   EXPECT_STREQ(arr.At(0)->GetName(), "again");
+
+   // Shrinking releases the slots to the pool, growing takes them back.
+   arr.ExpandCreate(2);
+   arr.ExpandCreate(10);
+   for (Int_t i = 0; i < 10; ++i)
+      EXPECT_NE(arr.At(i), nullptr);
+}
+
+TEST(TClonesArrayPool, Absorb)
+{
+   TClonesArray *src = new TClonesArray("TNamed", 4);
+   src->SetPoolAllocation(2);
+   for (Int_t i = 0; i < 4; ++i)
+      new ((*src)[i]) TNamed(TString::Format("s%d", i).Data(), "");
+
+   TClonesArray dst("TNamed", 4);
+   new (dst[0]) TNamed("d0", "");
+   dst.AbsorbObjects(src);
+   EXPECT_TRUE(dst.HasPoolAllocation());
+   EXPECT_EQ(src->GetEntriesFast(), 0);
+
+   // The absorbed objects must outlive their original array.
+   delete src;
+   ASSERT_EQ(dst.GetEntriesFast(), 5);
+   EXPECT_STREQ(dst.At(0)->GetName(), "d0");
+   EXPECT_STREQ(dst.At(4)->GetName(), "s3");
+}
+
+TEST(TClonesArrayPool, ManyBlocks)
+{
+   TClonesArray arr("TNamed", 1000);
+   arr.SetPoolAllocation(2);
+   for (Int_t i = 0; i < 1000; ++i)
+      new (arr[i]) TNamed(TString::Format("n%d", i).Data(), "");
+   std::set<TObject *> slots;
+   for (Int_t i = 0; i < 1000; ++i)
+      slots.insert(arr.At(i));
+
+   // All the released slots are found in the blocks and reused.
+   arr.ExpandCreate(1);
+   arr.ExpandCreate(1000);
+   for (Int_t i = 0; i < 1000; ++i)
+      EXPECT_EQ(slots.count(arr.At(i)), 1u) << "slot " << i;
+}
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+#include "ROOT/TFlatStringMap.hxx"
+
+#include <string>
+
+using ROOT::Internal::TFlatStringMap;
+
+TEST(TFlatStringMap, InsertFind)
+{
+   TFlatStringMap<int> map;
+   EXPECT_TRUE(map.empty());
+   EXPECT_EQ(map.Find("a"), nullptr);
+   map["a"] = 1;
+   map["b"] = 2;
+   ASSERT_NE(map.Find("a"), nullptr);
+   EXPECT_EQ(*map.Find("a"), 1);
+   EXPECT_EQ(*map.Find("b"), 2);
+   EXPECT_EQ(map.Find("c"), nullptr);
+   map["a"] = 3;
+   EXPECT_EQ(*map.Find("a"), 3);
+   EXPECT_EQ(map.size(), 2u);
+}
+
+TEST(TFlatStringMap, EraseAndGrow)
+{
+   TFlatStringMap<int> map;
+   const int n = 10000;
+   for (int i = 0; i < n; ++i)
+      map[std::to_string(i)] = i;
+   EXPECT_EQ(map.size(), std::size_t(n));
+   for (int i = 0; i < n; i += 2)
+      EXPECT_TRUE(map.Erase(std::to_string(i)));
+   EXPECT_FALSE(map.Erase("0"));
+   EXPECT_EQ(map.size(), std::size_t(n / 2));
+   for (int i = 0; i < n; ++i) {
+      const int *value = map.Find(std::to_string(i));
+      if (i % 2) {
+         ASSERT_NE(value, nullptr);
+         EXPECT_EQ(*value, i);
+      } else {
+         EXPECT_EQ(value, nullptr);
+      }
+   }
+   // Reinsert over the tombstones.
+   for (int i = 0; i < n; i += 2)
+      map[std::to_string(i)] = -i;
+   EXPECT_EQ(map.size(), std::size_t(n));
+   EXPECT_EQ(*map.Find("42"), -42);
+
+   std::size_t count = 0;
+   map.ForEach([&count](std::string_view, int &) { ++count; });
+   EXPECT_EQ(count, map.size());
+
+   map.Clear();
+   EXPECT_TRUE(map.empty());
+   EXPECT_EQ(map.Find("1"), nullptr);
+}
+
+TEST(TFlatStringMap, LookupKeepsValues)
+{
+   TFlatStringMap<int> map;
+   // Fill up to the load factor at which the next insertion rehashes.
+   for (int i = 0; i < 12; ++i)
+      map[std::to_string(i)] = i;
+   int *value = map.Find("0");
+   ASSERT_NE(value, nullptr);
+   for (int i = 0; i < 12; ++i)
+      EXPECT_EQ(map[std::to_string(i)], i);
+   EXPECT_EQ(map.Find("0"), value);
+   EXPECT_EQ(map.size(), 12u);
+}
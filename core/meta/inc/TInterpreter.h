@@ -155,6 +155,7 @@ public:
                                    const FwdDeclArgsToKeepCollection_t& fwdDeclArgsToKeep,
                                    const char** classesHeaders,
                                    Bool_t lateRegistration = false) = 0;
+   virtual Bool_t   LoadDeferredProtoClasses(const char * /*classname*/) { return kFALSE; }
    virtual void     RegisterTClassUpdate(TClass *oldcl,DictFuncPtr_t dict) = 0;
    virtual void     UnRegisterTClassUpdate(const TClass *oldcl) = 0;
    virtual Int_t    SetClassSharedLibs(const char *cls, const char *libs) = 0;
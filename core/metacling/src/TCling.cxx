@@ -1050,6 +1050,10 @@ TCling::TCling(const char *name, const char *title)
    fClingCallbacks(0), fAutoLoadCallBack(0),
    fTransactionCount(0), fHeaderParsingOnDemand(true), fIsAutoParsingSuspended(kFALSE)
 {
+   // Delay the reading of the TProtoClasses stored in the ROOT PCMs until
+   // the TClass of one of the classes of the module is first needed.
+   fLazyRootPcm = getenv("ROOT_LAZY_PCM") != nullptr;
+
    // rootcling also uses TCling for generating the dictionary ROOT files.
    bool fromRootCling = dlsym(RTLD_DEFAULT, "usedToIdentifyRootClingByDlSym");
 
@@ -1279,12 +1283,149 @@ static bool R__InitStreamerInfoFactory()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the TProtoClasses stored in an opened ROOT PCM and register them with
+/// the TClassTable, updating the TClass objects that already exist.
+
+void TCling::LoadPCMProtoClasses(TFile *pcmFile)
+{
+   TObjArray *protoClasses;
+   if (gDebug > 1)
+      ::Info("TCling::LoadPCM","reading protoclasses for %s \n",pcmFile->GetName());
+
+   pcmFile->GetObject("__ProtoClasses", protoClasses);
+
+   if (protoClasses) {
+      for (auto obj : *protoClasses) {
+         TProtoClass * proto = (TProtoClass*)obj;
+         TClassTable::Add(proto);
+      }
+      // Now that all TClass-es know how to set them up we can update
+      // existing TClasses, which might cause the creation of e.g. TBaseClass
+      // objects which in turn requires the creation of TClasses, that could
+      // come from the PCH, but maybe later in the loop. Instead of resolving
+      // a dependency graph the addition to the TClassTable above allows us
+      // to create these dependent TClasses as needed below.
+      for (auto proto : *protoClasses) {
+         if (TClass* existingCl
+             = (TClass*)gROOT->GetListOfClasses()->FindObject(proto->GetName())) {
+            // We have an existing TClass object. It might be emulated
+            // or interpreted; we now have more information available.
+            // Make that available.
+            if (existingCl->GetState() != TClass::kHasTClassInit) {
+               DictFuncPtr_t dict = gClassTable->GetDict(proto->GetName());
+               if (!dict) {
+                  ::Error("TCling::LoadPCM", "Inconsistent TClassTable for %s",
+                          proto->GetName());
+               } else {
+                  // This will replace the existing TClass.
+                  TClass *ncl = (*dict)();
+                  if (ncl) ncl->PostLoadCheck();
+
+               }
+            }
+         }
+      }
+
+      protoClasses->Clear(); // Ownership was transfered to TClassTable.
+      delete protoClasses;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record that the TProtoClasses of the ROOT PCM pcmFileName are to be read
+/// only when one of the classes listed in classesHeaders (see RegisterModule)
+/// requests its TProtoClass. Returns false if the TProtoClasses have to be
+/// read right away, i.e. if one of these classes already has a TClass that
+/// would need to be updated.
+/// The autoparse names of classesHeaders are spelled as requested in the
+/// LinkDef; the classes are also recorded under the normalized name that the
+/// dictionary registered in the TClassTable as their alternate, which is the
+/// name TClassTable::GetProtoNorm is called with.
+
+bool TCling::DeferPCMProtoClasses(const TString &pcmFileName, const char **classesHeaders)
+{
+   std::vector<std::string> classNames;
+   std::string normName;
+   for (const char** classesHeader = classesHeaders; *classesHeader; ++classesHeader) {
+      if (gROOT->GetListOfClasses()->FindObject(*classesHeader))
+         return false;
+      classNames.emplace_back(*classesHeader);
+      normName.clear();
+      if (TClassTable::Check(*classesHeader, normName) && !normName.empty()) {
+         if (gROOT->GetListOfClasses()->FindObject(normName.c_str()))
+            return false;
+         classNames.emplace_back(normName);
+      }
+      while (*classesHeader && strcmp(*classesHeader, "@") != 0)
+         ++classesHeader;
+      if (!*classesHeader)
+         break;
+   }
+   if (classNames.empty())
+      return false;
+
+   fPendingPCMs.insert(pcmFileName.Data());
+   for (auto &name : classNames)
+      fPendingProtoClasses[name] = pcmFileName.Data();
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the deferred TProtoClasses of the ROOT PCM declaring classname, if
+/// any (see ROOT_LAZY_PCM). Returns true if TProtoClasses were read.
+
+Bool_t TCling::LoadDeferredProtoClasses(const char *classname)
+{
+   R__LOCKGUARD(gInterpreterMutex);
+
+   if (fPendingPCMs.empty())
+      return kFALSE;
+   auto iter = fPendingProtoClasses.find(classname);
+   // A nested class is listed under its outermost enclosing class.
+   Int_t nesting = 0;
+   for (const char *c = classname; *c && iter == fPendingProtoClasses.end(); ++c) {
+      if (*c == '<') {
+         ++nesting;
+      } else if (*c == '>') {
+         --nesting;
+      } else if (nesting == 0 && c[0] == ':' && c[1] == ':') {
+         iter = fPendingProtoClasses.find(std::string(classname, c - classname));
+         ++c;
+      }
+   }
+   if (iter == fPendingProtoClasses.end())
+      return kFALSE;
+   std::string pcmFileName = iter->second;
+   fPendingProtoClasses.erase(iter);
+   // Stale entries of other classes of the same PCM are skipped by this check.
+   if (!fPendingPCMs.erase(pcmFileName))
+      return kFALSE;
+
+   Int_t oldDebug = gDebug;
+   if (gDebug > 5) {
+      gDebug -= 5;
+      ::Info("TCling::LoadDeferredProtoClasses", "Loading ROOT PCM %s for %s", pcmFileName.c_str(), classname);
+   } else {
+      gDebug = 0;
+   }
+
+   TDirectory::TContext ctxt;
+   std::unique_ptr<TFile> pcmFile(new TFile((pcmFileName + "?filetype=pcm").c_str(), "READ"));
+   if (!pcmFile->IsZombie())
+      LoadPCMProtoClasses(pcmFile.get());
+
+   gDebug = oldDebug;
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Tries to load a PCM; returns true on success.
 
 bool TCling::LoadPCM(TString pcmFileName,
                      const char** headers,
-                     void (*triggerFunc)()) const {
+                     void (*triggerFunc)(),
+                     const char** classesHeaders /*= nullptr*/) {
    // pcmFileName is an intentional copy; updated by FindFile() below.
 
    TString searchPath;
@@ -1343,46 +1484,11 @@ bool TCling::LoadPCM(TString pcmFileName,
          return kTRUE;
       }
 
-      TObjArray *protoClasses;
-      if (gDebug > 1)
-            ::Info("TCling::LoadPCM","reading protoclasses for %s \n",pcmFileName.Data());
-
-      pcmFile->GetObject("__ProtoClasses", protoClasses);
-
-      if (protoClasses) {
-         for (auto obj : *protoClasses) {
-            TProtoClass * proto = (TProtoClass*)obj;
-            TClassTable::Add(proto);
-         }
-         // Now that all TClass-es know how to set them up we can update
-         // existing TClasses, which might cause the creation of e.g. TBaseClass
-         // objects which in turn requires the creation of TClasses, that could
-         // come from the PCH, but maybe later in the loop. Instead of resolving
-         // a dependency graph the addition to the TClassTable above allows us
-         // to create these dependent TClasses as needed below.
-         for (auto proto : *protoClasses) {
-            if (TClass* existingCl
-                = (TClass*)gROOT->GetListOfClasses()->FindObject(proto->GetName())) {
-               // We have an existing TClass object. It might be emulated
-               // or interpreted; we now have more information available.
-               // Make that available.
-               if (existingCl->GetState() != TClass::kHasTClassInit) {
-                  DictFuncPtr_t dict = gClassTable->GetDict(proto->GetName());
-                  if (!dict) {
-                     ::Error("TCling::LoadPCM", "Inconsistent TClassTable for %s",
-                             proto->GetName());
-                  } else {
-                     // This will replace the existing TClass.
-                     TClass *ncl = (*dict)();
-                     if (ncl) ncl->PostLoadCheck();
-
-                  }
-               }
-            }
-         }
-
-         protoClasses->Clear(); // Ownership was transfered to TClassTable.
-         delete protoClasses;
+      if (fLazyRootPcm && classesHeaders && DeferPCMProtoClasses(pcmFileName, classesHeaders)) {
+         if (gDebug > 1)
+            ::Info("TCling::LoadPCM","deferring protoclasses for %s \n",pcmFileName.Data());
+      } else {
+         LoadPCMProtoClasses(pcmFile);
       }
 
       TObjArray *dataTypes;
@@ -1751,7 +1857,7 @@ void TCling::RegisterModule(const char* modulename,
 
        ) {
       // No pcm for now for libCore or libRint, the info is in the pch.
-      if (!LoadPCM(pcmFileName, headers, triggerFunc)) {
+      if (!LoadPCM(pcmFileName, headers, triggerFunc, classesHeaders)) {
          ::Error("TCling::RegisterModule", "cannot find dictionary module %s",
                  ROOT::TMetaUtils::GetModuleFileName(modulename).c_str());
       }
@@ -59,6 +59,7 @@ namespace cling {
 
 class TClingCallbacks;
 class TEnv;
+class TFile;
 class THashTable;
 class TInterpreterValue;
 class TMethod;
@@ -141,6 +142,9 @@ private: // Data Members
 
    Bool_t fHeaderParsingOnDemand;
    Bool_t fIsAutoParsingSuspended;
+   Bool_t fLazyRootPcm;               // True if the TProtoClasses of the ROOT PCMs are read on first use.
+   std::unordered_set<std::string> fPendingPCMs; // ROOT PCMs whose TProtoClasses are not read yet.
+   std::unordered_map<std::string, std::string> fPendingProtoClasses; // Class name to its pending ROOT PCM.
 
    UInt_t AutoParseImplRecurse(const char *cls, bool topLevel);
 
@@ -206,6 +210,7 @@ public: // Public Interface
                           const FwdDeclArgsToKeepCollection_t& fwdDeclsArgToSkip,
                           const char** classesHeaders,
                           Bool_t lateRegistration = false);
+   Bool_t  LoadDeferredProtoClasses(const char *classname);
    void    RegisterTClassUpdate(TClass *oldcl,DictFuncPtr_t dict);
    void    UnRegisterTClassUpdate(const TClass *oldcl);
 
@@ -536,7 +541,9 @@ private: // Private Utility Functions and Classes
    void AddFriendToClass(clang::FunctionDecl*, clang::CXXRecordDecl*) const;
 
    bool LoadPCM(TString pcmFileName, const char** headers,
-                void (*triggerFunc)()) const;
+                void (*triggerFunc)(), const char** classesHeaders = nullptr);
+   void LoadPCMProtoClasses(TFile *pcmFile);
+   bool DeferPCMProtoClasses(const TString &pcmFileName, const char **classesHeaders);
    void InitRootmapFile(const char *name);
    int  ReadRootmapFile(const char *rootmapfile, TUniqueString* uniqueString = nullptr);
    Bool_t HandleNewTransaction(const cling::Transaction &T);
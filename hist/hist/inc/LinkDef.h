@@ -74,7 +74,7 @@
 #pragma link C++ class TH3S-;
 #pragma link C++ class TH3I+;
 #pragma link C++ class THLimitsFinder+;
-#pragma link C++ class THnBase+;
+#pragma link C++ class THnBase-;
 #pragma link C++ class THnIter+;
 #pragma link C++ class TNDArray+;
 #pragma link C++ class TNDArrayT<Float_t>+;
@@ -165,6 +165,7 @@
 #pragma link C++ class TSVDUnfold+;
 #pragma link C++ class TEfficiency+;
 #pragma link C++ class TKDE+;
+#pragma link C++ class TQuantileSketch-;
 
 
 #pragma link C++ typedef THnSparseD;
@@ -145,6 +145,9 @@ namespace ROOT {
             return fFunc->EvalPar(x, p);
          }
 
+         /// evaluate function at several points (batch evaluation of TF1 for T = double)
+         void DoEvalParBatch(const T *const *x, unsigned int n, T *result, const double *p) const;
+
          /// evaluate function using the cached parameter values (of TF1)
          /// re-implement for better efficiency
          T DoEvalVec(const T *x) const
@@ -244,11 +247,10 @@ namespace ROOT {
          //  so in case of fLinear (or fPolynomial) a non-zero value will be returned for fixed parameters
 
          if (!fLinear) {
-            // need to set parameter values
-            fFunc->SetParameters(par);
-            // no need to call InitArgs (it is called in TF1::GradientPar)
+            // use the given parameter values without setting them in the TF1,
+            // so that the gradient can be evaluated concurrently
             double prec = this->GetDerivPrecision();
-            fFunc->GradientPar(x, grad, prec);
+            fFunc->GradientPar(x, par, grad, prec);
          } else { // case of linear functions
             unsigned int np = NPar();
             for (unsigned int i = 0; i < np; ++i)
@@ -262,9 +264,8 @@ namespace ROOT {
          // evaluate the derivative of the function with respect to parameter ipar
          // see note above concerning the fixed parameters
          if (! fLinear) {
-            fFunc->SetParameters(p);
             double prec = this->GetDerivPrecision();
-            return fFunc->GradientPar(ipar, x, prec);
+            return fFunc->GradientPar(ipar, x, p, prec);
          }
          if (fPolynomial) {
             // case of polynomial function (no parameter dependency)  (case for dim = 1)
@@ -280,6 +281,23 @@ namespace ROOT {
          }
       }
 
+      template<class T>
+      void WrappedMultiTF1Templ<T>::DoEvalParBatch(const T *const *x, unsigned int n, T *result, const double *p) const
+      {
+         std::vector<T> point(fDim);
+         for (unsigned int i = 0; i < n; ++i) {
+            for (unsigned int j = 0; j < fDim; ++j)
+               point[j] = x[j][i];
+            result[i] = fFunc->EvalPar(point.data(), p);
+         }
+      }
+
+      template<>
+      inline void WrappedMultiTF1Templ<double>::DoEvalParBatch(const double *const *x, unsigned int n, double *result, const double *p) const
+      {
+         fFunc->EvalParBatch(x, n, result, p);
+      }
+
       template<class T>
       void WrappedMultiTF1Templ<T>::SetDerivPrecision(double eps)
       {
@@ -0,0 +1,144 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TConcurrentStats
+#define ROOT_TConcurrentStats
+
+#include "RtypesCore.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace ROOT {
+namespace Internal {
+
+/// \name Helpers for the concurrent fill mode of the histograms
+/// See TH1::SetConcurrentFill() and THnBase::SetConcurrentFill().
+///@{
+
+/// Atomically replace target by update(target), retrying until no other
+/// thread modified target in between.
+template <typename T, typename F>
+inline void AtomicUpdate(T &target, F &&update)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   T expected;
+   __atomic_load(&target, &expected, __ATOMIC_RELAXED);
+   T desired = update(expected);
+   while (!__atomic_compare_exchange(&target, &expected, &desired, true /*weak*/, __ATOMIC_RELAXED,
+                                     __ATOMIC_RELAXED))
+      desired = update(expected);
+#else
+   static_assert(sizeof(std::atomic<T>) == sizeof(T), "std::atomic<T> must have the layout of T");
+   std::atomic<T> &atomicTarget = reinterpret_cast<std::atomic<T> &>(target);
+   T expected = atomicTarget.load(std::memory_order_relaxed);
+   while (!atomicTarget.compare_exchange_weak(expected, update(expected), std::memory_order_relaxed)) {
+   }
+#endif
+}
+
+/// Atomically add value to target.
+template <typename T>
+inline void AtomicAdd(T &target, T value)
+{
+   AtomicUpdate(target, [value](T old) { return T(old + value); });
+}
+
+/**
+\class ROOT::Internal::TConcurrentStats
+\brief Per-thread accumulation of the statistics of a histogram.
+
+Sums of weights (entries, sum of weights, sum of weight*x, ...) are updated
+at each fill; doing that atomically on a single set of sums would make all
+the filling threads contend on the same cache line. Instead, each thread adds
+to one of kNStripes sets of sums, protected by a spin lock that is
+uncontended as long as fewer than kNStripes threads fill. The sums are
+folded into the histogram when its statistics are read.
+*/
+class TConcurrentStats {
+public:
+   enum { kNStripes = 64 };
+
+private:
+   struct TStripe {
+      std::vector<Double_t> fSums;      ///< Partial sums of the threads using this stripe
+      std::atomic<bool> fLocked{false}; ///< Spin lock protecting fSums
+      char fPad[64 - sizeof(std::vector<Double_t>) - sizeof(std::atomic<bool>)]; ///< Keep stripes on different cache lines
+
+      void Lock()
+      {
+         while (fLocked.exchange(true, std::memory_order_acquire)) {
+         }
+      }
+      void Unlock() { fLocked.store(false, std::memory_order_release); }
+   };
+
+   std::unique_ptr<TStripe[]> fStripes; ///< The kNStripes sets of partial sums
+
+   /// Return the stripe used by the calling thread; threads are assigned to
+   /// stripes in a round-robin fashion, the first time they fill.
+   TStripe &GetStripe()
+   {
+      static std::atomic<unsigned> gNextStripe{0};
+      thread_local unsigned stripe = gNextStripe++ % kNStripes;
+      return fStripes[stripe];
+   }
+
+public:
+   /// Construct a set of nsums partial sums per stripe, initialized to zero.
+   explicit TConcurrentStats(Int_t nsums) : fStripes(new TStripe[kNStripes])
+   {
+      for (Int_t i = 0; i < kNStripes; ++i)
+         fStripes[i].fSums.assign(nsums, 0.);
+   }
+
+   /// Call update(sums) on the partial sums of the calling thread.
+   template <typename F>
+   void Update(F &&update)
+   {
+      TStripe &stripe = GetStripe();
+      stripe.Lock();
+      update(stripe.fSums.data());
+      stripe.Unlock();
+   }
+
+   /// Add the partial sums of all the threads to sums and reset them.
+   void Fold(Double_t *sums)
+   {
+      for (Int_t i = 0; i < kNStripes; ++i) {
+         TStripe &stripe = fStripes[i];
+         stripe.Lock();
+         for (std::size_t j = 0; j < stripe.fSums.size(); ++j) {
+            sums[j] += stripe.fSums[j];
+            stripe.fSums[j] = 0.;
+         }
+         stripe.Unlock();
+      }
+   }
+
+   /// Reset the partial sums of all the threads.
+   void Reset()
+   {
+      for (Int_t i = 0; i < kNStripes; ++i) {
+         TStripe &stripe = fStripes[i];
+         stripe.Lock();
+         stripe.fSums.assign(stripe.fSums.size(), 0.);
+         stripe.Unlock();
+      }
+   }
+};
+
+///@}
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
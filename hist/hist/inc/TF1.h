@@ -401,6 +401,7 @@ public:
    virtual void     DrawF1(Double_t xmin, Double_t xmax, Option_t *option = "");
    virtual Double_t Eval(Double_t x, Double_t y = 0, Double_t z = 0, Double_t t = 0) const;
    virtual Double_t EvalPar(const Double_t *x, const Double_t *params = 0);
+   virtual void     EvalParBatch(const Double_t *const *x, Int_t n, Double_t *result, const Double_t *params = 0);
    template <class T> T EvalPar(const T *x, const Double_t *params = 0);
    template <class T> T EvalParVec(const T *data, const Double_t *params = 0);
 #ifdef R__HAS_VECCORE
@@ -540,6 +541,8 @@ public:
    }
    virtual Double_t GradientPar(Int_t ipar, const Double_t *x, Double_t eps = 0.01);
    virtual void     GradientPar(const Double_t *x, Double_t *grad, Double_t eps = 0.01);
+   Double_t         GradientPar(Int_t ipar, const Double_t *x, const Double_t *params, Double_t eps) const;
+   void             GradientPar(const Double_t *x, const Double_t *params, Double_t *grad, Double_t eps) const;
    virtual void     InitArgs(const Double_t *x, const Double_t *params);
    static  void     InitStandardFunctions();
    virtual Double_t Integral(Double_t a, Double_t b, Double_t epsrel = 1.e-12);
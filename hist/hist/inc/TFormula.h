@@ -19,6 +19,7 @@
 #include "TObjArray.h"
 #include "TMethodCall.h"
 #include "TInterpreter.h"
+#include <atomic>
 #include <vector>
 #include <list>
 #include <map>
@@ -97,9 +98,12 @@ private:
 
    TInterpreter::CallFuncIFacePtr_t::Generic_t fFuncPtr;   //!  function pointer
    void *   fLambdaPtr;                                    //!  pointer to the lambda function
+   mutable std::atomic<TInterpreter::CallFuncIFacePtr_t::Generic_t> fBatchFuncPtr{nullptr}; //!  function pointer of the batch kernel, compiled on first use
+   mutable std::atomic<Bool_t> fBatchFailed{kFALSE};       //!  set if the batch kernel could not be compiled
 
    void     InputFormulaIntoCling();
    Bool_t   PrepareEvalMethod();
+   Bool_t   PrepareBatchEvalMethod() const;
    void     FillDefaults();
    void     HandlePolN(TString &formula);
    void     HandleParametrizedFunctions(TString &formula);
@@ -164,6 +168,7 @@ public:
    Double_t       Eval(Double_t x, Double_t y , Double_t z) const;
    Double_t       Eval(Double_t x, Double_t y , Double_t z , Double_t t ) const;
    Double_t       EvalPar(const Double_t *x, const Double_t *params=0) const;
+   void           EvalParBatch(const Double_t *const *x, Int_t n, Double_t *result, const Double_t *params=0) const;
    TString        GetExpFormula(Option_t *option="") const;
    const TObject *GetLinearPart(Int_t i) const;
    Int_t          GetNdim() const {return fNdim;}
@@ -179,8 +184,10 @@ public:
    Int_t          GetVarNumber(const char *name) const;
    TString        GetVarName(Int_t ivar) const;
    Bool_t         IsValid() const { return fReadyToExecute && fClingInitialized; }
+   static Bool_t  LoadCompiledCache(const char *filename);
    Bool_t         IsLinear() const { return TestBit(kLinear); }
    void           Print(Option_t *option = "") const;
+   static Int_t   SaveCompiledCache(const char *filename);
    void           SetName(const char* name);
    void           SetParameter(const char* name, Double_t value);
    void           SetParameter(Int_t param, Double_t value);
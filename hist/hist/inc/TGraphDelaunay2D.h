@@ -50,6 +50,7 @@ public:
    TGraphDelaunay2D(TGraph2D *g = 0);
 
    Double_t  ComputeZ(Double_t x, Double_t y) { return fDelaunay.Interpolate(x,y); }
+   void      ComputeZ(Int_t n, const Double_t *x, const Double_t *y, Double_t *z) { fDelaunay.Interpolate(n,x,y,z); }
    void      FindAllTriangles() { fDelaunay.FindAllTriangles(); }
 
    TGraph2D *GetGraph2D() const {return fGraph2D;}
@@ -52,6 +52,12 @@ class TCollection;
 class TVirtualFFT;
 class TVirtualHistPainter;
 
+namespace ROOT {
+namespace Internal {
+   class TH1ConcurrentFill;
+}
+}
+
 
 class TH1 : public TNamed, public TAttLine, public TAttFill, public TAttMarker {
 
@@ -100,6 +106,7 @@ protected:
     Int_t         fDimension;       ///<!Histogram dimension (1, 2 or 3 dim)
     Double_t     *fIntegral;        ///<!Integral of bins used by GetRandom
     TVirtualHistPainter *fPainter;  ///<!pointer to histogram painter
+    ROOT::Internal::TH1ConcurrentFill *fConcurrentFill; ///<!state of the concurrent fill mode, see SetConcurrentFill()
     EBinErrorOpt  fBinStatErrOpt;   ///< option for bin statistical errors
     static Int_t  fgBufferSize;     ///<!default buffer size for automatic histograms
     static Bool_t fgAddDirectory;   ///<!flag to add histograms to the directory
@@ -134,6 +141,14 @@ protected:
                                Option_t * opt, Bool_t doerr = kFALSE) const;
 
    virtual void     DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride=1);
+   Int_t            DoFillConcurrent(Int_t bin, Bool_t inRange, Double_t w, const Double_t *stats, Int_t nstats);
+   virtual void     AddToStats(const Double_t *stats);
+   void             DoFoldConcurrentStats();
+   void             FoldConcurrentStats() const { if (fConcurrentFill) ((TH1*)this)->DoFoldConcurrentStats(); }
+
+   enum {
+      kFillNBlock  = 256  ///< number of points processed at once by FillN
+   };
 
    static bool CheckAxisLimits(const TAxis* a1, const TAxis* a2);
    static bool CheckBinLimits(const TAxis* a1, const TAxis* a2);
@@ -311,6 +326,7 @@ public:
    virtual Double_t Interpolate(Double_t x, Double_t y, Double_t z);
            Bool_t   IsBinOverflow(Int_t bin, Int_t axis = 0) const;
            Bool_t   IsBinUnderflow(Int_t bin, Int_t axis = 0) const;
+           Bool_t   IsConcurrentFill() const { return fConcurrentFill != 0; }
    virtual Double_t AndersonDarlingTest(const TH1 *h2, Option_t *option="") const;
    virtual Double_t AndersonDarlingTest(const TH1 *h2, Double_t &advalue) const;
    virtual Double_t KolmogorovTest(const TH1 *h2, Option_t *option="") const;
@@ -354,6 +370,7 @@ public:
    virtual void     SetBinErrorOption(EBinErrorOpt type) { fBinStatErrOpt = type; }
    virtual void     SetBuffer(Int_t buffersize, Option_t *option="");
    virtual UInt_t   SetCanExtend(UInt_t extendBitMask);
+           void     SetConcurrentFill(Bool_t on = kTRUE);
    virtual void     SetContent(const Double_t *content);
    virtual void     SetContour(Int_t nlevels, const Double_t *levels=0);
    virtual void     SetContourLevel(Int_t level, Double_t value);
@@ -41,6 +41,7 @@ private:
 protected:
    void AllocCoordBuf() const;
    void InitStorage(Int_t* nbins, Int_t chunkSize);
+   Long64_t FillConcurrent(const Double_t *x, Double_t w);
 
    THn(): fCoordBuf() {}
    THn(const char* name, const char* title, Int_t dim, const Int_t* nbins,
@@ -97,6 +98,8 @@ public:
       FillBinBase(w);
    }
 
+   void SetConcurrentFill(Bool_t on = kTRUE);
+
    void SetBinContent(const Int_t* idx, Double_t v) {
       // Forwards to THnBase::SetBinContent().
       // Non-virtual, CINT-compatible replacement of a using declaration.
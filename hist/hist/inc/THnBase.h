@@ -37,6 +37,7 @@ class THnIter;
 namespace ROOT {
 namespace Internal {
    class THnBaseBinIter;
+   class TConcurrentStats;
 }
 }
 
@@ -56,6 +57,7 @@ protected:
       kValidInt,
       kInvalidInt
    } fIntegralStatus;        //! status of integral
+   ROOT::Internal::TConcurrentStats *fConcurrentStats; //! per-thread statistics in concurrent fill mode
 
 private:
    THnBase(const THnBase&); // Not implemented
@@ -64,7 +66,8 @@ private:
  protected:
    THnBase():
       fNdimensions(0), fEntries(0),
-      fTsumw(0), fTsumw2(-1.), fIntegral(0), fIntegralStatus(kNoInt)
+      fTsumw(0), fTsumw2(-1.), fIntegral(0), fIntegralStatus(kNoInt),
+      fConcurrentStats(0)
    {}
 
    THnBase(const char* name, const char* title, Int_t dim,
@@ -90,6 +93,13 @@ private:
       fIntegralStatus = kInvalidInt;
    }
 
+   virtual Long64_t FillConcurrent(const Double_t *x, Double_t w);
+   void DoFoldConcurrentStats();
+   void FoldConcurrentStats() const {
+      // Add the statistics of the concurrent fills to the sums of weights.
+      if (fConcurrentStats) const_cast<THnBase*>(this)->DoFoldConcurrentStats();
+   }
+
    virtual void InitStorage(Int_t* nbins, Int_t chunkSize) = 0;
    void Init(const char* name, const char* title,
              const TObjArray* axes, Bool_t keepTargetAxis,
@@ -130,8 +140,8 @@ private:
    virtual ROOT::Internal::THnBaseBinIter* CreateIter(Bool_t respectAxisRange) const = 0;
 
    virtual Long64_t GetNbins() const = 0;
-   Double_t GetEntries() const { return fEntries; }
-   Double_t GetWeightSum() const { return fTsumw; }
+   Double_t GetEntries() const { FoldConcurrentStats(); return fEntries; }
+   Double_t GetWeightSum() const { FoldConcurrentStats(); return fTsumw; }
    Int_t    GetNdimensions() const { return fNdimensions; }
    Bool_t   GetCalculateErrors() const { return fTsumw2 >= 0.; }
    void     CalculateErrors(Bool_t calc = kTRUE) {
@@ -141,6 +151,7 @@ private:
    }
 
    Long64_t Fill(const Double_t *x, Double_t w = 1.) {
+      if (fConcurrentStats) return FillConcurrent(x, w);
       UpdateXStat(x, w);
       Long64_t bin = GetBin(x, kTRUE /*alloc*/);
       FillBin(bin, w);
@@ -154,6 +165,9 @@ private:
 
    virtual void FillBin(Long64_t bin, Double_t w) = 0;
 
+   virtual void SetConcurrentFill(Bool_t on = kTRUE);
+   Bool_t IsConcurrentFill() const { return fConcurrentStats != 0; }
+
    void SetBinEdges(Int_t idim, const Double_t* bins);
    Bool_t IsInRange(Int_t *coord) const;
    Double_t GetBinError(const Int_t *idx) const { return GetBinError(GetBin(idx)); }
@@ -180,10 +194,10 @@ private:
    virtual void AddBinError2(Long64_t bin, Double_t e2) = 0;
    virtual void AddBinContent(Long64_t bin, Double_t v = 1.) = 0;
 
-   Double_t GetSumw() const  { return fTsumw; }
-   Double_t GetSumw2() const { return fTsumw2; }
-   Double_t GetSumwx(Int_t dim) const  { return fTsumwx[dim]; }
-   Double_t GetSumwx2(Int_t dim) const { return fTsumwx2[dim]; }
+   Double_t GetSumw() const  { FoldConcurrentStats(); return fTsumw; }
+   Double_t GetSumw2() const { FoldConcurrentStats(); return fTsumw2; }
+   Double_t GetSumwx(Int_t dim) const  { FoldConcurrentStats(); return fTsumwx[dim]; }
+   Double_t GetSumwx2(Int_t dim) const { FoldConcurrentStats(); return fTsumwx2[dim]; }
 
    TH1D*    Projection(Int_t xDim, Option_t* option = "") const {
       // Project all bins into a 1-dimensional histogram,
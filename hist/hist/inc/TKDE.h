@@ -93,6 +93,7 @@ public:
    void SetNBins(UInt_t nbins);
    void SetUseBinsNEvents(UInt_t nEvents);
    void SetTuneFactor(Double_t rho);
+   void SetNGridPoints(UInt_t npoints);
    void SetRange(Double_t xMin, Double_t xMax); // By default computed from the data
 
    virtual void Draw(const Option_t* option = "");
@@ -101,6 +102,7 @@ public:
    Double_t operator()(const Double_t* x, const Double_t* p=0) const;  // Needed for creating TF1
 
    Double_t GetValue(Double_t x) const { return (*this)(x); }
+   void GetValue(UInt_t n, const Double_t* x, Double_t* y) const;
    Double_t GetError(Double_t x) const;
 
    Double_t GetBias(Double_t x) const;
@@ -163,6 +165,7 @@ private:
    UInt_t fNEvents;        // Data's number of events
    Double_t fSumOfCounts; // Data sum of weights
    UInt_t fUseBinsNEvents; // If the algorithm is allowed to use binning this is the minimum number of events to do so
+   UInt_t fNGridPoints;    // Number of points of the grid used to interpolate the estimate (0 if it is computed exactly)
 
    Double_t fMean;  // Data mean
    Double_t fSigma; // Data std deviation
@@ -246,7 +249,7 @@ private:
    TF1* GetPDFUpperConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
    TF1* GetPDFLowerConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
 
-   ClassDef(TKDE, 2) // One dimensional semi-parametric Kernel Density Estimation
+   ClassDef(TKDE, 3) // One dimensional semi-parametric Kernel Density Estimation
 
 };
 
@@ -15,6 +15,8 @@
 #include "TObject.h"
 #include "TError.h"
 
+#include "ROOT/TConcurrentStats.hxx"
+
 //////////////////////////////////////////////////////////////////////////
 //                                                                      //
 // TNDArray                                                             //
@@ -84,6 +86,10 @@ public:
    virtual Double_t AtAsDouble(ULong64_t linidx) const = 0;
    virtual void SetAsDouble(ULong64_t linidx, Double_t value) = 0;
    virtual void AddAt(ULong64_t linidx, Double_t value) = 0;
+   // Thread-safe version of AddAt(); the storage must have been allocated
+   // with Allocate() beforehand.
+   virtual void AddAtAtomic(ULong64_t linidx, Double_t value) = 0;
+   virtual void Allocate() = 0;
 
 private:
    TNDArray(const TNDArray&); // intentionally not implemented
@@ -183,6 +189,13 @@ public:
       if (!fData) fData = new T[fNumData]();
       fData[linidx] += (T) value;
    }
+   void AddAtAtomic(ULong64_t linidx, Double_t value) {
+      ROOT::Internal::AtomicAdd(fData[linidx], (T) value);
+   }
+   void Allocate() {
+      // Allocate the storage now instead of at the first write.
+      if (!fData) fData = new T[fNumData]();
+   }
 
 protected:
    int fNumData; // number of bins, product of fSizes
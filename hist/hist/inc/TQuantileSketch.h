@@ -0,0 +1,66 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TQuantileSketch
+#define ROOT_TQuantileSketch
+
+#include "TNamed.h"
+
+#include <vector>
+
+class TCollection;
+
+class TQuantileSketch : public TNamed {
+
+protected:
+   Double_t fCompression;           ///< Compression parameter: number of centroids is of order fCompression
+   Long64_t fEntries;               ///< Number of entries
+   Double_t fTotalWeight;           ///< Sum of the weights of the centroids and of the buffered points
+   Double_t fXmin;                  ///< Smallest value filled
+   Double_t fXmax;                  ///< Largest value filled
+   std::vector<Double_t> fMeans;    ///< Means of the centroids, in increasing order
+   std::vector<Double_t> fWeights;  ///< Weights of the centroids
+   std::vector<Double_t> fBufferX;  //! Values filled since the last merge into the centroids
+   std::vector<Double_t> fBufferW;  //! Weights of the buffered values
+
+   void Compress(std::vector<Double_t> &means, std::vector<Double_t> &weights);
+
+public:
+   TQuantileSketch();
+   TQuantileSketch(const char *name, const char *title, Double_t compression = 200);
+   TQuantileSketch(const TQuantileSketch &other);
+   TQuantileSketch &operator=(const TQuantileSketch &other);
+   virtual ~TQuantileSketch();
+
+   virtual Bool_t    Add(const TQuantileSketch *other);
+   virtual void      Copy(TObject &obj) const;
+   virtual Int_t     Fill(Double_t x);
+   virtual Int_t     Fill(Double_t x, Double_t w);
+   virtual void      FillN(Int_t n, const Double_t *x, const Double_t *w, Int_t stride = 1);
+   void              Flush();
+   Double_t          GetCDF(Double_t x) const;
+   Double_t          GetCompression() const { return fCompression; }
+   Long64_t          GetEntries() const { return fEntries; }
+   Double_t          GetMean() const;
+   Double_t          GetMedian() const { return GetQuantile(0.5); }
+   Int_t             GetNCentroids() const;
+   Double_t          GetQuantile(Double_t prob) const;
+   virtual Int_t     GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum = 0) const;
+   Double_t          GetSumOfWeights() const { return fTotalWeight; }
+   Double_t          GetXmax() const { return fXmax; }
+   Double_t          GetXmin() const { return fXmin; }
+   virtual Long64_t  Merge(TCollection *list);
+   virtual void      Print(Option_t *option = "") const;
+   virtual void      Reset(Option_t *option = "");
+
+   ClassDef(TQuantileSketch, 1) // Mergeable sketch for approximate quantiles of streams of values
+};
+
+#endif
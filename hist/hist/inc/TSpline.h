@@ -57,6 +57,7 @@ public:
    virtual Double_t GetXmax()  const {return fXmax;}
    virtual void     Paint(Option_t *option="");
    virtual Double_t Eval(Double_t x) const=0;
+   virtual void     Eval(Int_t n, const Double_t *x, Double_t *y) const;
    virtual void     SaveAs(const char * /*filename*/,Option_t * /*option*/) const {;}
    void             SetNpx(Int_t n) {fNpx=n;}
 
@@ -226,6 +227,7 @@ public:
    TSpline3& operator=(const TSpline3&);
    Int_t    FindX(Double_t x) const;
    Double_t Eval(Double_t x) const;
+   void     Eval(Int_t n, const Double_t *x, Double_t *y) const;
    Double_t Derivative(Double_t x) const;
    virtual ~TSpline3() {if (fPoly) delete [] fPoly;}
    void GetCoeff(Int_t i, Double_t &x, Double_t &y, Double_t &b,
@@ -286,6 +288,7 @@ public:
    TSpline5(const TSpline5&);
    TSpline5& operator=(const TSpline5&);
    Int_t    FindX(Double_t x) const;
+   using TSpline::Eval;
    Double_t Eval(Double_t x) const;
    Double_t Derivative(Double_t x) const;
    virtual ~TSpline5() {if (fPoly) delete [] fPoly;}
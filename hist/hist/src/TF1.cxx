@@ -1094,7 +1094,7 @@ void TF1::DrawF1(Double_t xmin, Double_t xmax, Option_t *option)
 
 Double_t TF1::Eval(Double_t x, Double_t y, Double_t z, Double_t t) const
 {
-   if (fType == 0) return fFormula->Eval(x, y, z, t);
+   if (fType == EFType::kFormula) return fFormula->Eval(x, y, z, t);
 
    Double_t xx[4] = {x, y, z, t};
    Double_t *pp = (Double_t *)fParams->GetParameters();
@@ -1125,7 +1125,7 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
 {
    //fgCurrent = this;
 
-   if (fType == 0) {
+   if (fType == EFType::kFormula) {
       assert(fFormula);
 
       if (fNormalized && fNormIntegral != 0)
@@ -1174,6 +1174,34 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the function at n points, storing the values in result.
+///
+/// x[i] points to the n values of the coordinate i of the points, params are
+/// the parameter values (the ones of the function if null). For functions
+/// defined by a formula the points are evaluated at once, by a loop compiled
+/// together with the formula (see TFormula::EvalParBatch()); for the other
+/// types, this is equivalent to calling EvalPar() for each point, with the
+/// same caveat for interpreted functions.
+
+void TF1::EvalParBatch(const Double_t *const *x, Int_t n, Double_t *result, const Double_t *params)
+{
+   if (fType == EFType::kFormula) {
+      assert(fFormula);
+      fFormula->EvalParBatch(x, n, result, params);
+      if (fNormalized && fNormIntegral != 0)
+         for (Int_t i = 0; i < n; ++i)
+            result[i] /= fNormIntegral;
+      return;
+   }
+   std::vector<Double_t> point(TMath::Max(fNdim, 1));
+   for (Int_t i = 0; i < n; ++i) {
+      for (Int_t j = 0; j < fNdim; ++j)
+         point[j] = x[j][i];
+      result[i] = EvalPar(point.data(), params);
+   }
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
@@ -2084,6 +2112,21 @@ TAxis *TF1::GetZaxis() const
 /// If a parameter is fixed, the gradient on this parameter = 0
 
 Double_t TF1::GradientPar(Int_t ipar, const Double_t *x, Double_t eps)
+{
+   if (GetNpar() == 0) return 0;
+   return GradientPar(ipar, x, GetParameters(), eps);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the gradient (derivative) wrt a parameter ipar for the parameter
+/// values params, instead of the parameters of the function.
+///
+/// The function parameters are not modified, so this can be called
+/// concurrently from several threads (e.g. by the multithreaded fit gradient
+/// evaluation), as long as EvalPar(x, params) itself is thread safe.
+/// See GradientPar(Int_t, const Double_t *, Double_t) for the other arguments.
+
+Double_t TF1::GradientPar(Int_t ipar, const Double_t *x, const Double_t *params, Double_t eps) const
 {
    if (GetNpar() == 0) return 0;
 
@@ -2092,39 +2135,36 @@ Double_t TF1::GradientPar(Int_t ipar, const Double_t *x, Double_t eps)
       eps = 0.01;
    }
    Double_t h;
-   Double_t *parameters = GetParameters();
    TF1 *func = (TF1 *)this;
-   //save original parameters
+   // work on a copy of the parameters
+   std::vector<Double_t> parameters(params, params + GetNpar());
    Double_t par0 = parameters[ipar];
 
-
-   func->InitArgs(x, parameters);
+   if (fMethodCall) func->InitArgs(x, parameters.data());
 
    Double_t al, bl;
    Double_t f1, f2, g1, g2, h2, d0, d2;
 
-   ((TF1 *)this)->GetParLimits(ipar, al, bl);
+   GetParLimits(ipar, al, bl);
    if (al * bl != 0 && al >= bl) {
       //this parameter is fixed
       return 0;
    }
 
    // check if error has been computer (is not zero)
-   if (func->GetParError(ipar) != 0)
-      h = eps * func->GetParError(ipar);
+   if (GetParError(ipar) != 0)
+      h = eps * GetParError(ipar);
    else
       h = eps;
 
-
-
    parameters[ipar] = par0 + h;
-   f1 = func->EvalPar(x, parameters);
+   f1 = func->EvalPar(x, parameters.data());
    parameters[ipar] = par0 - h;
-   f2 = func->EvalPar(x, parameters);
+   f2 = func->EvalPar(x, parameters.data());
    parameters[ipar] = par0 + h / 2;
-   g1 = func->EvalPar(x, parameters);
+   g1 = func->EvalPar(x, parameters.data());
    parameters[ipar] = par0 - h / 2;
-   g2 = func->EvalPar(x, parameters);
+   g2 = func->EvalPar(x, parameters.data());
 
    //compute the central differences
    h2    = 1 / (2.*h);
@@ -2133,9 +2173,6 @@ Double_t TF1::GradientPar(Int_t ipar, const Double_t *x, Double_t eps)
 
    Double_t  grad = h2 * (4 * d2 - d0) / 3.;
 
-   // restore original value
-   parameters[ipar] = par0;
-
    return grad;
 }
 
@@ -2154,6 +2191,16 @@ Double_t TF1::GradientPar(Int_t ipar, const Double_t *x, Double_t eps)
 /// If a parameter is fixed, the gradient on this parameter = 0
 
 void TF1::GradientPar(const Double_t *x, Double_t *grad, Double_t eps)
+{
+   GradientPar(x, GetParameters(), grad, eps);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the gradient wrt parameters for the parameter values params,
+/// without modifying the function parameters (see GradientPar(Int_t, const
+/// Double_t *, const Double_t *, Double_t)).
+
+void TF1::GradientPar(const Double_t *x, const Double_t *params, Double_t *grad, Double_t eps) const
 {
    if (eps < 1e-10 || eps > 1) {
       Warning("Derivative", "parameter esp=%g out of allowed range[1e-10,1], reset to 0.01", eps);
@@ -2161,7 +2208,7 @@ void TF1::GradientPar(const Double_t *x, Double_t *grad, Double_t eps)
    }
 
    for (Int_t ipar = 0; ipar < GetNpar(); ipar++) {
-      grad[ipar] = GradientPar(ipar, x, eps);
+      grad[ipar] = GradientPar(ipar, x, params, eps);
    }
 }
 
@@ -21,12 +21,15 @@
 #include "TMethodCall.h"
 #include <TBenchmark.h>
 #include "TError.h"
+#include "TSystem.h"
 #include "TInterpreter.h"
 #include "TFormula.h"
 #include <cassert>
 #include <iostream>
 #include <unordered_map>
 #include <functional>
+#include <fstream>
+#include <set>
 
 using namespace std;
 
@@ -120,6 +123,12 @@ The class supports unlimited numer of variables and parameters.
 This class is not anymore the base class for the function classes `TF1`, but it has now
 adata member of TF1 which can be access via `TF1::GetFormula`.
 
+The formula expression is compiled by Cling into a function, which is shared by all
+the formulas with the same expression in the process. The functions compiled in a job
+can be saved in a library with `TFormula::SaveCompiledCache("formulas.C")`, and loaded
+by other jobs with `TFormula::LoadCompiledCache("formulas.C")`, before creating or
+reading the formulas, which then do not need to be compiled again.
+
 \class TFormulaFunction
  Helper class for TFormula
 
@@ -136,6 +145,10 @@ static const TString gNamePrefix = "TFormula__";
 // static map of function pointers and expressions
 //static std::unordered_map<std::string,  TInterpreter::CallFuncIFacePtr_t::Generic_t> gClingFunctions = std::unordered_map<TString,  TInterpreter::CallFuncIFacePtr_t::Generic_t>();
 static std::unordered_map<std::string,  void *> gClingFunctions = std::unordered_map<std::string,  void * >();
+// static map of the batch kernels, by their code passed to Cling
+static std::unordered_map<std::string,  void *> gClingBatchFunctions;
+// code of the functions known to Cling (declared or loaded from a compiled cache), by function name
+static std::map<std::string, std::string> gClingFunctionCode;
 
 ////////////////////////////////////////////////////////////////////////////////
 Bool_t TFormula::IsOperator(const char c)
@@ -611,6 +624,8 @@ void TFormula::Copy(TObject &obj) const
    }
 
    fnew.fFuncPtr = fFuncPtr;
+   fnew.fBatchFuncPtr.store(fBatchFuncPtr.load(std::memory_order_acquire), std::memory_order_release);
+   fnew.fBatchFailed = fBatchFailed.load();
 
 }
 
@@ -629,6 +644,8 @@ void TFormula::Clear(Option_t * )
 
    if(fMethod) fMethod->Delete();
    fMethod = nullptr;
+   fBatchFuncPtr = nullptr;
+   fBatchFailed = false;
 
    fClingVariables.clear();
    fClingParameters.clear();
@@ -707,6 +724,63 @@ bool TFormula::PrepareEvalMethod()
    return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Compile the batch kernel of the formula, which evaluates it at n points:
+///
+///     void clingName__batchN(const Double_t *const *xv, Int_t n, Double_t *p, Double_t *out)
+///
+/// where xv[i] points to the n values of the variable i. The kernel is the
+/// loop over the points around the formula expression, which Cling compiles
+/// with loop vectorization enabled. It is only compiled at the first call to
+/// EvalParBatch(), and shared between the formulas with the same expression.
+
+Bool_t TFormula::PrepareBatchEvalMethod() const
+{
+   R__LOCKGUARD(gROOTMutex);
+   if (fBatchFuncPtr.load(std::memory_order_acquire)) return true;
+   if (fBatchFailed || !fClingInitialized || TestBit(TFormula::kLambda)) return false;
+
+   const TString expression = GetExpFormula("CLING");
+   const Int_t ndim = TMath::Max(fNdim, 1);
+   TString point;
+   for (Int_t i = 0; i < fNdim; ++i)
+      point += TString::Format("%sxv[%d][i]", (i ? ", " : ""), i);
+   const TString batchName = TString::Format("%s__batch%d", fClingName.Data(), fNdim);
+   // the code is kept on a single line, see SaveCompiledCache()
+   const std::string batchInput = TString::Format("void %s(const Double_t *const *xv, Int_t n, Double_t *p, Double_t *out) "
+                                                  "{ for (Int_t i = 0; i < n; ++i) { Double_t x[%d] = {%s}; out[i] = %s; } }",
+                                                  batchName.Data(), ndim, point.Data(), expression.Data()).Data();
+
+   auto funcit = gClingBatchFunctions.find(batchInput);
+   if (funcit != gClingBatchFunctions.end()) {
+      fBatchFuncPtr.store((TInterpreter::CallFuncIFacePtr_t::Generic_t) funcit->second, std::memory_order_release);
+      return true;
+   }
+
+   fBatchFailed = true;
+   // the kernel may have been loaded already with LoadCompiledCache()
+   auto codeit = gClingFunctionCode.find(batchName.Data());
+   if (codeit == gClingFunctionCode.end() || codeit->second != batchInput) {
+      if (!gCling->Declare(("#pragma cling optimize(2)\n" + batchInput).c_str())) {
+         Warning("EvalParBatch", "Cannot compile the batch kernel of %s - evaluating point by point", fFormula.Data());
+         return false;
+      }
+   }
+   TMethodCall method;
+   method.InitWithPrototype(batchName, "const Double_t*const*,Int_t,Double_t*,Double_t*");
+   if (!method.IsValid()) {
+      Warning("EvalParBatch", "Cannot find the batch kernel of %s - evaluating point by point", fFormula.Data());
+      return false;
+   }
+   auto batchFuncPtr = gCling->CallFunc_IFacePtr(method.GetCallFunc()).fGeneric;
+   fBatchFailed = false;
+   gClingBatchFunctions.insert(std::make_pair(batchInput, (void *) batchFuncPtr));
+   gClingFunctionCode.insert(std::make_pair(std::string(batchName.Data()), batchInput));
+   // publish the kernel last, EvalParBatch() reads it without the lock
+   fBatchFuncPtr.store(batchFuncPtr, std::memory_order_release);
+   return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///    Inputs formula, transfered to C++ code into Cling
 
@@ -715,9 +789,141 @@ void TFormula::InputFormulaIntoCling()
 
    if(!fClingInitialized && fReadyToExecute && fClingInput.Length() > 0)
    {
-      gCling->Declare(fClingInput);
+      R__LOCKGUARD(gROOTMutex);
+      // the function may have been loaded already with LoadCompiledCache()
+      auto codeit = gClingFunctionCode.find(fClingName.Data());
+      if (codeit == gClingFunctionCode.end() || codeit->second != fClingInput.Data())
+         gCling->Declare(fClingInput);
       fClingInitialized = PrepareEvalMethod();
+      if (fClingInitialized)
+         gClingFunctionCode.insert(std::make_pair(std::string(fClingName.Data()), std::string(fClingInput.Data())));
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the first function called in code that is not declared
+/// by the headers of the macros written by SaveCompiledCache(), or an empty
+/// string if there is none, e.g. a function defined by the user in Cling.
+
+static std::string FindUnknownFunction(const std::string &code)
+{
+   // functions of <cmath>, besides those of TMath and ROOT::Math, keywords and casts
+   static const std::set<std::string> known = {
+      "abs", "fabs", "sqrt", "cbrt", "exp", "exp2", "expm1", "log", "log2", "log10", "log1p", "pow", "sin", "cos",
+      "tan", "asin", "acos", "atan", "atan2", "sinh", "cosh", "tanh", "asinh", "acosh", "atanh", "erf", "erfc",
+      "tgamma", "lgamma", "ceil", "floor", "trunc", "round", "fmod", "fmin", "fmax", "hypot", "copysign", "isnan",
+      "isinf", "for", "if", "while", "return", "sizeof", "double", "float", "int", "bool"};
+   auto isNameChar = [](char c) { return isalnum(c) || c == '_' || c == ':'; };
+   std::size_t i = 0;
+   while (i < code.size()) {
+      const bool nameStart = isalpha(code[i]) || code[i] == '_' || code.compare(i, 2, "::") == 0;
+      if (!nameStart || (i > 0 && (isNameChar(code[i - 1]) || code[i - 1] == '.'))) {
+         ++i;
+         continue;
+      }
+      std::size_t end = i;
+      while (end < code.size() && isNameChar(code[end]))
+         ++end;
+      std::string name = code.substr(i, end - i);
+      i = end;
+      while (end < code.size() && code[end] == ' ')
+         ++end;
+      if (end == code.size() || code[end] != '(')
+         continue;
+      if (name.compare(0, 2, "::") == 0)
+         name.erase(0, 2);
+      if (name.compare(0, 7, "TMath::") == 0 || name.compare(0, 12, "ROOT::Math::") == 0 ||
+          name.compare(0, 5, "std::") == 0 || name.compare(0, gNamePrefix.Length(), gNamePrefix.Data()) == 0 ||
+          (name.size() > 2 && name.compare(name.size() - 2, 2, "_t") == 0) || known.count(name))
+         continue;
+      return name;
+   }
+   return std::string();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Save the code of the functions compiled so far for all the formulas in
+/// the macro filename, and compile it with ACLiC into a shared library.
+/// Another job can then call LoadCompiledCache() with the same file name, to
+/// use the compiled functions instead of compiling them again with Cling,
+/// for instance before reading many TF1 objects from a file.
+///
+/// The library is built optimised but not loaded, the functions being known
+/// to this process already. The file name should not be the one of a cache
+/// loaded in the same process. The functions of formulas calling functions
+/// other than those of TMath, ROOT::Math and <cmath>, e.g. defined by the
+/// user in Cling, are not saved, since the macro would not compile. Return
+/// the number of functions saved, or -1 in case of error.
+
+Int_t TFormula::SaveCompiledCache(const char *filename)
+{
+   R__LOCKGUARD(gROOTMutex);
+   std::ofstream out(filename);
+   if (!out) {
+      ::Error("TFormula::SaveCompiledCache", "Cannot open %s", filename);
+      return -1;
+   }
+   out << "// Functions of the TFormula objects, generated by TFormula::SaveCompiledCache()\n"
+       << "#include \"TMath.h\"\n"
+       << "#include \"Math/PdfFuncMathCore.h\"\n"
+       << "#include \"Math/ChebyshevPol.h\"\n"
+       << "#include <cmath>\n"
+       << "using namespace std;\n";
+   Int_t nsaved = 0;
+   for (auto &func : gClingFunctionCode) {
+      const std::string unknown = FindUnknownFunction(func.second);
+      if (!unknown.empty()) {
+         ::Warning("TFormula::SaveCompiledCache", "Not saving %s, which calls %s: %s", func.first.c_str(),
+                   unknown.c_str(), func.second.c_str());
+         continue;
+      }
+      out << func.second << "\n";
+      ++nsaved;
    }
+   out.close();
+
+   if (!gSystem->CompileMacro(filename, "kOc")) {
+      ::Error("TFormula::SaveCompiledCache", "Cannot compile %s", filename);
+      return -1;
+   }
+   return nsaved;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Load the functions of the formulas saved with SaveCompiledCache() in
+/// filename, building the library (optimised, as SaveCompiledCache() does)
+/// if it is missing or out of date. The formulas created afterwards whose
+/// function is in the cache do not need to be compiled by Cling. Return
+/// kFALSE in case of error.
+
+Bool_t TFormula::LoadCompiledCache(const char *filename)
+{
+   R__LOCKGUARD(gROOTMutex);
+   std::ifstream in(filename);
+   if (!in) {
+      ::Error("TFormula::LoadCompiledCache", "Cannot open %s", filename);
+      return kFALSE;
+   }
+   std::map<std::string, std::string> code;
+   std::string line;
+   while (std::getline(in, line)) {
+      // a function per line: "<type> <name>(<arguments>) { ... }"
+      std::size_t first = line.find(' ');
+      std::size_t last = line.find('(');
+      if (line.compare(0, 2, "//") == 0 || line[0] == '#' || first == std::string::npos || last == std::string::npos ||
+          last < first)
+         continue;
+      const std::string name = line.substr(first + 1, last - first - 1);
+      if (name.compare(0, gNamePrefix.Length(), gNamePrefix.Data()) == 0)
+         code[name] = line;
+   }
+
+   if (!gSystem->CompileMacro(filename, "kO")) {
+      ::Error("TFormula::LoadCompiledCache", "Cannot load the library of %s", filename);
+      return kFALSE;
+   }
+   gClingFunctionCode.insert(code.begin(), code.end());
+   return kTRUE;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1898,6 +2104,8 @@ void TFormula::ProcessFormula(TString &formula)
          fClingName = TString::Format("%s__id%zu",gNamePrefix.Data(), hasher(inputFormula) );
 
          fClingInput = TString::Format("Double_t %s(%s){ return %s ; }", fClingName.Data(),argumentsPrototype.Data(),inputFormula.c_str());
+         fBatchFuncPtr = nullptr;
+         fBatchFailed = false;
 
          // this is not needed (maybe can be re-added in case of recompilation of identical expressions
          // // check in case of a change if need to re-initialize
@@ -2609,6 +2817,35 @@ Double_t TFormula::EvalPar(const Double_t *x,const Double_t *params) const
    return DoEval(x, params);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula at n points, storing the values in result.
+/// x[i] points to the n values of the variable i, params are the parameter
+/// values (the ones of the formula if null).
+///
+/// The points are evaluated in a single call to a loop compiled by Cling,
+/// which the compiler can vectorise; it is compiled at the first call. For
+/// formulas built from a lambda expression, the points are evaluated one by
+/// one.
+
+void TFormula::EvalParBatch(const Double_t *const *x, Int_t n, Double_t *result, const Double_t *params) const
+{
+   if (n <= 0) return;
+   auto batchFuncPtr = fBatchFuncPtr.load(std::memory_order_acquire);
+   if (fReadyToExecute && (batchFuncPtr || PrepareBatchEvalMethod())) {
+      if (!batchFuncPtr) batchFuncPtr = fBatchFuncPtr.load(std::memory_order_acquire);
+      Double_t *pars = (params) ? const_cast<Double_t *>(params) : const_cast<Double_t *>(fClingParameters.data());
+      void *args[4] = {&x, &n, &pars, &result};
+      (*batchFuncPtr)(0, 4, args, nullptr);
+      return;
+   }
+   std::vector<Double_t> point(TMath::Max(fNdim, 1));
+   for (Int_t i = 0; i < n; ++i) {
+      for (Int_t j = 0; j < fNdim; ++j)
+         point[j] = x[j][i];
+      result[i] = DoEval(point.data(), params);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Sets first 4  variables (e.g. x, y, z, t) and evaluate formula.
 
@@ -35,6 +35,8 @@
 #include <stdlib.h>
 #include <string>
 #include <cassert>
+#include <algorithm>
+#include <vector>
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -952,6 +954,99 @@ Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
    return yn;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Interpolate the graph at the n points x, and store the values in y.
+///
+/// The result is the same as calling Eval(x[i], spline, option) for each
+/// point (see above for the meaning of spline and option), but:
+///  - with option "S" and no spline, the TSpline3 is built only once for
+///    all the points;
+///  - the spline is evaluated with TSpline::Eval(n, x, y);
+///  - for the linear interpolation of a graph sorted in X (see
+///    TGraph::Sort), the neighbours of x[i] are searched from those of
+///    x[i-1], so that increasing x are interpolated with a single walk
+///    over the graph points. The points are processed by blocks, first
+///    locating the neighbours and then interpolating in a separate loop.
+///    Unsorted graphs are interpolated point by point.
+///
+/// When many batches are interpolated with a spline, build the spline once
+/// (e.g. TSpline3 s("s", graph)) and pass it in, rather than using option "S".
+
+void TGraph::Eval(Int_t n, const Double_t *x, Double_t *y, TSpline *spline, Option_t *option) const
+{
+   if (!spline && fNpoints > 1 && option && *option) {
+      TString opt = option;
+      opt.ToLower();
+      if (opt.Contains("s")) {
+         // points must be sorted before using a TSpline
+         std::vector<Double_t> xsort(fNpoints);
+         std::vector<Double_t> ysort(fNpoints);
+         std::vector<Int_t> indxsort(fNpoints);
+         TMath::Sort(fNpoints, fX, &indxsort[0], false);
+         for (Int_t i = 0; i < fNpoints; ++i) {
+            xsort[i] = fX[ indxsort[i] ];
+            ysort[i] = fY[ indxsort[i] ];
+         }
+         TSpline3 s("", &xsort[0], &ysort[0], fNpoints);
+         s.Eval(n, x, y);
+         return;
+      }
+   }
+   if (spline) {
+      spline->Eval(n, x, y);
+      return;
+   }
+   if (fNpoints < 2 || !TestBit(TGraph::kIsSortedX)) {
+      for (Int_t i = 0; i < n; ++i)
+         y[i] = Eval(x[i]);
+      return;
+   }
+
+   const Int_t kBlockSize = 256;
+   // maximum number of points to walk over before using a binary search
+   const Int_t kMaxWalk = 8;
+   Int_t low[kBlockSize];
+   // index of the last point smaller than the previous x (-1 if none),
+   // as for std::lower_bound(fX, fX + fNpoints, x) - fX - 1
+   Int_t last = -1;
+   Double_t xprev = 0;
+   for (Int_t begin = 0; begin < n; begin += kBlockSize) {
+      const Int_t nb = TMath::Min(kBlockSize, n - begin);
+      const Double_t *xb = x + begin;
+      for (Int_t i = 0; i < nb; ++i) {
+         const Double_t xi = xb[i];
+         if (begin + i > 0 && xi >= xprev) {
+            Int_t nwalk = 0;
+            while (last + 1 < fNpoints && fX[last + 1] < xi && nwalk < kMaxWalk) {
+               ++last;
+               ++nwalk;
+            }
+            if (last + 1 < fNpoints && fX[last + 1] < xi)
+               last = std::lower_bound(fX + last + 1, fX + fNpoints, xi) - fX - 1;
+         } else {
+            last = std::lower_bound(fX, fX + fNpoints, xi) - fX - 1;
+         }
+         xprev = xi;
+         // same as TMath::BinarySearch(fNpoints, fX, xi) in Eval(Double_t)
+         Int_t k = (last + 1 < fNpoints && fX[last + 1] == xi) ? last + 1 : last;
+         if (k == -1) k = 0;
+         low[i] = k;
+      }
+      for (Int_t i = 0; i < nb; ++i) {
+         const Double_t xi = xb[i];
+         Int_t k = low[i];
+         if (fX[k] == xi) {
+            y[begin + i] = fY[k];
+            continue;
+         }
+         if (k == fNpoints - 1) k--; // for extrapolating
+         const Double_t xlow = fX[k];
+         const Double_t xup = fX[k + 1];
+         y[begin + i] = (xlow == xup) ? fY[k] : fY[k + 1] + (xi - xup) * (fY[k] - fY[k + 1]) / (xlow - xup);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
 ///
@@ -25,6 +25,7 @@
 #include "TSystem.h"
 #include <stdlib.h>
 #include <cassert>
+#include <vector>
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -1168,18 +1169,31 @@ TH2D *TGraph2D::GetHistogram(Option_t *option)
 
    Double_t x, y, z;
 
-   for (Int_t ix = 1; ix <= fNpx; ix++) {
-      x  = hxmin + (ix - 0.5) * dx;
-      for (Int_t iy = 1; iy <= fNpy; iy++) {
-         y  = hymin + (iy - 0.5) * dy;
-         // do interpolation
-         if (oldInterp)
+   if (oldInterp) {
+      for (Int_t ix = 1; ix <= fNpx; ix++) {
+         x  = hxmin + (ix - 0.5) * dx;
+         for (Int_t iy = 1; iy <= fNpy; iy++) {
+            y  = hymin + (iy - 0.5) * dy;
+            // do interpolation
             z  = ((TGraphDelaunay*)fDelaunay)->ComputeZ(x, y);
-         else
-            z  = ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(x, y);
 
-         fHistogram->Fill(x, y, z);
+            fHistogram->Fill(x, y, z);
+         }
+      }
+   } else {
+      // interpolate all the bin centres at once, which can be done in parallel
+      const Int_t nbins = fNpx * fNpy;
+      std::vector<Double_t> xc(nbins), yc(nbins), zc(nbins);
+      for (Int_t ix = 1; ix <= fNpx; ix++) {
+         x  = hxmin + (ix - 0.5) * dx;
+         for (Int_t iy = 1; iy <= fNpy; iy++) {
+            const Int_t i = (ix - 1) * fNpy + iy - 1;
+            xc[i] = x;
+            yc[i] = hymin + (iy - 0.5) * dy;
+         }
       }
+      ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(nbins, xc.data(), yc.data(), zc.data());
+      for (Int_t i = 0; i < nbins; i++) fHistogram->Fill(xc[i], yc[i], zc[i]);
    }
 
 
@@ -1267,6 +1281,56 @@ Double_t TGraph2D::Interpolate(Double_t x, Double_t y)
       return 0;
    }
 
+   if (!FindDelaunay()) return TMath::QuietNaN();
+
+   if (fDelaunay->IsA() == TGraphDelaunay2D::Class() )
+      return ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(x, y);
+   else if (fDelaunay->IsA() == TGraphDelaunay::Class() )
+      return ((TGraphDelaunay*)fDelaunay)->ComputeZ(x, y);
+
+   // cannot be here
+   assert(false);
+   return TMath::QuietNaN();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Finds the z values at the n positions (x[i],y[i]) thanks to
+/// the Delaunay interpolation.
+/// With the default interpolation (TGraphDelaunay2D) the triangles are found
+/// only once and the points are interpolated in parallel when the implicit
+/// multi-threading is enabled (see ROOT::EnableImplicitMT).
+
+void TGraph2D::Interpolate(Int_t n, const Double_t *x, const Double_t *y, Double_t *z)
+{
+   if (fNpoints <= 0) {
+      Error("Interpolate", "Empty TGraph2D");
+      for (Int_t i = 0; i < n; i++) z[i] = 0;
+      return;
+   }
+
+   if (!FindDelaunay()) {
+      for (Int_t i = 0; i < n; i++) z[i] = TMath::QuietNaN();
+      return;
+   }
+
+   if (fDelaunay->IsA() == TGraphDelaunay2D::Class() ) {
+      ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(n, x, y, z);
+   } else if (fDelaunay->IsA() == TGraphDelaunay::Class() ) {
+      for (Int_t i = 0; i < n; i++) z[i] = ((TGraphDelaunay*)fDelaunay)->ComputeZ(x[i], y[i]);
+   } else {
+      // cannot be here
+      assert(false);
+   }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Sets fDelaunay to the Delaunay interpolator of fHistogram, booking the
+/// histogram if needed. Returns kFALSE if no interpolator is found.
+
+Bool_t TGraph2D::FindDelaunay()
+{
    if (!fHistogram) GetHistogram("empty");
    if (!fDelaunay) {
       TList *hl = fHistogram->GetListOfFunctions();
@@ -1280,17 +1344,7 @@ Double_t TGraph2D::Interpolate(Double_t x, Double_t y)
          if (!fDelaunay) fDelaunay =  hl->FindObject("TGraphDelaunay2D");
       }
    }
-
-   if (!fDelaunay) return TMath::QuietNaN();
-
-   if (fDelaunay->IsA() == TGraphDelaunay2D::Class() )
-      return ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(x, y);
-   else if (fDelaunay->IsA() == TGraphDelaunay::Class() )
-      return ((TGraphDelaunay*)fDelaunay)->ComputeZ(x, y);
-
-   // cannot be here
-   assert(false);
-   return TMath::QuietNaN();
+   return fDelaunay != 0;
 }
 
 
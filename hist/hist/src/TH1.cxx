@@ -40,6 +40,7 @@
 #include "TVirtualHistPainter.h"
 #include "TVirtualFFT.h"
 #include "TSystem.h"
+#include "TDataType.h"
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -49,6 +50,7 @@
 #include "Math/QuantFuncMathCore.h"
 
 #include "TH1Merger.h"
+#include "ROOT/TConcurrentStats.hxx"
 
 /** \addtogroup Hist
 @{
@@ -542,6 +544,50 @@ class DifferentLabels: public std::exception {};
 
 ClassImp(TH1);
 
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// State of the concurrent fill mode of a histogram, see TH1::SetConcurrentFill().
+
+class TH1ConcurrentFill {
+private:
+   TArray   *fArray; // bin contents of the histogram
+   EDataType fType;  // type of the bin contents
+
+   template <typename T>
+   static void AddSaturated(T &target, Double_t w)
+   {
+      // Same saturation as TH1C/S/I::AddBinContent().
+      const Long64_t inc = Int_t(w);
+      AtomicUpdate(target, [inc](T old) {
+         const Long64_t max = std::numeric_limits<T>::max();
+         const Long64_t newval = old + inc;
+         return T(newval > max ? max : (newval < -max ? -max : newval));
+      });
+   }
+
+public:
+   TConcurrentStats fStats; // number of entries followed by the sums of GetStats()
+
+   TH1ConcurrentFill(TArray *array, EDataType type) : fArray(array), fType(type), fStats(1 + TH1::kNstat) {}
+
+   /// Thread-safe equivalent of TH1::AddBinContent(bin, w).
+   void AddBinContent(Int_t bin, Double_t w)
+   {
+      switch (fType) {
+      case kChar_t: AddSaturated(static_cast<TArrayC *>(fArray)->fArray[bin], w); break;
+      case kShort_t: AddSaturated(static_cast<TArrayS *>(fArray)->fArray[bin], w); break;
+      case kInt_t: AddSaturated(static_cast<TArrayI *>(fArray)->fArray[bin], w); break;
+      case kFloat_t: AtomicAdd(static_cast<TArrayF *>(fArray)->fArray[bin], Float_t(w)); break;
+      default: AtomicAdd(static_cast<TArrayD *>(fArray)->fArray[bin], w); break;
+      }
+   }
+};
+
+} // namespace Internal
+} // namespace ROOT
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Histogram default constructor.
 
@@ -552,6 +598,7 @@ TH1::TH1(): TNamed(), TAttLine(), TAttFill(), TAttMarker()
    fNcells        = 0;
    fIntegral      = 0;
    fPainter       = 0;
+   fConcurrentFill = 0;
    fEntries       = 0;
    fNormFactor    = 0;
    fTsumw         = fTsumw2=fTsumwx=fTsumwx2=0;
@@ -581,6 +628,8 @@ TH1::~TH1()
    fIntegral = 0;
    delete[] fBuffer;
    fBuffer = 0;
+   delete fConcurrentFill;
+   fConcurrentFill = 0;
    if (fFunctions) {
       fFunctions->SetBit(kInvalidObject);
       TObject* obj = 0;
@@ -691,6 +740,7 @@ TH1::TH1(const char *name,const char *title,Int_t nbins,const Double_t *xbins)
 
 TH1::TH1(const TH1 &h) : TNamed(), TAttLine(), TAttFill(), TAttMarker()
 {
+   fConcurrentFill = 0;
    ((TH1&)h).Copy(*this);
 }
 
@@ -718,6 +768,7 @@ void TH1::Build()
 {
    fDirectory     = 0;
    fPainter       = 0;
+   fConcurrentFill = 0;
    fIntegral      = 0;
    fEntries       = 0;
    fNormFactor    = 0;
@@ -2472,6 +2523,7 @@ void TH1::Copy(TObject &obj) const
       ((TH1&)obj).fDirectory->Remove(&obj);
       ((TH1&)obj).fDirectory = 0;
    }
+   FoldConcurrentStats();
    TNamed::Copy(obj);
    ((TH1&)obj).fDimension = fDimension;
    ((TH1&)obj).fNormFactor= fNormFactor;
@@ -3124,6 +3176,7 @@ TH1* TH1::FFT(TH1* h_output, Option_t *option)
 Int_t TH1::Fill(Double_t x)
 {
    if (fBuffer)  return BufferFill(x,1);
+   if (fConcurrentFill) return Fill(x, 1.);
 
    Int_t bin;
    fEntries++;
@@ -3157,6 +3210,11 @@ Int_t TH1::Fill(Double_t x, Double_t w)
 {
 
    if (fBuffer) return BufferFill(x,w);
+   if (fConcurrentFill) {
+      Int_t bin = fXaxis.FindFixBin(x);
+      const Double_t stats[4] = {w, w*w, w*x, w*x*x};
+      return DoFillConcurrent(bin, bin > 0 && bin <= fXaxis.GetNbins(), w, stats, 4);
+   }
 
    Int_t bin;
    fEntries++;
@@ -3249,31 +3307,84 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
 ////////////////////////////////////////////////////////////////////////////////
 /// Internal method to fill histogram content from a vector
 /// called directly by TH1::BufferEmpty
+///
+/// Unless the axis can be extended, the points are processed by blocks of
+/// kFillNBlock: the bins of all the points of a block are found at once
+/// with TAxis::FindFixBins(), then the bin contents and the statistics are
+/// accumulated in separate passes.
 
 void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
    Int_t bin,i;
 
+   if (fConcurrentFill) {
+      // keep the thread-safe, point by point filling
+      ntimes *= stride;
+      for (i=0;i<ntimes;i+=stride) Fill(x[i], w ? w[i] : 1.);
+      return;
+   }
+
    fEntries += ntimes;
    Double_t ww = 1;
    Int_t nbins   = fXaxis.GetNbins();
-   ntimes *= stride;
-   for (i=0;i<ntimes;i+=stride) {
-      bin =fXaxis.FindBin(x[i]);
-      if (bin <0) continue;
-      if (w) ww = w[i];
-      if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
-      if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
-      AddBinContent(bin, ww);
-      if (bin == 0 || bin > nbins) {
-         if (!fgStatOverflows) continue;
+   if (fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) {
+      // the axis might be extended by any point, fill them one by one
+      ntimes *= stride;
+      for (i=0;i<ntimes;i+=stride) {
+         bin =fXaxis.FindBin(x[i]);
+         if (bin <0) continue;
+         if (w) ww = w[i];
+         if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin, ww);
+         if (bin == 0 || bin > nbins) {
+            if (!fgStatOverflows) continue;
+         }
+         Double_t z= ww;
+         fTsumw   += z;
+         fTsumw2  += z*z;
+         fTsumwx  += z*x[i];
+         fTsumwx2 += z*x[i]*x[i];
       }
-      Double_t z= ww;
-      fTsumw   += z;
-      fTsumw2  += z*z;
-      fTsumwx  += z*x[i];
-      fTsumwx2 += z*x[i]*x[i];
+      return;
    }
+
+   Int_t bins[kFillNBlock];
+   Double_t tsumw = fTsumw, tsumw2 = fTsumw2, tsumwx = fTsumwx, tsumwx2 = fTsumwx2;
+   for (Int_t first = 0; first < ntimes; first += kFillNBlock) {
+      const Int_t n = TMath::Min((Int_t)kFillNBlock, ntimes - first);
+      const Double_t *xb = x + first*stride;
+      const Double_t *wb = w ? w + first*stride : 0;
+      fXaxis.FindFixBins(n, xb, bins, stride);
+      // must be called before AddBinContent
+      if (wb && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+         for (i=0;i<n;i++) {
+            if (wb[i*stride] != 1.0) { Sumw2(); break; }
+         }
+      }
+      if (fSumw2.fN) {
+         for (i=0;i<n;i++) {
+            if (wb) ww = wb[i*stride];
+            fSumw2.fArray[bins[i]] += ww*ww;
+         }
+      }
+      for (i=0;i<n;i++) {
+         if (wb) ww = wb[i*stride];
+         AddBinContent(bins[i], ww);
+      }
+      for (i=0;i<n;i++) {
+         if (bins[i] == 0 || bins[i] > nbins) {
+            if (!fgStatOverflows) continue;
+         }
+         Double_t z = wb ? wb[i*stride] : 1;
+         Double_t xi = xb[i*stride];
+         tsumw   += z;
+         tsumw2  += z*z;
+         tsumwx  += z*xi;
+         tsumwx2 += z*xi*xi;
+      }
+   }
+   fTsumw = tsumw; fTsumw2 = tsumw2; fTsumwx = tsumwx; fTsumwx2 = tsumwx2;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4053,6 +4164,7 @@ Bool_t TH1::GetDefaultSumw2()
 
 Double_t TH1::GetEntries() const
 {
+   FoldConcurrentStats();
    if (fBuffer) {
       Int_t nentries = (Int_t) fBuffer[0];
       if (nentries > 0) return nentries;
@@ -5616,6 +5728,10 @@ TH1 *TH1::Rebin(Int_t ngroup, const char*newname, const Double_t *xbins)
       Error("Rebin", "Operation valid on 1-D histograms only");
       return 0;
    }
+   if (fConcurrentFill) {
+      Error("Rebin", "Cannot rebin %s in concurrent fill mode", GetName());
+      return 0;
+   }
    if (!newname && xbins) {
       Error("Rebin","if xbins is specified, newname must be given");
       return 0;
@@ -5975,6 +6091,14 @@ UInt_t TH1::SetCanExtend(UInt_t extendBitMask)
 {
    UInt_t oldExtendBitMask = kNoAxis;
 
+   if (fConcurrentFill && extendBitMask != kNoAxis) {
+      Error("SetCanExtend", "the axes of %s cannot be extended in concurrent fill mode", GetName());
+      if (fXaxis.CanExtend()) oldExtendBitMask |= kXaxis;
+      if (GetDimension() > 1 && fYaxis.CanExtend()) oldExtendBitMask |= kYaxis;
+      if (GetDimension() > 2 && fZaxis.CanExtend()) oldExtendBitMask |= kZaxis;
+      return oldExtendBitMask;
+   }
+
    if (fXaxis.CanExtend()) oldExtendBitMask |= kXaxis;
    if (extendBitMask & kXaxis) fXaxis.SetCanExtend(kTRUE);
    else fXaxis.SetCanExtend(kFALSE);
@@ -5994,6 +6118,94 @@ UInt_t TH1::SetCanExtend(UInt_t extendBitMask)
    return oldExtendBitMask;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable (or disable if `on` is false) the concurrent fill mode.
+///
+/// In this mode Fill(x), Fill(x,w), Fill(x,y,w), Fill(x,y,z,w) and FillN()
+/// can be called from several threads at the same time on the same histogram,
+/// without the need for one histogram per thread and a final merge.
+/// The bin contents and the sums of squares of weights are incremented with
+/// atomic operations, while the number of entries and the sums of weights
+/// used by the statistics are accumulated per thread and only added to the
+/// histogram when they are read (GetEntries(), GetStats(), GetMean(), ...)
+/// or when the concurrent mode is disabled.
+///
+/// All other operations are not thread-safe: in particular the histogram must
+/// not be read or filled by label while the filling threads run. Rebin(),
+/// SetBins() and SetCanExtend() are refused in this mode.
+/// Since Sumw2() cannot be triggered by a weighted fill in this mode, it is
+/// called when the mode is enabled, unless the bit kIsNotW is set.
+///
+/// The concurrent mode is not available for histograms whose axes can be
+/// extended, for profiles, TH1K and TH2Poly.
+
+void TH1::SetConcurrentFill(Bool_t on /*= kTRUE*/)
+{
+   if (!on) {
+      if (!fConcurrentFill) return;
+      DoFoldConcurrentStats();
+      delete fConcurrentFill;
+      fConcurrentFill = 0;
+      return;
+   }
+   if (fConcurrentFill) return;
+
+   TArray *array = dynamic_cast<TArray*>(this);
+   EDataType type = kNoType_t;
+   if      (dynamic_cast<TArrayC*>(this)) type = kChar_t;
+   else if (dynamic_cast<TArrayS*>(this)) type = kShort_t;
+   else if (dynamic_cast<TArrayI*>(this)) type = kInt_t;
+   else if (dynamic_cast<TArrayF*>(this)) type = kFloat_t;
+   else if (dynamic_cast<TArrayD*>(this)) type = kDouble_t;
+   if (!array || type == kNoType_t || InheritsFrom(TProfile::Class()) || InheritsFrom("TProfile2D") ||
+       InheritsFrom("TProfile3D") || InheritsFrom("TH1K")) {
+      Error("SetConcurrentFill", "%s does not support concurrent filling", ClassName());
+      return;
+   }
+   if (fXaxis.CanExtend() || (fDimension > 1 && fYaxis.CanExtend()) || (fDimension > 2 && fZaxis.CanExtend())) {
+      Error("SetConcurrentFill", "histogram %s has extendable axes", GetName());
+      return;
+   }
+
+   if (fBuffer) BufferEmpty(1);
+   if (!fSumw2.fN && !TestBit(kIsNotW)) Sumw2();
+   if (fIntegral) {delete [] fIntegral; fIntegral = 0;}
+   fConcurrentFill = new ROOT::Internal::TH1ConcurrentFill(array, type);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Thread-safe filling of bin with weight w, used by the Fill functions in
+/// concurrent fill mode. inRange tells whether the point is inside the axis
+/// ranges; if it is (or if under/overflows are used in the statistics), the
+/// nstats values in stats are added to the statistics of the calling thread.
+/// Returns bin, or -1 if the point is not used in the statistics, like Fill.
+
+Int_t TH1::DoFillConcurrent(Int_t bin, Bool_t inRange, Double_t w, const Double_t *stats, Int_t nstats)
+{
+   fConcurrentFill->AddBinContent(bin, w);
+   if (fSumw2.fN) ROOT::Internal::AtomicAdd(fSumw2.fArray[bin], w*w);
+
+   const Bool_t useStats = inRange || fgStatOverflows;
+   fConcurrentFill->fStats.Update([=](Double_t *sums) {
+      sums[0] += 1;
+      if (useStats)
+         for (Int_t i = 0; i < nstats; ++i) sums[1 + i] += stats[i];
+   });
+   return useStats ? bin : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the entries and statistics accumulated by the threads filling in
+/// concurrent fill mode to the histogram statistics.
+
+void TH1::DoFoldConcurrentStats()
+{
+   Double_t sums[1 + kNstat] = {0};
+   fConcurrentFill->fStats.Fold(sums);
+   fEntries += sums[0];
+   AddToStats(sums + 1);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Static function to set the default buffer size for automatic histograms.
 /// When an histogram is created with one of its axis lower limit greater
@@ -6309,6 +6521,7 @@ void TH1::Streamer(TBuffer &b)
       b.CheckByteCount(R__s, R__c, TH1::IsA());
 
    } else {
+      FoldConcurrentStats();
       b.WriteClassBuffer(TH1::Class(),this);
    }
 }
@@ -6442,6 +6655,7 @@ void TH1::Reset(Option_t *option)
 
    // need to reset also the statistics
    // (needs to be done after calling BufferEmpty() )
+   if (fConcurrentFill) fConcurrentFill->fStats.Reset();
    fTsumw       = 0;
    fTsumw2      = 0;
    fTsumwx      = 0;
@@ -7021,6 +7235,7 @@ Double_t TH1::GetKurtosis(Int_t axis) const
 void TH1::GetStats(Double_t *stats) const
 {
    if (fBuffer) ((TH1*)this)->BufferEmpty();
+   FoldConcurrentStats();
 
    // Loop on bins (possibly including underflows/overflows)
    Int_t bin, binx;
@@ -7078,6 +7293,18 @@ void TH1::PutStats(Double_t *stats)
    fTsumwx2 = stats[3];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add the values in array stats (same layout as in GetStats) to the current
+/// statistics.
+
+void TH1::AddToStats(const Double_t *stats)
+{
+   fTsumw   += stats[0];
+   fTsumw2  += stats[1];
+   fTsumwx  += stats[2];
+   fTsumwx2 += stats[3];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset the statistics including the number of entries
 /// and replace with values calculates from bin content
@@ -7087,6 +7314,8 @@ void TH1::PutStats(Double_t *stats)
 
 void TH1::ResetStats()
 {
+   // the statistics are recomputed from the bins, including the pending concurrent fills
+   if (fConcurrentFill) fConcurrentFill->fStats.Reset();
    Double_t stats[kNstat] = {0};
    fTsumw = 0;
    fEntries = 1; // to force re-calculation of the statistics in TH1::GetStats
@@ -7886,6 +8115,10 @@ void TH1::SetBins(Int_t nx, Double_t xmin, Double_t xmax)
       Error("SetBins","Operation only valid for 1-d histograms");
       return;
    }
+   if (fConcurrentFill) {
+      Error("SetBins","Cannot change the bins of %s in concurrent fill mode", GetName());
+      return;
+   }
    fXaxis.SetRange(0,0);
    fXaxis.Set(nx,xmin,xmax);
    fYaxis.Set(1,0,1);
@@ -7913,6 +8146,10 @@ void TH1::SetBins(Int_t nx, const Double_t *xBins)
       Error("SetBins","Operation only valid for 1-d histograms");
       return;
    }
+   if (fConcurrentFill) {
+      Error("SetBins","Cannot change the bins of %s in concurrent fill mode", GetName());
+      return;
+   }
    fXaxis.SetRange(0,0);
    fXaxis.Set(nx,xBins);
    fYaxis.Set(1,0,1);
@@ -7939,6 +8176,10 @@ void TH1::SetBins(Int_t nx, Double_t xmin, Double_t xmax, Int_t ny, Double_t ymi
       Error("SetBins","Operation only valid for 2-D histograms");
       return;
    }
+   if (fConcurrentFill) {
+      Error("SetBins","Cannot change the bins of %s in concurrent fill mode", GetName());
+      return;
+   }
    fXaxis.SetRange(0,0);
    fYaxis.SetRange(0,0);
    fXaxis.Set(nx,xmin,xmax);
@@ -7967,6 +8208,10 @@ void TH1::SetBins(Int_t nx, const Double_t *xBins, Int_t ny, const Double_t *yBi
       Error("SetBins","Operation only valid for 2-D histograms");
       return;
    }
+   if (fConcurrentFill) {
+      Error("SetBins","Cannot change the bins of %s in concurrent fill mode", GetName());
+      return;
+   }
    fXaxis.SetRange(0,0);
    fYaxis.SetRange(0,0);
    fXaxis.Set(nx,xBins);
@@ -7994,6 +8239,10 @@ void TH1::SetBins(Int_t nx, Double_t xmin, Double_t xmax, Int_t ny, Double_t ymi
       Error("SetBins","Operation only valid for 3-D histograms");
       return;
    }
+   if (fConcurrentFill) {
+      Error("SetBins","Cannot change the bins of %s in concurrent fill mode", GetName());
+      return;
+   }
    fXaxis.SetRange(0,0);
    fYaxis.SetRange(0,0);
    fZaxis.SetRange(0,0);
@@ -8024,6 +8273,10 @@ void TH1::SetBins(Int_t nx, const Double_t *xBins, Int_t ny, const Double_t *yBi
       Error("SetBins","Operation only valid for 3-D histograms");
       return;
    }
+   if (fConcurrentFill) {
+      Error("SetBins","Cannot change the bins of %s in concurrent fill mode", GetName());
+      return;
+   }
    fXaxis.SetRange(0,0);
    fYaxis.SetRange(0,0);
    fZaxis.SetRange(0,0);
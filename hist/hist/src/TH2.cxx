@@ -314,6 +314,7 @@ Int_t TH2::Fill(Double_t )
 Int_t TH2::Fill(Double_t x,Double_t y)
 {
    if (fBuffer) return BufferFill(x,y,1);
+   if (fConcurrentFill) return Fill(x,y,1.);
 
    Int_t binx, biny, bin;
    fEntries++;
@@ -358,6 +359,13 @@ Int_t TH2::Fill(Double_t x,Double_t y)
 Int_t TH2::Fill(Double_t x, Double_t y, Double_t w)
 {
    if (fBuffer) return BufferFill(x,y,w);
+   if (fConcurrentFill) {
+      Int_t binx = fXaxis.FindFixBin(x);
+      Int_t biny = fYaxis.FindFixBin(y);
+      Bool_t inRange = binx > 0 && binx <= fXaxis.GetNbins() && biny > 0 && biny <= fYaxis.GetNbins();
+      const Double_t stats[7] = {w, w*w, w*x, w*x*x, w*y, w*y*y, w*x*y};
+      return DoFillConcurrent(biny*(fXaxis.GetNbins()+2) + binx, inRange, w, stats, 7);
+   }
 
    Int_t binx, biny, bin;
    fEntries++;
@@ -551,7 +559,19 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
          return;
    }
 
+   if (fConcurrentFill) {
+      // keep the thread-safe, point by point filling
+      for (i=ifirst;i<ntimes;i+=stride) Fill(x[i], y[i], w ? w[i] : 1.);
+      return;
+   }
+
    Double_t ww = 1;
+   if (!(fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) && !(fYaxis.CanExtend() && !fYaxis.IsAlphanumeric())) {
+      DoFillNBlocks((ntimes-ifirst+stride-1)/stride, x+ifirst, y+ifirst, w ? w+ifirst : 0, stride);
+      return;
+   }
+
+   // an axis might be extended by any point, fill them one by one
    for (i=ifirst;i<ntimes;i+=stride) {
       fEntries++;
       binx = fXaxis.FindBin(x[i]);
@@ -579,6 +599,65 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with n points when no axis can be extended, see
+/// TH1::DoFillN(): the bins of kFillNBlock points are found at once, then
+/// the bin contents and the statistics are accumulated in separate passes.
+
+void TH2::DoFillNBlocks(Int_t n, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
+{
+   Int_t binsx[kFillNBlock], binsy[kFillNBlock], bins[kFillNBlock];
+   const Int_t nx = fXaxis.GetNbins();
+   const Int_t ny = fYaxis.GetNbins();
+   Double_t ww = 1;
+   Int_t i;
+   fEntries += n;
+   Double_t tsumw = fTsumw, tsumw2 = fTsumw2, tsumwx = fTsumwx, tsumwx2 = fTsumwx2;
+   Double_t tsumwy = fTsumwy, tsumwy2 = fTsumwy2, tsumwxy = fTsumwxy;
+   for (Int_t first = 0; first < n; first += kFillNBlock) {
+      const Int_t nb = TMath::Min((Int_t)kFillNBlock, n - first);
+      const Double_t *xb = x + first*stride;
+      const Double_t *yb = y + first*stride;
+      const Double_t *wb = w ? w + first*stride : 0;
+      fXaxis.FindFixBins(nb, xb, binsx, stride);
+      fYaxis.FindFixBins(nb, yb, binsy, stride);
+      for (i=0;i<nb;i++)
+         bins[i] = binsy[i]*(nx+2) + binsx[i];
+      // must be called before AddBinContent
+      if (wb && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+         for (i=0;i<nb;i++) {
+            if (wb[i*stride] != 1.0) { Sumw2(); break; }
+         }
+      }
+      if (fSumw2.fN) {
+         for (i=0;i<nb;i++) {
+            if (wb) ww = wb[i*stride];
+            fSumw2.fArray[bins[i]] += ww*ww;
+         }
+      }
+      for (i=0;i<nb;i++) {
+         if (wb) ww = wb[i*stride];
+         AddBinContent(bins[i], ww);
+      }
+      for (i=0;i<nb;i++) {
+         if (!fgStatOverflows && (binsx[i] == 0 || binsx[i] > nx || binsy[i] == 0 || binsy[i] > ny))
+            continue;
+         Double_t z = wb ? wb[i*stride] : 1;
+         Double_t xi = xb[i*stride];
+         Double_t yi = yb[i*stride];
+         tsumw   += z;
+         tsumw2  += z*z;
+         tsumwx  += z*xi;
+         tsumwx2 += z*xi*xi;
+         tsumwy  += z*yi;
+         tsumwy2 += z*yi*yi;
+         tsumwxy += z*xi*yi;
+      }
+   }
+   fTsumw = tsumw; fTsumw2 = tsumw2; fTsumwx = tsumwx; fTsumwx2 = tsumwx2;
+   fTsumwy = tsumwy; fTsumwy2 = tsumwy2; fTsumwxy = tsumwxy;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill histogram following distribution in function fname.
@@ -1128,6 +1207,7 @@ void TH2::GetRandom2(Double_t &x, Double_t &y)
 void TH2::GetStats(Double_t *stats) const
 {
    if (fBuffer) ((TH2*)this)->BufferEmpty();
+   FoldConcurrentStats();
 
    if ((fTsumw == 0 && fEntries > 0) || fXaxis.TestBit(TAxis::kAxisRange) || fYaxis.TestBit(TAxis::kAxisRange)) {
       std::fill(stats, stats + 7, 0);
@@ -1565,6 +1645,10 @@ TH2 *TH2::Rebin2D(Int_t nxgroup, Int_t nygroup, const char *newname)
    Double_t ymin  = fYaxis.GetXmin();
    Double_t ymax  = fYaxis.GetXmax();
 
+   if (fConcurrentFill) {
+      Error("Rebin2D", "Cannot rebin %s in concurrent fill mode", GetName());
+      return 0;
+   }
    if (GetDimension() != 2) {
       Error("Rebin2D", "Histogram must be TH2. This histogram has %d dimensions.", GetDimension());
       return 0;
@@ -2342,6 +2426,18 @@ void TH2::PutStats(Double_t *stats)
    fTsumwxy = stats[6];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add the values in array stats (same layout as in GetStats) to the current
+/// statistics.
+
+void TH2::AddToStats(const Double_t *stats)
+{
+   TH1::AddToStats(stats);
+   fTsumwy  += stats[4];
+   fTsumwy2 += stats[5];
+   fTsumwxy += stats[6];
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Compute the X distribution of quantiles in the other variable Y
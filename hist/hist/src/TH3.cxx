@@ -293,6 +293,7 @@ Int_t TH3::Fill(Double_t )
 Int_t TH3::Fill(Double_t x, Double_t y, Double_t z)
 {
    if (fBuffer) return BufferFill(x,y,z,1);
+   if (fConcurrentFill) return Fill(x,y,z,1.);
 
    Int_t binx, biny, binz, bin;
    fEntries++;
@@ -341,6 +342,15 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z)
 Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 {
    if (fBuffer) return BufferFill(x,y,z,w);
+   if (fConcurrentFill) {
+      Int_t binx = fXaxis.FindFixBin(x);
+      Int_t biny = fYaxis.FindFixBin(y);
+      Int_t binz = fZaxis.FindFixBin(z);
+      Bool_t inRange = binx > 0 && binx <= fXaxis.GetNbins() && biny > 0 && biny <= fYaxis.GetNbins() &&
+                       binz > 0 && binz <= fZaxis.GetNbins();
+      const Double_t stats[11] = {w, w*w, w*x, w*x*x, w*y, w*y*y, w*x*y, w*z, w*z*z, w*x*z, w*y*z};
+      return DoFillConcurrent(binx + (fXaxis.GetNbins()+2)*(biny + (fYaxis.GetNbins()+2)*binz), inRange, w, stats, 11);
+   }
 
    Int_t binx, biny, binz, bin;
    fEntries++;
@@ -375,6 +385,121 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 3-D histogram with an array of values and weights.
+///
+///  - ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+///  - x:       array of x values to be histogrammed
+///  - y:       array of y values to be histogrammed
+///  - z:       array of z values to be histogrammed
+///  - w:       array of weights
+///  - stride:  step size through arrays x, y, z and w
+///
+///   - If the weight is not equal to 1, the storage of the sum of squares of
+///     weights is automatically triggered and the sum of the squares of weights is incremented
+///     by w[i]^2 in the bin corresponding to x[i],y[i],z[i].
+///   - If w is NULL each entry is assumed a weight=1
+///
+/// Unless an axis can be extended, the points are processed by blocks as in
+/// TH1::DoFillN(), which is much faster than calling Fill() for each point.
+
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         if (w) BufferFill(x[i],y[i],z[i],w[i]);
+         else BufferFill(x[i],y[i],z[i],1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;
+      else
+         return;
+   }
+
+   if (fConcurrentFill || (fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) ||
+       (fYaxis.CanExtend() && !fYaxis.IsAlphanumeric()) || (fZaxis.CanExtend() && !fZaxis.IsAlphanumeric())) {
+      // an axis might be extended by any point, or the concurrent fill mode
+      // is active: fill them one by one
+      for (i=ifirst;i<ntimes;i+=stride)
+         Fill(x[i],y[i],z[i],w ? w[i] : 1.);
+      return;
+   }
+
+   const Int_t n = (ntimes-ifirst)/stride;
+   x += ifirst;
+   y += ifirst;
+   z += ifirst;
+   if (w) w += ifirst;
+
+   Int_t binsx[kFillNBlock], binsy[kFillNBlock], binsz[kFillNBlock], bins[kFillNBlock];
+   const Int_t nx = fXaxis.GetNbins();
+   const Int_t ny = fYaxis.GetNbins();
+   const Int_t nz = fZaxis.GetNbins();
+   Double_t ww = 1;
+   fEntries += n;
+   Double_t tsumw = fTsumw, tsumw2 = fTsumw2, tsumwx = fTsumwx, tsumwx2 = fTsumwx2;
+   Double_t tsumwy = fTsumwy, tsumwy2 = fTsumwy2, tsumwxy = fTsumwxy;
+   Double_t tsumwz = fTsumwz, tsumwz2 = fTsumwz2, tsumwxz = fTsumwxz, tsumwyz = fTsumwyz;
+   for (Int_t first = 0; first < n; first += kFillNBlock) {
+      const Int_t nb = TMath::Min((Int_t)kFillNBlock, n - first);
+      const Double_t *xb = x + first*stride;
+      const Double_t *yb = y + first*stride;
+      const Double_t *zb = z + first*stride;
+      const Double_t *wb = w ? w + first*stride : 0;
+      fXaxis.FindFixBins(nb, xb, binsx, stride);
+      fYaxis.FindFixBins(nb, yb, binsy, stride);
+      fZaxis.FindFixBins(nb, zb, binsz, stride);
+      for (i=0;i<nb;i++)
+         bins[i] = binsx[i] + (nx+2)*(binsy[i] + (ny+2)*binsz[i]);
+      // must be called before AddBinContent
+      if (wb && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+         for (i=0;i<nb;i++) {
+            if (wb[i*stride] != 1.0) { Sumw2(); break; }
+         }
+      }
+      if (fSumw2.fN) {
+         for (i=0;i<nb;i++) {
+            if (wb) ww = wb[i*stride];
+            fSumw2.fArray[bins[i]] += ww*ww;
+         }
+      }
+      for (i=0;i<nb;i++) {
+         if (wb) ww = wb[i*stride];
+         AddBinContent(bins[i], ww);
+      }
+      for (i=0;i<nb;i++) {
+         if (!fgStatOverflows && (binsx[i] == 0 || binsx[i] > nx || binsy[i] == 0 || binsy[i] > ny ||
+                                  binsz[i] == 0 || binsz[i] > nz))
+            continue;
+         Double_t v  = wb ? wb[i*stride] : 1;
+         Double_t xi = xb[i*stride];
+         Double_t yi = yb[i*stride];
+         Double_t zi = zb[i*stride];
+         tsumw   += v;
+         tsumw2  += v*v;
+         tsumwx  += v*xi;
+         tsumwx2 += v*xi*xi;
+         tsumwy  += v*yi;
+         tsumwy2 += v*yi*yi;
+         tsumwxy += v*xi*yi;
+         tsumwz  += v*zi;
+         tsumwz2 += v*zi*zi;
+         tsumwxz += v*xi*zi;
+         tsumwyz += v*yi*zi;
+      }
+   }
+   fTsumw = tsumw; fTsumw2 = tsumw2; fTsumwx = tsumwx; fTsumwx2 = tsumwx2;
+   fTsumwy = tsumwy; fTsumwy2 = tsumwy2; fTsumwxy = tsumwxy;
+   fTsumwz = tsumwz; fTsumwz2 = tsumwz2; fTsumwxz = tsumwxz; fTsumwyz = tsumwyz;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Increment cell defined by namex,namey,namez by a weight w
@@ -1136,6 +1261,7 @@ void TH3::GetRandom3(Double_t &x, Double_t &y, Double_t &z)
 void TH3::GetStats(Double_t *stats) const
 {
    if (fBuffer) ((TH3*)this)->BufferEmpty();
+   FoldConcurrentStats();
 
    Int_t bin, binx, biny, binz;
    Double_t w,err;
@@ -2656,6 +2782,22 @@ void TH3::PutStats(Double_t *stats)
    fTsumwyz = stats[10];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add the values in array stats (same layout as in GetStats) to the current
+/// statistics.
+
+void TH3::AddToStats(const Double_t *stats)
+{
+   TH1::AddToStats(stats);
+   fTsumwy  += stats[4];
+   fTsumwy2 += stats[5];
+   fTsumwxy += stats[6];
+   fTsumwz  += stats[7];
+   fTsumwz2 += stats[8];
+   fTsumwxz += stats[9];
+   fTsumwyz += stats[10];
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Rebin only the X axis
@@ -2724,6 +2866,10 @@ TH3 *TH3::Rebin3D(Int_t nxgroup, Int_t nygroup, Int_t nzgroup, const char *newna
    Double_t ymax  = fYaxis.GetXmax();
    Double_t zmin  = fZaxis.GetXmin();
    Double_t zmax  = fZaxis.GetXmax();
+   if (fConcurrentFill) {
+      Error("Rebin3D", "Cannot rebin %s in concurrent fill mode", GetName());
+      return 0;
+   }
    if ((nxgroup <= 0) || (nxgroup > nxbins)) {
       Error("Rebin", "Illegal value of nxgroup=%d",nxgroup);
       return 0;
@@ -222,6 +222,56 @@ void THn::Sumw2() {
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable (or disable if `on` is false) the concurrent fill mode, see
+/// THnBase::SetConcurrentFill(). The bin storage, which is otherwise
+/// allocated at the first fill, is allocated up front. Call Sumw2() before
+/// enabling the concurrent mode if errors should be calculated.
+
+void THn::SetConcurrentFill(Bool_t on /*= kTRUE*/)
+{
+   if (!on || fConcurrentStats) {
+      THnBase::SetConcurrentFill(on);
+      return;
+   }
+   GetArray().Allocate();
+   if (GetCalculateErrors())
+      fSumw2.Allocate();
+   fIntegralStatus = kInvalidInt;
+   fConcurrentStats = new ROOT::Internal::TConcurrentStats(3 + 2 * fNdimensions);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Thread-safe version of Fill(const Double_t*, Double_t), used in concurrent
+/// fill mode. The bin is computed without the shared coordinate buffer.
+
+Long64_t THn::FillConcurrent(const Double_t *x, Double_t w)
+{
+   TNDArray& arr = GetArray();
+   Long64_t bin = 0;
+   for (Int_t d = 0; d < fNdimensions; ++d)
+      bin += arr.GetCellSize(d) * GetAxis(d)->FindFixBin(x[d]);
+
+   arr.AddAtAtomic(bin, w);
+   const Bool_t errors = GetCalculateErrors();
+   if (errors)
+      fSumw2.AddAtAtomic(bin, w * w);
+
+   const Int_t ndim = fNdimensions;
+   fConcurrentStats->Update([=](Double_t *sums) {
+      sums[0] += 1;
+      if (errors) {
+         sums[1] += w;
+         sums[2] += w * w;
+         for (Int_t d = 0; d < ndim; ++d) {
+            sums[3 + 2 * d] += w * x[d];
+            sums[4 + 2 * d] += w * x[d] * x[d];
+         }
+      }
+   });
+   return bin;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create the coordinate buffer. Outlined to hide allocation
 /// from inlined functions.
@@ -31,6 +31,7 @@
 #include "Fit/SparseData.h"
 #include "Math/MinimizerOptions.h"
 #include "Math/WrappedMultiTF1.h"
+#include "ROOT/TConcurrentStats.hxx"
 
 
 /** \class THnBase
@@ -52,7 +53,7 @@ THnBase::THnBase(const char* name, const char* title, Int_t dim,
                  const Int_t* nbins, const Double_t* xmin, const Double_t* xmax):
 TNamed(name, title), fNdimensions(dim), fAxes(dim), fBrowsables(dim),
 fEntries(0), fTsumw(0), fTsumw2(-1.), fTsumwx(dim), fTsumwx2(dim),
-fIntegral(0), fIntegralStatus(kNoInt)
+fIntegral(0), fIntegralStatus(kNoInt), fConcurrentStats(0)
 {
    for (Int_t i = 0; i < fNdimensions; ++i) {
       TAxis* axis = new TAxis(nbins[i], xmin ? xmin[i] : 0., xmax ? xmax[i] : 1.);
@@ -68,6 +69,81 @@ fIntegral(0), fIntegralStatus(kNoInt)
 
 THnBase::~THnBase() {
    if (fIntegralStatus != kNoInt) delete [] fIntegral;
+   delete fConcurrentStats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enable (or disable if `on` is false) the concurrent fill mode, in which
+/// Fill(const Double_t*, Double_t) can be called from several threads at the
+/// same time on the same histogram, without the need for one histogram per
+/// thread and a final merge.
+///
+/// The bin contents (and the sums of squares of weights if Sumw2() was called
+/// before) are then incremented with atomic operations, while the statistics
+/// are accumulated per thread and only added to the sums of weights when
+/// they are read (GetEntries(), GetSumw(), ...) or when the concurrent mode
+/// is disabled. All other operations, including the other ways to fill the
+/// histogram, are not thread-safe: disable the concurrent mode once the
+/// filling threads are done.
+///
+/// Only THn supports the concurrent fill mode; the bins of THnSparse are
+/// allocated on the fly.
+
+void THnBase::SetConcurrentFill(Bool_t on /*= kTRUE*/)
+{
+   if (on) {
+      if (!fConcurrentStats)
+         Error("SetConcurrentFill", "%s does not support concurrent filling", ClassName());
+      return;
+   }
+   if (!fConcurrentStats)
+      return;
+   DoFoldConcurrentStats();
+   delete fConcurrentStats;
+   fConcurrentStats = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream an object of class THnBase. The statistics accumulated in
+/// concurrent fill mode are added to the histogram before it is written.
+
+void THnBase::Streamer(TBuffer &R__b)
+{
+   if (R__b.IsReading()) {
+      R__b.ReadClassBuffer(THnBase::Class(), this);
+   } else {
+      FoldConcurrentStats();
+      R__b.WriteClassBuffer(THnBase::Class(), this);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram in concurrent fill mode; see SetConcurrentFill().
+/// Implemented by the classes that support this mode.
+
+Long64_t THnBase::FillConcurrent(const Double_t* /*x*/, Double_t /*w*/)
+{
+   MayNotUse("FillConcurrent");
+   return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the statistics accumulated by the threads filling in concurrent fill
+/// mode to the entries and sums of weights, and reset them.
+
+void THnBase::DoFoldConcurrentStats()
+{
+   std::vector<Double_t> sums(3 + 2 * fNdimensions);
+   fConcurrentStats->Fold(sums.data());
+   fEntries += sums[0];
+   if (GetCalculateErrors()) {
+      fTsumw += sums[1];
+      fTsumw2 += sums[2];
+      for (Int_t d = 0; d < fNdimensions; ++d) {
+         fTsumwx[d] += sums[3 + 2 * d];
+         fTsumwx2[d] += sums[4 + 2 * d];
+      }
+   }
 }
 
 
@@ -643,6 +719,14 @@ void THnBase::AddInternal(const THnBase* h, Double_t c, Bool_t rebinned)
       Sumw2();
    Bool_t haveErrors = GetCalculateErrors();
 
+   // Sparse histograms with the same binning can add their bins directly by
+   // compact coordinate, in parallel if implicit multi-threading is enabled.
+   if (!rebinned && InheritsFrom(THnSparse::Class()) && h->InheritsFrom(THnSparse::Class())
+       && ((THnSparse*)this)->AddSparse((const THnSparse*)h, c)) {
+      SetEntries(GetEntries() + c * h->GetEntries());
+      return;
+   }
+
    Double_t* x = 0;
    if (rebinned) {
       x = new Double_t[fNdimensions];
@@ -1150,6 +1234,7 @@ THnBase* THnBase::RebinBase(const Int_t* group) const
 
 void THnBase::ResetBase(Option_t * /*option = ""*/)
 {
+   if (fConcurrentStats) fConcurrentStats->Reset();
    fEntries = 0.;
    fTsumw = 0.;
    fTsumw2 = -1.;
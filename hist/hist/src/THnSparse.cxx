@@ -16,6 +16,14 @@
 #include "TClass.h"
 #include "TDataMember.h"
 #include "TDataType.h"
+#include "TROOT.h"
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <functional>
+#include <vector>
 
 namespace {
 //______________________________________________________________________________
@@ -410,6 +418,92 @@ THnSparseCompactBinCoord::~THnSparseCompactBinCoord()
    delete [] fCurrentBin;
 }
 
+/** \class THnSparseBinIndex
+THnSparseBinIndex is used internally by THnSparse to find the linear index of
+a filled bin from the hash of its compact coordinates. It is an open
+addressing hash table with linear probing, made of a single array of 64 bit
+slots: the lower kIndexBits bits of a slot hold the linear bin index plus one
+(0 meaning an empty slot), the upper bits a tag taken from the hash. The
+compact coordinates are only stored once, in the THnSparseArrayChunk, and
+they are only compared to the ones looked up when the tags match.
+
+With a load factor of at most 3/4 this takes 11 to 21 bytes per filled bin,
+where a TExMap (three Long64_t per slot, and a second map for colliding
+hashes) takes around 70.
+*/
+
+class THnSparseBinIndex {
+public:
+   enum { kIndexBits = 40 }; // at most 2^40 - 1 filled bins
+
+   THnSparseBinIndex(): fSize(0) {}
+
+   Long64_t GetSize() const { return fSize; }
+   Long64_t GetCapacity() const { return fSlots.size(); }
+   // Whether inserting one more bin would exceed the maximal load factor.
+   Bool_t IsFull() const { return 4 * (fSize + 1) > 3 * (Long64_t) fSlots.size(); }
+
+   void Clear() {
+      std::vector<ULong64_t>().swap(fSlots);
+      fSize = 0;
+   }
+
+   void Init(Long64_t nbins) {
+      // Remove all bins and make room for nbins without exceeding the load factor.
+      size_t capacity = 16;
+      while (3 * capacity < 4 * (size_t) nbins + 4)
+         capacity *= 2;
+      fSlots.assign(capacity, 0);
+      fSize = 0;
+   }
+
+   template <class MATCH>
+   Long64_t Find(ULong64_t hash, MATCH&& matches) const {
+      // Return the linear index of the bin with hash for which matches(linidx)
+      // is true, or -1 if there is none.
+      if (fSlots.empty()) return -1;
+      const ULong64_t mixed = Mix(hash);
+      const ULong64_t tag = mixed & ~kIndexMask;
+      const size_t mask = fSlots.size() - 1;
+      for (size_t pos = mixed & mask; fSlots[pos]; pos = (pos + 1) & mask) {
+         const ULong64_t slot = fSlots[pos];
+         if ((slot & ~kIndexMask) == tag && matches((Long64_t)(slot & kIndexMask) - 1))
+            return (Long64_t)(slot & kIndexMask) - 1;
+      }
+      return -1;
+   }
+
+   void Insert(ULong64_t hash, Long64_t linidx) {
+      // Add the bin linidx with hash, which must not be in the index yet.
+      // The caller is responsible for growing the index, see IsFull().
+      const ULong64_t mixed = Mix(hash);
+      const size_t mask = fSlots.size() - 1;
+      size_t pos = mixed & mask;
+      while (fSlots[pos])
+         pos = (pos + 1) & mask;
+      fSlots[pos] = (mixed & ~kIndexMask) | (ULong64_t)(linidx + 1);
+      ++fSize;
+   }
+
+private:
+   static const ULong64_t kIndexMask = (1ULL << kIndexBits) - 1;
+
+   static ULong64_t Mix(ULong64_t h) {
+      // Spread the bits of the hash: for up to 8 bytes the hash is the compact
+      // coordinate itself, whose lower bits only depend on the first axes.
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return h;
+   }
+
+   std::vector<ULong64_t> fSlots; // bin index + 1 and hash tag, 0 if empty
+   Long64_t fSize;                // number of bins in the index
+};
+
+
 /** \class THnSparseArrayChunk
 THnSparseArrayChunk is used internally by THnSparse.
 THnSparse stores its (dynamic size) array of bin coordinates and their
@@ -571,14 +665,19 @@ Translation from an n-dimensional bin coordinate to the linear index within
 the chunks is done by GetBin(). It creates a hash from the compacted bin
 coordinates (the hash of a bin coordinate is the compacted coordinate itself
 if it takes less than 8 bytes, the size of a Long64_t.
-This hash is used to lookup the linear index in the TExMap member fBins;
-the coordinates of the entry fBins points to is compared to the coordinates
-passed to GetBin(). If they do not match, these two coordinates have the same
-hash - which is extremely unlikely but (for the case where the compact bin
-coordinates are larger than 4 bytes) possible. In this case, fBinsContinued
-contains a chain of linear indexes with the same hash. Iterating through this
-chain and comparing each bin coordinates with the one passed to GetBin() will
-retrieve the matching bin.
+This hash is used to lookup the linear index in the open addressing hash
+table of the internal class THnSparseBinIndex, which only stores the linear
+index and a few bits of the hash of each filled bin; the coordinates stored
+in the chunk for the candidate bins are compared to the coordinates passed to
+GetBin() to find the matching bin.
+
+## Merging
+Adding (THnBase::Add()) or merging (THnBase::Merge()) a THnSparse with the
+same binning into another one works directly on the compact coordinates. If
+implicit multi-threading is enabled (ROOT::EnableImplicitMT()), the lookup of
+the bins and the addition of their contents are done in parallel, the filled
+bins of the added histogram being partitioned between the threads; only the
+allocation of the new bins is sequential.
 */
 
 
@@ -588,7 +687,7 @@ ClassImp(THnSparse);
 /// Construct an empty THnSparse.
 
 THnSparse::THnSparse():
-   fChunkSize(1024), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(1024), fFilledBins(0), fBinIndex(new THnSparseBinIndex), fCompactCoord(0)
 {
    fBinContent.SetOwner();
 }
@@ -605,7 +704,7 @@ THnSparse::THnSparse(const char* name, const char* title, Int_t dim,
                      const Int_t* nbins, const Double_t* xmin, const Double_t* xmax,
                      Int_t chunksize):
    THnBase(name, title, dim, nbins, xmin, xmax),
-   fChunkSize(chunksize), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(chunksize), fFilledBins(0), fBinIndex(new THnSparseBinIndex), fCompactCoord(0)
 {
    fCompactCoord = new THnSparseCompactBinCoord(dim, nbins);
    fBinContent.SetOwner();
@@ -615,6 +714,7 @@ THnSparse::THnSparse(const char* name, const char* title, Int_t dim,
 /// Destruct a THnSparse
 
 THnSparse::~THnSparse() {
+   delete fBinIndex;
    delete fCompactCoord;
 }
 
@@ -651,36 +751,23 @@ void THnSparse::InitStorage(Int_t* nbins, Int_t chunkSize)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-///We have been streamed; set up fBins
+/// (Re)build the index of the filled bins, with room for nbins bins.
+/// Needed after streaming, and when the index grows.
 
-void THnSparse::FillExMap()
+void THnSparse::FillBinIndex(Long64_t nbins)
 {
+   THnSparseCoordCompression compactCoord(*GetCompactCoord());
+   fBinIndex->Init(TMath::Max(nbins, GetNbins()));
    TIter iChunk(&fBinContent);
    THnSparseArrayChunk* chunk = 0;
-   THnSparseCoordCompression compactCoord(*GetCompactCoord());
    Long64_t idx = 0;
-   if (2 * GetNbins() > fBins.Capacity())
-      fBins.Expand(3 * GetNbins());
    while ((chunk = (THnSparseArrayChunk*) iChunk())) {
       const Int_t chunkSize = chunk->GetEntries();
       Char_t* buf = chunk->fCoordinates;
       const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
       const Char_t* endbuf = buf + singleCoordSize * chunkSize;
-      for (; buf < endbuf; buf += singleCoordSize, ++idx) {
-         Long64_t hash = compactCoord.GetHashFromBuffer(buf);
-         Long64_t linidx = fBins.GetValue(hash);
-         if (linidx) {
-            Long64_t nextidx = linidx;
-            while (nextidx) {
-               // must be a collision, so go to fBinsContinued.
-               linidx = nextidx;
-               nextidx = fBinsContinued.GetValue(linidx);
-            }
-            fBinsContinued.Add(linidx, idx + 1);
-         } else {
-            fBins.Add(hash, idx + 1);
-         }
-      }
+      for (; buf < endbuf; buf += singleCoordSize, ++idx)
+         fBinIndex->Insert(compactCoord.GetHashFromBuffer(buf), idx);
    }
 }
 
@@ -688,11 +775,9 @@ void THnSparse::FillExMap()
 /// Initialize storage for nbins
 
 void THnSparse::Reserve(Long64_t nbins) {
-   if (!fBins.GetSize() && fBinContent.GetSize()) {
-      FillExMap();
-   }
-   if (2 * nbins > fBins.Capacity()) {
-      fBins.Expand(3 * nbins);
+   if (4 * nbins + 4 > 3 * fBinIndex->GetCapacity()
+       || (GetNbins() && !fBinIndex->GetSize())) {
+      FillBinIndex(nbins);
    }
 }
 
@@ -790,22 +875,35 @@ Double_t THnSparse::GetBinError2(Long64_t linidx) const {
 Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 {
    THnSparseCompactBinCoord* cc = GetCompactCoord();
-   ULong64_t hash = cc->GetHash();
-   if (fBinContent.GetSize() && !fBins.GetSize())
-      FillExMap();
-   Long64_t linidx = (Long64_t) fBins.GetValue(hash);
-   while (linidx) {
-      // fBins stores index + 1!
-      THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
-      if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
-         return linidx - 1; // we store idx+1, 0 is "TExMap: not found"
+   if (GetNbins() && !fBinIndex->GetSize())
+      FillBinIndex(GetNbins());
+   Long64_t linidx = FindBin(cc->GetHash(), cc->GetBuffer());
+   if (linidx >= 0 || !allocate) return linidx;
+   return AllocateBin(cc->GetHash(), cc->GetBuffer());
+}
 
-      Long64_t nextlinidx = fBinsContinued.GetValue(linidx);
-      if (!nextlinidx) break;
+////////////////////////////////////////////////////////////////////////////////
+/// Return the linear index of the filled bin with compact coordinates buf
+/// and their hash, or -1 if there is none. Does not modify the histogram:
+/// can be called concurrently, as long as no bin is allocated.
 
-      linidx = nextlinidx;
-   }
-   if (!allocate) return -1;
+Long64_t THnSparse::FindBin(ULong64_t hash, const Char_t* buf) const
+{
+   const Int_t coordSize = GetCompactCoord()->GetBufferSize();
+   return fBinIndex->Find(hash, [&](Long64_t linidx) {
+      const THnSparseArrayChunk* chunk = GetChunk(linidx / fChunkSize);
+      return !memcmp(chunk->fCoordinates + (linidx % fChunkSize) * coordSize, buf, coordSize);
+   });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Allocate a new bin with compact coordinates buf and their hash, which
+/// must not be filled yet. Return its linear index.
+
+Long64_t THnSparse::AllocateBin(ULong64_t hash, const Char_t* buf)
+{
+   if (fBinIndex->IsFull())
+      FillBinIndex(2 * GetNbins() + 1);
 
    ++fFilledBins;
 
@@ -816,23 +914,88 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
       chunk = AddChunk();
       newidx = 0;
    }
-   chunk->AddBin(newidx, cc->GetBuffer());
+   chunk->AddBin(newidx, buf);
 
    // store translation between hash and bin
    newidx += (fBinContent.GetEntriesFast() - 1) * fChunkSize;
-   if (!linidx) {
-      // fBins didn't find it
-      if (2 * GetNbins() > fBins.Capacity())
-         fBins.Expand(3 * GetNbins());
-      fBins.Add(hash, newidx + 1);
-   } else {
-      // fBins contains one, but it's the wrong one;
-      // add entry to fBinsContinued.
-      fBinsContinued.Add(linidx, newidx + 1);
-   }
+   fBinIndex->Insert(hash, newidx);
    return newidx;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add the bins of h, which has the same binning as this, scaled by c, using
+/// their compact coordinates; see THnBase::AddInternal(). The number of
+/// entries is not updated. Return kFALSE if the binnings differ.
+///
+/// With implicit multi-threading the bins of h are partitioned in ranges,
+/// looked up in this histogram and then added to it in parallel: distinct
+/// bins of h go to distinct bins of this. Only the bins that are missing in
+/// this histogram are allocated sequentially, in the order of h.
+
+Bool_t THnSparse::AddSparse(const THnSparse* h, Double_t c)
+{
+   for (Int_t d = 0; d < fNdimensions; ++d)
+      if (GetAxis(d)->GetNbins() != h->GetAxis(d)->GetNbins())
+         return kFALSE;
+
+   const Long64_t nbins = h->GetNbins();
+   if (!nbins) return kTRUE;
+   Reserve(GetNbins() + nbins);
+
+   const THnSparseCoordCompression& compactCoord = *GetCompactCoord();
+   const Int_t coordSize = compactCoord.GetBufferSize();
+   const Int_t hChunkSize = h->GetChunkSize();
+   auto coordOf = [&](Long64_t i) {
+      return h->GetChunk(i / hChunkSize)->fCoordinates + (i % hChunkSize) * coordSize;
+   };
+
+   // Process the bins of h in ranges, possibly in parallel.
+   const Long64_t kRange = 16 * 1024;
+   const Long64_t nRanges = (nbins + kRange - 1) / kRange;
+   auto forEachRange = [&](const std::function<void(Long64_t, Long64_t)>& func) {
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled() && nRanges > 1) {
+         ROOT::TThreadExecutor pool;
+         pool.Foreach([&](Long64_t r) { func(r * kRange, TMath::Min(nbins, (r + 1) * kRange)); },
+                      ROOT::TSeq<Long64_t>(0, nRanges));
+         return;
+      }
+#endif
+      func(0, nbins);
+   };
+
+   // Look up the bins of h in this histogram.
+   std::vector<Long64_t> target(nbins);
+   forEachRange([&](Long64_t first, Long64_t last) {
+      for (Long64_t i = first; i < last; ++i) {
+         const Char_t* buf = coordOf(i);
+         target[i] = FindBin(compactCoord.GetHashFromBuffer(buf), buf);
+      }
+   });
+
+   // Allocate the missing bins.
+   for (Long64_t i = 0; i < nbins; ++i) {
+      if (target[i] < 0) {
+         const Char_t* buf = coordOf(i);
+         target[i] = AllocateBin(compactCoord.GetHashFromBuffer(buf), buf);
+      }
+   }
+
+   // Add the contents and errors.
+   const Bool_t haveErrors = GetCalculateErrors();
+   forEachRange([&](Long64_t first, Long64_t last) {
+      for (Long64_t i = first; i < last; ++i) {
+         THnSparseArrayChunk* chunk = GetChunk(target[i] / fChunkSize);
+         const Int_t idx = target[i] % fChunkSize;
+         const Double_t v = h->GetBinContent(i);
+         if (haveErrors)
+            chunk->fSumw2->fArray[idx] += h->GetBinError2(i) * c * c;
+         chunk->fContent->SetAt(chunk->fContent->GetAt(idx) + c * v, idx);
+      }
+   });
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return THnSparseCompactBinCoord object.
 
@@ -881,7 +1044,7 @@ Double_t THnSparse::GetSparseFractionMem() const {
 
    Double_t size = 0.;
    size += fBinContent.GetEntries() * (GetChunkSize() * sizePerChunkElement + sizeof(THnSparseArrayChunk));
-   size += + 3 * sizeof(Long64_t) * fBins.GetSize() /* TExMap */;
+   size += sizeof(ULong64_t) * fBinIndex->GetCapacity() /* THnSparseBinIndex */;
 
    Double_t nbinsTotal = 1.;
    for (Int_t d = 0; d < fNdimensions; ++d)
@@ -963,8 +1126,7 @@ void THnSparse::Sumw2()
 void THnSparse::Reset(Option_t *option /*= ""*/)
 {
    fFilledBins = 0;
-   fBins.Delete();
-   fBinsContinued.Clear();
+   fBinIndex->Clear();
    fBinContent.Delete();
    ResetBase(option);
 }
@@ -22,6 +22,12 @@
  
  The algorithm is briefly described in (4). A binned version is also implemented to address the 
  performance issue due to its data size dependance.
+
+ For the built-in kernels, which vanish outside a finite range, only the data
+ points close to the evaluation point contribute to the sum. For large data sets
+ the estimate can in addition be tabulated on a grid of points and interpolated
+ (see TKDE::SetNGridPoints). Arrays of points are evaluated with TKDE::GetValue,
+ in parallel when the implicit multi-threading is enabled.
  */
 
 
@@ -43,20 +49,63 @@
 #include "TCanvas.h"
 #include "TKDE.h"
 
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 
 ClassImp(TKDE);
 
+namespace {
+
+// Calls func(begin, end) for blocks of the indices [0, n), in parallel
+// if the implicit multi-threading is enabled and parallel is true
+template <class F>
+void ForEachBlock(UInt_t n, Bool_t parallel, const F & func) {
+   const UInt_t kBlockSize = 1024;
+   const UInt_t nBlocks = (n + kBlockSize - 1) / kBlockSize;
+   auto blockFunc = [&](UInt_t iblock) {
+      func(iblock * kBlockSize, std::min(n, (iblock + 1) * kBlockSize));
+   };
+#ifdef R__USE_IMT
+   if (parallel && nBlocks > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(blockFunc, ROOT::TSeq<UInt_t>(0, nBlocks));
+      return;
+   }
+#endif
+   for (UInt_t iblock = 0; iblock < nBlocks; ++iblock)
+      blockFunc(iblock);
+}
+
+}
+
 class TKDE::TKernel {
    TKDE* fKDE;
    UInt_t fNWeights; // Number of kernel weights (bandwidth as vectorized for binning)
    std::vector<Double_t> fWeights; // Kernel weights (bandwidth)
+   Double_t fSupport;   // Kernel is zero outside [-fSupport, fSupport], 0 if not known (user defined kernel)
+   Double_t fMaxWeight; // Largest kernel weight
+   std::vector<UInt_t> fOrder;        // Indices of the data sorted by value
+   std::vector<Double_t> fSortedData; // Data sorted by value
+   std::vector<Double_t> fGrid;       // Estimate at the grid points, if used
+   Double_t fGridMin;   // First grid point
+   Double_t fGridStep;  // Distance between the grid points
+   Double_t Evaluate(Double_t x) const;
 public:
    TKernel(Double_t weight, TKDE* kde);
    void ComputeAdaptiveWeights();
+   void ComputeGrid(UInt_t npoints, Double_t xMin, Double_t xMax);
    Double_t operator()(Double_t x) const;
    Double_t GetWeight(Double_t x) const;
    Double_t GetFixedWeight() const;
    const std::vector<Double_t> & GetAdaptiveWeights() const;
+   // Only the built-in kernels can be evaluated concurrently: the user
+   // defined kernel, a ROOT::Math::WrappedFunction of the functor given to
+   // the constructor (e.g. a TF1, which stores its arguments), may not be
+   // thread safe
+   Bool_t IsThreadSafe() const { return fSupport > 0; }
 };
 
 struct TKDE::KernelIntegrand {
@@ -130,6 +179,7 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    fNBins = events < 10000 ? 100 : events / 10;
    fNEvents = events;
    fUseBinsNEvents = 10000;
+   fNGridPoints = 0;
    fMean = 0.0;
    fSigma = 0.0;
    fXMin = xMin;
@@ -401,6 +451,18 @@ void TKDE::SetTuneFactor(Double_t rho) {
    SetKernel();
 }
 
+void TKDE::SetNGridPoints(UInt_t npoints) {
+   // Sets the number of equidistant points between the minimum and the maximum
+   // of the range at which the estimate is computed when the kernel is set.
+   // Inside the range the estimate is then the linear interpolation of these
+   // values, which is much faster for large data sets. Outside of the range,
+   // or if npoints is smaller than 2 (default), the estimate is computed exactly.
+   // The number of points should be large enough to sample the smallest
+   // bandwidth with a few points.
+   fNGridPoints = npoints;
+   SetKernel();
+}
+
 void TKDE::SetRange(Double_t xMin, Double_t xMax) {
    // Sets minimum range value and maximum range value
    if (xMin >= xMax) {
@@ -551,6 +613,9 @@ void TKDE::SetKernel() {
    if (fIteration == kAdaptive) {
       fKernel->ComputeAdaptiveWeights();
    }
+   if (fNGridPoints > 1) {
+      fKernel->ComputeGrid(fNGridPoints, fXMin, fXMax);
+   }
 }
 
 void TKDE::SetKernelFunction(KernelFunction_Ptr kernfunc) {
@@ -672,6 +737,17 @@ Double_t TKDE::operator()(Double_t x) const {
    return (*fKernel)(x);
 }
 
+void TKDE::GetValue(UInt_t n, const Double_t* x, Double_t* y) const {
+   // Computes the kernel density estimate y[i] at the n points x[i].
+   // The points are evaluated in parallel if the implicit multi-threading
+   // is enabled (see ROOT::EnableImplicitMT)
+   if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
+   ForEachBlock(n, fKernel->IsThreadSafe(), [&](UInt_t begin, UInt_t end) {
+      for (UInt_t i = begin; i < end; ++i)
+         y[i] = (*fKernel)(x[i]);
+   });
+}
+
 Double_t TKDE::GetMean() const {
    // return the mean of the data
    if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
@@ -694,8 +770,33 @@ TKDE::TKernel::TKernel(Double_t weight, TKDE* kde) :
 // Internal class constructor
 fKDE(kde),
 fNWeights(kde->fData.size()),
-fWeights(fNWeights, weight)
-{}
+fWeights(fNWeights, weight),
+fSupport(0),
+fMaxWeight(weight),
+fGridMin(0),
+fGridStep(0)
+{
+   switch (kde->fKernelType) {
+      case kGaussian :
+         fSupport = 9.;
+         break;
+      case kEpanechnikov :
+      case kBiweight :
+      case kCosineArch :
+         fSupport = 1.;
+         break;
+      default:
+         return;
+   }
+   // sort the data, to sum only the data points in the support of the kernel
+   fOrder.resize(fNWeights);
+   std::iota(fOrder.begin(), fOrder.end(), 0);
+   const std::vector<Double_t> & data = kde->fData;
+   std::stable_sort(fOrder.begin(), fOrder.end(), [&](UInt_t i, UInt_t j) { return data[i] < data[j]; });
+   fSortedData.resize(fNWeights);
+   for (UInt_t k = 0; k < fNWeights; ++k)
+      fSortedData[k] = data[fOrder[k]];
+}
 
 void TKDE::TKernel::ComputeAdaptiveWeights() {
    // Gets the adaptive weights (bandwidths) for TKernel internal computation
@@ -704,11 +805,19 @@ void TKDE::TKernel::ComputeAdaptiveWeights() {
    unsigned int n = fKDE->fData.size();
    assert( n == weights.size() );
    bool useDataWeights = (fKDE->fBinCount.size() == n); 
+   // the estimate at the data points with the fixed weights
+   std::vector<Double_t> values(n);
+   ForEachBlock(n, IsThreadSafe(), [&](UInt_t begin, UInt_t end) {
+      for (UInt_t i = begin; i < end; ++i) {
+         if (useDataWeights && fKDE->fBinCount[i] <= 0) continue;
+         values[i] = Evaluate(fKDE->fData[i]);
+      }
+   });
    Double_t f = 0.0;
    for (unsigned int i = 0; i < n; ++i) { 
 //   for (; weight != weights.end(); ++weight, ++data, ++dataW) {
       if (useDataWeights && fKDE->fBinCount[i] <= 0) continue;  // skip negative or null weights
-      f = (*fKDE->fKernel)(fKDE->fData[i]);
+      f = values[i];
       if (f <= 0)
          fKDE->Warning("ComputeAdativeWeights","function value is zero or negative for x = %f w = %f",
                        fKDE->fData[i],(useDataWeights) ? fKDE->fBinCount[i] : 1.);
@@ -720,6 +829,18 @@ void TKDE::TKernel::ComputeAdaptiveWeights() {
    fKDE->fAdaptiveBandwidthFactor = fKDE->fUseMirroring ? kAPPROX_GEO_MEAN / fKDE->fSigmaRob : std::sqrt(std::exp(fKDE->fAdaptiveBandwidthFactor / fKDE->fData.size()));
    transform(weights.begin(), weights.end(), fWeights.begin(), std::bind2nd(std::multiplies<Double_t>(), fKDE->fAdaptiveBandwidthFactor));
    //printf("adaptive bandwidth factor % f weight 0 %f , %f \n",fKDE->fAdaptiveBandwidthFactor, weights[0],fWeights[0] );
+   fMaxWeight = *std::max_element(fWeights.begin(), fWeights.end());
+}
+
+void TKDE::TKernel::ComputeGrid(UInt_t npoints, Double_t xMin, Double_t xMax) {
+   // Computes the estimate at npoints equidistant points in [xMin, xMax]
+   fGrid.assign(npoints, 0.0);
+   fGridMin = xMin;
+   fGridStep = (xMax - xMin) / (npoints - 1);
+   ForEachBlock(npoints, IsThreadSafe(), [&](UInt_t begin, UInt_t end) {
+      for (UInt_t i = begin; i < end; ++i)
+         fGrid[i] = Evaluate(fGridMin + i * fGridStep);
+   });
 }
 
 Double_t TKDE::TKernel::GetWeight(Double_t x) const {
@@ -903,40 +1024,56 @@ const std::vector<Double_t> & TKDE::TKernel::GetAdaptiveWeights() const {
 }
 
 Double_t TKDE::TKernel::operator()(Double_t x) const {
-   // The internal class's unary function: returns the kernel density estimate
-   Double_t result(0.0);
+   // The internal class's unary function: returns the kernel density estimate,
+   // interpolated from the grid if it is used
+   if (!fGrid.empty()) {
+      Double_t u = (x - fGridMin) / fGridStep;
+      if (u >= 0 && u <= fGrid.size() - 1) {
+         UInt_t i = std::min(UInt_t(u), UInt_t(fGrid.size() - 2));
+         u -= i;
+         return (1. - u) * fGrid[i] + u * fGrid[i + 1];
+      }
+   }
+   return Evaluate(x);
+}
+
+Double_t TKDE::TKernel::Evaluate(Double_t x) const {
+   // Returns the kernel density estimate at x, summing only over the data
+   // in the support of the kernel when it is known
    UInt_t n = fKDE->fData.size();
    // case of bins or weighted data 
    Bool_t useBins = (fKDE->fBinCount.size() == n);
    Double_t nSum = (useBins) ? fKDE->fSumOfCounts : fKDE->fNEvents;
-   // double dmin = 1.E10;
-   // double xmin,bmin,wmin; 
-   for (UInt_t i = 0; i < n; ++i) {
-      Double_t binCount = (useBins) ? fKDE->fBinCount[i] : 1.0;
-      //printf("data point %i  %f  count %f weight % f result % f\n",i,fKDE->fData[i],binCount,fWeights[i], result);
-      result += binCount / fWeights[i] * (*fKDE->fKernelFunction)((x - fKDE->fData[i]) / fWeights[i]);
-      if (fKDE->fAsymLeft) {
-         result -= binCount / fWeights[i] * (*fKDE->fKernelFunction)((x - (2. * fKDE->fXMin - fKDE->fData[i])) / fWeights[i]);
+   // sum of the kernels centred at the data points d, or at the mirrored
+   // points 2 * c - d if reflect is true
+   auto sum = [&](Double_t c, Bool_t reflect) {
+      UInt_t first = 0;
+      UInt_t last = n;
+      if (!fOrder.empty()) {
+         // only the points with |x - d| <= fSupport * fMaxWeight contribute
+         Double_t xd = reflect ? 2. * c - x : x;
+         Double_t h = fSupport * fMaxWeight;
+         first = std::lower_bound(fSortedData.begin(), fSortedData.end(), xd - h) - fSortedData.begin();
+         last = std::upper_bound(fSortedData.begin(), fSortedData.end(), xd + h) - fSortedData.begin();
       }
-      if (fKDE->fAsymRight) {
-         result -= binCount / fWeights[i] * (*fKDE->fKernelFunction)((x - (2. * fKDE->fXMax - fKDE->fData[i])) / fWeights[i]);
+      Double_t s = 0;
+      for (UInt_t k = first; k < last; ++k) {
+         UInt_t i = fOrder.empty() ? k : fOrder[k];
+         Double_t binCount = (useBins) ? fKDE->fBinCount[i] : 1.0;
+         Double_t d = reflect ? 2. * c - fKDE->fData[i] : fKDE->fData[i];
+         s += binCount / fWeights[i] * (*fKDE->fKernelFunction)((x - d) / fWeights[i]);
       }
-      // if ( TMath::IsNaN(result) ) {
-      //    printf("event %i count %f  weight %f  data % f x %f \n",i,binCount,fWeights[i],fKDE->fData[i],x );
-      // }
-      // if ( result <= 0 ) {
-      //    printf("event %i count %f  weight %f  data % f x %f \n",i,binCount,fWeights[i],fKDE->fData[i],x );
-      // }
-      // if (std::abs(x -  fKDE->fData[i]) < dmin ) {
-      //    xmin = x;
-      //    bmin = binCount;
-      //    wmin = fWeights[i];
-      //    dmin = std::abs(x -  fKDE->fData[i]);
-      // }
+      return s;
+   };
+   Double_t result = sum(0., kFALSE);
+   if (fKDE->fAsymLeft) {
+      result -= sum(fKDE->fXMin, kTRUE);
+   }
+   if (fKDE->fAsymRight) {
+      result -= sum(fKDE->fXMax, kTRUE);
    }
    if ( TMath::IsNaN(result) ) {
       fKDE->Warning("operator()","Result is NaN for  x %f \n",x);
-    //xmin % f , %f, %f \n",result,x,xmin,bmin,wmin );
    }
    return result / nSum;
 }
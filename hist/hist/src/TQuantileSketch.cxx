@@ -0,0 +1,466 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TQuantileSketch.h"
+
+#include "TBuffer.h"
+#include "TCollection.h"
+#include "TMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+ClassImp(TQuantileSketch);
+
+/** \class TQuantileSketch
+    \ingroup Hist
+ Mergeable sketch of the distribution of a stream of values, for the
+ estimation of its quantiles (median, percentiles, ...) with a bounded
+ amount of memory.
+
+ The values are summarised by a merging t-digest (T. Dunning, "Computing
+ extremely accurate quantiles using t-digests"): a list of centroids (mean
+ and weight of a group of adjacent values), whose weights are limited by a
+ scale function so that the centroids are small close to the tails of the
+ distribution and larger around the median. The number of centroids, hence
+ the memory used, is of the order of the compression parameter given to the
+ constructor (200 by default) and does not depend on the number of entries.
+ The error on the probability of the estimated quantiles is smallest for
+ the extreme quantiles and is typically below 1e-3 for the default
+ compression; the minimum and maximum values, the number of entries, the
+ sum of weights and the mean are preserved exactly.
+
+ Compared to TH1::GetQuantiles no binning has to be chosen in advance, and
+ compared to TH1K the points are not kept.
+
+ The values are first collected in a buffer, which is merged into the
+ centroids when full and before the sketch is queried or written.
+ Sketches filled separately (e.g. by different threads, jobs or
+ TDataFrame slots) are combined with Add() or Merge(), which makes the
+ class usable with TThreadedObject, TDataFrame::Fill and hadd:
+ ~~~ {.cpp}
+ TQuantileSketch s("s", "sketch of x");
+ for (auto x : values)
+    s.Fill(x);
+ Double_t probs[3] = {0.05, 0.5, 0.95};
+ Double_t q[3];
+ s.GetQuantiles(3, q, probs);
+
+ auto sd = tdf.Fill<double>(TQuantileSketch("sd", "sketch of x"), {"x"});
+ std::cout << sd->GetMedian() << std::endl;
+ ~~~
+ The query methods merge the buffer in the centroids, so they must not be
+ called concurrently with each other or with Fill() on the same object.
+*/
+
+namespace {
+
+// Number of values buffered before being merged in the centroids, per unit
+// of compression.
+const Int_t kBufferFactor = 5;
+
+// Largest quantile up to which a centroid starting at quantile q may
+// extend, for the k1 scale function k(q) = compression / (2 pi) * asin(2q - 1).
+Double_t QuantileLimit(Double_t q, Double_t compression)
+{
+   const Double_t angle = std::asin(2 * q - 1) + 2 * TMath::Pi() / compression;
+   return angle >= TMath::PiOver2() ? 1. : (std::sin(angle) + 1) / 2;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Default constructor, for I/O.
+
+TQuantileSketch::TQuantileSketch()
+   : fCompression(200), fEntries(0), fTotalWeight(0), fXmin(0), fXmax(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+///
+/// \param name, title name and title of the sketch
+/// \param compression the number of centroids is of the order of compression.
+///        Larger values give more accurate quantiles and use more memory.
+
+TQuantileSketch::TQuantileSketch(const char *name, const char *title, Double_t compression)
+   : TNamed(name, title), fCompression(compression), fEntries(0), fTotalWeight(0), fXmin(0), fXmax(0)
+{
+   if (fCompression < 10) {
+      Warning("TQuantileSketch", "compression %g is too small, set to 10", compression);
+      fCompression = 10;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor.
+
+TQuantileSketch::TQuantileSketch(const TQuantileSketch &other)
+   : TNamed(), fCompression(200), fEntries(0), fTotalWeight(0), fXmin(0), fXmax(0)
+{
+   other.Copy(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Assignment operator.
+
+TQuantileSketch &TQuantileSketch::operator=(const TQuantileSketch &other)
+{
+   if (this != &other)
+      other.Copy(*this);
+   return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TQuantileSketch::~TQuantileSketch()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the values summarised by other to this sketch.
+/// The result is the same (within the accuracy of the sketch) as if the
+/// values had been filled in this sketch.
+
+Bool_t TQuantileSketch::Add(const TQuantileSketch *other)
+{
+   if (!other)
+      return kFALSE;
+   if (other == this) {
+      // The buffers would be appended to themselves
+      const TQuantileSketch copy(*this);
+      return Add(&copy);
+   }
+   if (other->fTotalWeight > 0) {
+      if (fTotalWeight == 0) {
+         fXmin = other->fXmin;
+         fXmax = other->fXmax;
+      } else {
+         fXmin = std::min(fXmin, other->fXmin);
+         fXmax = std::max(fXmax, other->fXmax);
+      }
+      fBufferX.insert(fBufferX.end(), other->fMeans.begin(), other->fMeans.end());
+      fBufferW.insert(fBufferW.end(), other->fWeights.begin(), other->fWeights.end());
+      fBufferX.insert(fBufferX.end(), other->fBufferX.begin(), other->fBufferX.end());
+      fBufferW.insert(fBufferW.end(), other->fBufferW.begin(), other->fBufferW.end());
+      fTotalWeight += other->fTotalWeight;
+   }
+   fEntries += other->fEntries;
+   Flush();
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the sorted centroids (means, weights) into fMeans and fWeights,
+/// combining adjacent centroids as long as their weight stays within the
+/// limit given by the scale function.
+
+void TQuantileSketch::Compress(std::vector<Double_t> &means, std::vector<Double_t> &weights)
+{
+   fMeans.clear();
+   fWeights.clear();
+   if (means.empty())
+      return;
+
+   Double_t total = 0;
+   for (auto w : weights)
+      total += w;
+
+   Double_t sumW = 0;
+   Double_t curMean = means[0];
+   Double_t curW = weights[0];
+   Double_t limitW = total * QuantileLimit(0., fCompression);
+   for (size_t i = 1; i < means.size(); ++i) {
+      if (sumW + curW + weights[i] <= limitW) {
+         curW += weights[i];
+         curMean += (means[i] - curMean) * weights[i] / curW;
+      } else {
+         sumW += curW;
+         fMeans.push_back(curMean);
+         fWeights.push_back(curW);
+         limitW = total * QuantileLimit(std::min(sumW / total, 1.), fCompression);
+         curMean = means[i];
+         curW = weights[i];
+      }
+   }
+   fMeans.push_back(curMean);
+   fWeights.push_back(curW);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy this sketch to obj.
+
+void TQuantileSketch::Copy(TObject &obj) const
+{
+   TNamed::Copy(obj);
+   TQuantileSketch &s = (TQuantileSketch &)obj;
+   s.fCompression = fCompression;
+   s.fEntries = fEntries;
+   s.fTotalWeight = fTotalWeight;
+   s.fXmin = fXmin;
+   s.fXmax = fXmax;
+   s.fMeans = fMeans;
+   s.fWeights = fWeights;
+   s.fBufferX = fBufferX;
+   s.fBufferW = fBufferW;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the value x with weight 1.
+
+Int_t TQuantileSketch::Fill(Double_t x)
+{
+   return Fill(x, 1.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the value x with weight w.
+/// Values which are not a number and non-positive weights are ignored, in
+/// which case -1 is returned.
+
+Int_t TQuantileSketch::Fill(Double_t x, Double_t w)
+{
+   if (!(w > 0) || std::isnan(x))
+      return -1;
+   if (fTotalWeight == 0) {
+      fXmin = x;
+      fXmax = x;
+   } else if (x < fXmin) {
+      fXmin = x;
+   } else if (x > fXmax) {
+      fXmax = x;
+   }
+   fBufferX.push_back(x);
+   fBufferW.push_back(w);
+   fTotalWeight += w;
+   ++fEntries;
+   if (fBufferX.size() >= (size_t)(kBufferFactor * fCompression))
+      Flush();
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the n values x[i*stride] with the weights w[i*stride]
+/// (or 1 if w is null).
+
+void TQuantileSketch::FillN(Int_t n, const Double_t *x, const Double_t *w, Int_t stride)
+{
+   for (Int_t i = 0; i < n; ++i)
+      Fill(x[i * stride], w ? w[i * stride] : 1.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the buffered values in the centroids.
+
+void TQuantileSketch::Flush()
+{
+   if (fBufferX.empty())
+      return;
+
+   std::vector<std::pair<Double_t, Double_t>> buffer(fBufferX.size());
+   for (size_t i = 0; i < fBufferX.size(); ++i)
+      buffer[i] = std::make_pair(fBufferX[i], fBufferW[i]);
+   std::sort(buffer.begin(), buffer.end());
+   fBufferX.clear();
+   fBufferW.clear();
+
+   // merge the sorted buffer with the centroids, which are sorted already
+   std::vector<Double_t> means, weights;
+   means.reserve(fMeans.size() + buffer.size());
+   weights.reserve(fMeans.size() + buffer.size());
+   size_t ic = 0;
+   for (auto &point : buffer) {
+      while (ic < fMeans.size() && fMeans[ic] <= point.first) {
+         means.push_back(fMeans[ic]);
+         weights.push_back(fWeights[ic]);
+         ++ic;
+      }
+      means.push_back(point.first);
+      weights.push_back(point.second);
+   }
+   means.insert(means.end(), fMeans.begin() + ic, fMeans.end());
+   weights.insert(weights.end(), fWeights.begin() + ic, fWeights.end());
+
+   Compress(means, weights);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the estimated fraction of the total weight of the values smaller
+/// than x.
+
+Double_t TQuantileSketch::GetCDF(Double_t x) const
+{
+   const_cast<TQuantileSketch *>(this)->Flush();
+   if (fMeans.empty() || x < fXmin)
+      return 0;
+   if (x >= fXmax)
+      return 1;
+
+   const size_t n = fMeans.size();
+   // the values of a centroid are taken to be spread around its mean, so the
+   // cumulative weight at the mean of centroid i is the weight of the
+   // centroids before it plus half of its own weight
+   if (x < fMeans[0])
+      return (fMeans[0] > fXmin ? (x - fXmin) / (fMeans[0] - fXmin) : 1.) * fWeights[0] / 2 / fTotalWeight;
+   Double_t sumW = fWeights[0] / 2;
+   for (size_t i = 0; i + 1 < n; ++i) {
+      const Double_t dw = (fWeights[i] + fWeights[i + 1]) / 2;
+      if (x < fMeans[i + 1])
+         return (sumW + dw * (x - fMeans[i]) / (fMeans[i + 1] - fMeans[i])) / fTotalWeight;
+      sumW += dw;
+   }
+   const Double_t tail = (fXmax > fMeans[n - 1]) ? (x - fMeans[n - 1]) / (fXmax - fMeans[n - 1]) : 0.;
+   return (sumW + tail * fWeights[n - 1] / 2) / fTotalWeight;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the weighted mean of the values.
+
+Double_t TQuantileSketch::GetMean() const
+{
+   const_cast<TQuantileSketch *>(this)->Flush();
+   if (fTotalWeight == 0)
+      return 0;
+   Double_t sum = 0;
+   for (size_t i = 0; i < fMeans.size(); ++i)
+      sum += fMeans[i] * fWeights[i];
+   return sum / fTotalWeight;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the current number of centroids.
+
+Int_t TQuantileSketch::GetNCentroids() const
+{
+   const_cast<TQuantileSketch *>(this)->Flush();
+   return fMeans.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the estimated quantile for the probability prob, i.e. the value x
+/// such that a fraction prob of the total weight is in values smaller than x.
+/// Return 0 if the sketch is empty.
+
+Double_t TQuantileSketch::GetQuantile(Double_t prob) const
+{
+   const_cast<TQuantileSketch *>(this)->Flush();
+   if (fMeans.empty())
+      return 0;
+   if (prob <= 0)
+      return fXmin;
+   if (prob >= 1)
+      return fXmax;
+
+   const size_t n = fMeans.size();
+   const Double_t target = prob * fTotalWeight;
+   // interpolate linearly between the centroid means, placed at their
+   // cumulative weight (see GetCDF()), and the minimum and maximum values
+   Double_t sumW = fWeights[0] / 2;
+   if (target < sumW)
+      return fXmin + (fMeans[0] - fXmin) * target / sumW;
+   for (size_t i = 0; i + 1 < n; ++i) {
+      const Double_t dw = (fWeights[i] + fWeights[i + 1]) / 2;
+      if (target < sumW + dw)
+         return fMeans[i] + (fMeans[i + 1] - fMeans[i]) * (target - sumW) / dw;
+      sumW += dw;
+   }
+   const Double_t tail = fTotalWeight - sumW;
+   return fMeans[n - 1] + (fXmax - fMeans[n - 1]) * std::min((target - sumW) / tail, 1.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the quantiles q[i] for the nprobSum probabilities probSum[i],
+/// as TH1::GetQuantiles() does. If probSum is null, the quantiles for the
+/// probabilities (i+1)/nprobSum are computed.
+/// Return the number of quantiles computed.
+
+Int_t TQuantileSketch::GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum) const
+{
+   for (Int_t i = 0; i < nprobSum; ++i)
+      q[i] = GetQuantile(probSum ? probSum[i] : Double_t(i + 1) / nprobSum);
+   return nprobSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add all the TQuantileSketch objects in list to this one.
+/// Used by TThreadedObject, TDataFrame and hadd.
+/// Return the number of entries of the merged sketch, or -1 in case of error.
+
+Long64_t TQuantileSketch::Merge(TCollection *list)
+{
+   if (!list)
+      return 0;
+   TIter next(list);
+   while (TObject *obj = next()) {
+      if (obj == this)
+         continue;
+      const TQuantileSketch *other = dynamic_cast<const TQuantileSketch *>(obj);
+      if (!other) {
+         Error("Merge", "Attempt to merge object of class %s to a %s", obj->ClassName(), ClassName());
+         return -1;
+      }
+      Add(other);
+   }
+   return fEntries;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print a summary of the sketch. With option "all", print the centroids.
+
+void TQuantileSketch::Print(Option_t *option) const
+{
+   std::cout << "TQuantileSketch " << GetName() << " : " << GetTitle() << std::endl;
+   std::cout << "   entries = " << fEntries << ", sum of weights = " << fTotalWeight
+             << ", centroids = " << GetNCentroids() << ", compression = " << fCompression << std::endl;
+   if (fEntries == 0)
+      return;
+   std::cout << "   min = " << fXmin << ", median = " << GetMedian() << ", max = " << fXmax << std::endl;
+   TString opt = option;
+   opt.ToLower();
+   if (opt.Contains("all")) {
+      for (size_t i = 0; i < fMeans.size(); ++i)
+         std::cout << "   centroid " << i << " : mean = " << fMeans[i] << " weight = " << fWeights[i] << std::endl;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all the values.
+
+void TQuantileSketch::Reset(Option_t *)
+{
+   fEntries = 0;
+   fTotalWeight = 0;
+   fXmin = 0;
+   fXmax = 0;
+   fMeans.clear();
+   fWeights.clear();
+   fBufferX.clear();
+   fBufferW.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream an object of class TQuantileSketch.
+/// The buffered values are merged in the centroids before writing.
+
+void TQuantileSketch::Streamer(TBuffer &b)
+{
+   if (b.IsReading()) {
+      fBufferX.clear();
+      fBufferW.clear();
+      b.ReadClassBuffer(TQuantileSketch::Class(), this);
+   } else {
+      Flush();
+      b.WriteClassBuffer(TQuantileSketch::Class(), this);
+   }
+}
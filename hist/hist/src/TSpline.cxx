@@ -112,6 +112,16 @@ Int_t TSpline::DistancetoPrimitive(Int_t px, Int_t py)
    return fHistogram->DistancetoPrimitive(px, py);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the spline at the n points x, and store the values in y.
+/// The default implementation calls Eval(x[i]) for each point.
+
+void TSpline::Eval(Int_t n, const Double_t *x, Double_t *y) const
+{
+   for (Int_t i = 0; i < n; ++i)
+      y[i] = Eval(x[i]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
 
@@ -786,6 +796,53 @@ Double_t TSpline3::Eval(Double_t x) const
    return fPoly[klow].Eval(x);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Eval this spline at the n points x, and store the values in y.
+///
+/// The result is the same as calling Eval(x[i]) for each point, but the
+/// knot search uses the previous point as a starting guess: when the x are
+/// increasing (e.g. sorted inputs) the knots are found by walking forward
+/// from the previous one, instead of a binary search per point. The points
+/// are processed by blocks, first locating the knots and then evaluating
+/// the polynomials in a separate loop without branches.
+
+void TSpline3::Eval(Int_t n, const Double_t *x, Double_t *y) const
+{
+   const Int_t kBlockSize = 256;
+   // maximum number of knots to walk over before using a binary search
+   const Int_t kMaxWalk = 8;
+   Int_t klow[kBlockSize];
+   // knot found for the previous point, i.e. FindX(x[i-1])
+   Int_t k = -1;
+   for (Int_t begin = 0; begin < n; begin += kBlockSize) {
+      const Int_t nb = TMath::Min(kBlockSize, n - begin);
+      const Double_t *xb = x + begin;
+      for (Int_t i = 0; i < nb; ++i) {
+         const Double_t xi = xb[i];
+         // for x inside the knots FindX() returns the knot klow such that
+         // x(klow) < x <= x(klow+1), which can be reached from any knot
+         // below x. With equidistant knots FindX() does not search.
+         if (!fKstep && k >= 0 && k < fNp - 1 && xi > fXmin && xi < fXmax && fPoly[k].X() < xi) {
+            Int_t nwalk = 0;
+            while (k < fNp - 2 && xi > fPoly[k + 1].X() && nwalk < kMaxWalk) {
+               ++k;
+               ++nwalk;
+            }
+            if (xi > fPoly[k + 1].X())
+               k = FindX(xi);
+         } else {
+            k = FindX(xi);
+         }
+         klow[i] = (k >= fNp - 1 && fNp > 1) ? fNp - 2 : k;
+      }
+      for (Int_t i = 0; i < nb; ++i) {
+         TSplinePoly3 &poly = fPoly[klow[i]];
+         const Double_t dx = xb[i] - poly.X();
+         y[begin + i] = poly.Y() + dx * (poly.B() + dx * (poly.C() + dx * poly.D()));
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Derivative.
 
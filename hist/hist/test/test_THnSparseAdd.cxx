@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include "THnSparse.h"
+#include "TList.h"
+#include "TROOT.h"
+#include "TRandom3.h"
+
+#include <memory>
+
+namespace {
+
+// A 5-dimensional sparse histogram with compact coordinates longer than
+// 8 bytes, so that hashes can collide. Each axis is filled at 8 values only,
+// so that histograms created with different seeds share most of their bins.
+THnSparseD *MakeSparse(const char *name, UInt_t seed, Int_t nfill)
+{
+   Int_t bins[5] = {100000, 100000, 100000, 1000, 300};
+   Double_t xmin[5] = {0., 0., 0., 0., 0.};
+   Double_t xmax[5] = {1., 1., 1., 1., 1.};
+   THnSparseD *h = new THnSparseD(name, "", 5, bins, xmin, xmax, 1024);
+   h->Sumw2();
+   TRandom3 rnd(seed);
+   Double_t x[5];
+   for (Int_t i = 0; i < nfill; ++i) {
+      for (Int_t d = 0; d < 5; ++d)
+         x[d] = (rnd.Integer(8) + 0.5) / 8;
+      h->Fill(x, 0.5 * (1 + rnd.Integer(4)));
+   }
+   return h;
+}
+
+void ExpectSameBins(const THnSparse &ref, const THnSparse &h)
+{
+   ASSERT_EQ(ref.GetNbins(), h.GetNbins());
+   Int_t coord[5];
+   for (Long64_t i = 0; i < ref.GetNbins(); ++i) {
+      const Double_t v = ref.GetBinContent(i, coord);
+      const Long64_t bin = h.GetBin(coord);
+      ASSERT_GE(bin, 0) << "bin " << i;
+      EXPECT_DOUBLE_EQ(v, h.GetBinContent(bin)) << "bin " << i;
+      EXPECT_DOUBLE_EQ(ref.GetBinError2(i), h.GetBinError2(bin)) << "bin " << i;
+   }
+   EXPECT_DOUBLE_EQ(ref.GetEntries(), h.GetEntries());
+}
+
+void CheckAddAndMerge()
+{
+   std::unique_ptr<THnSparseD> h1(MakeSparse("h1", 1, 50000));
+   std::unique_ptr<THnSparseD> h2(MakeSparse("h2", 2, 50000));
+   std::unique_ptr<THnSparseD> h3(MakeSparse("h3", 3, 20000));
+
+   // RebinnedAdd() always takes the bin by bin path.
+   std::unique_ptr<THnSparseD> ref(MakeSparse("ref", 1, 50000));
+   ref->RebinnedAdd(h2.get(), 2.);
+   std::unique_ptr<THnSparseD> sum(MakeSparse("sum", 1, 50000));
+   sum->Add(h2.get(), 2.);
+   ExpectSameBins(*ref, *sum);
+
+   // Adding bins that are all present already, then to an empty histogram.
+   ref->RebinnedAdd(h1.get());
+   sum->Add(h1.get());
+   ExpectSameBins(*ref, *sum);
+   std::unique_ptr<THnSparse> empty(static_cast<THnSparse *>(h1->Clone("empty")));
+   empty->Reset();
+   empty->Add(h1.get());
+   ExpectSameBins(*h1, *empty);
+
+   ref->RebinnedAdd(h3.get());
+   TList list;
+   list.Add(h3.get());
+   sum->Merge(&list);
+   ExpectSameBins(*ref, *sum);
+}
+
+} // namespace
+
+TEST(THnSparse, Add)
+{
+   CheckAddAndMerge();
+}
+
+#ifdef R__USE_IMT
+TEST(THnSparse, AddImplicitMT)
+{
+   ROOT::EnableImplicitMT(4);
+   CheckAddAndMerge();
+   ROOT::DisableImplicitMT();
+}
+#endif
@@ -0,0 +1,190 @@
+#include "gtest/gtest.h"
+
+#include "TH1.h"
+#include "TH2.h"
+#include "THn.h"
+#include "TBufferFile.h"
+#include "TRandom3.h"
+
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const Int_t kNThreads = 4;
+const Int_t kNPerThread = 20000;
+
+// Points filled by one thread; weights are multiples of 1/4 so that sums of
+// weights do not depend on the order of the additions.
+struct Points {
+   std::vector<Double_t> x, y, w;
+   Points(UInt_t seed)
+   {
+      TRandom3 rnd(seed);
+      for (Int_t i = 0; i < kNPerThread; ++i) {
+         x.push_back(rnd.Uniform(-1.2, 1.2));
+         y.push_back(rnd.Gaus(0, 0.6));
+         w.push_back(0.25 * (1 + rnd.Integer(8)));
+      }
+   }
+};
+
+std::vector<Points> MakePoints()
+{
+   std::vector<Points> points;
+   for (Int_t t = 0; t < kNThreads; ++t)
+      points.emplace_back(t + 1);
+   return points;
+}
+
+template <typename F>
+void RunThreads(F &&fill)
+{
+   std::vector<std::thread> threads;
+   for (Int_t t = 0; t < kNThreads; ++t)
+      threads.emplace_back(fill, t);
+   for (auto &thread : threads)
+      thread.join();
+}
+
+void ExpectSameStats(const TH1 &h1, const TH1 &h2)
+{
+   Double_t s1[TH1::kNstat] = {0}, s2[TH1::kNstat] = {0};
+   h1.GetStats(s1);
+   h2.GetStats(s2);
+   for (Int_t i = 0; i < 7; ++i)
+      EXPECT_NEAR(s1[i], s2[i], 1e-9 * (1 + std::abs(s1[i]))) << "stat " << i;
+   EXPECT_DOUBLE_EQ(h1.GetEntries(), h2.GetEntries());
+}
+
+} // namespace
+
+TEST(ConcurrentFill, TH1D)
+{
+   const std::vector<Points> points = MakePoints();
+   TH1D ref("ref", "", 100, -1., 1.);
+   TH1D h("h", "", 100, -1., 1.);
+   h.SetConcurrentFill();
+   EXPECT_TRUE(h.IsConcurrentFill());
+
+   for (auto &p : points)
+      for (Int_t i = 0; i < kNPerThread; ++i)
+         ref.Fill(p.x[i], p.w[i]);
+   RunThreads([&](Int_t t) {
+      for (Int_t i = 0; i < kNPerThread; ++i)
+         h.Fill(points[t].x[i], points[t].w[i]);
+   });
+
+   // The statistics are folded in when read, with the mode still active.
+   EXPECT_DOUBLE_EQ(ref.GetEntries(), h.GetEntries());
+   h.SetConcurrentFill(kFALSE);
+   EXPECT_FALSE(h.IsConcurrentFill());
+   for (Int_t bin = 0; bin < ref.GetNcells(); ++bin) {
+      EXPECT_DOUBLE_EQ(ref.GetBinContent(bin), h.GetBinContent(bin)) << "bin " << bin;
+      EXPECT_DOUBLE_EQ(ref.GetBinError(bin), h.GetBinError(bin)) << "bin " << bin;
+   }
+   ExpectSameStats(ref, h);
+}
+
+TEST(ConcurrentFill, TH2F)
+{
+   const std::vector<Points> points = MakePoints();
+   TH2F ref("ref2", "", 20, -1., 1., 30, -1., 1.);
+   TH2F h("h2", "", 20, -1., 1., 30, -1., 1.);
+   h.SetConcurrentFill();
+
+   for (auto &p : points)
+      ref.FillN(kNPerThread, p.x.data(), p.y.data(), nullptr);
+   RunThreads([&](Int_t t) { h.FillN(kNPerThread, points[t].x.data(), points[t].y.data(), nullptr); });
+
+   for (Int_t bin = 0; bin < ref.GetNcells(); ++bin)
+      EXPECT_FLOAT_EQ(ref.GetBinContent(bin), h.GetBinContent(bin)) << "bin " << bin;
+   ExpectSameStats(ref, h);
+}
+
+TEST(ConcurrentFill, THnD)
+{
+   const std::vector<Points> points = MakePoints();
+   Int_t nbins[2] = {20, 30};
+   Double_t xmin[2] = {-1., -1.};
+   Double_t xmax[2] = {1., 1.};
+   THnD ref("refn", "", 2, nbins, xmin, xmax);
+   THnD h("hn", "", 2, nbins, xmin, xmax);
+   ref.Sumw2();
+   h.Sumw2();
+   h.SetConcurrentFill();
+   EXPECT_TRUE(h.IsConcurrentFill());
+
+   for (auto &p : points)
+      for (Int_t i = 0; i < kNPerThread; ++i) {
+         Double_t x[2] = {p.x[i], p.y[i]};
+         ref.Fill(x, p.w[i]);
+      }
+   RunThreads([&](Int_t t) {
+      for (Int_t i = 0; i < kNPerThread; ++i) {
+         Double_t x[2] = {points[t].x[i], points[t].y[i]};
+         h.Fill(x, points[t].w[i]);
+      }
+   });
+   h.SetConcurrentFill(kFALSE);
+
+   for (Long64_t bin = 0; bin < ref.GetNbins(); ++bin) {
+      EXPECT_DOUBLE_EQ(ref.GetBinContent(bin), h.GetBinContent(bin)) << "bin " << bin;
+      EXPECT_DOUBLE_EQ(ref.GetBinError2(bin), h.GetBinError2(bin)) << "bin " << bin;
+   }
+   EXPECT_DOUBLE_EQ(ref.GetEntries(), h.GetEntries());
+   EXPECT_DOUBLE_EQ(ref.GetSumw(), h.GetSumw());
+   EXPECT_DOUBLE_EQ(ref.GetSumw2(), h.GetSumw2());
+   for (Int_t d = 0; d < 2; ++d) {
+      EXPECT_NEAR(ref.GetSumwx(d), h.GetSumwx(d), 1e-9 * (1 + std::abs(ref.GetSumwx(d))));
+      EXPECT_NEAR(ref.GetSumwx2(d), h.GetSumwx2(d), 1e-9 * (1 + std::abs(ref.GetSumwx2(d))));
+   }
+}
+
+TEST(ConcurrentFill, Streamer)
+{
+   const std::vector<Points> points = MakePoints();
+   TH1D h("hs", "", 100, -1., 1.);
+   Int_t nbins[1] = {100};
+   Double_t xmin[1] = {-1.};
+   Double_t xmax[1] = {1.};
+   THnD hn("hns", "", 1, nbins, xmin, xmax);
+   h.SetConcurrentFill();
+   hn.SetConcurrentFill();
+   RunThreads([&](Int_t t) {
+      for (Int_t i = 0; i < kNPerThread; ++i) {
+         h.Fill(points[t].x[i]);
+         hn.Fill(&points[t].x[i]);
+      }
+   });
+
+   // The statistics of the threads are written, with the mode still active.
+   TBufferFile buf(TBuffer::kWrite);
+   buf.WriteObject(&h);
+   buf.WriteObject(&hn);
+   buf.SetReadMode();
+   buf.SetBufferOffset(0);
+   std::unique_ptr<TH1D> hread((TH1D *)buf.ReadObject(TH1D::Class()));
+   std::unique_ptr<THnD> hnread((THnD *)buf.ReadObject(THnD::Class()));
+   ASSERT_TRUE(hread && hnread);
+   EXPECT_FALSE(hread->IsConcurrentFill());
+   EXPECT_DOUBLE_EQ(hread->GetEntries(), kNThreads * kNPerThread);
+   EXPECT_DOUBLE_EQ(hnread->GetEntries(), kNThreads * kNPerThread);
+   ExpectSameStats(h, *hread);
+}
+
+TEST(ConcurrentFill, RefuseRebin)
+{
+   TH1D h("hr", "", 100, -1., 1.);
+   h.SetConcurrentFill();
+   EXPECT_EQ(h.SetCanExtend(TH1::kXaxis), (UInt_t)TH1::kNoAxis);
+   EXPECT_FALSE(h.GetXaxis()->CanExtend());
+   EXPECT_EQ(h.Rebin(2), nullptr);
+   h.SetBins(10, 0., 1.);
+   EXPECT_EQ(h.GetNbinsX(), 100);
+   h.SetConcurrentFill(kFALSE);
+   EXPECT_NE(h.Rebin(2), nullptr);
+   EXPECT_EQ(h.GetNbinsX(), 50);
+}
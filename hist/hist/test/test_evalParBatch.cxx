@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+
+#include "TF1.h"
+#include "TF2.h"
+#include "TFormula.h"
+
+#include <vector>
+
+namespace {
+
+// Compare the batch evaluation of f with the evaluation point by point.
+void ExpectSameAsEvalPar(TF1 &f, Int_t ndim, const Double_t *params)
+{
+   const Int_t n = 1000;
+   std::vector<std::vector<Double_t>> coords(ndim, std::vector<Double_t>(n));
+   std::vector<const Double_t *> x(ndim);
+   for (Int_t j = 0; j < ndim; ++j) {
+      for (Int_t i = 0; i < n; ++i)
+         coords[j][i] = -2. + 4. * i / n + 0.3 * j;
+      x[j] = coords[j].data();
+   }
+   std::vector<Double_t> result(n);
+   f.EvalParBatch(x.data(), n, result.data(), params);
+
+   Double_t point[2];
+   for (Int_t i = 0; i < n; ++i) {
+      for (Int_t j = 0; j < ndim; ++j)
+         point[j] = coords[j][i];
+      EXPECT_DOUBLE_EQ(f.EvalPar(point, params), result[i]) << "point " << i;
+   }
+}
+
+} // namespace
+
+TEST(EvalParBatch, Formula)
+{
+   TF1 f1("f1", "gaus(0) + [3]*x*x", -5, 5);
+   f1.SetParameters(2., 0.5, 0.8, 0.1);
+   ExpectSameAsEvalPar(f1, 1, nullptr);
+   const Double_t params[4] = {1., -0.2, 1.5, -0.3};
+   ExpectSameAsEvalPar(f1, 1, params);
+
+   TF2 f2("f2", "[0]*sin(x)*exp(-[1]*y*y)", -5, 5, -5, 5);
+   f2.SetParameters(3., 0.4);
+   ExpectSameAsEvalPar(f2, 2, nullptr);
+
+   // Functions without parameters.
+   TF1 f3("f3", "x*x - 1", -5, 5);
+   ExpectSameAsEvalPar(f3, 1, nullptr);
+}
+
+TEST(EvalParBatch, NonFormula)
+{
+   TF1 f("f", [](Double_t *x, Double_t *p) { return p[0] * x[0] + p[1]; }, -5, 5, 2);
+   f.SetParameters(2., -1.);
+   ExpectSameAsEvalPar(f, 1, nullptr);
+
+   TFormula lambda("lambda", "[](double *x, double *p){ return p[0]*x[0]*x[0]; }", 1, 1);
+   lambda.SetParameter(0, 3.);
+   const Double_t xs[3] = {-1., 0.5, 2.};
+   const Double_t *x[1] = {xs};
+   Double_t result[3];
+   lambda.EvalParBatch(x, 3, result);
+   for (Int_t i = 0; i < 3; ++i)
+      EXPECT_DOUBLE_EQ(3. * xs[i] * xs[i], result[i]);
+}
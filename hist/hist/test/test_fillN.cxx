@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TRandom3.h"
+
+#include <vector>
+
+namespace {
+
+// Compare the contents, errors and statistics of two histograms.
+void ExpectSameHistograms(const TH1 &h1, const TH1 &h2)
+{
+   ASSERT_EQ(h1.GetNcells(), h2.GetNcells());
+   for (Int_t bin = 0; bin < h1.GetNcells(); ++bin) {
+      EXPECT_DOUBLE_EQ(h1.GetBinContent(bin), h2.GetBinContent(bin)) << "bin " << bin;
+      EXPECT_DOUBLE_EQ(h1.GetBinError(bin), h2.GetBinError(bin)) << "bin " << bin;
+   }
+   Double_t s1[TH1::kNstat], s2[TH1::kNstat];
+   h1.GetStats(s1);
+   h2.GetStats(s2);
+   for (Int_t i = 0; i < 11; ++i)
+      EXPECT_DOUBLE_EQ(s1[i], s2[i]) << "stat " << i;
+   EXPECT_DOUBLE_EQ(h1.GetEntries(), h2.GetEntries());
+}
+
+struct Points {
+   std::vector<Double_t> x, y, z, w;
+   Points(Int_t n)
+   {
+      TRandom3 rnd(42);
+      for (Int_t i = 0; i < n; ++i) {
+         // include under- and overflows
+         x.push_back(rnd.Uniform(-1.2, 1.2));
+         y.push_back(rnd.Gaus(0, 0.6));
+         z.push_back(rnd.Uniform(-1.1, 1.1));
+         w.push_back(rnd.Uniform(0.5, 2.));
+      }
+   }
+};
+
+} // namespace
+
+TEST(FillN, TH1)
+{
+   const Int_t n = 1000;
+   Points p(n);
+   const Double_t edges[] = {-1., -0.5, -0.1, 0., 0.2, 0.7, 1.};
+
+   TH1D fixed1("fixed1", "", 20, -1, 1), fixed2("fixed2", "", 20, -1, 1);
+   TH1D var1("var1", "", 6, edges), var2("var2", "", 6, edges);
+   for (Int_t i = 0; i < n; ++i) {
+      fixed1.Fill(p.x[i], p.w[i]);
+      var1.Fill(p.x[i]);
+   }
+   fixed2.FillN(n, p.x.data(), p.w.data());
+   var2.FillN(n, p.x.data(), nullptr);
+   ExpectSameHistograms(fixed1, fixed2);
+   ExpectSameHistograms(var1, var2);
+
+   // with a stride
+   TH1D strided1("strided1", "", 20, -1, 1), strided2("strided2", "", 20, -1, 1);
+   for (Int_t i = 0; i < n; i += 2)
+      strided1.Fill(p.x[i], p.w[i]);
+   strided2.FillN(n / 2, p.x.data(), p.w.data(), 2);
+   ExpectSameHistograms(strided1, strided2);
+}
+
+TEST(FillN, TH2)
+{
+   const Int_t n = 1000;
+   Points p(n);
+   TH2D h1("h2_1", "", 10, -1, 1, 15, -1, 1), h2("h2_2", "", 10, -1, 1, 15, -1, 1);
+   for (Int_t i = 0; i < n; ++i)
+      h1.Fill(p.x[i], p.y[i], p.w[i]);
+   h2.FillN(n, p.x.data(), p.y.data(), p.w.data());
+   ExpectSameHistograms(h1, h2);
+}
+
+TEST(FillN, TH3)
+{
+   const Int_t n = 1000;
+   Points p(n);
+   TH3D h1("h3_1", "", 10, -1, 1, 8, -1, 1, 6, -1, 1), h2("h3_2", "", 10, -1, 1, 8, -1, 1, 6, -1, 1);
+   for (Int_t i = 0; i < n; ++i)
+      h1.Fill(p.x[i], p.y[i], p.z[i], p.w[i]);
+   h2.FillN(n, p.x.data(), p.y.data(), p.z.data(), p.w.data());
+   ExpectSameHistograms(h1, h2);
+
+   // extendable axes are filled point by point
+   TH3D e1("e3_1", "", 4, -0.5, 0.5, 4, -0.5, 0.5, 4, -0.5, 0.5), e2("e3_2", "", 4, -0.5, 0.5, 4, -0.5, 0.5, 4, -0.5, 0.5);
+   e1.SetCanExtend(TH1::kAllAxes);
+   e2.SetCanExtend(TH1::kAllAxes);
+   for (Int_t i = 0; i < n; ++i)
+      e1.Fill(p.x[i], p.y[i], p.z[i]);
+   e2.FillN(n, p.x.data(), p.y.data(), p.z.data(), nullptr);
+   ExpectSameHistograms(e1, e2);
+}
@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+
+#include "TF1.h"
+#include "TFormula.h"
+#include "TInterpreter.h"
+#include "TMath.h"
+#include "TString.h"
+#include "TSystem.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const char *kExpressions[] = {"[0]*exp(-0.5*((x-[1])/[2])^2)", "sin([0]*x)+[1]*x*x", "breitwigner"};
+const Double_t kParams[] = {1.5, 0.3, 0.8};
+
+// Check the values of the formulas, compiled or loaded from the cache.
+void CheckFormulas()
+{
+   TF1 f1("cache1", kExpressions[0], -5, 5);
+   TF1 f2("cache2", kExpressions[1], -5, 5);
+   TF1 f3("cache3", kExpressions[2], -5, 5);
+   f1.SetParameters(kParams);
+   f2.SetParameters(kParams);
+   f3.SetParameters(kParams);
+   for (Double_t x = -4.; x < 4.; x += 0.5) {
+      EXPECT_DOUBLE_EQ(f1.Eval(x), kParams[0] * std::exp(-0.5 * std::pow((x - kParams[1]) / kParams[2], 2)));
+      EXPECT_DOUBLE_EQ(f2.Eval(x), std::sin(kParams[0] * x) + kParams[1] * x * x);
+      EXPECT_NEAR(f3.Eval(x), kParams[0] * TMath::BreitWigner(x, kParams[1], kParams[2]), 1e-12);
+   }
+}
+
+} // namespace
+
+class FormulaCache : public ::testing::Test {
+protected:
+   TString fDir;       // directory of the cache, removed by TearDown() unless given by the parent job
+   TString fCacheFile; // macro of the cache in fDir
+   bool fOwnDir = false;
+
+   void SetUp() override
+   {
+      if (const char *dir = gSystem->Getenv("ROOT_TEST_FORMULA_CACHE")) {
+         fDir = dir;
+      } else {
+         fDir = TString::Format("%s/formulaCache_%d", gSystem->TempDirectory(), gSystem->GetPid());
+         ASSERT_EQ(gSystem->mkdir(fDir, kTRUE), 0);
+         fOwnDir = true;
+      }
+      fCacheFile = fDir + "/formulaCacheTest.C";
+   }
+
+   void TearDown() override
+   {
+      if (!fOwnDir)
+         return;
+      // The macro, the library and the files ACLiC produced next to them.
+      if (void *dirp = gSystem->OpenDirectory(fDir)) {
+         while (const char *entry = gSystem->GetDirEntry(dirp)) {
+            if (strcmp(entry, ".") && strcmp(entry, ".."))
+               gSystem->Unlink(fDir + "/" + entry);
+         }
+         gSystem->FreeDirectory(dirp);
+      }
+      gSystem->Unlink(fDir);
+   }
+};
+
+// Run by SaveAndLoad in a new process: load the cache before creating the formulas.
+TEST_F(FormulaCache, Load)
+{
+   if (fOwnDir)
+      return;
+   ASSERT_TRUE(TFormula::LoadCompiledCache(fCacheFile));
+   TString libs = gSystem->GetLibraries();
+   EXPECT_TRUE(libs.Contains("formulaCacheTest_C")) << libs;
+   CheckFormulas();
+}
+
+TEST_F(FormulaCache, SaveAndLoad)
+{
+   if (!fOwnDir)
+      return;
+   CheckFormulas();
+
+   // A formula calling a function known only to Cling is not saved.
+   gInterpreter->Declare("double formulaCacheUserFunc(double x) { return 2 * x; }");
+   TF1 user("cacheUser", "[0]*formulaCacheUserFunc(x)", -5, 5);
+   user.SetParameter(0, 3.);
+   EXPECT_DOUBLE_EQ(user.Eval(2.), 12.);
+
+   ASSERT_GE(TFormula::SaveCompiledCache(fCacheFile), (Int_t)(sizeof(kExpressions) / sizeof(kExpressions[0])));
+   std::ifstream in(fCacheFile.Data());
+   std::stringstream code;
+   code << in.rdbuf();
+   EXPECT_EQ(code.str().find("formulaCacheUserFunc"), std::string::npos);
+   EXPECT_NE(code.str().find("breitwigner_pdf"), std::string::npos);
+
+   // The library is built, but not loaded in this process.
+   TString libs = gSystem->GetLibraries();
+   EXPECT_FALSE(libs.Contains("formulaCacheTest_C")) << libs;
+
+   // The library is up to date, loading it in another job must not rebuild it.
+   TString lib = gSystem->DynamicPathName(fDir + "/formulaCacheTest_C", kTRUE);
+   ASSERT_FALSE(lib.IsNull());
+   Long_t id, flags, modtime;
+   Long64_t size;
+   gSystem->GetPathInfo(lib, &id, &size, &flags, &modtime);
+
+   const std::string self = ::testing::internal::GetArgvs()[0];
+   EXPECT_EQ(gSystem->Exec(TString::Format("ROOT_TEST_FORMULA_CACHE=%s %s --gtest_filter=FormulaCache.Load",
+                                           fDir.Data(), self.c_str())),
+             0);
+
+   Long_t newmodtime;
+   gSystem->GetPathInfo(lib, &id, &size, &flags, &newmodtime);
+   EXPECT_EQ(newmodtime, modtime);
+}
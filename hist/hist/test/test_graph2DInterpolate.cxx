@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+
+#include "TGraph2D.h"
+#include "TH2.h"
+#include "TROOT.h"
+#include "TRandom3.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// A graph of random points of z = x * exp(-x*x - y*y), and points to
+// interpolate, some of them outside of the convex hull.
+void CheckBatchInterpolate()
+{
+   const Int_t np = 20000;
+   TRandom3 rnd(1);
+   TGraph2D g(np);
+   for (Int_t i = 0; i < np; ++i) {
+      const Double_t x = rnd.Uniform(-2, 2);
+      const Double_t y = rnd.Uniform(-2, 2);
+      g.SetPoint(i, x, y, x * std::exp(-x * x - y * y));
+   }
+
+   const Int_t n = 50000;
+   std::vector<Double_t> x(n), y(n), z(n);
+   for (Int_t i = 0; i < n; ++i) {
+      x[i] = rnd.Uniform(-2.2, 2.2);
+      y[i] = rnd.Uniform(-2.2, 2.2);
+   }
+   g.Interpolate(n, x.data(), y.data(), z.data());
+
+   Int_t nInside = 0;
+   for (Int_t i = 0; i < n; ++i) {
+      EXPECT_DOUBLE_EQ(g.Interpolate(x[i], y[i]), z[i]) << "point " << i;
+      if (std::abs(x[i]) < 1.9 && std::abs(y[i]) < 1.9) {
+         EXPECT_NEAR(x[i] * std::exp(-x[i] * x[i] - y[i] * y[i]), z[i], 0.02) << "point " << i;
+         ++nInside;
+      }
+   }
+   EXPECT_GT(nInside, n / 2);
+
+   // the histogram is filled with the batch interpolation
+   TH2D *h = g.GetHistogram();
+   ASSERT_NE(nullptr, h);
+   for (Int_t ix = 1; ix <= h->GetNbinsX(); ix += 7) {
+      for (Int_t iy = 1; iy <= h->GetNbinsY(); iy += 5) {
+         const Double_t xc = h->GetXaxis()->GetBinCenter(ix);
+         const Double_t yc = h->GetYaxis()->GetBinCenter(iy);
+         EXPECT_DOUBLE_EQ(g.Interpolate(xc, yc), h->GetBinContent(ix, iy)) << "bin " << ix << "," << iy;
+      }
+   }
+}
+
+} // namespace
+
+TEST(TGraph2D, BatchInterpolate)
+{
+   CheckBatchInterpolate();
+}
+
+#ifdef R__USE_IMT
+TEST(TGraph2D, BatchInterpolateImplicitMT)
+{
+   ROOT::EnableImplicitMT(4);
+   CheckBatchInterpolate();
+   ROOT::DisableImplicitMT();
+}
+#endif
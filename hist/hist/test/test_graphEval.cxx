@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+
+#include "TGraph.h"
+#include "TRandom3.h"
+#include "TSpline.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Points inside and outside the graph range, at the graph points and
+// in between, both sorted and in random order.
+std::vector<Double_t> MakePoints(const TGraph &g, Bool_t sorted)
+{
+   TRandom3 rnd(2);
+   std::vector<Double_t> x;
+   for (Int_t i = 0; i < 2000; ++i)
+      x.push_back(rnd.Uniform(-1.5, 11.5));
+   for (Int_t i = 0; i < g.GetN(); i += 3)
+      x.push_back(g.GetX()[i]);
+   if (sorted)
+      std::sort(x.begin(), x.end());
+   return x;
+}
+
+void ExpectSameAsEval(const TGraph &g, TSpline *spline, Option_t *option)
+{
+   for (Bool_t sorted : {kFALSE, kTRUE}) {
+      std::vector<Double_t> x = MakePoints(g, sorted);
+      std::vector<Double_t> y(x.size());
+      g.Eval(x.size(), x.data(), y.data(), spline, option);
+      for (size_t i = 0; i < x.size(); ++i)
+         EXPECT_DOUBLE_EQ(g.Eval(x[i], spline, option), y[i]) << "x = " << x[i];
+   }
+}
+
+TGraph MakeGraph(Bool_t sortX)
+{
+   TRandom3 rnd(1);
+   TGraph g(100);
+   for (Int_t i = 0; i < 100; ++i)
+      g.SetPoint(i, rnd.Uniform(0, 10), rnd.Gaus());
+   if (sortX)
+      g.Sort();
+   return g;
+}
+
+} // namespace
+
+TEST(TGraphEval, Linear)
+{
+   TGraph sorted = MakeGraph(kTRUE);
+   ASSERT_TRUE(sorted.TestBit(TGraph::kIsSortedX));
+   ExpectSameAsEval(sorted, nullptr, "");
+   ExpectSameAsEval(MakeGraph(kFALSE), nullptr, "");
+}
+
+TEST(TGraphEval, Spline)
+{
+   TGraph g = MakeGraph(kTRUE);
+   ExpectSameAsEval(g, nullptr, "S");
+   ExpectSameAsEval(MakeGraph(kFALSE), nullptr, "S");
+   TSpline3 spline("spline", &g);
+   ExpectSameAsEval(g, &spline, "");
+}
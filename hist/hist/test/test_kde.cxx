@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+
+#include "TKDE.h"
+#include "TROOT.h"
+#include "TRandom3.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const UInt_t kN = 5000;
+
+std::vector<Double_t> MakeData()
+{
+   TRandom3 rnd(1);
+   std::vector<Double_t> data(kN);
+   for (UInt_t i = 0; i < kN; ++i)
+      data[i] = (i % 4) ? rnd.Exp(1) : 2 + rnd.Gaus(0, 0.2);
+   return data;
+}
+
+Double_t Gaussian(Double_t u)
+{
+   return (u > -9. && u < 9.) ? std::exp(-.5 * u * u) / std::sqrt(2 * M_PI) : 0.;
+}
+
+// The estimate summed over all the data, with the bandwidths of kde and
+// the asymmetric mirroring at xMin if asymLeft is true
+Double_t Reference(const TKDE &kde, const std::vector<Double_t> &data, Double_t x, Double_t xMin, Bool_t asymLeft)
+{
+   const Double_t *w = kde.GetAdaptiveWeights();
+   Double_t sum = 0;
+   for (UInt_t i = 0; i < data.size(); ++i) {
+      sum += Gaussian((x - data[i]) / w[i]) / w[i];
+      if (asymLeft)
+         sum -= Gaussian((x - (2 * xMin - data[i])) / w[i]) / w[i];
+   }
+   return sum / data.size();
+}
+
+void CheckValues()
+{
+   std::vector<Double_t> data = MakeData();
+   const Double_t xMin = 0;
+   const Double_t xMax = 10;
+   for (Bool_t asymLeft : {kFALSE, kTRUE}) {
+      TKDE kde(kN, data.data(), xMin, xMax,
+               asymLeft ? "KernelType:Gaussian;Iteration:Adaptive;Mirror:MirrorAsymLeft;Binning:Unbinned"
+                        : "KernelType:Gaussian;Iteration:Adaptive;Mirror:NoMirror;Binning:Unbinned");
+
+      const UInt_t n = 3000;
+      std::vector<Double_t> x(n), y(n);
+      for (UInt_t i = 0; i < n; ++i)
+         x[i] = -0.5 + 6. * i / n;
+      kde.GetValue(n, x.data(), y.data());
+      for (UInt_t i = 0; i < n; i += 7) {
+         const Double_t ref = Reference(kde, data, x[i], xMin, asymLeft);
+         EXPECT_NEAR(ref, y[i], 1e-12 * (1 + ref)) << "x = " << x[i];
+         EXPECT_DOUBLE_EQ(kde.GetValue(x[i]), y[i]) << "x = " << x[i];
+      }
+
+      // the grid is interpolated linearly inside the range, and not used outside
+      kde.SetNGridPoints(10001);
+      std::vector<Double_t> yGrid(n);
+      kde.GetValue(n, x.data(), yGrid.data());
+      for (UInt_t i = 0; i < n; ++i) {
+         if (x[i] < xMin)
+            EXPECT_DOUBLE_EQ(y[i], yGrid[i]) << "x = " << x[i];
+         else
+            EXPECT_NEAR(y[i], yGrid[i], 2e-3 * y[i] + 1e-5) << "x = " << x[i];
+      }
+      EXPECT_NEAR(Reference(kde, data, 2., xMin, asymLeft), kde.GetValue(2.), 1e-9);
+   }
+}
+
+} // namespace
+
+TEST(TKDE, GetValue)
+{
+   CheckValues();
+}
+
+#ifdef R__USE_IMT
+TEST(TKDE, GetValueImplicitMT)
+{
+   ROOT::EnableImplicitMT(4);
+   CheckValues();
+   ROOT::DisableImplicitMT();
+}
+#endif
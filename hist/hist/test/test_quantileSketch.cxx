@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+
+#include "TList.h"
+#include "TMemFile.h"
+#include "TQuantileSketch.h"
+#include "TRandom3.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const Int_t kN = 200000;
+
+// A bimodal distribution with an asymmetric tail.
+std::vector<Double_t> MakeValues()
+{
+   TRandom3 rnd(1);
+   std::vector<Double_t> values(kN);
+   for (Int_t i = 0; i < kN; ++i)
+      values[i] = (i % 3) ? rnd.Gaus(0, 1) : 3 + rnd.Exp(1);
+   return values;
+}
+
+// Check that the quantiles of s are those of the sorted values, comparing
+// the probabilities rather than the values.
+void ExpectQuantiles(const TQuantileSketch &s, const std::vector<Double_t> &sorted)
+{
+   const Double_t probs[] = {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999};
+   for (auto p : probs) {
+      const Double_t q = s.GetQuantile(p);
+      const Double_t rank = std::lower_bound(sorted.begin(), sorted.end(), q) - sorted.begin();
+      EXPECT_NEAR(p, rank / sorted.size(), 1e-3) << "p = " << p;
+      EXPECT_NEAR(p, s.GetCDF(q), 1e-9) << "p = " << p;
+   }
+   EXPECT_DOUBLE_EQ(sorted.front(), s.GetXmin());
+   EXPECT_DOUBLE_EQ(sorted.back(), s.GetXmax());
+   EXPECT_DOUBLE_EQ(sorted.front(), s.GetQuantile(0));
+   EXPECT_DOUBLE_EQ(sorted.back(), s.GetQuantile(1));
+}
+
+} // namespace
+
+TEST(TQuantileSketch, Fill)
+{
+   std::vector<Double_t> values = MakeValues();
+   TQuantileSketch s("s", "", 200);
+   for (auto x : values)
+      s.Fill(x);
+   EXPECT_EQ(-1, s.Fill(1., 0.));
+
+   Double_t mean = 0;
+   for (auto x : values)
+      mean += x;
+   mean /= kN;
+
+   std::sort(values.begin(), values.end());
+   ExpectQuantiles(s, values);
+   EXPECT_EQ(kN, s.GetEntries());
+   EXPECT_DOUBLE_EQ(kN, s.GetSumOfWeights());
+   EXPECT_NEAR(mean, s.GetMean(), 1e-12);
+   EXPECT_LT(s.GetNCentroids(), 200);
+
+   Double_t q[4];
+   EXPECT_EQ(4, s.GetQuantiles(4, q));
+   EXPECT_DOUBLE_EQ(s.GetMedian(), q[1]);
+   EXPECT_DOUBLE_EQ(s.GetXmax(), q[3]);
+
+   s.Reset();
+   EXPECT_EQ(0, s.GetEntries());
+   EXPECT_EQ(0, s.GetNCentroids());
+}
+
+TEST(TQuantileSketch, Merge)
+{
+   std::vector<Double_t> values = MakeValues();
+   std::vector<std::unique_ptr<TQuantileSketch>> parts;
+   for (Int_t k = 0; k < 4; ++k)
+      parts.emplace_back(new TQuantileSketch(Form("p%d", k), ""));
+   for (Int_t i = 0; i < kN; ++i)
+      parts[i % 4]->Fill(values[i]);
+
+   TQuantileSketch merged(*parts[0]);
+   TList list;
+   for (Int_t k = 1; k < 4; ++k)
+      list.Add(parts[k].get());
+   EXPECT_EQ(kN, merged.Merge(&list));
+
+   std::sort(values.begin(), values.end());
+   ExpectQuantiles(merged, values);
+   EXPECT_DOUBLE_EQ(kN, merged.GetSumOfWeights());
+}
+
+TEST(TQuantileSketch, AddSelf)
+{
+   std::vector<Double_t> values = MakeValues();
+   TQuantileSketch s("s", "");
+   for (auto x : values)
+      s.Fill(x);
+   EXPECT_TRUE(s.Add(&s));
+
+   // Every value counted twice: the same distribution with twice the weight.
+   std::sort(values.begin(), values.end());
+   ExpectQuantiles(s, values);
+   EXPECT_EQ(2 * kN, s.GetEntries());
+   EXPECT_DOUBLE_EQ(2 * kN, s.GetSumOfWeights());
+}
+
+TEST(TQuantileSketch, IO)
+{
+   std::vector<Double_t> values = MakeValues();
+   TQuantileSketch s("s", "title");
+   // leave values in the buffer, which is merged when writing
+   s.FillN(kN - 10, values.data(), nullptr);
+
+   TMemFile file("test_quantileSketch.root", "RECREATE");
+   file.WriteTObject(&s);
+   std::unique_ptr<TQuantileSketch> read(static_cast<TQuantileSketch *>(file.Get("s")));
+   ASSERT_NE(nullptr, read);
+   EXPECT_STREQ("title", read->GetTitle());
+   EXPECT_EQ(s.GetEntries(), read->GetEntries());
+   EXPECT_EQ(s.GetNCentroids(), read->GetNCentroids());
+   for (auto p : {0.01, 0.5, 0.99})
+      EXPECT_DOUBLE_EQ(s.GetQuantile(p), read->GetQuantile(p));
+}
@@ -0,0 +1,74 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TListOfKeys
+#define ROOT_TListOfKeys
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TListOfKeys                                                          //
+//                                                                      //
+// The list of TKeys of a TDirectoryFile, with a flat index from key    //
+// name to the cycles of the key for fast lookup in large directories.  //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "THashList.h"
+
+#include "ROOT/TFlatStringMap.hxx"
+
+#include <vector>
+
+class TKey;
+
+class TListOfKeys : public THashList
+{
+private:
+   mutable ROOT::Internal::TFlatStringMap<std::vector<TKey *>> fIndex; //! Map from key name to all its cycles
+   Bool_t     fFullyIndexed; //! False if some objects of the list are not in fIndex (e.g. not TKeys)
+
+   TListOfKeys(const TListOfKeys&) = delete;
+   TListOfKeys& operator=(const TListOfKeys&) = delete;
+
+   void MapObject(TObject *obj);
+   void UnmapObject(TObject *obj);
+   void ReindexRenamed(const char *name) const;
+
+public:
+   TListOfKeys(Int_t capacity = TCollection::kInitHashTableCapacity, Int_t rehash = 0);
+   ~TListOfKeys() override;
+
+   TKey      *GetKey(const char *name, Short_t cycle = 9999) const;
+
+   using THashList::FindObject;
+   TObject   *FindObject(const char *name) const override;
+
+   void       Clear(Option_t *option="") override;
+   void       Delete(Option_t *option="") override;
+
+   void       AddFirst(TObject *obj) override;
+   void       AddFirst(TObject *obj, Option_t *opt) override;
+   void       AddLast(TObject *obj) override;
+   void       AddLast(TObject *obj, Option_t *opt) override;
+   void       AddAt(TObject *obj, Int_t idx) override;
+   void       AddAfter(const TObject *after, TObject *obj) override;
+   void       AddAfter(TObjLink *after, TObject *obj) override;
+   void       AddBefore(const TObject *before, TObject *obj) override;
+   void       AddBefore(TObjLink *before, TObject *obj) override;
+
+   void       RecursiveRemove(TObject *obj) override;
+   void       Rehash(Int_t newCapacity);
+   TObject   *Remove(TObject *obj) override;
+   TObject   *Remove(TObjLink *lnk) override;
+
+   ClassDefOverride(TListOfKeys,0);  // List of TKeys of a directory
+};
+
+#endif // ROOT_TListOfKeys
@@ -0,0 +1,310 @@
+// @(#)root/io:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TListOfKeys
+\ingroup IO
+
+The list of TKeys of a TDirectoryFile.
+
+In addition to the THashList, the keys are indexed by name in a flat
+open-addressing hash map (ROOT::Internal::TFlatStringMap) holding all the
+cycles of each name. Looking up a key by name, as done by
+TDirectoryFile::Get, GetKey and FindKey, no longer walks the buckets of the
+THashTable nor the list, which made directories with ~100k keys slow.
+
+As for a THashList, a key renamed with SetName() is found under its new
+name once the list has been rehashed (see Rehash()). Lookups never return a
+key under its old name.
+*/
+
+#include "TListOfKeys.h"
+#include "TKey.h"
+
+#include <algorithm>
+#include <string.h>
+
+ClassImp(TListOfKeys);
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor, see THashList for the meaning of the arguments.
+
+TListOfKeys::TListOfKeys(Int_t capacity, Int_t rehash) :
+   THashList(capacity, rehash), fFullyIndexed(kTRUE)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TListOfKeys::~TListOfKeys()
+{
+   fIndex.Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the key to the name index.
+
+void TListOfKeys::MapObject(TObject *obj)
+{
+   TKey *key = dynamic_cast<TKey *>(obj);
+   if (key)
+      fIndex[key->GetName()].push_back(key);
+   else if (obj)
+      fFullyIndexed = kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the key from the name index.
+
+void TListOfKeys::UnmapObject(TObject *obj)
+{
+   auto removeFrom = [obj](std::vector<TKey *> &keys) {
+      auto iter = std::find(keys.begin(), keys.end(), obj);
+      if (iter == keys.end())
+         return false;
+      keys.erase(iter);
+      return true;
+   };
+
+   TKey *key = dynamic_cast<TKey *>(obj);
+   if (!key)
+      return;
+   std::vector<TKey *> *keys = fIndex.Find(key->GetName());
+   if (keys && removeFrom(*keys)) {
+      if (keys->empty())
+         fIndex.Erase(key->GetName());
+      return;
+   }
+   // The key was renamed after being added, look for it everywhere.
+   fIndex.ForEach([&removeFrom](std::string_view, std::vector<TKey *> &cycles) { removeFrom(cycles); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Move the keys indexed under name that were renamed since to the entry of
+/// their current name.
+
+void TListOfKeys::ReindexRenamed(const char *name) const
+{
+   std::vector<TKey *> *keys = fIndex.Find(name);
+   if (!keys)
+      return;
+   std::vector<TKey *> renamed;
+   auto iter =
+      std::partition(keys->begin(), keys->end(), [name](TKey *key) { return !strcmp(name, key->GetName()); });
+   renamed.assign(iter, keys->end());
+   keys->erase(iter, keys->end());
+   if (keys->empty())
+      fIndex.Erase(name);
+   for (TKey *key : renamed)
+      fIndex[key->GetName()].push_back(key);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the key with the given name and the highest cycle not larger than
+/// cycle (9999 means the highest cycle), or nullptr if there is none.
+
+TKey *TListOfKeys::GetKey(const char *name, Short_t cycle) const
+{
+   TKey *best = nullptr;
+   Bool_t renamed = kFALSE;
+   if (const std::vector<TKey *> *keys = fIndex.Find(name)) {
+      for (TKey *key : *keys) {
+         if (strcmp(name, key->GetName())) {
+            renamed = kTRUE;
+            continue;
+         }
+         if (cycle != 9999 && key->GetCycle() > cycle)
+            continue;
+         if (!best || key->GetCycle() > best->GetCycle())
+            best = key;
+      }
+   }
+   if (renamed)
+      ReindexRenamed(name);
+   if (!best && !fFullyIndexed) {
+      TIter next(GetListForObject(name));
+      while (TObject *obj = next()) {
+         TKey *key = dynamic_cast<TKey *>(obj);
+         if (key && !strcmp(name, key->GetName()) && (cycle == 9999 || cycle >= key->GetCycle()))
+            return key;
+      }
+   }
+   return best;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Find the key with the given name and the highest cycle.
+
+TObject *TListOfKeys::FindObject(const char *name) const
+{
+   TObject *obj = GetKey(name);
+   if (!obj && !fFullyIndexed)
+      obj = THashList::FindObject(name);
+   return obj;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add object at the beginning of the list.
+
+void TListOfKeys::AddFirst(TObject *obj)
+{
+   THashList::AddFirst(obj);
+   MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add object at the beginning of the list and also store option.
+
+void TListOfKeys::AddFirst(TObject *obj, Option_t *opt)
+{
+   THashList::AddFirst(obj, opt);
+   MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add object at the end of the list.
+
+void TListOfKeys::AddLast(TObject *obj)
+{
+   THashList::AddLast(obj);
+   MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add object at the end of the list and also store option.
+
+void TListOfKeys::AddLast(TObject *obj, Option_t *opt)
+{
+   THashList::AddLast(obj, opt);
+   MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object at location idx in the list.
+
+void TListOfKeys::AddAt(TObject *obj, Int_t idx)
+{
+   THashList::AddAt(obj, idx);
+   MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object after object after in the list.
+
+void TListOfKeys::AddAfter(const TObject *after, TObject *obj)
+{
+   THashList::AddAfter(after, obj);
+   MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object after object after in the list.
+
+void TListOfKeys::AddAfter(TObjLink *after, TObject *obj)
+{
+   THashList::AddAfter(after, obj);
+   MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object before object before in the list.
+
+void TListOfKeys::AddBefore(const TObject *before, TObject *obj)
+{
+   THashList::AddBefore(before, obj);
+   MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Insert object before object before in the list.
+
+void TListOfKeys::AddBefore(TObjLink *before, TObject *obj)
+{
+   THashList::AddBefore(before, obj);
+   MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all objects from the list. Does not delete the objects unless
+/// the list is the owner (set via SetOwner()).
+
+void TListOfKeys::Clear(Option_t *option)
+{
+   fIndex.Clear();
+   fFullyIndexed = kTRUE;
+   THashList::Clear(option);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all objects from the list AND delete all heap based objects.
+/// With option "slow" the list can be searched while the objects are
+/// deleted; the lookups then go through the THashTable, which is kept
+/// consistent by THashList::Delete.
+
+void TListOfKeys::Delete(Option_t *option)
+{
+   fIndex.Clear();
+   fFullyIndexed = kFALSE;
+   THashList::Delete(option);
+   fFullyIndexed = kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove object from this collection and recursively remove the object
+/// from all other objects. The object might be partially destructed, so its
+/// name can not be used to find it in the index.
+
+void TListOfKeys::RecursiveRemove(TObject *obj)
+{
+   if (!obj) return;
+
+   Int_t size = GetSize();
+   THashList::RecursiveRemove(obj);
+   if (GetSize() != size)
+      fIndex.ForEach([obj](std::string_view, std::vector<TKey *> &keys) {
+         keys.erase(std::remove(keys.begin(), keys.end(), obj), keys.end());
+      });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Rehash the list, see THashList::Rehash, and index all the keys again
+/// under their current names, e.g. after keys have been renamed.
+
+void TListOfKeys::Rehash(Int_t newCapacity)
+{
+   THashList::Rehash(newCapacity);
+   fIndex.Clear();
+   fFullyIndexed = kTRUE;
+   TIter next(this);
+   while (TObject *obj = next())
+      MapObject(obj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove object from the list.
+
+TObject *TListOfKeys::Remove(TObject *obj)
+{
+   TObject *result = THashList::Remove(obj);
+   if (result) UnmapObject(result);
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove object via its objlink from the list.
+
+TObject *TListOfKeys::Remove(TObjLink *lnk)
+{
+   if (!lnk) return 0;
+
+   TObject *result = THashList::Remove(lnk);
+   if (result) UnmapObject(result);
+   return result;
+}
@@ -0,0 +1,80 @@
+#include "TDirectoryFile.h"
+#include "TKey.h"
+#include "TListOfKeys.h"
+#include "TMemFile.h"
+#include "TNamed.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+static void WriteCycles(TDirectory *dir, const char *name, int ncycles)
+{
+   TNamed obj(name, "title");
+   for (int i = 0; i < ncycles; ++i) {
+      obj.SetTitle(TString::Format("cycle %d", i + 1));
+      dir->WriteTObject(&obj);
+   }
+}
+
+TEST(TListOfKeys, Cycles)
+{
+   TMemFile file("tlistofkeys_cycles.root", "RECREATE");
+   WriteCycles(&file, "a", 3);
+   WriteCycles(&file, "b", 1);
+
+   ASSERT_NE(dynamic_cast<TListOfKeys *>(file.GetListOfKeys()), nullptr);
+   EXPECT_EQ(file.GetListOfKeys()->GetSize(), 4);
+
+   TKey *key = file.GetKey("a");
+   ASSERT_NE(key, nullptr);
+   EXPECT_EQ(key->GetCycle(), 3);
+   for (Short_t cycle = 1; cycle <= 3; ++cycle) {
+      key = file.GetKey("a", cycle);
+      ASSERT_NE(key, nullptr);
+      EXPECT_EQ(key->GetCycle(), cycle);
+      EXPECT_EQ(file.FindKey(TString::Format("a;%d", cycle)), key);
+   }
+   EXPECT_EQ(file.FindKey("a")->GetCycle(), 3);
+   EXPECT_EQ(file.FindKey("b;1"), file.GetKey("b"));
+   EXPECT_EQ(file.GetKey("b", 2), file.GetKey("b"));
+   EXPECT_EQ(file.GetKey("c"), nullptr);
+
+   std::unique_ptr<TNamed> obj(static_cast<TNamed *>(file.Get("a;2")));
+   ASSERT_NE(obj, nullptr);
+   EXPECT_STREQ(obj->GetTitle(), "cycle 2");
+
+   // Deleting a cycle removes it from the index.
+   file.Delete("a;3");
+   EXPECT_EQ(file.GetKey("a")->GetCycle(), 2);
+   EXPECT_EQ(file.FindKey("a;3")->GetCycle(), 2);
+}
+
+TEST(TListOfKeys, Rename)
+{
+   TMemFile file("tlistofkeys_rename.root", "RECREATE");
+   WriteCycles(&file, "a", 2);
+   auto keys = dynamic_cast<TListOfKeys *>(file.GetListOfKeys());
+   ASSERT_NE(keys, nullptr);
+
+   TKey *renamed = file.GetKey("a", 1);
+   ASSERT_NE(renamed, nullptr);
+   renamed->SetName("z");
+   // The key is not returned under its old name, even before the rehash.
+   EXPECT_EQ(file.GetKey("a", 1), nullptr);
+   EXPECT_EQ(file.GetKey("a")->GetCycle(), 2);
+   EXPECT_EQ(file.GetKey("z"), renamed);
+
+   renamed = file.GetKey("a", 2);
+   renamed->SetName("y");
+   keys->Rehash(keys->GetSize());
+   EXPECT_EQ(file.GetKey("a"), nullptr);
+   EXPECT_EQ(file.FindKey("y;2"), renamed);
+   EXPECT_EQ(file.FindKey("z")->GetCycle(), 1);
+
+   // A new object with the old name starts again at cycle 1.
+   WriteCycles(&file, "a", 1);
+   ASSERT_NE(file.GetKey("a"), nullptr);
+   EXPECT_EQ(file.GetKey("a")->GetCycle(), 1);
+   EXPECT_EQ(keys->GetSize(), 3);
+}
@@ -258,13 +258,15 @@ namespace FitUtil {
        The effective chi2 uses the errors on the coordinates : W = 1/(sigma_y**2 + ( sigma_x_i * df/dx_i )**2 )
        return also nPoints as the effective number of used points in the Chi2 evaluation
    */
-   double EvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints);
+   double EvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints,
+                                const unsigned int &executionPolicy = ROOT::Fit::kSerial, unsigned nChunks = 0);
 
    /**
        evaluate the Chi2 gradient given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the Chi2 evaluation
    */
-   void EvaluateChi2Gradient(const IModelFunction & func, const BinData & data, const double * x, double * grad, unsigned int & nPoints);
+   void EvaluateChi2Gradient(const IModelFunction & func, const BinData & data, const double * x, double * grad, unsigned int & nPoints,
+                             const unsigned int &executionPolicy = ROOT::Fit::kSerial, unsigned nChunks = 0);
 
    /**
        evaluate the LogL given a model function and the data at the point x.
@@ -276,11 +278,13 @@ namespace FitUtil {
        evaluate the LogL gradient given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
    */
-   void EvaluateLogLGradient(const IModelFunction & func, const UnBinData & data, const double * x, double * grad, unsigned int & nPoints);
+   void EvaluateLogLGradient(const IModelFunction & func, const UnBinData & data, const double * x, double * grad, unsigned int & nPoints,
+                             const unsigned int &executionPolicy = ROOT::Fit::kSerial, unsigned nChunks = 0);
 
 #ifdef R__HAS_VECCORE
    template <class NotCompileIfScalarBackend = std::enable_if<!(std::is_same<double, ROOT::Double_v>::value)>>
-   void EvaluateLogLGradient(const IModelFunctionTempl<ROOT::Double_v> &, const UnBinData &, const double *, double *, unsigned int & ) {}
+   void EvaluateLogLGradient(const IModelFunctionTempl<ROOT::Double_v> &, const UnBinData &, const double *, double *, unsigned int &,
+                             const unsigned int & = ROOT::Fit::kSerial, unsigned = 0) {}
 #endif
 
    /**
@@ -295,7 +299,8 @@ namespace FitUtil {
        evaluate the Poisson LogL given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
    */
-   void EvaluatePoissonLogLGradient(const IModelFunction & func, const BinData & data, const double * x, double * grad);
+   void EvaluatePoissonLogLGradient(const IModelFunction & func, const BinData & data, const double * x, double * grad,
+                                    const unsigned int &executionPolicy = ROOT::Fit::kSerial, unsigned nChunks = 0);
 
    // methods required by dedicate minimizer like Fumili
 
@@ -778,13 +783,15 @@ namespace FitUtil {
          return vecCore::ReduceAdd(res);
       }
 
-      static double EvalChi2Effective(const IModelFunctionTempl<T> &, const BinData &, const double *, unsigned int &)
+      static double EvalChi2Effective(const IModelFunctionTempl<T> &, const BinData &, const double *, unsigned int &,
+                                      const unsigned int & = ROOT::Fit::kSerial, unsigned = 0)
       {
          Error("FitUtil::Evaluate<T>::EvalChi2Effective", "The vectorized evaluation of the Chi2 with coordinate errors is still not supported");
          return -1.;
       }
 
-      static void EvalChi2Gradient(const IModelFunctionTempl<T> &, const BinData &, const double *, double *, unsigned int)
+      static void EvalChi2Gradient(const IModelFunctionTempl<T> &, const BinData &, const double *, double *, unsigned int &,
+                                   const unsigned int & = ROOT::Fit::kSerial, unsigned = 0)
       {
          Error("FitUtil::Evaluate<T>::EvalChi2Gradient", "The vectorized evaluation of the Chi2 with gradient is still not supported");
       }
@@ -802,7 +809,8 @@ static double EvalPoissonBinPdf(const IModelFunctionTempl<T> &, const BinData &,
          return -1.;
       }
 
-static void EvalPoissonLogLGradient(const IModelFunctionTempl<T> &, const BinData &, const double *, double * ) {
+static void EvalPoissonLogLGradient(const IModelFunctionTempl<T> &, const BinData &, const double *, double *,
+                                   const unsigned int & = ROOT::Fit::kSerial, unsigned = 0) {
          Error("FitUtil::Evaluate<T>::EvaluatePoissonLogLGradient", "The vectorized evaluation of the BinnedLikelihood fit evaluated point by point is still not supported");
       }
    };
@@ -832,13 +840,15 @@ static void EvalPoissonLogLGradient(const IModelFunctionTempl<T> &, const BinDat
          return FitUtil::EvaluatePoissonLogL(func, data, p, iWeight, extended, nPoints, executionPolicy, nChunks);
       }
 
-      static double EvalChi2Effective(const IModelFunctionTempl<double> &func, const BinData & data, const double * p, unsigned int &nPoints)
+      static double EvalChi2Effective(const IModelFunctionTempl<double> &func, const BinData & data, const double * p, unsigned int &nPoints,
+                                      const unsigned int &executionPolicy = ROOT::Fit::kSerial, unsigned nChunks = 0)
       {
-         return FitUtil::EvaluateChi2Effective(func, data, p, nPoints);
+         return FitUtil::EvaluateChi2Effective(func, data, p, nPoints, executionPolicy, nChunks);
       }
-      static void EvalChi2Gradient(const IModelFunctionTempl<double> &func, const BinData & data, const double * p, double * g, unsigned int &nPoints)
+      static void EvalChi2Gradient(const IModelFunctionTempl<double> &func, const BinData & data, const double * p, double * g, unsigned int &nPoints,
+                                   const unsigned int &executionPolicy = ROOT::Fit::kSerial, unsigned nChunks = 0)
       {
-          FitUtil::EvaluateChi2Gradient(func, data, p, g, nPoints);
+          FitUtil::EvaluateChi2Gradient(func, data, p, g, nPoints, executionPolicy, nChunks);
       }
       static double EvalChi2Residual(const IModelFunctionTempl<double> &func, const BinData & data, const double * p, unsigned int i, double *g = 0)
       {
@@ -851,8 +861,9 @@ static void EvalPoissonLogLGradient(const IModelFunctionTempl<T> &, const BinDat
          return FitUtil::EvaluatePoissonBinPdf(func, data, p, i, g);
       }
 
-static void EvalPoissonLogLGradient(const IModelFunctionTempl<double> &func, const BinData &data, const double *p, double *g) {
-         FitUtil::EvaluatePoissonLogLGradient(func, data, p, g);
+static void EvalPoissonLogLGradient(const IModelFunctionTempl<double> &func, const BinData &data, const double *p, double *g,
+                                   const unsigned int &executionPolicy = ROOT::Fit::kSerial, unsigned nChunks = 0) {
+         FitUtil::EvaluatePoissonLogLGradient(func, data, p, g, executionPolicy, nChunks);
       }
    };
 
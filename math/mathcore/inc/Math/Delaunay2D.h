@@ -95,6 +95,10 @@ public:
    /// Return the Interpolated z value corresponding to the (x,y) point
    double  Interpolate(double x, double y);
 
+   /// Compute the interpolated z values for the n points (x[i],y[i]).
+   /// The points are processed in parallel if the implicit multi-threading is enabled
+   void    Interpolate(int n, const double *x, const double *y, double *z);
+
    /// Find all triangles 
    void      FindAllTriangles();
 
@@ -122,7 +126,7 @@ private:
    // internal methods
 
    
-   inline double Linear_transform(double x, double offset, double factor){
+   inline double Linear_transform(double x, double offset, double factor) const {
 	   return (x+offset)*factor;
    }
 
@@ -134,7 +138,10 @@ private:
    void DoFindTriangles();
 
    /// internal method to compute the interpolation
-   double  DoInterpolateNormalized(double x, double y);
+   double  DoInterpolateNormalized(double x, double y) const;
+
+   /// internal method to compute the interpolation at (x,y) once the triangles are found
+   double  DoInterpolate(double x, double y) const;
 
 
    
@@ -264,12 +271,18 @@ protected:
    /* To speed up localisation of points a grid is layed over normalized space
     *
     * A reference to triangle ABC is added to _all_ grid cells that include ABC's bounding box
+    *
+    * The number of cells grows with the number of triangles, so that each cell
+    * contains a few triangles. The triangles of the cells are stored contiguously:
+    * the triangles of cell c are fCellTriangles[fCellStart[c]] ... fCellTriangles[fCellStart[c+1]-1],
+    * in increasing order
     */
 
-   static const int fNCells = 25; //! number of cells to divide the normalized space
+   int fNCells; //! number of cells to divide each axis of the normalized space
    double fXCellStep; //! inverse denominator to calculate X cell = fNCells / (fXNmax - fXNmin)
    double fYCellStep; //! inverse denominator to calculate X cell = fNCells / (fYNmax - fYNmin)
-   std::set<UInt_t> fCells[(fNCells+1)*(fNCells+1)]; //! grid cells with containing triangles
+   std::vector<UInt_t> fCellStart;     //! index in fCellTriangles of the first triangle of each cell
+   std::vector<UInt_t> fCellTriangles; //! triangles of the grid cells
 
    inline unsigned int Cell(UInt_t x, UInt_t y) const {
 	   return x*(fNCells+1) + y;
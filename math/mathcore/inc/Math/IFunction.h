@@ -85,6 +85,13 @@ namespace ROOT {
           */
          virtual unsigned int NDim() const = 0;
 
+         /**
+            Return true if the function can be evaluated concurrently from several threads,
+            e.g. by a minimizer computing a numerical gradient in parallel.
+            Derived classes must re-implement it to declare themselves thread safe
+          */
+         virtual bool IsThreadSafe() const { return false; }
+
          /**
              Evaluate the function at a point x[].
              Use the pure virtual private method DoEval which must be implemented by the sub-classes
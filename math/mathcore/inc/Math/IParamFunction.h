@@ -21,6 +21,7 @@
 
 
 #include <cassert>
+#include <vector>
 
 /**
    @defgroup ParamFunc Parameteric Function Evaluation Interfaces.
@@ -120,6 +121,16 @@ namespace ROOT {
             return DoEvalPar(x, p);
          }
 
+         /**
+         Evaluate the function at n points for the given parameters p, storing the values in result.
+         x[i] points to the n values of the coordinate i of the points.
+         Use the virtual function DoEvalParBatch to implement it
+         */
+         void EvalParBatch(const T *const *x, unsigned int n, T *result, const double *p) const
+         {
+            DoEvalParBatch(x, n, result, p);
+         }
+
          using BaseFunc::operator();
 
       private:
@@ -129,6 +140,21 @@ namespace ROOT {
          */
          virtual T DoEvalPar(const T *x, const double *p) const = 0;
 
+         /**
+            Implementation of the evaluation at several points. The default calls DoEvalPar
+            for each point; derived classes can re-implement it for better efficiency
+         */
+         virtual void DoEvalParBatch(const T *const *x, unsigned int n, T *result, const double *p) const
+         {
+            const unsigned int ndim = this->NDim();
+            std::vector<T> point(ndim);
+            for (unsigned int i = 0; i < n; ++i) {
+               for (unsigned int j = 0; j < ndim; ++j)
+                  point[j] = x[j][i];
+               result[i] = DoEvalPar(point.data(), p);
+            }
+         }
+
          /**
             Implement the ROOT::Math::IBaseFunctionMultiDim interface DoEval(x) using the cached parameter values
          */
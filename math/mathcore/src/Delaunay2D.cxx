@@ -22,13 +22,44 @@
 #include "triangle.h"
 #endif
 
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 #include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <stdlib.h>
 
 namespace ROOT {
    
    namespace Math {
 
+namespace {
+
+/// call func(begin, end) for blocks of the indices [0, n), in parallel
+/// if the implicit multi-threading is enabled
+template <class F>
+void ForEachBlock(unsigned int n, const F & func) {
+   const unsigned int kBlockSize = 4096;
+   const unsigned int nBlocks = (n + kBlockSize - 1) / kBlockSize;
+   auto blockFunc = [&](unsigned int iblock) {
+      func(iblock * kBlockSize, std::min(n, (iblock + 1) * kBlockSize));
+   };
+#ifdef R__USE_IMT
+   if (nBlocks > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(blockFunc, ROOT::TSeq<unsigned int>(0, nBlocks));
+      return;
+   }
+#endif
+   for (unsigned int iblock = 0; iblock < nBlocks; ++iblock)
+      blockFunc(iblock);
+}
+
+} // namespace
+
 
 /// class constructor from array of data points
 Delaunay2D::Delaunay2D(int n, const double * x, const double * y, const double * z, 
@@ -95,6 +126,7 @@ void Delaunay2D::SetInputPoints(int n, const double * x, const double * y, const
 
 
 #ifndef HAS_CGAL
+   fNCells       = 25;
    fXCellStep    = 0.;
    fYCellStep    = 0.;
 #endif
@@ -111,6 +143,27 @@ double Delaunay2D::Interpolate(double x, double y)
    // needed in this function.
    FindAllTriangles();
 
+   return DoInterpolate(x, y);
+}
+
+//______________________________________________________________________________
+void Delaunay2D::Interpolate(int n, const double *x, const double *y, double *z)
+{
+   // Compute the z values corresponding to the n points (x[i],y[i]).
+   // Once the triangles are found the interpolation does not modify the
+   // object, so the points can be processed concurrently.
+
+   FindAllTriangles();
+
+   ForEachBlock(n, [&](unsigned int begin, unsigned int end) {
+      for (unsigned int i = begin; i < end; ++i)
+         z[i] = DoInterpolate(x[i], y[i]);
+   });
+}
+
+//______________________________________________________________________________
+double Delaunay2D::DoInterpolate(double x, double y) const
+{
    // Find the z value corresponding to the point (x,y).
    double xx, yy;
    xx = Linear_transform(x, fOffsetX, fScaleFactorX); //xx = xTransformer(x);
@@ -207,15 +260,12 @@ void Delaunay2D::DoFindTriangles() {
 }
 
 /// CGAL implementation for interpolation
-double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
+double Delaunay2D::DoInterpolateNormalized(double xx, double yy) const
 {
    // Finds the Delaunay triangle that the point (xi,yi) sits in (if any) and
    // calculate a z-value for it by linearly interpolating the z-values that
    // make up that triangle.
 
-   // initialise the Delaunay algorithm if needed
-    FindAllTriangles();
-
    //coordinate computation
    Point p(xx, yy);
 
@@ -242,11 +292,17 @@ double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
 
 /// Triangle implementation for normalizing the points
 void Delaunay2D::DoNormalizePoints() {
+   fXN.resize(fNpoints);
+   fYN.resize(fNpoints);
    for (Int_t n = 0; n < fNpoints; n++) {
-      fXN.push_back(Linear_transform(fX[n], fOffsetX, fScaleFactorX));
-      fYN.push_back(Linear_transform(fY[n], fOffsetY, fScaleFactorY));
+      fXN[n] = Linear_transform(fX[n], fOffsetX, fScaleFactorX);
+      fYN[n] = Linear_transform(fY[n], fOffsetY, fScaleFactorY);
    }
 
+   // the grid has about one cell per point (there are about two triangles per point),
+   // with at least the 25x25 cells which are enough for a few hundred points
+   fNCells = std::max(25, std::min(4096, int(std::sqrt(double(fNpoints)))));
+
    //also initialize fXCellStep and FYCellStep
    fXCellStep = fNCells / (fXNmax - fXNmin);
    fYCellStep = fNCells / (fYNmax - fYNmin);
@@ -323,51 +379,61 @@ void Delaunay2D::DoFindTriangles() {
 
    triangulate((char *) "zQN", &in, &out, nullptr);
 
-   fTriangles.resize(out.numberoftriangles);
-   for(int t = 0; t < out.numberoftriangles; ++t){
-      Triangle tri;
-
-      auto transform = [&] (const unsigned int v) {
-         //each triangle as numberofcorners vertices ( = 3)
-         tri.idx[v] = out.trianglelist[t*out.numberofcorners + v];
-
-         //printf("triangle %u vertex %u: point %u/%i\n", t, v, tri.idx[v], out.numberofpoints);
-
-         //pointlist is [x0 y0 x1 y1 ...]
-         tri.x[v] = in.pointlist[tri.idx[v] * 2 + 0];
-
-         //printf("\t x: %f\n", tri.x[v]);
+   const int nt = out.numberoftriangles;
+   fTriangles.resize(nt);
 
-         tri.y[v] = in.pointlist[tri.idx[v] * 2 + 1];
+   // range of the grid cells covered by the bounding box of each triangle
+   auto cellIndex = [this](int c) -> UInt_t { return std::max(0, std::min(fNCells, c)); };
+   std::vector<UInt_t> cellRange(4 * nt);
 
-         //printf("\t y: %f\n", tri.y[v]);
-      };
+   // the triangles are independent: fill them by blocks, in parallel if
+   // the implicit multi-threading is enabled
+   ForEachBlock(nt, [&](unsigned int begin, unsigned int end) {
+      for (unsigned int t = begin; t < end; ++t) {
+         Triangle tri;
 
-      transform(0);
-      transform(1);
-      transform(2);
+         auto transform = [&] (const unsigned int v) {
+            //each triangle as numberofcorners vertices ( = 3)
+            tri.idx[v] = out.trianglelist[t*out.numberofcorners + v];
 
-      //see comment in header for CGAL fallback section
-      tri.invDenom = 1 / ( (tri.y[1] - tri.y[2])*(tri.x[0] - tri.x[2]) + (tri.x[2] - tri.x[1])*(tri.y[0] - tri.y[2]) );
+            //pointlist is [x0 y0 x1 y1 ...]
+            tri.x[v] = in.pointlist[tri.idx[v] * 2 + 0];
+            tri.y[v] = in.pointlist[tri.idx[v] * 2 + 1];
+         };
 
-      fTriangles[t] = tri;
+         transform(0);
+         transform(1);
+         transform(2);
 
-      auto bx = std::minmax({tri.x[0], tri.x[1], tri.x[2]});
-      auto by = std::minmax({tri.y[0], tri.y[1], tri.y[2]});
+         //see comment in header for CGAL fall back section
+         tri.invDenom = 1 / ( (tri.y[1] - tri.y[2])*(tri.x[0] - tri.x[2]) + (tri.x[2] - tri.x[1])*(tri.y[0] - tri.y[2]) );
 
-      unsigned int cellXmin = CellX(bx.first);
-      unsigned int cellXmax = CellX(bx.second);
+         fTriangles[t] = tri;
 
-      unsigned int cellYmin = CellY(by.first);
-      unsigned int cellYmax = CellY(by.second);
+         auto bx = std::minmax({tri.x[0], tri.x[1], tri.x[2]});
+         auto by = std::minmax({tri.y[0], tri.y[1], tri.y[2]});
 
-      for(unsigned int i = cellXmin; i <= cellXmax; ++i) {
-         for(unsigned int j = cellYmin; j <= cellYmax; ++j) {
-            //printf("(%u,%u) = %u\n", i, j, Cell(i,j));
-            fCells[Cell(i,j)].insert(t);
-         }
+         cellRange[4 * t + 0] = cellIndex(CellX(bx.first));
+         cellRange[4 * t + 1] = cellIndex(CellX(bx.second));
+         cellRange[4 * t + 2] = cellIndex(CellY(by.first));
+         cellRange[4 * t + 3] = cellIndex(CellY(by.second));
       }
-   }
+   });
+
+   // add the triangles to the cells, in increasing order
+   const unsigned int ncells = (fNCells + 1) * (fNCells + 1);
+   fCellStart.assign(ncells + 1, 0);
+   for (int t = 0; t < nt; ++t)
+      for (unsigned int i = cellRange[4 * t + 0]; i <= cellRange[4 * t + 1]; ++i)
+         for (unsigned int j = cellRange[4 * t + 2]; j <= cellRange[4 * t + 3]; ++j)
+            ++fCellStart[Cell(i, j) + 1];
+   std::partial_sum(fCellStart.begin(), fCellStart.end(), fCellStart.begin());
+   fCellTriangles.resize(fCellStart.back());
+   std::vector<UInt_t> next(fCellStart.begin(), fCellStart.end() - 1);
+   for (int t = 0; t < nt; ++t)
+      for (unsigned int i = cellRange[4 * t + 0]; i <= cellRange[4 * t + 1]; ++i)
+         for (unsigned int j = cellRange[4 * t + 2]; j <= cellRange[4 * t + 3]; ++j)
+            fCellTriangles[next[Cell(i, j)]++] = t;
 
    freeStruct(in); freeStruct(out);
 }
@@ -376,7 +442,7 @@ void Delaunay2D::DoFindTriangles() {
 /// Finds the Delaunay triangle that the point (xi,yi) sits in (if any) and
 /// calculate a z-value for it by linearly interpolating the z-values that
 /// make up that triangle.
-double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
+double Delaunay2D::DoInterpolateNormalized(double xx, double yy) const
 {
 
    // relay that ll the triangles have been found
@@ -402,7 +468,9 @@ double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
    if(cX < 0 || cX > fNCells || cY < 0 || cY > fNCells)
       return fZout; //TODO some more fancy interpolation here
 
-    for(unsigned int t : fCells[Cell(cX, cY)]){
+    const unsigned int cell = Cell(cX, cY);
+    for(unsigned int k = fCellStart[cell]; k < fCellStart[cell + 1]; ++k){
+       const unsigned int t = fCellTriangles[k];
        auto coords = bayCoords(t);
 
        if(inTriangle(coords)){
@@ -414,41 +482,6 @@ double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
        }
     }
 
-    //debugging
-
-    /*
-    for(unsigned int t = 0; t < fNdt; ++t) {
-       auto coords = bayCoords(t);
-
-       if(inTriangle(coords)){
-
-          //brute force found a triangle -> grid not
-          printf("Found triangle %u for (%f,%f) -> (%u,%u)\n", t, xx,yy, cX, cY);
-          printf("Triangles in grid cell: ");
-          for(unsigned int x : fCells[Cell(cX, cY)])
-             printf("%u ", x);
-          printf("\n");
-
-          printf("Triangle %u is in cells: ", t);
-          for(unsigned int i = 0; i <= fNCells; ++i)
-             for(unsigned int j = 0; j <= fNCells; ++j)
-                if(fCells[Cell(i,j)].count(t))
-                   printf("(%u,%u) ", i, j);
-          printf("\n");
-          for(unsigned int i = 0; i < 3; ++i)
-             printf("\tpoint %u (%u): (%f,%f) -> (%u,%u)\n", i, fTriangles[t].idx[i], fTriangles[t].x[i], fTriangles[t].y[i], CellX(fTriangles[t].x[i]), CellY(fTriangles[t].y[i]));
-
-          //we found the triangle -> interpolate using the barycentric interpolation
-          return std::get<0>(coords) * fZ[fTriangles[t].idx[0]]
-                 + std::get<1>(coords) * fZ[fTriangles[t].idx[1]]
-                 + std::get<2>(coords) * fZ[fTriangles[t].idx[2]];
-
-       }
-    }
-
-    printf("Could not find a triangle for point (%f,%f)\n", xx, yy);
-    */
-
     //no triangle found return standard value
    return fZout;
 }
@@ -31,6 +31,8 @@
 #include <cassert>
 #include <algorithm>
 #include <numeric>
+#include <atomic>
+#include <utility>
 //#include <memory>
 
 //#define DEBUG
@@ -207,6 +209,75 @@ namespace ROOT {
             }
          }
 
+         // number of points for which the model function is evaluated at once
+         // in the chi2 and likelihood loops (see IParamMultiFunction::EvalParBatch)
+         const unsigned int kEvalBlockSize = 256;
+
+         // evaluate the model function at the n points of the data starting at begin
+         static void EvalModelBlock(const IModelFunction & func, const FitData & data, unsigned int begin,
+                                    unsigned int n, const double * p, double * fval) {
+            const unsigned int ndim = data.NDim();
+            std::vector<const double *> x(ndim);
+            for (unsigned int j = 0; j < ndim; ++j)
+               x[j] = data.GetCoordComponent(begin, j);
+            func.EvalParBatch(x.data(), n, fval, p);
+         }
+
+         // copy the coordinates of the point i of data in x
+         // (unlike FitData::Coords this is thread safe)
+         static void GetPointCoords(const FitData & data, unsigned int i, double * x) {
+            for (unsigned int j = 0; j < data.NDim(); ++j)
+               x[j] = *data.GetCoordComponent(i, j);
+         }
+
+         // copy in x2 the upper edges of the bin i; BinData::BinUpEdge() cannot be used
+         // in the blocks evaluated in parallel, since it fills a buffer of the data
+         static const double * GetBinUpEdge(const BinData & data, unsigned int i, double * x2) {
+            for (unsigned int j = 0; j < data.NDim(); ++j)
+               x2[j] = data.GetBinUpEdgeComponent(i, j);
+            return x2;
+         }
+
+         // sum in grad the gradient contributions returned by blockFunc(begin, end, g)
+         // (which adds the npar derivatives for the points [begin, end) to g) for the
+         // blocks of points of [0, n), in parallel with the multithread execution policy
+         template <class BlockFunc>
+         void SumGradientBlocks(unsigned int n, unsigned int npar, const BlockFunc & blockFunc, double * grad,
+                                unsigned int executionPolicy, unsigned nChunks, const char * where) {
+            const unsigned int nBlocks = (n + kEvalBlockSize - 1) / kEvalBlockSize;
+            auto mapFunction = [&](const unsigned iblock) {
+               std::vector<double> g(npar);
+               const unsigned int begin = iblock * kEvalBlockSize;
+               blockFunc(begin, std::min(n, begin + kEvalBlockSize), g.data());
+               return g;
+            };
+            std::vector<double> g(npar);
+            if (executionPolicy == ROOT::Fit::kSerial) {
+               for (unsigned int iblock = 0; iblock < nBlocks; ++iblock) {
+                  const unsigned int begin = iblock * kEvalBlockSize;
+                  blockFunc(begin, std::min(n, begin + kEvalBlockSize), g.data());
+               }
+#ifdef R__USE_IMT
+            } else if (executionPolicy == ROOT::Fit::kMultithread) {
+               auto redFunction = [npar](const std::vector<std::vector<double>> & objs) {
+                  std::vector<double> sum(npar);
+                  for (auto & obj : objs)
+                     for (unsigned int k = 0; k < npar; ++k)
+                        sum[k] += obj[k];
+                  return sum;
+               };
+               auto chunks = nChunks != 0 ? nChunks : setAutomaticChunking(n);
+               ROOT::TThreadExecutor pool;
+               g = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, nBlocks), redFunction, std::min(chunks, nBlocks));
+#endif
+            } else {
+               (void)mapFunction;
+               (void)nChunks;
+               Error(where, "Execution policy unknown. Avalaible choices:\n 0: Serial (default)\n 1: MultiThread (requires IMT)\n");
+            }
+            std::copy(g.begin(), g.end(), grad);
+         }
+
 
 
       } // end namespace  FitUtil
@@ -247,11 +318,6 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
    std::cout << "use all error=1 " << fitOpt.fErrors1 << std::endl;
 #endif
 
-#ifdef USE_PARAMCACHE
-   IntegralEvaluator<> igEval( func, 0, useBinIntegral);
-#else
-   IntegralEvaluator<> igEval( func, p, useBinIntegral);
-#endif
    double maxResValue = std::numeric_limits<double>::max() /n;
    double wrefVolume = 1.0;
    if (useBinVolume) {
@@ -260,7 +326,11 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
    (const_cast<IModelFunction &>(func)).SetParameters(p);
 
-   auto mapFunction = [&](const unsigned i){
+   // the model function is evaluated by blocks of points (fvalBatch), unless
+   // it needs to be integrated or evaluated at the bin centers
+   const bool useBatch = !useBinIntegral && !useBinVolume;
+
+   auto mapFunction = [&](const unsigned i, const double * fvalBatch, IntegralEvaluator<> & igEval, double * x2buf){
 
       double chi2{};
       double fval{};
@@ -276,7 +346,7 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
       double binVolume = 1.0;
       if (useBinVolume) {
          unsigned int ndim = data.NDim();
-         const double * x2 = data.BinUpEdge(i);
+         const double * x2 = GetBinUpEdge(data, i, x2buf);
          xc.resize(data.NDim());
          for (unsigned int j = 0; j < ndim; ++j) {
             auto xx = *data.GetCoordComponent(i, j);
@@ -297,7 +367,10 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
       }
 
 
-      if (!useBinIntegral) {
+      if (fvalBatch) {
+         fval = *fvalBatch;
+      }
+      else if (!useBinIntegral) {
 #ifdef USE_PARAMCACHE
          fval = func ( x );
 #else
@@ -307,7 +380,7 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
       else {
          // calculate integral normalized by bin volume
          // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x, data.BinUpEdge(i)) ;
+         fval = igEval( x, GetBinUpEdge(data, i, x2buf)) ;
       }
       // normalize result if requested according to bin volume
       if (useBinVolume) fval *= binVolume;
@@ -349,6 +422,25 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
       return chi2;
   };
 
+  const unsigned int nBlocks = (n + kEvalBlockSize - 1) / kEvalBlockSize;
+  auto blockFunction = [&](const unsigned iblock){
+     const unsigned int begin = iblock * kEvalBlockSize;
+     const unsigned int end = std::min(n, begin + kEvalBlockSize);
+     double fval[kEvalBlockSize];
+     if (useBatch) EvalModelBlock(func, data, begin, end - begin, p, fval);
+     // the integrators are not thread safe: use one per block
+#ifdef USE_PARAMCACHE
+     IntegralEvaluator<> igEval( func, 0, useBinIntegral);
+#else
+     IntegralEvaluator<> igEval( func, p, useBinIntegral);
+#endif
+     std::vector<double> x2buf(data.NDim());
+     double chi2{};
+     for (unsigned int i = begin; i < end; ++i)
+        chi2 += mapFunction(i, useBatch ? &fval[i - begin] : nullptr, igEval, x2buf.data());
+     return chi2;
+  };
+
 #ifdef R__USE_IMT
   auto redFunction = [](const std::vector<double> & objs){
                           return std::accumulate(objs.begin(), objs.end(), double{});
@@ -359,14 +451,14 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
   double res{};
   if(executionPolicy == ROOT::Fit::kSerial){
-    for (unsigned int i=0; i<n; ++i) {
-      res += mapFunction(i);
+    for (unsigned int iblock=0; iblock<nBlocks; ++iblock) {
+      res += blockFunction(iblock);
     }
 #ifdef R__USE_IMT
   } else if(executionPolicy == ROOT::Fit::kMultithread) {
     auto chunks = nChunks !=0? nChunks: setAutomaticChunking(data.Size());
     ROOT::TThreadExecutor pool;
-    res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+    res = pool.MapReduce(blockFunction, ROOT::TSeq<unsigned>(0, nBlocks), redFunction, std::min(chunks, nBlocks));
 #endif
 //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
     // ROOT::TProcessExecutor pool;
@@ -381,7 +473,8 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
 //___________________________________________________________________________________________________________________________
 
-double FitUtil::EvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints) {
+double FitUtil::EvaluateChi2Effective(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints,
+                                      const unsigned int & executionPolicy, unsigned nChunks) {
    // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints
    // the actual number of used points
    // method using the error in the coordinates
@@ -396,26 +489,26 @@ double FitUtil::EvaluateChi2Effective(const IModelFunction & func, const BinData
 
    assert(data.HaveCoordErrors()  || data.HaveAsymErrors());
 
-   double chi2 = 0;
-   //int nRejected = 0;
-
-
    //func.SetParameters(p);
 
    unsigned int ndim = func.NDim();
 
-   // use Richardson derivator
-   ROOT::Math::RichardsonDerivator derivator;
-
    double maxResValue = std::numeric_limits<double>::max() /n;
 
+   auto mapFunction = [&](const unsigned i) {
 
-
-   for (unsigned int i = 0; i < n; ++ i) {
-
-
-      double y = 0;
-      const double * x = data.GetPoint(i,y);
+      // use Richardson derivator
+      ROOT::Math::RichardsonDerivator derivator;
+
+      // copy the point: GetPoint and GetPointError are not thread safe
+      std::vector<double> xv(ndim);
+      std::vector<double> exv(ndim);
+      GetPointCoords(data, i, xv.data());
+      for (unsigned int j = 0; j < ndim; ++j)
+         exv[j] = data.GetCoordErrorComponent(i, j);
+      const double * x = xv.data();
+      const double * ex = exv.data();
+      double y = data.Value(i);
 
       double fval = func( x, p );
 
@@ -423,12 +516,11 @@ double FitUtil::EvaluateChi2Effective(const IModelFunction & func, const BinData
 
 
       double ey = 0;
-      const double * ex = 0;
       if (!data.HaveAsymErrors() )
-         ex = data.GetPointError(i, ey);
+         ey = data.Error(i);
       else {
          double eylow, eyhigh = 0;
-         ex = data.GetPointError(i, eylow, eyhigh);
+         data.GetAsymError(i, eylow, eyhigh);
          if ( delta_y_func < 0)
             ey = eyhigh; // function is higher than points
          else
@@ -474,17 +566,34 @@ double FitUtil::EvaluateChi2Effective(const IModelFunction & func, const BinData
 
       // avoid (infinity and nan ) in the chi2 sum
       // eventually add possibility of excluding some points (like singularity)
-      if ( resval < maxResValue )
-         chi2 += resval;
-      else
-         chi2 += maxResValue;
-      //nRejected++;
+      return ( resval < maxResValue ) ? resval : maxResValue;
+   };
+
+#ifdef R__USE_IMT
+   auto redFunction = [](const std::vector<double> & objs){
+                          return std::accumulate(objs.begin(), objs.end(), double{});
+   };
+#else
+   (void)nChunks;
+#endif
 
+   double chi2{};
+   if(executionPolicy == ROOT::Fit::kSerial){
+      for (unsigned int i=0; i<n; ++i) {
+         chi2 += mapFunction(i);
+      }
+#ifdef R__USE_IMT
+   } else if(executionPolicy == ROOT::Fit::kMultithread) {
+      auto chunks = nChunks !=0? nChunks: setAutomaticChunking(data.Size());
+      ROOT::TThreadExecutor pool;
+      chi2 = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+#endif
+   } else{
+      Error("FitUtil::EvaluateChi2Effective","Execution policy unknown. Avalaible choices:\n 0: Serial (default)\n 1: MultiThread (requires IMT)\n");
    }
 
    // reset the number of fitting data points
    nPoints = n;  // no points are rejected
-   //if (nRejected != 0)  nPoints = n - nRejected;
 
 #ifdef DEBUG
    std::cout << "chi2 = " << chi2 << " n = " << nPoints  << std::endl;
@@ -607,7 +716,8 @@ double FitUtil::EvaluateChi2Residual(const IModelFunction & func, const BinData
 
 }
 
-void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, unsigned int & nPoints) {
+void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, unsigned int & nPoints,
+                                   const unsigned int & executionPolicy, unsigned nChunks) {
    // evaluate the gradient of the chi2 function
    // this function is used when the model function knows how to calculate the derivative and we can
    // avoid that the minimizer re-computes them
@@ -618,8 +728,6 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
       MATH_ERROR_MSG("FitUtil::EvaluateChi2Residual","Error on the coordinates are not used in calculating Chi2 gradient");            return; // it will assert otherwise later in GetPoint
    }
 
-   unsigned int nRejected = 0;
-
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
    assert (fg != 0); // must be called by a gradient function
 
@@ -637,98 +745,104 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
 
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
-   IntegralEvaluator<> igEval( func, p, useBinIntegral);
-
-   //int nRejected = 0;
-   // set values of parameters
-
    unsigned int npar = func.NPar();
    //   assert (npar == NDim() );  // npar MUST be  Chi2 dimension
-   std::vector<double> gradFunc( npar );
-   // set all vector values to zero
-   std::vector<double> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
+   std::atomic<unsigned int> nRejected(0);
 
+   // add to g the gradient contributions of the points [begin, end)
+   auto blockFunction = [&](unsigned int begin, unsigned int end, double * g) {
 
-      double y, invError = 0;
-      const double * x1 = data.GetPoint(i,y, invError);
+      // the integrators are not thread safe: use one per block
+      IntegralEvaluator<> igEval( func, p, useBinIntegral);
+      std::vector<double> gradFunc( npar );
+      std::vector<double> x1v( data.NDim() );
+      std::vector<double> xc( data.NDim() );
+      std::vector<double> x2v( data.NDim() );
 
-      double fval = 0;
-      const double * x2 = 0;
+      for (unsigned int i = begin; i < end; ++ i) {
 
-      double binVolume = 1;
-      if (useBinVolume) {
-         unsigned int ndim = data.NDim();
-         x2 = data.BinUpEdge(i);
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+         double y = data.Value(i);
+         double invError = data.Error(i);
+         invError = (invError != 0.0) ? 1.0/invError : 1;
+         GetPointCoords(data, i, x1v.data());
+         const double * x1 = x1v.data();
+
+         double fval = 0;
+         const double * x2 = 0;
+
+         double binVolume = 1;
+         if (useBinVolume) {
+            unsigned int ndim = data.NDim();
+            x2 = GetBinUpEdge(data, i, x2v.data());
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral ) {
-         fval = func ( x, p );
-         func.ParameterGradient(  x , p, &gradFunc[0] );
-      }
-      else {
-         x2 = data.BinUpEdge(i);
-         // calculate normalized integral and gradient (divided by bin volume)
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, x2 ) ;
-         CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
-      }
-      if (useBinVolume) fval *= binVolume;
+         if (!useBinIntegral ) {
+            fval = func ( x, p );
+            func.ParameterGradient(  x , p, &gradFunc[0] );
+         }
+         else {
+            x2 = GetBinUpEdge(data, i, x2v.data());
+            // calculate normalized integral and gradient (divided by bin volume)
+            fval = igEval( x1, x2 ) ;
+            CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
+         }
+         if (useBinVolume) fval *= binVolume;
 
 #ifdef DEBUG
-      std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
-      for (unsigned int ipar = 0; ipar < npar; ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << std::endl;
+         std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
+         for (unsigned int ipar = 0; ipar < npar; ++ipar)
+            std::cout << p[ipar] << "\t";
+         std::cout << "\tfval = " << fval << std::endl;
 #endif
-      if ( !CheckValue(fval) ) {
-         nRejected++;
-         continue;
-      }
+         if ( !CheckValue(fval) ) {
+            nRejected++;
+            continue;
+         }
 
-      // loop on the parameters
-      unsigned int ipar = 0;
-      for ( ; ipar < npar ; ++ipar) {
+         // compute the point contributions first, to skip the point
+         // in case of an overflow in the gradient calculation
+         unsigned int ipar = 0;
+         for ( ; ipar < npar ; ++ipar) {
 
-         // correct gradient for bin volumes
-         if (useBinVolume) gradFunc[ipar] *= binVolume;
+            // correct gradient for bin volumes
+            if (useBinVolume) gradFunc[ipar] *= binVolume;
 
-         // avoid singularity in the function (infinity and nan ) in the chi2 sum
-         // eventually add possibility of excluding some points (like singularity)
-         double dfval = gradFunc[ipar];
-         if ( !CheckValue(dfval) ) {
-               break; // exit loop on parameters
-         }
+            // avoid singularity in the function (infinity and nan ) in the chi2 sum
+            // eventually add possibility of excluding some points (like singularity)
+            double dfval = gradFunc[ipar];
+            if ( !CheckValue(dfval) ) {
+                  break; // exit loop on parameters
+            }
 
-         // calculate derivative point contribution
-         double tmp = - 2.0 * ( y -fval )* invError * invError * gradFunc[ipar];
-         g[ipar] += tmp;
+            // calculate derivative point contribution
+            gradFunc[ipar] = - 2.0 * ( y -fval )* invError * invError * gradFunc[ipar];
+         }
 
-      }
+         if ( ipar < npar ) {
+             // case loop was broken for an overflow in the gradient calculation
+            nRejected++;
+            continue;
+         }
 
-      if ( ipar < npar ) {
-          // case loop was broken for an overflow in the gradient calculation
-         nRejected++;
-         continue;
+         for (ipar = 0; ipar < npar; ++ipar)
+            g[ipar] += gradFunc[ipar];
       }
+   };
 
-
-   }
+   SumGradientBlocks(n, npar, blockFunction, grad, executionPolicy, nChunks, "FitUtil::EvaluateChi2Gradient");
 
    // correct the number of points
    nPoints = n;
@@ -738,9 +852,6 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
       if (nPoints < npar)  MATH_ERROR_MSG("FitUtil::EvaluateChi2Gradient","Error - too many points rejected for overflow in gradient calculation");
    }
 
-   // copy result
-   std::copy(g.begin(), g.end(), grad);
-
 }
 
 //______________________________________________________________________________________________________
@@ -842,31 +953,10 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double>  & func, const Un
 
    // needed to compue effective global weight in case of extended likelihood
 
-    auto mapFunction = [&](const unsigned i){
+    // the function values are computed by blocks of points, see below
+    auto mapFunction = [&](const unsigned i, double fval){
        double W = 0;
        double W2 = 0;
-       double fval = 0;
-
-       if(data.NDim() > 1) {
-          std::vector<double> x(data.NDim());
-          for (unsigned int j = 0; j < data.NDim(); ++j)
-             x[j] = *data.GetCoordComponent(i, j);
-#ifdef USE_PARAMCACHE
-          fval = func ( x.data() );
-#else
-          fval = func ( x.data(), p );
-#endif
-
-          // one -dim case
-       } else {
-          const auto x = data.GetCoordComponent(i, 0);
-#ifdef USE_PARAMCACHE
-          fval = func ( x );
-#else
-          fval = func ( x, p );
-#endif
-
-       }
 
       if (normalizeFunc) fval = fval * (1/norm);
 
@@ -884,10 +974,21 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double>  & func, const Un
             }
          }
       }
-   nPoints++;
       return LikelihoodAux<double>(logval, W, W2);
    };
 
+   const unsigned int nBlocks = (n + kEvalBlockSize - 1) / kEvalBlockSize;
+   auto blockFunction = [&](const unsigned iblock){
+      const unsigned int begin = iblock * kEvalBlockSize;
+      const unsigned int end = std::min(n, begin + kEvalBlockSize);
+      double fval[kEvalBlockSize];
+      EvalModelBlock(func, data, begin, end - begin, p, fval);
+      LikelihoodAux<double> res;
+      for (unsigned int i = begin; i < end; ++i)
+         res += mapFunction(i, fval[i - begin]);
+      return res;
+   };
+
 #ifdef R__USE_IMT
   auto redFunction = [](const std::vector<LikelihoodAux<double>> & objs){
            return std::accumulate(objs.begin(), objs.end(), LikelihoodAux<double>(0.0,0.0,0.0),
@@ -903,20 +1004,22 @@ double FitUtil::EvaluateLogL(const IModelFunctionTempl<double>  & func, const Un
   double sumW{};
   double sumW2{};
   if(executionPolicy == ROOT::Fit::kSerial){
-    for (unsigned int i=0; i<n; ++i) {
-      auto resArray = mapFunction(i);
+    for (unsigned int iblock=0; iblock<nBlocks; ++iblock) {
+      auto resArray = blockFunction(iblock);
       logl+=resArray.logvalue;
       sumW+=resArray.weight;
       sumW2+=resArray.weight2;
     }
+    nPoints += n;
 #ifdef R__USE_IMT
   } else if(executionPolicy == ROOT::Fit::kMultithread) {
     auto chunks = nChunks !=0? nChunks: setAutomaticChunking(data.Size());
     ROOT::TThreadExecutor pool;
-    auto resArray = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+    auto resArray = pool.MapReduce(blockFunction, ROOT::TSeq<unsigned>(0, nBlocks), redFunction, std::min(chunks, nBlocks));
     logl=resArray.logvalue;
     sumW=resArray.weight;
     sumW2=resArray.weight2;
+    nPoints += n;
 #endif
 //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
     // ROOT::TProcessExecutor pool;
@@ -982,7 +1085,8 @@ nPoints = 0;
    return -logl;
 }
 
-void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, double * grad, unsigned int & ) {
+void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, double * grad, unsigned int &,
+                                   const unsigned int & executionPolicy, unsigned nChunks) {
    // evaluate the gradient of the log likelihood function
 
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
@@ -993,30 +1097,32 @@ void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & d
    //int nRejected = 0;
 
    unsigned int npar = func.NPar();
-   std::vector<double> gradFunc( npar );
-   std::vector<double> g( npar);
-
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x = data.Coords(i);
-      double fval = func ( x , p);
-      func.ParameterGradient( x, p, &gradFunc[0] );
-      for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
-         if (fval > 0)
-            g[kpar] -= 1./fval * gradFunc[ kpar ];
-         else if (gradFunc [ kpar] != 0) {
-            const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
-            const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
-            double gg = kdmax1 * gradFunc[ kpar ];
-            if ( gg > 0) gg = std::min( gg, kdmax2);
-            else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
+
+   // add to g the gradient contributions of the points [begin, end)
+   auto blockFunction = [&](unsigned int begin, unsigned int end, double * g) {
+      std::vector<double> gradFunc( npar );
+      std::vector<double> x( data.NDim() );
+      for (unsigned int i = begin; i < end; ++ i) {
+         GetPointCoords(data, i, x.data());
+         double fval = func ( x.data() , p);
+         func.ParameterGradient( x.data(), p, &gradFunc[0] );
+         for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
+            if (fval > 0)
+               g[kpar] -= 1./fval * gradFunc[ kpar ];
+            else if (gradFunc [ kpar] != 0) {
+               const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
+               const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
+               double gg = kdmax1 * gradFunc[ kpar ];
+               if ( gg > 0) gg = std::min( gg, kdmax2);
+               else gg = std::max(gg, - kdmax2);
+               g[kpar] -= gg;
+            }
+            // if func derivative is zero term is also zero so do not add in g[kpar]
          }
-         // if func derivative is zero term is also zero so do not add in g[kpar]
       }
+   };
 
-    // copy result
-   std::copy(g.begin(), g.end(), grad);
-   }
+   SumGradientBlocks(n, npar, blockFunction, grad, executionPolicy, nChunks, "FitUtil::EvaluateLogLGradient");
 }
 //_________________________________________________________________________________________________
 // for binned log likelihood functions
@@ -1174,16 +1280,16 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
              << useBinVolume << " useW2 " << useW2 << " wrefVolume = " << wrefVolume << std::endl;
 #endif
 
-#ifdef USE_PARAMCACHE
-   IntegralEvaluator<> igEval(func, 0, useBinIntegral);
-#else
-   IntegralEvaluator<> igEval(func, p, useBinIntegral);
-#endif
+   // the model function is evaluated by blocks of points (fvalBatch), unless
+   // it needs to be integrated or evaluated at the bin centers
+   const bool useBatch = !useBinIntegral && !useBinVolume;
+
    // double nuTot = 0; // total number of expected events (needed for non-extended fits)
    // double wTot = 0; // sum of all weights
    // double w2Tot = 0; // sum of weight squared  (these are needed for useW2)
 
-   auto mapFunction = [&](const unsigned i) {
+   auto mapFunction = [&](const unsigned i, const double *fvalBatch, IntegralEvaluator<> &igEval, double *x2buf,
+                          unsigned int &nPointsBlock) {
       auto x1 = data.GetCoordComponent(i, 0);
       auto y = *data.ValuePtr(i);
 
@@ -1194,7 +1300,7 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
 
       if (useBinVolume) {
          unsigned int ndim = data.NDim();
-         const double *x2 = data.BinUpEdge(i);
+         const double *x2 = GetBinUpEdge(data, i, x2buf);
          xc.resize(data.NDim());
          for (unsigned int j = 0; j < ndim; ++j) {
             auto xx = *data.GetCoordComponent(i, j);
@@ -1215,7 +1321,9 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
          x = x1;
       }
 
-      if (!useBinIntegral) {
+      if (fvalBatch) {
+         fval = *fvalBatch;
+      } else if (!useBinIntegral) {
 #ifdef USE_PARAMCACHE
          fval = func(x);
 #else
@@ -1224,7 +1332,7 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
       } else {
          // calculate integral (normalized by bin volume)
          // need to set function and parameters here in case loop is parallelized
-         fval = igEval(x, data.BinUpEdge(i));
+         fval = igEval(x, GetBinUpEdge(data, i, x2buf));
       }
       if (useBinVolume) fval *= binVolume;
 
@@ -1238,7 +1346,7 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
          std::cout << "]  ";
          if (fitOpt.fIntegral) {
             std::cout << "x2 = [ ";
-            for (unsigned int j = 0; j < func.NDim(); ++j) std::cout << data.BinUpEdge(i)[j] << " , ";
+            for (unsigned int j = 0; j < func.NDim(); ++j) std::cout << data.GetBinUpEdgeComponent(i, j) << " , ";
             std::cout << "] ";
          }
          std::cout << "  y = " << y << " fval = " << fval << std::endl;
@@ -1283,12 +1391,34 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
 
          if (y >  0) {
             nloglike += y * (ROOT::Math::Util::EvalLog(y) - ROOT::Math::Util::EvalLog(fval));
-            nPoints++;
+            nPointsBlock++;
          }
       }
       return nloglike;
    };
 
+   // the non empty bins are counted per block, which is returned together
+   // with the block likelihood so that the count is not raced on
+   const unsigned int nBlocks = (n + kEvalBlockSize - 1) / kEvalBlockSize;
+   auto blockFunction = [&](const unsigned iblock) {
+      const unsigned int begin = iblock * kEvalBlockSize;
+      const unsigned int end = std::min(n, begin + kEvalBlockSize);
+      double fval[kEvalBlockSize];
+      if (useBatch) EvalModelBlock(func, data, begin, end - begin, p, fval);
+      // the integrators are not thread safe: use one per block
+#ifdef USE_PARAMCACHE
+      IntegralEvaluator<> igEval(func, 0, useBinIntegral);
+#else
+      IntegralEvaluator<> igEval(func, p, useBinIntegral);
+#endif
+      std::vector<double> x2buf(data.NDim());
+      unsigned int nPointsBlock = 0;
+      double nloglike{};
+      for (unsigned int i = begin; i < end; ++i)
+         nloglike += mapFunction(i, useBatch ? &fval[i - begin] : nullptr, igEval, x2buf.data(), nPointsBlock);
+      return std::make_pair(nloglike, nPointsBlock);
+   };
+
    // if (notExtended) {
    //    // not extended : remove from the Likelihood the global Poisson term
    //    if (!useW2)
@@ -1305,23 +1435,30 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
    //    //nloglike += (w2Tot/wTot) * nuTot;
    // }
 #ifdef R__USE_IMT
-   auto redFunction = [](const std::vector<double> &objs) {
-      return std::accumulate(objs.begin(), objs.end(), double{});
+   auto redFunction = [](const std::vector<std::pair<double, unsigned int>> &objs) {
+      std::pair<double, unsigned int> sum{};
+      for (auto &obj : objs) {
+         sum.first += obj.first;
+         sum.second += obj.second;
+      }
+      return sum;
    };
 #else
    (void)nChunks;
 #endif
 
-   double res{};
+   std::pair<double, unsigned int> res{};
    if (executionPolicy == ROOT::Fit::kSerial) {
-      for (unsigned int i = 0; i < n; ++i) {
-         res += mapFunction(i);
+      for (unsigned int iblock = 0; iblock < nBlocks; ++iblock) {
+         auto blockRes = blockFunction(iblock);
+         res.first += blockRes.first;
+         res.second += blockRes.second;
       }
 #ifdef R__USE_IMT
    } else if (executionPolicy == ROOT::Fit::kMultithread) {
       auto chunks = nChunks != 0 ? nChunks : setAutomaticChunking(data.Size());
       ROOT::TThreadExecutor pool;
-      res = pool.MapReduce(mapFunction, ROOT::TSeq<unsigned>(0, n), redFunction, chunks);
+      res = pool.MapReduce(blockFunction, ROOT::TSeq<unsigned>(0, nBlocks), redFunction, std::min(chunks, nBlocks));
 #endif
       //   } else if(executionPolicy == ROOT::Fit::kMultitProcess){
       // ROOT::TProcessExecutor pool;
@@ -1331,14 +1468,17 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction &func, const BinData &d
             "Execution policy unknown. Avalaible choices:\n 0: Serial (default)\n 1: MultiThread (requires IMT)\n");
    }
 
+   nPoints = res.second;
+
 #ifdef DEBUG
-   std::cout << "Loglikelihood  = " << res << std::endl;
+   std::cout << "Loglikelihood  = " << res.first << std::endl;
 #endif
 
-   return res;
+   return res.first;
 }
 
-void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, double * grad ) {
+void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, double * grad,
+                                          const unsigned int & executionPolicy, unsigned nChunks) {
    // evaluate the gradient of the Poisson log likelihood function
 
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
@@ -1352,73 +1492,77 @@ void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinDat
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
 
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
-   IntegralEvaluator<> igEval( func, p, useBinIntegral);
-
    unsigned int npar = func.NPar();
-   std::vector<double> gradFunc( npar );
-   std::vector<double> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x1 = data.Coords(i);
-      double y = data.Value(i);
-      double fval = 0;
-      const double * x2 = 0;
-
-      double binVolume = 1.0;
-      if (useBinVolume) {
-         x2 = data.BinUpEdge(i);
-         unsigned int ndim = data.NDim();
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+   // add to g the gradient contributions of the points [begin, end)
+   auto blockFunction = [&](unsigned int begin, unsigned int end, double * g) {
+
+      // the integrators are not thread safe: use one per block
+      IntegralEvaluator<> igEval( func, p, useBinIntegral);
+      std::vector<double> gradFunc( npar );
+      std::vector<double> x1v( data.NDim() );
+      std::vector<double> xc( data.NDim() );
+      std::vector<double> x2v( data.NDim() );
+
+      for (unsigned int i = begin; i < end; ++ i) {
+         GetPointCoords(data, i, x1v.data());
+         const double * x1 = x1v.data();
+         double y = data.Value(i);
+         double fval = 0;
+         const double * x2 = 0;
+
+         double binVolume = 1.0;
+         if (useBinVolume) {
+            x2 = GetBinUpEdge(data, i, x2v.data());
+            unsigned int ndim = data.NDim();
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral) {
-         fval = func ( x, p );
-         func.ParameterGradient(  x , p, &gradFunc[0] );
-      }
-      else {
-         // calculate integral (normalized by bin volume)
-         // need to set function and parameters here in case loop is parallelized
-         x2 = data.BinUpEdge(i);
-         fval = igEval( x1, x2) ;
-         CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
-      }
-      if (useBinVolume) fval *= binVolume;
-
-      // correct the gradient
-      for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
-
-         // correct gradient for bin volumes
-         if (useBinVolume) gradFunc[kpar] *= binVolume;
-
-         // df/dp * (1.  - y/f )
-         if (fval > 0)
-            g[kpar] += gradFunc[ kpar ] * ( 1. - y/fval );
-         else if (gradFunc [ kpar] != 0) {
-            const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
-            const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
-            double gg = kdmax1 * gradFunc[ kpar ];
-            if ( gg > 0) gg = std::min( gg, kdmax2);
-            else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
+         if (!useBinIntegral) {
+            fval = func ( x, p );
+            func.ParameterGradient(  x , p, &gradFunc[0] );
+         }
+         else {
+            // calculate integral (normalized by bin volume)
+            x2 = GetBinUpEdge(data, i, x2v.data());
+            fval = igEval( x1, x2) ;
+            CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
+         }
+         if (useBinVolume) fval *= binVolume;
+
+         // correct the gradient
+         for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
+
+            // correct gradient for bin volumes
+            if (useBinVolume) gradFunc[kpar] *= binVolume;
+
+            // df/dp * (1.  - y/f )
+            if (fval > 0)
+               g[kpar] += gradFunc[ kpar ] * ( 1. - y/fval );
+            else if (gradFunc [ kpar] != 0) {
+               const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
+               const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
+               double gg = kdmax1 * gradFunc[ kpar ];
+               if ( gg > 0) gg = std::min( gg, kdmax2);
+               else gg = std::max(gg, - kdmax2);
+               g[kpar] -= gg;
+            }
          }
       }
+   };
 
-      // copy result
-      std::copy(g.begin(), g.end(), grad);
-   }
+   SumGradientBlocks(n, npar, blockFunction, grad, executionPolicy, nChunks, "FitUtil::EvaluatePoissonLogLGradient");
 }
 
 unsigned FitUtil::setAutomaticChunking(unsigned nEvents){
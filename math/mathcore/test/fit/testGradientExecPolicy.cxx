@@ -0,0 +1,165 @@
+#include "TH1.h"
+#include "TF1.h"
+#include "TRandom.h"
+#include "TStopwatch.h"
+#include "TFitResult.h"
+#include "TError.h"
+#include "HFitInterface.h"
+#include "Fit/BinData.h"
+#include "Fit/FitUtil.h"
+#include "Math/WrappedMultiTF1.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// compare the gradients g1 with the reference g2 (1e-6 relative tolerance)
+int compareGradient(const std::vector<double> &g1, const std::vector<double> &g2, std::string s = "",
+                    double tol = 1.E-6)
+{
+   for (unsigned int k = 0; k < g2.size(); ++k) {
+      if (std::abs(g1[k] - g2[k]) > tol * (std::abs(g2[k]) + 1.)) {
+         std::cerr << s << " Failed comparison of gradient component " << k << " \t " << g1[k]
+                   << "   it should be = " << g2[k] << std::endl;
+         return -1;
+      }
+   }
+   return 0;
+}
+
+double func(const double *x, const double *params)
+{
+   return params[0] * exp(-(*x + (-130.)) * (*x + (-130.)) / 2) +
+          params[1] * exp(-(params[2] * (*x * (0.01)) - params[3] * ((*x) * (0.01)) * ((*x) * (0.01))));
+}
+
+#ifdef R__USE_IMT
+// compare the multithreaded chi2, Poisson likelihood and their gradients with the serial ones,
+// for fits using the bin edges (bin volume or integral option)
+int testBinEdgeOptions(TF1 *f, const TH1 &h, const ROOT::Fit::DataOptions &opt, std::string s)
+{
+   ROOT::Fit::BinData data(opt);
+   ROOT::Fit::FillData(data, &h, f);
+   ROOT::Math::WrappedMultiTF1 wf(*f, 1);
+   const double p[4] = {1.1, 990, 7.4, 1.6};
+   unsigned int nPoints = 0;
+   int iret = 0;
+
+   double chi2 = ROOT::Fit::FitUtil::EvaluateChi2(wf, data, p, nPoints, ROOT::Fit::kSerial);
+   double chi2MT = ROOT::Fit::FitUtil::EvaluateChi2(wf, data, p, nPoints, ROOT::Fit::kMultithread);
+   double logL = ROOT::Fit::FitUtil::EvaluatePoissonLogL(wf, data, p, 0, true, nPoints, ROOT::Fit::kSerial);
+   double logLMT = ROOT::Fit::FitUtil::EvaluatePoissonLogL(wf, data, p, 0, true, nPoints, ROOT::Fit::kMultithread);
+   if (std::abs(chi2MT - chi2) > 1.E-10 * std::abs(chi2)) {
+      std::cerr << s << " multithreaded chi2 " << chi2MT << " differs from the serial one " << chi2 << std::endl;
+      iret = -1;
+   }
+   if (std::abs(logLMT - logL) > 1.E-10 * std::abs(logL)) {
+      std::cerr << s << " multithreaded likelihood " << logLMT << " differs from the serial one " << logL
+                << std::endl;
+      iret = -1;
+   }
+
+   std::vector<double> g(4), gMT(4);
+   ROOT::Fit::FitUtil::EvaluateChi2Gradient(wf, data, p, g.data(), nPoints, ROOT::Fit::kSerial);
+   ROOT::Fit::FitUtil::EvaluateChi2Gradient(wf, data, p, gMT.data(), nPoints, ROOT::Fit::kMultithread);
+   iret |= compareGradient(gMT, g, s + " multithreaded Chi2 gradient: ");
+   ROOT::Fit::FitUtil::EvaluatePoissonLogLGradient(wf, data, p, g.data(), ROOT::Fit::kSerial);
+   ROOT::Fit::FitUtil::EvaluatePoissonLogLGradient(wf, data, p, gMT.data(), ROOT::Fit::kMultithread);
+   iret |= compareGradient(gMT, g, s + " multithreaded Poisson likelihood gradient: ");
+   return iret;
+}
+#endif
+
+int main()
+{
+   TF1 *f = new TF1("fGrad", func, 100, 200, 4);
+   f->SetParameters(1, 1000, 7.5, 1.5);
+
+   // large number of bins, to measure the parallel gradient evaluation
+   TH1D h1("h1", "Test random numbers", 1000000, 100, 200);
+   gRandom->SetSeed(1);
+   h1.FillRandom("fGrad", 10000000);
+
+   ROOT::Fit::DataOptions opt;
+   ROOT::Fit::BinData data(opt);
+   ROOT::Fit::FillData(data, &h1, f);
+   ROOT::Math::WrappedMultiTF1 wf(*f, 1);
+
+   const double p[4] = {1.1, 990, 7.4, 1.6};
+   const int nIter = 5;
+   unsigned int nPoints = 0;
+   int iret = 0;
+   TStopwatch w;
+
+   std::vector<double> gChi2(4), gPoisson(4);
+   w.Start();
+   for (int i = 0; i < nIter; ++i)
+      ROOT::Fit::FitUtil::EvaluateChi2Gradient(wf, data, p, gChi2.data(), nPoints, ROOT::Fit::kSerial);
+   w.Stop();
+   std::cout << "Chi2 gradient serial:              " << w.RealTime() / nIter << " s" << std::endl;
+
+   w.Start();
+   for (int i = 0; i < nIter; ++i)
+      ROOT::Fit::FitUtil::EvaluatePoissonLogLGradient(wf, data, p, gPoisson.data(), ROOT::Fit::kSerial);
+   w.Stop();
+   std::cout << "Poisson likelihood gradient serial: " << w.RealTime() / nIter << " s" << std::endl;
+
+#ifdef R__USE_IMT
+   std::vector<double> g(4);
+   w.Start();
+   for (int i = 0; i < nIter; ++i)
+      ROOT::Fit::FitUtil::EvaluateChi2Gradient(wf, data, p, g.data(), nPoints, ROOT::Fit::kMultithread);
+   w.Stop();
+   std::cout << "Chi2 gradient multithread:              " << w.RealTime() / nIter << " s" << std::endl;
+   iret |= compareGradient(g, gChi2, "Multithreaded Chi2 gradient: ");
+
+   w.Start();
+   for (int i = 0; i < nIter; ++i)
+      ROOT::Fit::FitUtil::EvaluatePoissonLogLGradient(wf, data, p, g.data(), ROOT::Fit::kMultithread);
+   w.Stop();
+   std::cout << "Poisson likelihood gradient multithread: " << w.RealTime() / nIter << " s" << std::endl;
+   iret |= compareGradient(g, gPoisson, "Multithreaded Poisson likelihood gradient: ");
+
+   std::cout << "\n **FIT: Multithreaded Chi2 with gradient **\n\n";
+   f->SetParameters(1, 1000, 7.5, 1.5);
+   auto r1 = h1.Fit(f, "S G Q");
+   f->SetParameters(1, 1000, 7.5, 1.5);
+   auto r2 = h1.Fit(f, "MULTITHREAD S G Q");
+   if ((Int_t)r1 != 0 || (Int_t)r2 != 0) {
+      Error("testGradientExecPolicy", "Chi2 Fit with gradient failed!");
+      return -1;
+   }
+   if (std::abs(r2->MinFcnValue() - r1->MinFcnValue()) > 0.01 * std::abs(r1->MinFcnValue())) {
+      Error("testGradientExecPolicy", "Multithreaded Chi2 Fit with gradient differs from the sequential one");
+      iret = -1;
+   }
+
+   // the bin volume and integral options read the bin upper edges in each block
+   TH1D h2("h2", "Test random numbers", 2000, 100, 200);
+   h2.FillRandom("fGrad", 1000000);
+   ROOT::Fit::DataOptions optVolume;
+   optVolume.fBinVolume = true;
+   iret |= testBinEdgeOptions(f, h2, optVolume, "Bin volume:");
+   ROOT::Fit::DataOptions optIntegral;
+   optIntegral.fIntegral = true;
+   iret |= testBinEdgeOptions(f, h2, optIntegral, "Bin integral:");
+
+   std::cout << "\n **FIT: Multithreaded Chi2 and likelihood with bin integral **\n\n";
+   for (const char *option : {"I S Q", "I L S Q"}) {
+      f->SetParameters(1, 1000, 7.5, 1.5);
+      auto r3 = h2.Fit(f, option);
+      f->SetParameters(1, 1000, 7.5, 1.5);
+      auto r4 = h2.Fit(f, TString("MULTITHREAD ") + option);
+      if ((Int_t)r3 != 0 || (Int_t)r4 != 0) {
+         Error("testGradientExecPolicy", "Fit with option %s failed!", option);
+         return -1;
+      }
+      if (std::abs(r4->MinFcnValue() - r3->MinFcnValue()) > 1.E-6 * std::abs(r3->MinFcnValue())) {
+         Error("testGradientExecPolicy", "Multithreaded fit with option %s differs from the sequential one", option);
+         iret = -1;
+      }
+   }
+#endif
+
+   return iret;
+}
@@ -50,6 +50,8 @@ public:
 
    void SetErrorDef(double up) { fUp = up; }
 
+   bool IsThreadSafe() const { return fFunc.IsThreadSafe(); }
+
    //virtual std::vector<double> Gradient(const std::vector<double>&) const;
 
    // forward interface
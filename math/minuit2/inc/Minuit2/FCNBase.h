@@ -113,6 +113,13 @@ public:
    */
    virtual void SetErrorDef(double ) {};
 
+   /**
+       return true if the function can be called concurrently from several threads.
+       Only then the numerical gradient may be computed in parallel
+       (see MnStrategy::SetParallelGradient). Re-implement this function if needed.
+   */
+   virtual bool IsThreadSafe() const { return false; }
+
 };
 
   }  // namespace Minuit2
@@ -71,6 +71,8 @@ public:
    //virtual double operator()(int npar, double* params,int iflag = 4) const;
    bool CheckGradient() const { return false; }
 
+   bool IsThreadSafe() const { return fFunc.IsThreadSafe(); }
+
 private:
    const Function & fFunc;
    double fUp;
@@ -428,6 +428,9 @@ bool Minuit2Minimizer::Minimize() {
 
    // set strategy and add extra options if needed
    ROOT::Minuit2::MnStrategy strategy(strategyLevel);
+   // the gradient is computed in parallel for a function declaring itself thread safe,
+   // unless it is switched off with the ParallelGradient option
+   strategy.SetParallelGradient(fMinuitFCN->IsThreadSafe());
    ROOT::Math::IOptions * minuit2Opt = ROOT::Math::MinimizerOptions::FindDefault("Minuit2");
    if (minuit2Opt) {
       // set extra  options
@@ -462,6 +465,10 @@ bool Minuit2Minimizer::Minimize() {
       bool ret = minuit2Opt->GetValue("StorageLevel",storageLevel);
       if (ret) SetStorageLevel(storageLevel);
 
+      int parallelGrad = 1;
+      minuit2Opt->GetValue("ParallelGradient",parallelGrad);
+      if (parallelGrad == 0) strategy.SetParallelGradient(false);
+
       if (printLevel > 0) {
          std::cout << "Minuit2Minimizer::Minuit  - Changing default options" << std::endl;
          minuit2Opt->Print();
@@ -10,6 +10,7 @@
 #include "Minuit2/Numerical2PGradientCalculator.h"
 #include "Minuit2/InitialGradientCalculator.h"
 #include "Minuit2/MnFcn.h"
+#include "Minuit2/FCNBase.h"
 #include "Minuit2/MnUserTransformation.h"
 #include "Minuit2/MnMachinePrecision.h"
 #include "Minuit2/MinimumParameters.h"
@@ -33,6 +34,15 @@
 
 #include "Minuit2/MPIProcess.h"
 
+#ifdef USE_ROOT_ERROR
+#include "RConfigure.h"
+#endif
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 namespace ROOT {
 
    namespace Minuit2 {
@@ -100,10 +110,6 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    MnAlgebraicVector g2 = Gradient.G2();
    MnAlgebraicVector gstep = Gradient.Gstep();
 
-#ifndef _OPENMP
-   MPIProcess mpiproc(n,0);
-#endif
-
 #ifdef DEBUG
    std::cout << "Calculating Gradient at x =   " << par.Vec() << std::endl;
    int pr = std::cout.precision(13);
@@ -111,37 +117,14 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    std::cout.precision(pr);
 #endif
 
-#ifndef _OPENMP
-   // for serial execution this can be outside the loop
-   MnAlgebraicVector x = par.Vec();
-
-   unsigned int startElementIndex = mpiproc.StartElementIndex();
-   unsigned int endElementIndex = mpiproc.EndElementIndex();
-
-   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
-
-#else
-
- // parallelize this loop using OpenMP
-//#define N_PARALLEL_PAR 5
-#pragma omp parallel
-#pragma omp for
-//#pragma omp for schedule (static, N_PARALLEL_PAR)
-
-   for(int i = 0; i < int(n); i++) {
-
-#endif
+   // compute the derivative with respect to the parameter i, varying it in x
+   auto computeElement = [&](unsigned int i, MnAlgebraicVector & x) {
 
 #ifdef DEBUG_MP
       int ith = omp_get_thread_num();
       //std::cout << "Thread number " << ith << "  " << i << std::endl;
 #endif
 
-#ifdef _OPENMP
-       // create in loop since each thread will use its own copy
-      MnAlgebraicVector x = par.Vec();
-#endif
-
       double xtf = x(i);
       double epspri = eps2 + fabs(grd(i)*eps2);
       double stepb4 = 0.;
@@ -183,7 +166,7 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
          g2(i) = (fs1 + fs2 - 2.*fcnmin)/step/step;
 
 #ifdef DEBUG
-         pr = std::cout.precision(13);
+         int pr = std::cout.precision(13);
          std::cout << "cycle " << j << " x " << x(i) << " step " << step << " f1 " << fs1 << " f2 " << fs2
                    << " grd " << grd(i) << " g2 " << g2(i) << std::endl;
          std::cout.precision(pr);
@@ -212,17 +195,59 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
 
 
 #ifdef DEBUG
-      pr = std::cout.precision(13);
+      int pr2 = std::cout.precision(13);
       int iext = Trafo().ExtOfInt(i);
       std::cout << "Parameter " << Trafo().Name(iext) << " Gradient =   " << grd(i) << " g2 = " << g2(i) << " step " << gstep(i) << std::endl;
-      std::cout.precision(pr);
+      std::cout.precision(pr2);
 #endif
-   }
+   };
 
 #ifndef _OPENMP
+
+   MPIProcess mpiproc(n,0);
+
+   unsigned int startElementIndex = mpiproc.StartElementIndex();
+   unsigned int endElementIndex = mpiproc.EndElementIndex();
+
+#ifdef R__USE_IMT
+   // distribute the parameters of this process over the threads of the implicit MT pool.
+   // Each task varies its own copy of the parameter vector and fills distinct elements.
+   // Only a function that declares itself thread safe may be called concurrently
+   if (Strategy().ParallelGradient() && Fcn().Fcn().IsThreadSafe() && endElementIndex > startElementIndex + 1 && ROOT::IsImplicitMTEnabled()) {
+      auto taskFunc = [&](unsigned int i) {
+         MnAlgebraicVector x = par.Vec();
+         computeElement(i, x);
+      };
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(taskFunc, ROOT::TSeq<unsigned int>(startElementIndex, endElementIndex));
+   }
+   else
+#endif
+   {
+      // for serial execution this can be outside the loop
+      MnAlgebraicVector x = par.Vec();
+      for(unsigned int i = startElementIndex; i < endElementIndex; i++)
+         computeElement(i, x);
+   }
+
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(g2);
    mpiproc.SyncVector(gstep);
+
+#else
+
+ // parallelize this loop using OpenMP
+//#define N_PARALLEL_PAR 5
+#pragma omp parallel
+#pragma omp for
+//#pragma omp for schedule (static, N_PARALLEL_PAR)
+
+   for(int i = 0; i < int(n); i++) {
+       // create in loop since each thread will use its own copy
+      MnAlgebraicVector x = par.Vec();
+      computeElement(i, x);
+   }
+
 #endif
 
    return FunctionGradient(grd, g2, gstep);
@@ -22,8 +22,12 @@
 
 #include "RooObjCacheManager.h"
 
+#include <vector>
+
 class RooRealVar;
 class RooArgList ;
+class RooHistFunc ;
+class RooDataHist ;
 
 class PiecewiseInterpolation : public RooAbsReal {
 public:
@@ -88,6 +92,23 @@ protected:
 
   std::vector<int> _interpCode;
 
+  // Fused interpolation of all bins, for RooHistFunc nominal and variations
+  mutable Int_t _fastState ; //! 0: not initialized, 1: fused interpolation in use, -1: not applicable
+  mutable RooHistFunc* _fastNominalFunc ; //! Nominal function, used to find the current bin
+  mutable std::vector<Double_t> _fastNominal ; //! Nominal bin contents
+  mutable std::vector<Double_t> _fastLow ; //! Low-side bin contents, one block of bins per parameter
+  mutable std::vector<Double_t> _fastHigh ; //! High-side bin contents, one block of bins per parameter
+  mutable std::vector<Double_t> _fastParams ; //! Parameter values at which _fastYield was calculated
+  mutable std::vector<Double_t> _fastYield ; //! Interpolated contents of all bins
+  mutable Bool_t _fastYieldValid ; //! True if _fastYield is up to date
+  mutable std::vector<const RooDataHist*> _fastHists ; //! Histograms the bin contents were copied from
+  mutable std::vector<ULong_t> _fastHistVersions ; //! Content versions of _fastHists at the time of the copy
+
+  Bool_t initFastEval() const ;
+  void calculateFastYield() const ;
+
+  virtual Bool_t redirectServersHook(const RooAbsCollection& newServerList, Bool_t mustReplaceAll, Bool_t nameChange, Bool_t isRecursive) ;
+
   Double_t evaluate() const;
 
   ClassDef(PiecewiseInterpolation,3) // Sum of RooAbsReal objects
@@ -23,6 +23,8 @@
 #include "RooNLLVar.h"
 #include "RooChi2Var.h"
 #include "RooRealVar.h"
+#include "RooHistFunc.h"
+#include "RooDataHist.h"
 #include "RooMsgService.h"
 #include "RooNumIntConfig.h"
 #include "RooTrace.h"
@@ -38,7 +40,8 @@ ClassImp(PiecewiseInterpolation);
 
 ////////////////////////////////////////////////////////////////////////////////
 
-PiecewiseInterpolation::PiecewiseInterpolation()
+PiecewiseInterpolation::PiecewiseInterpolation() :
+  _fastState(0), _fastNominalFunc(0), _fastYieldValid(kFALSE)
 {
   _positiveDefinite=false;
   TRACE_CREATE
@@ -58,7 +61,8 @@ PiecewiseInterpolation::PiecewiseInterpolation(const char* name, const char* tit
   _lowSet("!lowSet","low-side variation",this),
   _highSet("!highSet","high-side variation",this),
   _paramSet("!paramSet","high-side variation",this),
-  _positiveDefinite(false)
+  _positiveDefinite(false),
+  _fastState(0), _fastNominalFunc(0), _fastYieldValid(kFALSE)
 
 {
   // Constructor with two set of RooAbsReals. The value of the function will be
@@ -134,7 +138,8 @@ PiecewiseInterpolation::PiecewiseInterpolation(const PiecewiseInterpolation& oth
   _highSet("!highSet",this,other._highSet),
   _paramSet("!paramSet",this,other._paramSet),
   _positiveDefinite(other._positiveDefinite),
-  _interpCode(other._interpCode)
+  _interpCode(other._interpCode),
+  _fastState(0), _fastNominalFunc(0), _fastYieldValid(kFALSE)
 {
   // Member _ownedList is intentionally not copy-constructed -- ownership is not transferred
   TRACE_CREATE
@@ -158,6 +163,47 @@ PiecewiseInterpolation::~PiecewiseInterpolation()
 
 Double_t PiecewiseInterpolation::evaluate() const 
 {
+  // Take the contents of the current bin from the fused interpolation of all bins
+  if (_fastState>0) {
+    // Copy the bin contents again if a histogram was changed (set, add, reset)
+    for (unsigned int k=0 ; k<_fastHists.size() ; k++) {
+      if (_fastHists[k]->contentVersion()!=_fastHistVersions[k]) {
+	_fastState = 0 ;
+	break ;
+      }
+    }
+  }
+  if (_fastState==0) {
+    initFastEval() ;
+  }
+  if (_fastState>0) {
+    Int_t bin = _fastNominalFunc->getBin() ;
+    if (bin>=0) {
+
+      // Interpolate all bins again if any parameter changed
+      RooFIter fastParamIter(_paramSet.fwdIterator()) ;
+      RooAbsReal* fastParam ;
+      for (Int_t j=0 ; (fastParam=(RooAbsReal*)fastParamIter.next()) ; j++) {
+	Double_t x = fastParam->getVal() ;
+	if (x!=_fastParams[j]) {
+	  _fastParams[j] = x ;
+	  _fastYieldValid = kFALSE ;
+	}
+      }
+      if (!_fastYieldValid) {
+	calculateFastYield() ;
+      }
+
+      Double_t sum = _fastYield[bin] ;
+      if(_positiveDefinite && (sum<0)){
+	sum = 0;
+      } else if(sum<0){
+	cxcoutD(Tracing) <<"PiecewiseInterpolation::evaluate -  sum < 0, not forcing positive definite"<<endl;
+      }
+      return sum;
+    }
+  }
+
   ///////////////////
   Double_t nominal = _nominal;
   Double_t sum(nominal) ;
@@ -309,6 +355,219 @@ Double_t PiecewiseInterpolation::evaluate() const
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Check if the interpolation can be done for all bins in one pass. This
+/// is the case if the nominal and all variations are RooHistFuncs without
+/// interpolation, on histograms with identical binning of the same
+/// observables, as made by HistFactory. The bin contents are then copied
+/// into contiguous arrays, which are copied again when the contents of one
+/// of the histograms change. Return true if the fused interpolation is used.
+
+Bool_t PiecewiseInterpolation::initFastEval() const
+{
+  _fastState = -1 ;
+  _fastYieldValid = kFALSE ;
+  _fastNominalFunc = 0 ;
+  _fastNominal.clear() ;
+  _fastLow.clear() ;
+  _fastHigh.clear() ;
+  _fastParams.clear() ;
+  _fastYield.clear() ;
+  _fastHists.clear() ;
+  _fastHistVersions.clear() ;
+
+  for (unsigned int i=0; i<_interpCode.size(); ++i) {
+    if (_interpCode[i]<0 || _interpCode[i]>5) return kFALSE ;
+  }
+  if (Int_t(_interpCode.size())!=_paramSet.getSize()) return kFALSE ;
+
+  RooHistFunc* nomFunc = dynamic_cast<RooHistFunc*>(_nominal.absArg()) ;
+  if (!nomFunc || nomFunc->getInterpolationOrder()!=0) return kFALSE ;
+
+  // Collect the variations, low-side first
+  std::vector<RooHistFunc*> funcs ;
+  RooFIter lowIter(_lowSet.fwdIterator()) ;
+  RooFIter highIter(_highSet.fwdIterator()) ;
+  RooAbsArg* arg ;
+  while((arg=lowIter.next())) funcs.push_back(dynamic_cast<RooHistFunc*>(arg)) ;
+  while((arg=highIter.next())) funcs.push_back(dynamic_cast<RooHistFunc*>(arg)) ;
+
+  RooDataHist& nomHist = nomFunc->dataHist() ;
+  const Int_t nBins = nomHist.numEntries() ;
+  RooArgSet* nomVars = nomFunc->getVariables() ;
+  Bool_t ok(kTRUE) ;
+  for (unsigned int k=0 ; ok && k<funcs.size() ; k++) {
+    RooHistFunc* func = funcs[k] ;
+    if (!func || func->getInterpolationOrder()!=0 || func->dataHist().numEntries()!=nBins) {
+      ok = kFALSE ;
+      break ;
+    }
+    RooArgSet* vars = func->getVariables() ;
+    ok = vars->equals(*nomVars) ;
+    delete vars ;
+
+    // Every bin of the nominal histogram must be the same bin in the variation
+    if (&func->dataHist()==&nomHist) continue ;
+    for (Int_t i=0 ; ok && i<nBins ; i++) {
+      ok = (func->dataHist().getIndex(*nomHist.get(i))==i) ;
+    }
+  }
+  delete nomVars ;
+  if (!ok) return kFALSE ;
+
+  const Int_t nParams = _paramSet.getSize() ;
+  _fastNominal.resize(nBins) ;
+  _fastLow.resize(nParams*nBins) ;
+  _fastHigh.resize(nParams*nBins) ;
+  for (Int_t i=0 ; i<nBins ; i++) {
+    nomHist.get(i) ;
+    _fastNominal[i] = nomHist.weight() ;
+  }
+  for (Int_t j=0 ; j<nParams ; j++) {
+    RooDataHist& lowHist = funcs[j]->dataHist() ;
+    RooDataHist& highHist = funcs[nParams+j]->dataHist() ;
+    for (Int_t i=0 ; i<nBins ; i++) {
+      lowHist.get(i) ;
+      _fastLow[j*nBins+i] = lowHist.weight() ;
+      highHist.get(i) ;
+      _fastHigh[j*nBins+i] = highHist.weight() ;
+    }
+  }
+  _fastParams.assign(nParams,0) ;
+  _fastYield.resize(nBins) ;
+  _fastNominalFunc = nomFunc ;
+  _fastHists.push_back(&nomHist) ;
+  for (unsigned int k=0 ; k<funcs.size() ; k++) {
+    _fastHists.push_back(&funcs[k]->dataHist()) ;
+  }
+  for (unsigned int k=0 ; k<_fastHists.size() ; k++) {
+    _fastHistVersions.push_back(_fastHists[k]->contentVersion()) ;
+  }
+  _fastState = 1 ;
+
+  return kTRUE ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Interpolate the contents of all bins at the parameter values in
+/// _fastParams, one parameter at a time. The arithmetic is the same as in
+/// evaluate(), such that both give identical results.
+
+void PiecewiseInterpolation::calculateFastYield() const
+{
+  const Int_t nBins = _fastNominal.size() ;
+  const Int_t nParams = _fastParams.size() ;
+  const Double_t* nom = _fastNominal.data() ;
+  Double_t* sum = _fastYield.data() ;
+
+  for (Int_t i=0 ; i<nBins ; i++) {
+    sum[i] = nom[i] ;
+  }
+
+  for (Int_t j=0 ; j<nParams ; j++) {
+    const Double_t x = _fastParams[j] ;
+    const Double_t* low = _fastLow.data() + j*nBins ;
+    const Double_t* high = _fastHigh.data() + j*nBins ;
+
+    switch(_interpCode[j]) {
+    case 0: {
+      // piece-wise linear
+      if (x>0) {
+	for (Int_t i=0 ; i<nBins ; i++) sum[i] += x*(high[i] - nom[i]) ;
+      } else {
+	for (Int_t i=0 ; i<nBins ; i++) sum[i] += x*(nom[i] - low[i]) ;
+      }
+      break ;
+    }
+    case 1: {
+      // piece-wise log
+      if (x>=0) {
+	for (Int_t i=0 ; i<nBins ; i++) sum[i] *= pow(high[i]/nom[i], +x) ;
+      } else {
+	for (Int_t i=0 ; i<nBins ; i++) sum[i] *= pow(low[i]/nom[i], -x) ;
+      }
+      break ;
+    }
+    case 2:
+    case 3: {
+      // parabolic with linear extrapolation
+      const double c = 0;
+      for (Int_t i=0 ; i<nBins ; i++) {
+	double a = 0.5*(high[i]+low[i])-nom[i];
+	double b = 0.5*(high[i]-low[i]);
+	if (x>1) {
+	  sum[i] += (2*a+b)*(x-1)+high[i]-nom[i];
+	} else if (x<-1) {
+	  sum[i] += -1*(2*a-b)*(x+1)+low[i]-nom[i];
+	} else {
+	  sum[i] += a*pow(x,2) + b*x+c;
+	}
+      }
+      break ;
+    }
+    case 4: {
+      // polynomial interpolation and linear extrapolation
+      if (x>1) {
+	for (Int_t i=0 ; i<nBins ; i++) sum[i] += x*(high[i] - nom[i]) ;
+      } else if (x<-1) {
+	for (Int_t i=0 ; i<nBins ; i++) sum[i] += x*(nom[i] - low[i]) ;
+      } else {
+	for (Int_t i=0 ; i<nBins ; i++) {
+	  double eps_plus = high[i] - nom[i];
+	  double eps_minus = nom[i] - low[i];
+	  double S = 0.5 * (eps_plus + eps_minus);
+	  double A = 0.0625 * (eps_plus - eps_minus);
+	  double val = nom[i] + x * (S + x * A * ( 15 + x * x * (-10 + x * x * 3  ) ) );
+	  if (val < 0) val = 0;
+	  sum[i] += val-nom[i];
+	}
+      }
+      break ;
+    }
+    case 5: {
+      const double x0 = 1.0;
+      if (x > x0 || x < -x0) {
+	if (x>0) {
+	  for (Int_t i=0 ; i<nBins ; i++) sum[i] += x*(high[i] - nom[i]) ;
+	} else {
+	  for (Int_t i=0 ; i<nBins ; i++) sum[i] += x*(nom[i] - low[i]) ;
+	}
+      } else {
+	for (Int_t i=0 ; i<nBins ; i++) {
+	  if (nom[i] == 0) continue ;
+	  double eps_plus = high[i] - nom[i];
+	  double eps_minus = nom[i] - low[i];
+	  double S = (eps_plus + eps_minus)/2;
+	  double A = (eps_plus - eps_minus)/2;
+	  double a = S;
+	  double b = 3*A/(2*x0);
+	  double d = -A/(2*x0*x0*x0);
+	  double val = nom[i] + a*x + b*pow(x, 2) + 0 + d*pow(x, 4);
+	  if (val < 0) val = 0;
+	  sum[i] += val-nom[i];
+	}
+      }
+      break ;
+    }
+    }
+  }
+
+  _fastYieldValid = kTRUE ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reinitialize the fused interpolation when servers are redirected
+
+Bool_t PiecewiseInterpolation::redirectServersHook(const RooAbsCollection& /*newServerList*/, Bool_t /*mustReplaceAll*/, 
+						   Bool_t /*nameChange*/, Bool_t /*isRecursive*/)
+{
+  _fastState = 0 ;
+  return kFALSE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Bool_t PiecewiseInterpolation::setBinIntegrator(RooArgSet& allVars) 
@@ -615,6 +874,7 @@ void PiecewiseInterpolation::setInterpCode(RooAbsReal& param, int code){
       coutW(InputArguments) << "PiecewiseInterpolation::setInterpCode :  " << param.GetName() 
 			    << " is now " << code << endl ;
     _interpCode.at(index) = code;
+    _fastState = 0 ;
   }
 }
 
@@ -625,6 +885,7 @@ void PiecewiseInterpolation::setAllInterpCodes(int code){
   for(unsigned int i=0; i<_interpCode.size(); ++i){
     _interpCode.at(i) = code;
   }
+  _fastState = 0 ;
 }
 
 
@@ -672,6 +933,7 @@ void PiecewiseInterpolation::Streamer(TBuffer &R__b)
       R__b.ReadClassBuffer(PiecewiseInterpolation::Class(),this);
       specialIntegratorConfig(kTRUE)->method1D().setLabel("RooBinIntegrator") ;      
       if (_interpCode.empty()) _interpCode.resize(_paramSet.getSize());
+      _fastState = 0 ;
    } else {
       R__b.WriteClassBuffer(PiecewiseInterpolation::Class(),this);
    }
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooDataHist.h"
+#include "RooFormulaVar.h"
+#include "RooHistFunc.h"
+#include "RooRealVar.h"
+#include "RooStats/HistFactory/PiecewiseInterpolation.h"
+
+#include <memory>
+
+namespace {
+
+const Int_t kNBins = 10;
+
+// Nominal and variations of a sample, and two interpolations of them: one on
+// the RooHistFuncs, which uses the fused interpolation of all bins, and one
+// on functions wrapping them, which is evaluated bin by bin.
+struct Sample {
+   RooRealVar x{"x", "x", 0, 10};
+   RooRealVar alpha{"alpha", "alpha", 0, -5, 5};
+   std::unique_ptr<RooDataHist> nomHist, lowHist, highHist;
+   std::unique_ptr<RooHistFunc> nom, low, high;
+   std::unique_ptr<RooFormulaVar> nomWrap, lowWrap, highWrap;
+   std::unique_ptr<PiecewiseInterpolation> fast, generic;
+
+   Sample()
+   {
+      x.setBins(kNBins);
+      nomHist.reset(new RooDataHist("nomHist", "", x));
+      lowHist.reset(new RooDataHist("lowHist", "", x));
+      highHist.reset(new RooDataHist("highHist", "", x));
+      for (Int_t i = 0; i < kNBins; ++i) {
+         x.setBin(i);
+         nomHist->set(x, 100. + 10 * i);
+         lowHist->set(x, 80. + 12 * i);
+         highHist->set(x, 115. + 7 * i + (i % 3));
+      }
+      nom.reset(new RooHistFunc("nom", "", x, *nomHist));
+      low.reset(new RooHistFunc("low", "", x, *lowHist));
+      high.reset(new RooHistFunc("high", "", x, *highHist));
+      nomWrap.reset(new RooFormulaVar("nomWrap", "@0", RooArgList(*nom)));
+      lowWrap.reset(new RooFormulaVar("lowWrap", "@0", RooArgList(*low)));
+      highWrap.reset(new RooFormulaVar("highWrap", "@0", RooArgList(*high)));
+      fast.reset(new PiecewiseInterpolation("fast", "", *nom, RooArgList(*low), RooArgList(*high), RooArgList(alpha)));
+      generic.reset(new PiecewiseInterpolation("generic", "", *nomWrap, RooArgList(*lowWrap), RooArgList(*highWrap),
+                                               RooArgList(alpha)));
+   }
+
+   void ExpectSame(int code)
+   {
+      for (Double_t a = -2.5; a <= 2.5; a += 0.25) {
+         alpha.setVal(a);
+         for (Int_t i = 0; i < kNBins; ++i) {
+            x.setBin(i);
+            EXPECT_DOUBLE_EQ(fast->getVal(), generic->getVal()) << "code " << code << " alpha " << a << " bin " << i;
+         }
+      }
+   }
+};
+
+} // namespace
+
+TEST(PiecewiseInterpolation, FastAndGenericPaths)
+{
+   Sample s;
+   for (int code = 0; code <= 5; ++code) {
+      s.fast->setAllInterpCodes(code);
+      s.generic->setAllInterpCodes(code);
+      s.ExpectSame(code);
+   }
+}
+
+TEST(PiecewiseInterpolation, HistogramChanges)
+{
+   Sample s;
+   s.fast->setAllInterpCodes(4);
+   s.generic->setAllInterpCodes(4);
+   s.ExpectSame(4);
+
+   // The copies of the bin contents follow the changes of the histograms.
+   s.x.setBin(3);
+   s.nomHist->set(s.x, 250.);
+   s.highHist->add(s.x, 20.);
+   s.ExpectSame(4);
+
+   s.lowHist->reset();
+   s.ExpectSame(4);
+}
@@ -25,6 +25,7 @@ Exponential p.d.f
 #include "Riostream.h"
 #include "Riostream.h"
 #include <math.h>
+#include <vector>
 
 #include "RooExponential.h"
 #include "RooRealVar.h"
@@ -57,6 +58,17 @@ Double_t RooExponential::evaluate() const{
   return exp(c*x);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the exponential for a range of events of data, see RooAbsReal::getValBatch()
+
+Bool_t RooExponential::evaluateBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents) const{
+  std::vector<Double_t> cVal(nEvents);
+  x.getValBatch(output,data,first,nEvents);
+  c.getValBatch(&cVal[0],data,first,nEvents);
+  for (Int_t i=0; i<nEvents; i++) output[i] = exp(cVal[i]*output[i]);
+  return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooExponential::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const
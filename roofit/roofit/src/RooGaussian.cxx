@@ -25,6 +25,7 @@ Plain Gaussian p.d.f
 #include "Riostream.h"
 #include "Riostream.h"
 #include <math.h>
+#include <vector>
 
 #include "RooGaussian.h"
 #include "RooAbsReal.h"
@@ -69,6 +70,24 @@ Double_t RooGaussian::evaluate() const
   return ret ;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the Gaussian for a range of events of data, see RooAbsReal::getValBatch()
+
+Bool_t RooGaussian::evaluateBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents) const
+{
+  std::vector<Double_t> meanVal(nEvents), sigmaVal(nEvents) ;
+  x.getValBatch(output,data,first,nEvents) ;
+  mean.getValBatch(&meanVal[0],data,first,nEvents) ;
+  sigma.getValBatch(&sigmaVal[0],data,first,nEvents) ;
+
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    Double_t arg= output[i] - meanVal[i];
+    Double_t sig = sigmaVal[i] ;
+    output[i] = exp(-0.5*arg*arg/(sig*sig)) ;
+  }
+  return kTRUE ;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// calculate and return the negative log-likelihood of the Poisson
 
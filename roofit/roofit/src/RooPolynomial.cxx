@@ -26,6 +26,7 @@ less than polynomial functions due to the normalization condition
 
 #include <cmath>
 #include <cassert>
+#include <algorithm>
 
 #include "RooPolynomial.h"
 #include "RooAbsReal.h"
@@ -123,6 +124,36 @@ Double_t RooPolynomial::evaluate() const
   return retVal * std::pow(x, lowestOrder) + (lowestOrder ? 1.0 : 0.0);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the polynomial for a range of events of data, see RooAbsReal::getValBatch()
+
+Bool_t RooPolynomial::evaluateBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents) const
+{
+  const unsigned sz = _coefList.getSize();
+  const int lowestOrder = _lowestOrder;
+  if (!sz) {
+    std::fill(output, output + nEvents, lowestOrder ? 1. : 0.);
+    return kTRUE;
+  }
+  // coefficient i of event k is coefs[i * nEvents + k]
+  std::vector<Double_t> coefs(sz * nEvents);
+  {
+    const RooArgSet* nset = _coefList.nset();
+    RooFIter it = _coefList.fwdIterator();
+    RooAbsReal* c;
+    unsigned i = 0;
+    while ((c = (RooAbsReal*) it.next())) c->getValBatch(&coefs[nEvents * i++], data, first, nEvents, nset);
+  }
+  _x.getValBatch(output, data, first, nEvents);
+  for (Int_t k = 0; k < nEvents; ++k) {
+    const Double_t x = output[k];
+    Double_t retVal = coefs[nEvents * (sz - 1) + k];
+    for (unsigned i = sz - 1; i--; ) retVal = coefs[nEvents * i + k] + x * retVal;
+    output[k] = retVal * std::pow(x, lowestOrder) + (lowestOrder ? 1.0 : 0.0);
+  }
+  return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooPolynomial::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const
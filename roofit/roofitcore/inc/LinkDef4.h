@@ -46,6 +46,7 @@
 #pragma link C++ class RooAbsDataStore+ ;
 #pragma link C++ class RooTreeDataStore- ;
 #pragma link C++ class RooCompositeDataStore+ ;
+#pragma link C++ class RooLinkedTreeDataStore- ;
 #pragma link C++ class RooTreeData+ ;
 #pragma link C++ class RooRangeBoolean+ ;
 #pragma link C++ class RooVectorDataStore- ;
@@ -59,6 +60,7 @@
 #ifndef __ROOFIT_NOROOMINIMIZER
 #pragma link C++ class RooMinimizer+ ;
 #pragma link C++ class RooMinimizerFcn+ ;
+#pragma link C++ class RooGradMinimizerFcn+ ;
 #endif
 #pragma link C++ class RooAbsMoment+ ;
 #pragma link C++ class RooMoment+ ;
@@ -18,6 +18,7 @@
 
 #include <assert.h>
 #include "TNamed.h"
+#include "ThreadLocalStorage.h"
 #include "THashList.h"
 #include "TRefArray.h"
 #include "RooPrintable.h"
@@ -40,6 +41,7 @@ class RooAbsCollection ;
 class RooTreeData ;
 class RooTreeDataStore ;
 class RooVectorDataStore ;
+class RooLinkedTreeDataStore ;
 class RooAbsData ;
 class RooAbsDataStore ;
 class RooAbsProxy ;
@@ -282,6 +284,10 @@ public:
 
   static void setDirtyInhibit(Bool_t flag) ;
 
+  // Tracking of value changes for caches that outlive the dirty flags
+  static ULong64_t currentDirtyStamp() ;
+  static ULong64_t lastValueChangeStamp() ;
+
   virtual Bool_t operator==(const RooAbsArg& other) = 0 ;
   virtual Bool_t isIdentical(const RooAbsArg& other, Bool_t assumeSameType=kFALSE) = 0 ;
 
@@ -530,6 +536,7 @@ public:
   friend class RooCompositeDataStore ;
   friend class RooTreeDataStore ;
   friend class RooVectorDataStore ;
+  friend class RooLinkedTreeDataStore ;
   friend class RooTreeData ;
   friend class RooDataSet ;
   friend class RooRealMPFE ;
@@ -550,7 +557,9 @@ public:
 
   // Debug stuff
   static Bool_t _verboseDirty ; // Static flag controlling verbose messaging for dirty state changes
-  static Bool_t _inhibitDirty ; // Static flag controlling global inhibit of dirty state propagation
+  // Flag controlling global inhibit of dirty state propagation. It is thread-local,
+  // as threads that evaluate clones of a function must not inhibit each other.
+  static Bool_t& _inhibitDirty() { TTHREAD_TLS(Bool_t) flag(kFALSE) ; return flag ; }
   Bool_t _deleteWatch ; //! Delete watch flag 
 
   Bool_t inhibitDirty() const ;
@@ -563,6 +572,8 @@ public:
   // Value and Shape dirty state bits
   void setValueDirty(const RooAbsArg* source) const ; 
   void setShapeDirty(const RooAbsArg* source) const ; 
+  void propagateValueDirty(const RooAbsArg* source, ULong64_t stamp) const ;
+  void propagateShapeDirty(const RooAbsArg* source, ULong64_t stamp) const ;
   mutable Bool_t _valueDirty ;  // Flag set if value needs recalculating because input values modified
   mutable Bool_t _shapeDirty ;  // Flag set if value needs recalculating because input shapes modified
 
@@ -582,6 +593,9 @@ public:
 
   mutable Bool_t _localNoInhibitDirty ; //! Prevent 'AlwaysDirty' mode for this node
 
+  mutable ULong64_t _valueDirtyStamp ; //! Stamp of the last value dirty propagation that visited this node
+  mutable ULong64_t _shapeDirtyStamp ; //! Stamp of the last shape dirty propagation that visited this node
+
 /*   RooArgSet _leafNodeCache ; //! Cached leaf nodes */
 /*   RooArgSet _branchNodeCache //! Cached branch nodes     */
 
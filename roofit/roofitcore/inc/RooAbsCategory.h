@@ -25,6 +25,7 @@ class RooArgSet ;
 class RooDataSet ;
 class Roo1DTable ;
 class RooVectorDataStore ;
+class RooLinkedTreeDataStore ;
 
 class RooAbsCategory : public RooAbsArg {
 public:
@@ -99,6 +100,7 @@ protected:
   virtual Bool_t isValid(const RooCatType& value) const ;
 
   friend class RooVectorDataStore ;
+  friend class RooLinkedTreeDataStore ;
   virtual void syncCache(const RooArgSet* set=0) ;
   virtual void copyCache(const RooAbsArg* source, Bool_t valueOnly=kFALSE, Bool_t setValueDirty=kTRUE) ;
   virtual void attachToTree(TTree& t, Int_t bufSize=32000) ;
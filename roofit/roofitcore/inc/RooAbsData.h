@@ -87,6 +87,8 @@ public:
   virtual Double_t weightError(ErrorType etype=Poisson) const ;
   virtual void weightError(Double_t& lo, Double_t& hi, ErrorType etype=Poisson) const ; 
   virtual const RooArgSet* get(Int_t index) const ;
+  virtual const Double_t* getBatch(const RooAbsReal& real, Int_t first, Int_t nEvents) const ;
+  virtual Bool_t getWeightBatch(Double_t* weights, Int_t first, Int_t nEvents) const ;
 
   virtual Int_t numEntries() const ;
   virtual Double_t sumEntries() const = 0 ;
@@ -211,7 +213,7 @@ public:
   static void claimVars(RooAbsData*) ;
   static Bool_t releaseVars(RooAbsData*) ;
 
-  enum StorageType { Tree, Vector, Composite };
+  enum StorageType { Tree, Vector, Composite, LinkedTree };
 
   static void setDefaultStorageType(StorageType s) ;
 
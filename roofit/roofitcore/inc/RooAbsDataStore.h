@@ -24,6 +24,7 @@
 
 
 class RooAbsArg ;
+class RooAbsReal ;
 class RooArgList ;
 class TIterator ;
 class TTree ;
@@ -52,6 +53,10 @@ public:
 
   virtual Double_t weight(Int_t index) const = 0 ;
 
+  // Retrieve a range of rows column-wise, for batch evaluation
+  virtual const Double_t* getBatch(const RooAbsReal& /*real*/, Int_t /*first*/, Int_t /*nEvents*/) const { return 0 ; }
+  virtual Bool_t getWeightBatch(Double_t* /*weights*/, Int_t /*first*/, Int_t /*nEvents*/) const { return kFALSE ; }
+
   virtual Bool_t isWeighted() const = 0 ;
 
   // Change observable name
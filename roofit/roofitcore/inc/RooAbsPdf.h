@@ -22,6 +22,8 @@
 #include "RooObjCacheManager.h"
 #include "RooCmdArg.h"
 
+#include <atomic>
+
 class RooDataSet;
 class RooDataHist ;
 class RooArgSet ;
@@ -185,6 +187,7 @@ public:
   // Function evaluation support
   virtual Bool_t traceEvalHook(Double_t value) const ;  
   virtual Double_t getValV(const RooArgSet* set=0) const ;
+  virtual void getValBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents, const RooArgSet* set=0) const ;
   virtual Double_t getLogVal(const RooArgSet* set=0) const ;
 
   Double_t getNorm(const RooArgSet& nset) const { 
@@ -226,6 +229,7 @@ public:
     // Return expecteded number of p.d.fs to be used in calculated of extended likelihood
     return expectedEvents(&nset) ; 
   }
+  virtual Double_t expectedEventsDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
 
   // Printing interface (human readable)
   virtual void printValue(std::ostream& os) const ;
@@ -235,6 +239,7 @@ public:
   static int verboseEval() ;
 
   virtual Double_t extendedTerm(Double_t observedEvents, const RooArgSet* nset=0) const ;
+  Double_t extendedTermDerivative(const RooAbsRealLValue& param, Double_t observedEvents, const RooArgSet* nset=0) const ;
 
   static void clearEvalError() ;
   static Bool_t evalError() ;
@@ -296,6 +301,9 @@ protected:
 
   virtual Bool_t syncNormalization(const RooArgSet* dset, Bool_t adjustProxies=kTRUE) const ;
 
+  virtual Double_t evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
+  Double_t normalizedDerivative(const RooAbsRealLValue& param, const RooArgSet* nset, Double_t value, Double_t rawDeriv) const ;
+
   friend class RooAbsAnaConvPdf ;
   mutable Double_t _rawValue ;
   mutable RooAbsReal* _norm   ;      //! Normalization integral (owned by _normMgr)
@@ -332,7 +340,7 @@ protected:
 
   static void raiseEvalError() ;
 
-  static Bool_t _evalError ;
+  static std::atomic<Bool_t> _evalError ; // Atomic, as it is raised and cleared by concurrent evaluations
 
   RooNumGenConfig* _specGeneratorConfig ; //! MC generator configuration specific for this object
   
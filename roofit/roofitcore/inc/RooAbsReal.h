@@ -40,6 +40,7 @@ class RooFitResult ;
 class RooAbsMoment ;
 class RooDerivative ;
 class RooVectorDataStore ;
+class RooLinkedTreeDataStore ;
 
 class TH1;
 class TH1F;
@@ -49,6 +50,7 @@ class TH3F;
 #include <list>
 #include <string>
 #include <iostream>
+#include <functional>
 
 class RooAbsReal : public RooAbsArg {
 public:
@@ -64,7 +66,7 @@ public:
   inline Double_t getVal(const RooArgSet* set=0) const { 
 /*     if (_fast && !_inhibitDirty && std::string("RooHistFunc")==IsA()->GetName()) std::cout << "RooAbsReal::getVal(" << GetName() << ") CLEAN value = " << _value << std::endl ;  */
 #ifndef _WIN32
-    return (_fast && !_inhibitDirty) ? _value : getValV(set) ; 
+    return (_fast && !_inhibitDirty()) ? _value : getValV(set) ; 
 #else
     return (_fast && !inhibitDirty()) ? _value : getValV(set) ;     
 #endif
@@ -72,6 +74,8 @@ public:
   inline  Double_t getVal(const RooArgSet& set) const { return _fast ? _value : getValV(&set) ; }
 
   virtual Double_t getValV(const RooArgSet* set=0) const ;
+  virtual void getValBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents, const RooArgSet* set=0) const ;
+  Double_t getDerivative(const RooAbsRealLValue& param, const RooArgSet* nset=0) const ;
 
   Double_t getPropagatedError(const RooFitResult& fr) ;
 
@@ -371,10 +375,20 @@ protected:
     return kFALSE ;
   }
   virtual Double_t evaluate() const = 0 ;
+  virtual Bool_t evaluateBatch(Double_t* /*output*/, const RooAbsData& /*data*/, Int_t /*first*/, Int_t /*nEvents*/) const {
+    // Hook for the evaluation of evaluate() for a range of events in one go, see getValBatch().
+    // Return kFALSE if not implemented, which makes getValBatch() evaluate event by event
+    return kFALSE ;
+  }
+  virtual Double_t evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
+  static Double_t numericDerivative(const RooAbsRealLValue& param, const std::function<Double_t()>& func, Bool_t propagate=kFALSE) ;
+  Bool_t getValBatchFromData(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents, const RooArgSet* set) const ;
+  void getValBatchPerEvent(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents, const RooArgSet* set) const ;
 
   // Hooks for RooDataSet interface
   friend class RooRealIntegral ;
   friend class RooVectorDataStore ;
+  friend class RooLinkedTreeDataStore ;
   virtual void syncCache(const RooArgSet* set=0) { getVal(set) ; }
   virtual void copyCache(const RooAbsArg* source, Bool_t valueOnly=kFALSE, Bool_t setValDirty=kTRUE) ;
   virtual void attachToTree(TTree& t, Int_t bufSize=32000) ;
@@ -398,6 +412,12 @@ protected:
   mutable Char_t  _sbyteValue ; //! Transient cache for signed byte values from tree branches 
   mutable UInt_t  _uintValue  ; //! Transient cache for unsigned integer values from tree branches 
 
+  mutable const RooAbsArg* _derivParam ;   //! Parameter of the cached derivative
+  mutable const RooArgSet* _derivNormSet ; //! Normalization set of the cached derivative
+  mutable ULong64_t _derivDirtyStamp ;     //! Dirty stamp of this object when the derivative was cached
+  mutable ULong64_t _derivStamp ;          //! Global dirty stamp when the derivative was cached
+  mutable Double_t _derivValue ;           //! Cached derivative
+
   friend class RooAbsPdf ;
   friend class RooAbsAnaConvPdf ;
   friend class RooRealProxy ;
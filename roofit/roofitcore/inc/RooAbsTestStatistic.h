@@ -24,6 +24,7 @@
 
 class RooArgSet ;
 class RooAbsData ;
+class RooDataSet ;
 class RooAbsReal ;
 class RooSimultaneous ;
 class RooRealMPFE ;
@@ -63,6 +64,12 @@ public:
   virtual Double_t offset() const { return _offset ; }
   virtual Double_t offsetCarry() const { return _offsetCarry; }
 
+  void setUseThreads(Bool_t flag) ;
+  Bool_t useThreads() const { 
+    // Return true if partitions are evaluated in threads rather than in forked processes
+    return _useThreads ; 
+  }
+
 protected:
 
   virtual void printCompactTreeHook(std::ostream& os, const char* indent="") ;
@@ -71,6 +78,9 @@ protected:
   virtual Double_t evaluate() const ;
 
   virtual Double_t evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const = 0 ;
+  virtual Double_t evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
+  virtual Double_t evaluatePartitionDerivative(const RooAbsRealLValue& param, Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const ;
+  void partitionRange(Int_t& nFirst, Int_t& nLast, Int_t& nStep) const ;
   virtual Double_t getCarry() const;
 
   void setMPSet(Int_t setNum, Int_t numSets) ; 
@@ -121,6 +131,8 @@ protected:
   Bool_t initialize() ;
   void initSimMode(RooSimultaneous* pdf, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;    
   void initMPMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  void initThreadMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  RooDataSet* partitionView() const ;
 
   mutable Bool_t _init ;          //! Is object initialized  
   GOFOpMode   _gofOpMode ;        // Operation mode of test statistic instance 
@@ -138,6 +150,8 @@ protected:
   // Parallel mode data
   Int_t          _nCPU ;      //  Number of processors to use in parallel calculation mode
   pRooRealMPFE*  _mpfeArray ; //! Array of parallel execution frond ends
+  Bool_t         _useThreads ; // Evaluate partitions in threads of the implicit MT pool rather than in forked processes
+  mutable Bool_t _threadsWarm ; //! Partitions have been evaluated serially since the last reconfiguration
 
   RooFit::MPSplit        _mpinterl ; // Use interleaving strategy rather than N-wise split for partioning of dataset for multiprocessor-split
   Bool_t         _doOffset ; // Apply interval value offset to control numeric precision?
@@ -145,7 +159,7 @@ protected:
   mutable Double_t _offsetCarry; //! avoids loss of precision
   mutable Double_t _evalCarry; //! carry of Kahan sum in evaluatePartition
 
-  ClassDef(RooAbsTestStatistic,2) // Abstract base class for real-valued test statistics
+  ClassDef(RooAbsTestStatistic,3) // Abstract base class for real-valued test statistics
 
 };
 
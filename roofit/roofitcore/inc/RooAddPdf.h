@@ -64,6 +64,7 @@ public:
     // which is the sum of all coefficients
     return expectedEvents(&nset) ; 
   }
+  virtual Double_t expectedEventsDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
 
   const RooArgList& pdfList() const { 
     // Return list of component p.d.fs
@@ -121,6 +122,8 @@ protected:
   mutable RooObjCacheManager _projCacheMgr ;  // Manager of cache with coefficient projections and transformations
   CacheElem* getProjCache(const RooArgSet* nset, const RooArgSet* iset=0, const char* rangeName=0) const ;
   void updateCoefficients(CacheElem& cache, const RooArgSet* nset) const ;
+  virtual Bool_t evaluateBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents) const ;
+  virtual Double_t evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
 
   
   friend class RooAddGenContext ;
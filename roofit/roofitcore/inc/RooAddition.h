@@ -72,6 +72,7 @@ protected:
   mutable RooObjCacheManager _cacheMgr ; // The cache manager
 
   Double_t evaluate() const;
+  virtual Double_t evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
 
   ClassDef(RooAddition,2) // Sum of RooAbsReal objects
 };
@@ -101,8 +101,14 @@ public:
   Double_t weight(const RooArgSet& bin, Int_t intOrder=1, Bool_t correctForBinSize=kFALSE, Bool_t cdfBoundaries=kFALSE, Bool_t oneSafe=kFALSE) ;   
   Double_t binVolume() const { return _curVolume ; }
   Double_t binVolume(const RooArgSet& bin) ; 
+  const RooAbsBinning* getBinning(const RooAbsArg& var) const ;
   virtual Bool_t valid() const ;
 
+  const std::vector<Int_t>& nonEmptyBins() const ;
+
+  virtual const Double_t* getBatch(const RooAbsReal& real, Int_t first, Int_t nEvents) const ;
+  virtual Bool_t getWeightBatch(Double_t* weights, Int_t first, Int_t nEvents) const ;
+
   TIterator* sliceIterator(RooAbsArg& sliceArg, const RooArgSet& otherArgs) ;
   
   virtual void weightError(Double_t& lo, Double_t& hi, ErrorType etype=Poisson) const ;
@@ -119,6 +125,9 @@ public:
   virtual void reset() ;
   void dump2() ;
 
+  // Number of changes of the bin contents, to detect stale copies of them
+  ULong_t contentVersion() const { return _contentVersion ; }
+
   virtual void printMultiline(std::ostream& os, Int_t content, Bool_t verbose=kFALSE, TString indent="") const ;
   virtual void printArgs(std::ostream& os) const ;
   virtual void printValue(std::ostream& os) const ;
@@ -186,7 +195,10 @@ protected:
   mutable std::vector<std::vector<Double_t> > _binbounds; //! list of bin bounds per dimension
 
   mutable Int_t _cache_sum_valid ; //! Is cache sum valid
+  ULong_t _contentVersion = 0 ; //! Incremented whenever the bin contents change
   mutable Double_t _cache_sum ; //! Cache for sum of entries ;
+  mutable std::vector<Int_t> _nonEmptyBins ; //! Cache of valid bins with non-zero weight
+  mutable Bool_t _nonEmptyBinsValid ; //! Is cache of non-empty bins valid
 
 
 private:
@@ -20,6 +20,7 @@ class TDirectory ;
 class RooAbsRealLValue ;
 class RooRealVar ;
 class RooDataHist ;
+class RooVectorDataStore ;
 #include "RooAbsData.h"
 #include "RooDirItem.h"
 
@@ -68,6 +69,8 @@ public:
 
   RooDataHist* binnedClone(const char* newName=0, const char* newTitle=0) const ;
 
+  RooDataSet* viewClone(Int_t firstEntry, Int_t lastEntry, const char* newName=0) const ;
+
   virtual Double_t sumEntries() const ;
   virtual Double_t sumEntries(const char* cutSpec, const char* cutRange=0) const ;
 
@@ -143,6 +146,9 @@ protected:
   RooDataSet(const char *name, const char *title, RooDataSet *ntuple, 
 	     const RooArgSet& vars, const RooFormulaVar* cutVar, const char* cutRange, int nStart, int nStop, Bool_t copyCache, const char* wgtVarName=0);
   
+  RooDataSet(const char *name, const char *title, const RooVectorDataStore& vstore, 
+	     const RooArgSet& vars, Int_t firstEntry, Int_t lastEntry, const char* wgtVarName=0);
+  
   RooArgSet addWgtVar(const RooArgSet& origVars, const RooAbsArg* wgtVar) ; 
   
   RooArgSet _varsNoWgt ;   // Vars without weight variable 
@@ -21,6 +21,7 @@
 #include "TString.h"
 #include <list>
 #include <map>
+#include <mutex>
 
 class RooExpensiveObjectCache : public TObject {
 public:
@@ -42,6 +43,8 @@ public:
 
   static RooExpensiveObjectCache& instance() ;
 
+  static std::recursive_mutex& mutex() ;
+
   Int_t size() const { return _map.size() ; }
 
   static void cleanup() ;
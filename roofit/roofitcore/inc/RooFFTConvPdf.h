@@ -19,8 +19,10 @@
 #include "RooHistPdf.h"
 #include "TVirtualFFT.h"
 class RooRealVar ;
+class RooAbsLValue ;
 
 #include <map>
+#include <vector>
  
 class RooFFTConvPdf : public RooAbsCachedPdf {
 public:
@@ -85,6 +87,7 @@ protected:
     TVirtualFFT* fftr2c1 ;
     TVirtualFFT* fftr2c2 ;
     TVirtualFFT* fftc2r ;
+    std::vector<TVirtualFFT*> fftPool ; // Transforms for slices filled in parallel, three per thread
 
     RooAbsPdf* pdf1Clone ;
     RooAbsPdf* pdf2Clone ;
@@ -103,6 +106,10 @@ protected:
   virtual RooAbsArg& pdfObservable(RooAbsArg& histObservable) const ;
   virtual void fillCacheObject(PdfCacheElem& cache) const ;
   void fillCacheSlice(FFTCacheElem& cache, const RooArgSet& slicePosition) const ;
+  void fillCacheSlices(FFTCacheElem& cache, const RooArgSet& slicePosition, RooAbsLValue** obsLV, const std::vector<Int_t>& sliceBins) const ;
+  void scanSlice(FFTCacheElem& cache, const RooArgSet& slicePosition, Double_t*& input1, Double_t*& input2, Int_t& N, Int_t& N2, Int_t& totalShift) const ;
+  void storeSlice(FFTCacheElem& cache, const RooArgSet& slicePosition, const Double_t* output, Int_t N, Int_t N2, Int_t totalShift) const ;
+  static void fftConvolve(TVirtualFFT* fftr2c1, TVirtualFFT* fftr2c2, TVirtualFFT* fftc2r, Double_t* input1, Double_t* input2, Int_t N2) ;
 
   virtual PdfCacheElem* createCache(const RooArgSet* nset) const ;
   virtual TString histNameSuffix() const ;
@@ -49,6 +49,7 @@ public:
   // Function value accessor
   inline Bool_t ok() { return _isOK ; }
   Double_t eval(const RooArgSet* nset=0) ;
+  Double_t evalDerivative(const RooAbsRealLValue& param, const RooArgSet* nset=0) ;
 
   // Debugging
   void dump() ;
@@ -85,6 +86,8 @@ protected:
   mutable RooArgSet _actual;    //! Set of actual dependents
   RooLinkedList _labelList ;    //  List of label names for category objects  
   mutable Bool_t    _compiled ; //  Flag set if formula is compiled
+  Int_t _shiftCode ;            //! Code of the variable shifted in evalDerivative()
+  Double_t _shift ;             //! Shift of this variable
 
   ClassDef(RooFormula,1)     // ROOT::v5::TFormula derived class interfacing with RooAbsArg objects
 };
@@ -65,6 +65,7 @@ protected:
 
   // Function evaluation
   virtual Double_t evaluate() const ;
+  virtual Double_t evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
   RooFormula& formula() const ;
 
   // Post-processing of server redirection
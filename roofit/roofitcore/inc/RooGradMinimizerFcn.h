@@ -0,0 +1,44 @@
+/*****************************************************************************
+ * Project: RooFit                                                           *
+ * Package: RooFitCore                                                       *
+ * @(#)root/roofitcore:$Id$
+ *                                                                           *
+ * Redistribution and use in source and binary forms,                        *
+ * with or without modification, are permitted according to the terms        *
+ * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+ *****************************************************************************/
+
+#ifndef __ROOFIT_NOROOMINIMIZER
+
+#ifndef ROO_GRAD_MINIMIZER_FCN
+#define ROO_GRAD_MINIMIZER_FCN
+
+#include "Math/IFunction.h"
+#include "RooMinimizerFcn.h"
+
+class RooGradMinimizerFcn : public ROOT::Math::IMultiGradFunction {
+
+ public:
+
+  RooGradMinimizerFcn(const RooMinimizerFcn& fcn) ;
+  RooGradMinimizerFcn(const RooGradMinimizerFcn& other) ;
+  virtual ~RooGradMinimizerFcn() ;
+
+  virtual ROOT::Math::IBaseFunctionMultiDim* Clone() const ;
+  virtual unsigned int NDim() const { return _fcn->NDim() ; }
+
+  RooMinimizerFcn* fcn() const { return _fcn ; }
+
+ private:
+
+  virtual double DoEval(const double* x) const ;
+  virtual double DoDerivative(const double* x, unsigned int icoord) const ;
+
+  RooGradMinimizerFcn& operator=(const RooGradMinimizerFcn&) ;
+
+  RooMinimizerFcn* _fcn ; // Function providing values and derivatives, owned
+
+};
+
+#endif
+#endif
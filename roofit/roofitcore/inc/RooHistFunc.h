@@ -54,6 +54,8 @@ public:
     return _intOrder ; 
   }
 
+  Int_t getBin() const ;
+
   Int_t getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* rangeName=0) const ;
   Double_t analyticalIntegral(Int_t code, const char* rangeName=0) const ;
 
@@ -80,6 +82,7 @@ protected:
   Bool_t areIdentical(const RooDataHist& dh1, const RooDataHist& dh2) ;
 
   Double_t evaluate() const;
+  Bool_t transferObservables() const ;
   Double_t totalVolume() const ;
   friend class RooAbsCachedReal ;
   Double_t totVolume() const ;
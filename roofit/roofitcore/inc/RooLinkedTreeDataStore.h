@@ -0,0 +1,151 @@
+/*****************************************************************************
+ * Project: RooFit                                                           *
+ * Package: RooFitCore                                                       *
+ *    File: $Id$
+ * Authors:                                                                  *
+ *   WV, Wouter Verkerke, UC Santa Barbara, verkerke@slac.stanford.edu       *
+ *   DK, David Kirkby,    UC Irvine,         dkirkby@uci.edu                 *
+ *                                                                           *
+ * Copyright (c) 2000-2005, Regents of the University of California          *
+ *                          and Stanford University. All rights reserved.    *
+ *                                                                           *
+ * Redistribution and use in source and binary forms,                        *
+ * with or without modification, are permitted according to the terms        *
+ * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+ *****************************************************************************/
+#ifndef ROO_LINKED_TREE_DATA_STORE
+#define ROO_LINKED_TREE_DATA_STORE
+
+#include <list>
+#include <vector>
+#include <string>
+#include "RooAbsDataStore.h"
+
+class RooAbsArg ;
+class RooAbsReal ;
+class RooAbsCategory ;
+class RooArgList ;
+class RooFormulaVar ;
+class RooRealVar ;
+class TLeaf ;
+class TTree ;
+
+class RooLinkedTreeDataStore : public RooAbsDataStore {
+public:
+
+  RooLinkedTreeDataStore() ;
+
+  // Ctor linking to the given tree, which must outlive the store
+  RooLinkedTreeDataStore(const char* name, const char* title, const RooArgSet& vars, TTree& tree,
+			 const RooFormulaVar* select=0, const char* rangeName=0, const char* wgtVarName=0) ;
+  virtual RooAbsDataStore* clone(const char* newname=0) const { return new RooLinkedTreeDataStore(*this,newname) ; }
+  virtual RooAbsDataStore* clone(const RooArgSet& vars, const char* newname=0) const { return new RooLinkedTreeDataStore(*this,vars,newname) ; }
+
+  RooLinkedTreeDataStore(const RooLinkedTreeDataStore& other, const char* newname=0) ;
+  RooLinkedTreeDataStore(const RooLinkedTreeDataStore& other, const RooArgSet& vars, const char* newname=0) ;
+
+  virtual ~RooLinkedTreeDataStore() ;
+
+  // Write current row (not supported, the store is read-only)
+  virtual Int_t fill() ;
+
+  // Retrieve a row
+  using RooAbsDataStore::get ;
+  virtual const RooArgSet* get(Int_t index) const ;
+  virtual Double_t weight() const ;
+  virtual Double_t weightError(RooAbsData::ErrorType etype=RooAbsData::Poisson) const ;
+  virtual void weightError(Double_t& lo, Double_t& hi, RooAbsData::ErrorType etype=RooAbsData::Poisson) const ;
+  virtual Double_t weight(Int_t index) const ;
+  virtual Bool_t isWeighted() const { return (_wgtVar!=0) ; }
+
+  // Retrieve a range of rows column-wise
+  virtual const Double_t* getBatch(const RooAbsReal& real, Int_t first, Int_t nEvents) const ;
+  virtual Bool_t getWeightBatch(Double_t* weights, Int_t first, Int_t nEvents) const ;
+
+  // Change observable name
+  virtual Bool_t changeObservableName(const char* from, const char* to) ;
+
+  // Add one or more columns
+  virtual RooAbsArg* addColumn(RooAbsArg& var, Bool_t adjustRange=kTRUE) ;
+  virtual RooArgSet* addColumns(const RooArgList& varList) ;
+
+  // Merge column-wise
+  RooAbsDataStore* merge(const RooArgSet& allvars, std::list<RooAbsDataStore*> dstoreList) ;
+
+  // Add rows
+  virtual void append(RooAbsDataStore& other) ;
+
+  // General & bookkeeping methods
+  virtual Bool_t valid() const { return kTRUE ; }
+  virtual Int_t numEntries() const { return _nEntries ; }
+  virtual Double_t sumEntries() const { return _sumWeight ; }
+  virtual void reset() ;
+
+  // Buffer redirection routines used in inside RooAbsOptTestStatistics
+  virtual void attachBuffers(const RooArgSet& extObs) ;
+  virtual void resetBuffers() ;
+
+  // Constant term  optimizer interface
+  virtual const RooAbsArg* cacheOwner() { return 0 ; }
+  virtual void cacheArgs(const RooAbsArg* owner, RooArgSet& varSet, const RooArgSet* nset=0, Bool_t skipZeroWeights=kTRUE) ;
+  virtual void attachCache(const RooAbsArg* /*newOwner*/, const RooArgSet& /*cachedVars*/) {}
+  virtual void resetCache() {}
+
+  virtual void setArgStatus(const RooArgSet& set, Bool_t active) ;
+
+  void loadValues(const RooAbsDataStore *tds, const RooFormulaVar* select=0, const char* rangeName=0, Int_t nStart=0, Int_t nStop=2000000000) ;
+
+  // Number of events held in memory at a time
+  void setChunkSize(Int_t nEvents) ;
+  Int_t chunkSize() const { return _chunkSize ; }
+
+  TTree* linkedTree() const { return _tree ; }
+
+  class Column {
+  public:
+    Column() : _real(0), _cat(0), _leaf(0), _active(kTRUE), _const(0) {}
+    std::string _branch ;            // Name of the branch holding the column
+    RooAbsReal* _real ;              // Real-valued variable loaded by get(), or
+    RooAbsCategory* _cat ;           // category loaded by get()
+    TLeaf* _leaf ;                   // Leaf of the current tree, zero if the tree has no such branch
+    Bool_t _active ;                 // Read the column?
+    Double_t _const ;                // Value of columns without branch
+    std::vector<Double_t> _values ;  // Values of the events of the current chunk
+  } ;
+
+protected:
+
+  friend class RooVectorDataStore ;
+
+  RooArgSet varsNoWeight(const RooArgSet& allVars, const char* wgtName) ;
+  RooRealVar* weightVar(const RooArgSet& allVars, const char* wgtName) ;
+
+  void initColumns() ;
+  void attachLeaves() const ;
+  void initChunks() ;
+  void selectEntries(const RooFormulaVar* select, const char* rangeName) ;
+  Bool_t readEntry(Long64_t entry, Int_t slot) const ;
+  void loadChunk(Int_t chunk) const ;
+  Bool_t loadSlot(Int_t slot) const ;
+
+  RooArgSet _varsww ;       //! Variables including the weight
+  RooRealVar* _wgtVar ;     //! Pointer to weight variable (if set)
+
+  TTree* _tree ;            //! Linked tree, not owned
+  std::vector<bool> _selected ;        //! Entries of the tree that are events of the store, empty if all are
+  std::vector<Long64_t> _chunkStart ;  //! Tree entry of the first event of each chunk
+  Int_t _nEntries ;         //! Number of events
+  Double_t _sumWeight ;     //! Sum of the event weights
+  Int_t _chunkSize ;        //! Number of events per chunk
+
+  mutable std::vector<Column> _columns ; //! Columns, in the order of _varsww
+  Int_t _wgtColumn ;        //! Index of the weight column, -1 if none
+  mutable Int_t _treeNumber ; //! Number of the tree of a chain the leaves belong to
+  mutable Int_t _curChunk ;   //! Chunk held in the column buffers, -1 if none
+  mutable Double_t _curWgt ;  //! Weight of the current event
+
+  ClassDef(RooLinkedTreeDataStore,1) // Read-only data storage reading events from an external TTree
+};
+
+
+#endif
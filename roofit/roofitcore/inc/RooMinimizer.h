@@ -26,6 +26,7 @@
 
 #include "Fit/Fitter.h"
 #include "RooMinimizerFcn.h"
+#include "RooGradMinimizerFcn.h"
 
 class RooAbsReal ;
 class RooFitResult ;
@@ -51,6 +52,8 @@ public:
   void setOffsetting(Bool_t flag) ;
   void setMaxIterations(Int_t n) ;
   void setMaxFunctionCalls(Int_t n) ; 
+  void setParallelGradient(Int_t nClones) ;
+  void setAnalyticalGradient(Bool_t flag=kTRUE) ;
 
   RooFitResult* fit(const char* options) ;
 
@@ -100,11 +103,13 @@ protected:
   inline std::ofstream* logfile() { return fitterFcn()->GetLogFile(); }
   inline Double_t& maxFCN() { return fitterFcn()->GetMaxFCN() ; }
   
-  const RooMinimizerFcn* fitterFcn() const {  return ( fitter()->GetFCN() ? ((RooMinimizerFcn*) fitter()->GetFCN()) : _fcn ) ; }
-  RooMinimizerFcn* fitterFcn() { return ( fitter()->GetFCN() ? ((RooMinimizerFcn*) fitter()->GetFCN()) : _fcn ) ; }
+  const RooMinimizerFcn* fitterFcn() const ;
+  RooMinimizerFcn* fitterFcn() ;
 
 private:
 
+  bool fitFcn() const ;
+
   Int_t       _printLevel ;
   Int_t       _status ;
   Bool_t      _optConst ;
@@ -115,6 +120,7 @@ private:
   TStopwatch  _timer ;
   TStopwatch  _cumulTimer ;
   Bool_t      _profileStart ;
+  Bool_t      _gradient ;
 
   TMatrixDSym* _extV ;
 
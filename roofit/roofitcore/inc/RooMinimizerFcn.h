@@ -41,6 +41,7 @@ class RooMinimizerFcn : public ROOT::Math::IBaseFunctionMultiDim {
 
   virtual ROOT::Math::IBaseFunctionMultiDim* Clone() const;
   virtual unsigned int NDim() const { return _nDim; }
+  virtual bool IsThreadSafe() const { return _nClones>0 ; }
 
   RooArgList* GetFloatParamList() { return _floatParamList; }
   RooArgList* GetConstParamList() { return _constParamList; }
@@ -64,6 +65,11 @@ class RooMinimizerFcn : public ROOT::Math::IBaseFunctionMultiDim {
   Int_t evalCounter() const { return _evalCounter ; }
   void zeroEvalCount() { _evalCounter = 0 ; }
 
+  void SetNumClones(Int_t nClones) ;
+  Int_t GetNumClones() const { return _nClones ; }
+
+  Double_t EvalDerivative(const double* x, unsigned int icoord) const ;
+
 
  private:
   
@@ -78,6 +84,9 @@ class RooMinimizerFcn : public ROOT::Math::IBaseFunctionMultiDim {
 
   virtual double DoEval(const double * x) const;  
   void updateFloatVec() ;
+  void synchronizeClones(Bool_t rebuild, Bool_t optConst) ;
+
+  class ClonePool ;
 
 private:
 
@@ -101,6 +110,10 @@ private:
   RooArgList* _initFloatParamList;
   RooArgList* _initConstParamList;
 
+  Int_t _nClones ;        // Number of clones of the function for concurrent evaluation
+  ClonePool* _clones ;    //! Clones of the function, shared by the copies of this object
+  Bool_t _ownClones ;     //! True if this object owns _clones
+
 };
 
 #endif
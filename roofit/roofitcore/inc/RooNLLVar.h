@@ -22,12 +22,13 @@
 #include <vector>
 
 class RooRealSumPdf ;
+class RooDataHist ;
 
 class RooNLLVar : public RooAbsOptTestStatistic {
 public:
 
   // Constructors, assignment etc
-  RooNLLVar() { _first = kTRUE ; }
+  RooNLLVar() { _first = kTRUE ; _batchMode = kFALSE ; }
   RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbsData& data,
 	    const RooCmdArg& arg1=RooCmdArg::none(), const RooCmdArg& arg2=RooCmdArg::none(),const RooCmdArg& arg3=RooCmdArg::none(),
 	    const RooCmdArg& arg4=RooCmdArg::none(), const RooCmdArg& arg5=RooCmdArg::none(),const RooCmdArg& arg6=RooCmdArg::none(),
@@ -49,12 +50,16 @@ public:
   virtual RooAbsTestStatistic* create(const char *name, const char *title, RooAbsReal& pdf, RooAbsData& adata,
 				      const RooArgSet& projDeps, const char* rangeName, const char* addCoefRangeName=0, 
 				      Int_t nCPU=1, RooFit::MPSplit interleave=RooFit::BulkPartition, Bool_t verbose=kTRUE, Bool_t splitRange=kFALSE, Bool_t binnedL=kFALSE) {
-    return new RooNLLVar(name,title,(RooAbsPdf&)pdf,adata,projDeps,_extended,rangeName, addCoefRangeName, nCPU, interleave,verbose,splitRange,kFALSE,binnedL) ;
+    RooNLLVar* nll = new RooNLLVar(name,title,(RooAbsPdf&)pdf,adata,projDeps,_extended,rangeName, addCoefRangeName, nCPU, interleave,verbose,splitRange,kFALSE,binnedL) ;
+    nll->_batchMode = _batchMode ;
+    return nll ;
   }
   
   virtual ~RooNLLVar();
 
   void applyWeightSquared(Bool_t flag) ; 
+  void enableBatchMode(Bool_t flag) ;
+  Bool_t batchMode() const { return _batchMode ; }
 
   virtual Double_t defaultErrorLevel() const { return 0.5 ; }
 
@@ -66,15 +71,27 @@ protected:
 
   Bool_t _extended ;
   virtual Double_t evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const ;
+  virtual Double_t evaluatePartitionDerivative(const RooAbsRealLValue& param, Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const ;
+  Bool_t evaluatePartitionBatch(Int_t firstEvent, Int_t lastEvent, Double_t& result, Double_t& carry,
+				Double_t& sumWeight, Double_t& sumWeightCarry) const ;
+  void partitionBins(const RooDataHist& dhist, Int_t firstEvent, Int_t lastEvent, Int_t stepSize, std::vector<Int_t>& bins) const ;
+  void evaluatePartitionBins(const RooDataHist& dhist, const std::vector<Int_t>& bins, Double_t& result, Double_t& carry,
+			     Double_t& sumWeight, Double_t& sumWeightCarry) const ;
+  Double_t binLogFactorial(Int_t i, Double_t N) const ;
+  Bool_t cacheBinVolumes() ;
+  static Bool_t sameBoundaries(const std::list<Double_t>& boundaries, const RooAbsBinning* binning) ;
   Bool_t _weightSq ; // Apply weights squared?
+  Bool_t _batchMode ; // Evaluate the p.d.f for batches of events?
   mutable Bool_t _first ; //!
   Double_t _offsetSaveW2; //!
   Double_t _offsetCarrySaveW2; //!
 
   mutable std::vector<Double_t> _binw ; //!
+  mutable std::vector<Double_t> _binN ; //! Bin weights for which log-factorials are cached
+  mutable std::vector<Double_t> _binLogFact ; //! Cached log-factorials of bin weights
   mutable RooRealSumPdf* _binnedPdf ; //!
    
-  ClassDef(RooNLLVar,2) // Function representing (extended) -log(L) of p.d.f and dataset
+  ClassDef(RooNLLVar,3) // Function representing (extended) -log(L) of p.d.f and dataset
 };
 
 #endif
@@ -153,6 +153,8 @@ protected:
   RooAbsReal* specializeRatio(RooFormulaVar& input, const char* targetRangeName) const ;
   Double_t calculate(const RooProdPdf::CacheElem& cache, Bool_t verbose=kFALSE) const ;
   Double_t calculate(const RooArgList* partIntList, const RooLinkedList* normSetList) const ;
+  virtual Bool_t evaluateBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents) const ;
+  virtual Double_t evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
 
  
   friend class RooProdGenContext ;
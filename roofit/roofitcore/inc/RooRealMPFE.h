@@ -43,6 +43,8 @@ public:
 
   void applyNLLWeightSquared(Bool_t flag) ;
 
+  void enableNLLBatchMode(Bool_t flag) ;
+
   void enableOffsetting(Bool_t flag) ;
 
   void followAsSlave(RooRealMPFE& master) { _updateMaster = &master ; }
@@ -59,13 +61,14 @@ public:
   State _state ;
 
   enum Message { SendReal=0, SendCat, Calculate, Retrieve, ReturnValue, Terminate, 
-		 ConstOpt, Verbose, LogEvalError, ApplyNLLW2, EnableOffset, CalculateNoOffset } ;
+		 ConstOpt, Verbose, LogEvalError, ApplyNLLW2, EnableOffset, CalculateNoOffset, EnableNLLBatch } ;
   
   void initialize() ; 
   void initVars() ;
   void serverLoop() ;
 
   void doApplyNLLW2(Bool_t flag) ;
+  void doEnableNLLBatch(Bool_t flag) ;
 
   RooRealProxy _arg ; // Function to calculate in parallel process
   RooListProxy _vars ;   // Variables
@@ -35,13 +35,18 @@ public:
 
   // Accessors
 #ifndef _WIN32
-  inline operator Double_t() const { return (_arg->_fast && !_arg->_inhibitDirty) ? ((RooAbsReal*)_arg)->_value : ((RooAbsReal*)_arg)->getVal(_nset) ; }
+  inline operator Double_t() const { return (_arg->_fast && !_arg->_inhibitDirty()) ? ((RooAbsReal*)_arg)->_value : ((RooAbsReal*)_arg)->getVal(_nset) ; }
 #else
   inline operator Double_t() const { return (_arg->_fast && !_arg->inhibitDirty()) ? ((RooAbsReal*)_arg)->_value : ((RooAbsReal*)_arg)->getVal(_nset) ; }
 #endif
 
   inline const RooAbsReal& arg() const { return (RooAbsReal&)*_arg ; }
 
+  // Values for a range of events of a dataset, see RooAbsReal::getValBatch()
+  inline void getValBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents) const {
+    ((RooAbsReal*)_arg)->getValBatch(output,data,first,nEvents,_nset) ;
+  }
+
   // Modifier
   virtual Bool_t setArg(RooAbsReal& newRef) ;
 
@@ -70,6 +70,8 @@ public:
   virtual void setCacheAndTrackHints(RooArgSet&) ;
 
 protected:
+
+  virtual Double_t evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const ;
   
   class CacheElem : public RooAbsCacheElement {
   public:
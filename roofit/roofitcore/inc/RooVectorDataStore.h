@@ -34,6 +34,7 @@ class RooArgList ;
 class TTree ;
 class RooFormulaVar ;
 class RooArgSet ;
+class RooLinkedTreeDataStore ;
 
 class RooVectorDataStore : public RooAbsDataStore {
 public:
@@ -47,7 +48,10 @@ public:
 
   RooVectorDataStore(const RooVectorDataStore& other, const char* newname=0) ;
   RooVectorDataStore(const RooTreeDataStore& other, const RooArgSet& vars, const char* newname=0) ;
+  RooVectorDataStore(const RooLinkedTreeDataStore& other, const RooArgSet& vars, const char* newname=0) ;
   RooVectorDataStore(const RooVectorDataStore& other, const RooArgSet& vars, const char* newname=0) ;
+  RooVectorDataStore(const RooVectorDataStore& other, const RooArgSet& vars, Int_t firstEntry, Int_t lastEntry, const char* newname=0) ;
+  Bool_t canView() const { return _realfStoreList.empty() ; }
 
 
   RooVectorDataStore(const char *name, const char *title, RooAbsDataStore& tds, 
@@ -75,6 +79,10 @@ public:
   virtual Double_t weight(Int_t index) const ;
   virtual Bool_t isWeighted() const { return (_wgtVar!=0||_extWgtArray!=0) ; }
 
+  // Retrieve a range of rows column-wise
+  virtual const Double_t* getBatch(const RooAbsReal& real, Int_t first, Int_t nEvents) const ;
+  virtual Bool_t getWeightBatch(Double_t* weights, Int_t first, Int_t nEvents) const ;
+
   // Change observable name
   virtual Bool_t changeObservableName(const char* from, const char* to) ;
   
@@ -151,7 +159,8 @@ public:
 
     RealVector(const RealVector& other, RooAbsReal* real=0) : 
       _vec(other._vec), _nativeReal(real?real:other._nativeReal), _real(real?real:other._real), _buf(other._buf), _nativeBuf(other._nativeBuf), _nset(0)   {
-      _vec0 = _vec.size()>0 ? &_vec.front() : 0 ;
+      // The copy of a view is a view of the same entries
+      _vec0 = _vec.size()>0 ? &_vec.front() : other._vec0 ;
       if (other._tracker) {
 	_tracker = new RooChangeTracker(Form("track_%s",_nativeReal->GetName()),"tracker",other._tracker->parameters()) ;
       } else {
@@ -162,6 +171,12 @@ public:
       }
     }
 
+    // View of the entries of other from firstEntry on, which does not copy them
+    RealVector(const RealVector& other, RooAbsReal* real, Int_t firstEntry) : 
+      _nativeReal(real), _real(real), _buf(other._buf), _nativeBuf(other._nativeBuf), _tracker(0), _nset(0) {
+      _vec0 = other._vec0 ? other._vec0 + firstEntry : 0 ;
+    }
+
     RealVector& operator=(const RealVector& other) {
       if (&other==this) return *this;
       _nativeReal = other._nativeReal;
@@ -478,7 +493,15 @@ public:
     CatVector(const CatVector& other, RooAbsCategory* cat=0) : 
       _cat(cat?cat:other._cat), _buf(other._buf), _nativeBuf(other._nativeBuf), _vec(other._vec) 
       {
-	_vec0 = _vec.size()>0 ? &_vec.front() : 0 ;
+	// The copy of a view is a view of the same entries
+	_vec0 = _vec.size()>0 ? &_vec.front() : other._vec0 ;
+      }
+
+    // View of the entries of other from firstEntry on, which does not copy them
+    CatVector(const CatVector& other, RooAbsCategory* cat, Int_t firstEntry) : 
+      _cat(cat), _buf(other._buf), _nativeBuf(other._nativeBuf)
+      {
+	_vec0 = other._vec0 ? other._vec0 + firstEntry : 0 ;
       }
 
     CatVector& operator=(const CatVector& other) {
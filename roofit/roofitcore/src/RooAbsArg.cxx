@@ -69,6 +69,7 @@ setting/clearing/testing named attributes.
 #include <fstream>
 #include <algorithm>
 #include <sstream>
+#include <atomic>
 
 using namespace std ;
 
@@ -80,8 +81,15 @@ ClassImp(RooAbsArg);
 ;
 
 Bool_t RooAbsArg::_verboseDirty(kFALSE) ;
-Bool_t RooAbsArg::_inhibitDirty(kFALSE) ;
-Bool_t RooAbsArg::inhibitDirty() const { return _inhibitDirty && !_localNoInhibitDirty; }
+Bool_t RooAbsArg::inhibitDirty() const { return _inhibitDirty() && !_localNoInhibitDirty; }
+
+namespace {
+  // Source of the stamps that identify a dirty state propagation, such that
+  // nodes reachable along several paths are visited only once
+  std::atomic<ULong64_t> dirtyStampCounter(0) ;
+  // Stamp of the last value change
+  std::atomic<ULong64_t> lastValueChange(0) ;
+}
 
 std::map<RooAbsArg*,TRefArray*> RooAbsArg::_ioEvoList ;
 std::stack<RooAbsArg*> RooAbsArg::_ioReadStack ;
@@ -100,7 +108,9 @@ RooAbsArg::RooAbsArg() :
   _eocache(0),
   _namePtr(0),
   _isConstant(kFALSE),
-  _localNoInhibitDirty(kFALSE)
+  _localNoInhibitDirty(kFALSE),
+  _valueDirtyStamp(0),
+  _shapeDirtyStamp(0)
 {
   _clientShapeIter = _clientListShape.MakeIterator() ;
   _clientValueIter = _clientListValue.MakeIterator() ;
@@ -126,7 +136,9 @@ RooAbsArg::RooAbsArg(const char *name, const char *title) :
   _eocache(0),
   _namePtr(0),
   _isConstant(kFALSE),
-  _localNoInhibitDirty(kFALSE)
+  _localNoInhibitDirty(kFALSE),
+  _valueDirtyStamp(0),
+  _shapeDirtyStamp(0)
 {
   _namePtr = (TNamed*) RooNameReg::instance().constPtr(GetName()) ;
 
@@ -152,7 +164,9 @@ RooAbsArg::RooAbsArg(const RooAbsArg& other, const char* name)
     _eocache(other._eocache),
     _namePtr(other._namePtr),
     _isConstant(other._isConstant),
-    _localNoInhibitDirty(other._localNoInhibitDirty)
+    _localNoInhibitDirty(other._localNoInhibitDirty),
+    _valueDirtyStamp(0),
+    _shapeDirtyStamp(0)
 {
   // Use name in argument, if supplied
   if (name) {
@@ -238,7 +252,29 @@ RooAbsArg::~RooAbsArg()
 
 void RooAbsArg::setDirtyInhibit(Bool_t flag)
 {
-  _inhibitDirty = flag ;
+  _inhibitDirty() = flag ;
+  // Values may have changed without propagation while dirty flags were inhibited
+  lastValueChange = ++dirtyStampCounter ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the stamp of the most recent dirty state propagation
+
+ULong64_t RooAbsArg::currentDirtyStamp()
+{
+  return dirtyStampCounter ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the stamp of the most recent value change. A result that was cached
+/// when currentDirtyStamp() was at or after this stamp is still valid, even if
+/// the dirty flags were raised since.
+
+ULong64_t RooAbsArg::lastValueChangeStamp()
+{
+  return lastValueChange ;
 }
 
 
@@ -841,11 +877,36 @@ Bool_t RooAbsArg::observableOverlaps(const RooArgSet* nset, const RooAbsArg& tes
 
 void RooAbsArg::setValueDirty(const RooAbsArg* source) const
 {
-  if (_operMode!=Auto || _inhibitDirty) return ;
+  if (_operMode!=Auto || _inhibitDirty()) return ;
+
+  const ULong64_t stamp = ++dirtyStampCounter ;
+  lastValueChange = stamp ;
+
+  // Handle no-propagation scenarios first
+  if (_clientListValue.GetSize()==0) {
+    _valueDirty = kTRUE ;
+    _valueDirtyStamp = stamp ;
+    return ;
+  }
+
+  propagateValueDirty(source,stamp) ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Raise the value dirty flag of this object and its clients. Clients that
+/// were already visited by the propagation identified by stamp are skipped,
+/// which makes the propagation linear in the number of client links rather
+/// than in the number of paths through the expression graph.
+
+void RooAbsArg::propagateValueDirty(const RooAbsArg* source, ULong64_t stamp) const
+{
+  if (_operMode!=Auto || _inhibitDirty()) return ;
 
   // Handle no-propagation scenarios first
   if (_clientListValue.GetSize()==0) {
     _valueDirty = kTRUE ;
+    _valueDirtyStamp = stamp ;
     return ;
   }
 
@@ -860,6 +921,12 @@ void RooAbsArg::setValueDirty(const RooAbsArg* source) const
     return ;
   }
 
+  // All clients were already reached by this propagation
+  if (_valueDirtyStamp==stamp) {
+    return ;
+  }
+  _valueDirtyStamp = stamp ;
+
   // Propagate dirty flag to all clients if this is a down->up transition
   if (_verboseDirty) {
     cxcoutD(LinkStateMgmt) << "RooAbsArg::setValueDirty(" << (source?source->GetName():"self") << "->" << GetName() << "," << this
@@ -872,7 +939,7 @@ void RooAbsArg::setValueDirty(const RooAbsArg* source) const
   RooFIter clientValueIter = _clientListValue.fwdIterator() ;
   RooAbsArg* client ;
   while ((client=clientValueIter.next())) {
-    client->setValueDirty(source) ;
+    client->propagateValueDirty(source,stamp) ;
   }
 
 
@@ -884,6 +951,16 @@ void RooAbsArg::setValueDirty(const RooAbsArg* source) const
 /// change to all of our clients.
 
 void RooAbsArg::setShapeDirty(const RooAbsArg* source) const
+{
+  propagateShapeDirty(source,++dirtyStampCounter) ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Raise the shape dirty flag of this object and the shape and value dirty
+/// flags of its clients, visiting each client once per propagation.
+
+void RooAbsArg::propagateShapeDirty(const RooAbsArg* source, ULong64_t stamp) const
 {
   if (_verboseDirty) {
     cxcoutD(LinkStateMgmt) << "RooAbsArg::setShapeDirty(" << GetName()
@@ -905,14 +982,20 @@ void RooAbsArg::setShapeDirty(const RooAbsArg* source) const
     return ;
   }
 
+  // All clients were already reached by this propagation
+  if (_shapeDirtyStamp==stamp) {
+    return ;
+  }
+  _shapeDirtyStamp = stamp ;
+
   // Propagate dirty flag to all clients if this is a down->up transition
   _shapeDirty=kTRUE ;
 
   RooFIter clientShapeIter = _clientListShape.fwdIterator() ;
   RooAbsArg* client ;
   while ((client=clientShapeIter.next())) {
-    client->setShapeDirty(source) ;
-    client->setValueDirty(source) ;
+    client->propagateShapeDirty(source,stamp) ;
+    client->propagateValueDirty(source,stamp) ;
   }
 
 }
@@ -1757,6 +1840,7 @@ void RooAbsArg::setOperMode(OperMode mode, Bool_t recurseADirty)
   if (mode==_operMode) return ;
 
   _operMode = mode ;
+  lastValueChange = ++dirtyStampCounter ;
   _fast = ((mode==AClean) || dynamic_cast<RooRealVar*>(this)!=0 || dynamic_cast<RooConstVar*>(this)!=0 ) ;
   for (Int_t i=0 ;i<numCaches() ; i++) {
     getCache(i)->operModeHook() ;
@@ -171,7 +171,9 @@ RooAbsCachedPdf::PdfCacheElem* RooAbsCachedPdf::getCache(const RooArgSet* nset,
   // Create and fill cache
   cache = createCache(nset) ; 
 
-  // Check if we have contents registered already in global expensive object cache 
+  // Check if we have contents registered already in global expensive object cache. The lock
+  // is held until the contents are copied, as another thread may replace the cached object.
+  std::unique_lock<std::recursive_mutex> cacheLock(RooExpensiveObjectCache::mutex()) ;
   RooDataHist* htmp = (RooDataHist*) expensiveObjectCache().retrieveObject(cache->hist()->GetName(),RooDataHist::Class(),cache->paramTracker()->parameters()) ;
 
   if (htmp) {    
@@ -188,6 +190,7 @@ RooAbsCachedPdf::PdfCacheElem* RooAbsCachedPdf::getCache(const RooArgSet* nset,
     expensiveObjectCache().registerObject(GetName(),cache->hist()->GetName(),*eoclone,cache->paramTracker()->parameters()) ;
     
   } 
+  cacheLock.unlock() ;
 
   
   // Store this cache configuration
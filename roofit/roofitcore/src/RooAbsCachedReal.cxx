@@ -157,7 +157,9 @@ RooAbsCachedReal::FuncCacheElem* RooAbsCachedReal::getCache(const RooArgSet* nse
     arg->setOperMode(ADirty);
   }
 
-  // Check if we have contents registered already in global expensive object cache 
+  // Check if we have contents registered already in global expensive object cache. The lock
+  // is held until the contents are copied, as another thread may replace the cached object.
+  std::unique_lock<std::recursive_mutex> cacheLock(RooExpensiveObjectCache::mutex()) ;
   RooDataHist* htmp = (RooDataHist*) expensiveObjectCache().retrieveObject(cache->hist()->GetName(),RooDataHist::Class(),cache->paramTracker()->parameters()) ;
 
   if (htmp) {    
@@ -173,6 +175,7 @@ RooAbsCachedReal::FuncCacheElem* RooAbsCachedReal::getCache(const RooArgSet* nse
     eoclone->removeSelfFromDir() ;
     expensiveObjectCache().registerObject(GetName(),cache->hist()->GetName(),*eoclone,cache->paramTracker()->parameters()) ;
   } 
+  cacheLock.unlock() ;
 
   // Store this cache configuration
   Int_t code = _cacheMgr.setObj(nset,0,((RooAbsCacheElement*)cache),0) ;
@@ -45,6 +45,7 @@ points for its contents and provides an iterator over its elements
 #include "RooAbsDataStore.h"
 #include "RooVectorDataStore.h"
 #include "RooTreeDataStore.h"
+#include "RooLinkedTreeDataStore.h"
 #include "RooDataHist.h"
 #include "RooCompositeDataStore.h"
 #include "RooCategory.h"
@@ -76,8 +77,8 @@ RooAbsData::StorageType RooAbsData::defaultStorageType=RooAbsData::Vector ;
 
 void RooAbsData::setDefaultStorageType(RooAbsData::StorageType s)
 {
-   if (RooAbsData::Composite == s) {
-      cout << "Composite storage is not a valid *default* storage type." << endl;
+   if (RooAbsData::Composite == s || RooAbsData::LinkedTree == s) {
+      cout << (RooAbsData::Composite == s ? "Composite" : "LinkedTree") << " storage is not a valid *default* storage type." << endl;
    } else {
       defaultStorageType = s;
    }
@@ -136,6 +137,8 @@ RooAbsData::RooAbsData(const char *name, const char *title, const RooArgSet& var
       storageType = RooAbsData::Tree;
    } else if (dynamic_cast<RooVectorDataStore *>(dstore)) {
       storageType = RooAbsData::Vector;
+   } else if (dynamic_cast<RooLinkedTreeDataStore *>(dstore)) {
+      storageType = RooAbsData::LinkedTree;
    } else {
       storageType = RooAbsData::Composite;
    }
@@ -248,7 +251,8 @@ RooAbsData::~RooAbsData()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Convert tree-based storage to vector-based storage
+/// Convert tree-based storage to vector-based storage. The events of a
+/// dataset linked to an external tree are copied into memory.
 
 void RooAbsData::convertToVectorStore()
 {
@@ -257,6 +261,11 @@ void RooAbsData::convertToVectorStore()
       delete _dstore;
       _dstore = newStore;
       storageType = RooAbsData::Vector;
+   } else if (storageType == RooAbsData::LinkedTree) {
+      RooVectorDataStore *newStore = new RooVectorDataStore(*(RooLinkedTreeDataStore *)_dstore, _vars, GetName());
+      delete _dstore;
+      _dstore = newStore;
+      storageType = RooAbsData::Vector;
    }
 }
 
@@ -302,6 +311,27 @@ const RooArgSet* RooAbsData::get(Int_t index) const
   return _dstore->get(index) ;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the values of 'real' for the events [first,first+nEvents),
+/// if real is stored in (or attached to) a column of this dataset, or zero if
+/// the values are not available column-wise.
+
+const Double_t* RooAbsData::getBatch(const RooAbsReal& real, Int_t first, Int_t nEvents) const
+{
+  checkInit() ;
+  return _dstore->getBatch(real,first,nEvents) ;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill weights with the weights of the events [first,first+nEvents).
+/// Return kFALSE if the weights cannot be retrieved column-wise.
+
+Bool_t RooAbsData::getWeightBatch(Double_t* weights, Int_t first, Int_t nEvents) const
+{
+  checkInit() ;
+  return _dstore->getWeightBatch(weights,first,nEvents) ;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Internal method -- Cache given set of functions with data
 
@@ -2318,6 +2348,15 @@ void RooAbsData::Streamer(TBuffer &R__b)
    convertToVectorStore() ;
       }
 
+   } else if (storageType == RooAbsData::LinkedTree) {
+      // The events of a linked tree are not held by its store, write them as a vector store
+      RooAbsDataStore* linkedStore = _dstore ;
+      _dstore = new RooVectorDataStore(*(RooLinkedTreeDataStore *)linkedStore, _vars, GetName());
+      storageType = RooAbsData::Vector;
+      R__b.WriteClassBuffer(RooAbsData::Class(),this);
+      delete _dstore;
+      _dstore = linkedStore;
+      storageType = RooAbsData::LinkedTree;
    } else {
       R__b.WriteClassBuffer(RooAbsData::Class(),this);
    }
@@ -167,7 +167,7 @@ ClassImp(RooAbsPdf::GenSpec);
 ;
 
 Int_t RooAbsPdf::_verboseEval = 0;
-Bool_t RooAbsPdf::_evalError = kFALSE ;
+std::atomic<Bool_t> RooAbsPdf::_evalError(kFALSE) ;
 TString RooAbsPdf::_normRangeOverride ;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -311,6 +311,83 @@ Double_t RooAbsPdf::getValV(const RooArgSet* nset) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill output with the normalized values of this p.d.f for the events
+/// [first,first+nEvents) of data, see RooAbsReal::getValBatch().
+///
+/// The unnormalized values are calculated with evaluateBatch() and divided by
+/// the normalization integral, which is evaluated once. This requires that
+/// the normalization was set up for nset by a previous call to getVal(nset)
+/// and that it does not depend on the observables of data, as is the case for
+/// conditional p.d.f.s. Otherwise, and for events where the p.d.f value is
+/// negative or Not-a-Number, the p.d.f is evaluated event by event.
+
+void RooAbsPdf::getValBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents, const RooArgSet* nset) const
+{
+  if (nEvents<=0) return ;
+  if (getValBatchFromData(output,data,first,nEvents,nset)) return ;
+
+  if (!nset || nset!=_normSet || !_norm || _norm->dependsOn(*data.get()) ||
+      !evaluateBatch(output,data,first,nEvents)) {
+    getValBatchPerEvent(output,data,first,nEvents,nset) ;
+    return ;
+  }
+
+  Double_t normVal(_norm->getVal()) ;
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    Double_t rawVal = output[i] ;
+    if (rawVal<0 || TMath::IsNaN(rawVal) || normVal<=0.) {
+      // Let getValV() handle and log the error
+      data.get(first+i) ;
+      output[i] = getVal(nset) ;
+    } else {
+      output[i] = rawVal / normVal ;
+    }
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative of the normalized value of this p.d.f with respect
+/// to param. The unnormalized value returned by evaluate() is differentiated
+/// numerically, and combined with the derivative of the normalization integral
+/// by normalizedDerivative(). The latter derivative does not depend on the
+/// observables, so that it is calculated only once for all events of a dataset.
+
+Double_t RooAbsPdf::evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const
+{
+  if (!nset || selfNormalized()) {
+    return RooAbsReal::evaluateDerivative(param,nset) ;
+  }
+  if (!dependsOnValue(param)) return 0 ;
+
+  // Synchronize the normalization with nset, so that evaluate() is in the same state as in getValV()
+  Double_t value = getVal(nset) ;
+  Double_t rawDeriv = numericDerivative(param,[this]{ return evaluate() ; }) ;
+  return normalizedDerivative(param,nset,value,rawDeriv) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative of the normalized value with respect to param, given
+/// the normalized value and the derivative rawDeriv of the unnormalized value
+/// returned by evaluate(). The normalization must have been synchronized with
+/// nset by a call to getVal(nset).
+
+Double_t RooAbsPdf::normalizedDerivative(const RooAbsRealLValue& param, const RooArgSet* nset, Double_t value, Double_t rawDeriv) const
+{
+  if (!nset || !_norm) return rawDeriv ;
+
+  Double_t normVal = _norm->getVal() ;
+  if (normVal<=0.) return 0 ;
+
+  return (rawDeriv - value*_norm->getDerivative(param)) / normVal ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Analytical integral with normalization (see RooAbsReal::analyticalIntegralWN() for further information)
 ///
@@ -707,6 +784,21 @@ Double_t RooAbsPdf::extendedTerm(Double_t observed, const RooArgSet* nset) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative of extendedTerm() with respect to param
+
+Double_t RooAbsPdf::extendedTermDerivative(const RooAbsRealLValue& param, Double_t observed, const RooArgSet* nset) const
+{
+  if (!canBeExtended()) return 0 ;
+
+  Double_t expected = expectedEvents(nset) ;
+  if (expected<=0 || TMath::IsNaN(expected)) return 0 ;
+
+  return expectedEventsDerivative(param,nset)*(1 - observed/expected) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Construct representation of -log(L) of PDFwith given dataset. If dataset is unbinned, an unbinned likelihood is constructed. If the dataset
 /// is binned, a binned likelihood is constructed. 
@@ -734,6 +826,9 @@ Double_t RooAbsPdf::extendedTerm(Double_t observed, const RooArgSet* nset) const
 ///                                    Strategy 3 = RooFit::Hybrid --> Follow strategy 0 for all RooSimultaneous components, except those with less than
 ///                                                 30 dataset entries, for which strategy 2 is followed.
 ///
+/// NumThreads(int num, int strat)  -- Parallelize NLL calculation in num partitions calculated by threads of the implicit multi-threading
+///                                    pool (see ROOT::EnableImplicitMT()) rather than in forked processes. Strategies as for NumCPU
+///
 /// Optimize(Bool_t flag)           -- Activate constant term optimization (on by default)
 /// SplitRange(Bool_t flag)         -- Use separate fit ranges in a simultaneous fit. Actual range name for each
 ///                                    subsample is assumed to by rangeName_{indexState} where indexState
@@ -748,6 +843,8 @@ Double_t RooAbsPdf::extendedTerm(Double_t observed, const RooArgSet* nset) const
 /// CloneData(Bool flag)           -- Use clone of dataset in NLL (default is true)
 /// Offset(Bool_t)                  -- Offset likelihood by initial value (so that starting value of FCN in minuit is zero). This
 ///                                    can improve numeric stability in simultaneously fits with components with large likelihood values
+/// BatchMode(Bool_t)               -- Evaluate the p.d.f for batches of events rather than event by event (off by default).
+///                                    This is faster for p.d.f.s that implement evaluateBatch(), and gives identical results
 /// 
 /// 
 
@@ -789,6 +886,8 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   pc.defineInt("ext","Extended",0,2) ;
   pc.defineInt("numcpu","NumCPU",0,1) ;
   pc.defineInt("interleave","NumCPU",1,0) ;
+  pc.defineInt("numthreads","NumThreads",0,0) ;
+  pc.defineInt("threadInterleave","NumThreads",1,0) ;
   pc.defineInt("verbose","Verbose",0,0) ;
   pc.defineInt("optConst","Optimize",0,0) ;
   pc.defineInt("cloneData","CloneData",2,0) ;
@@ -797,10 +896,12 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   pc.defineSet("glObs","GlobalObservables",0,0) ;
   pc.defineInt("constrAll","Constrained",0,0) ;
   pc.defineInt("doOffset","OffsetLikelihood",0,0) ;
+  pc.defineInt("batchMode","BatchMode",0,0) ;
   pc.defineSet("extCons","ExternalConstraints",0,0) ;
   pc.defineMutex("Range","RangeWithName") ;
   pc.defineMutex("Constrain","Constrained") ;
   pc.defineMutex("GlobalObservables","GlobalObservablesTag") ;
+  pc.defineMutex("NumCPU","NumThreads") ;
     
   // Process and check varargs 
   pc.process(cmdList) ;
@@ -821,6 +922,12 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   Int_t optConst = pc.getInt("optConst") ;
   Int_t cloneData = pc.getInt("cloneData") ;
   Int_t doOffset = pc.getInt("doOffset") ;
+  Bool_t batchMode = pc.getInt("batchMode") ;
+  Bool_t useThreads = pc.hasProcessed("NumThreads") ;
+  if (useThreads) {
+    numcpu = pc.getInt("numthreads") ;
+    interl = (RooFit::MPSplit) pc.getInt("threadInterleave") ;
+  }
   
   // If no explicit cloneData command is specified, cloneData is set to true if optimization is activated
   if (cloneData==2) {
@@ -899,7 +1006,10 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     // Simple case: default range, or single restricted range
     //cout<<"FK: Data test 1: "<<data.sumEntries()<<endl;
 
-    nll = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+    RooNLLVar* nllVar = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+    nllVar->enableBatchMode(batchMode) ;
+    nllVar->setUseThreads(useThreads) ;
+    nll = nllVar ;
 
   } else {
     // Composite case: multiple ranges
@@ -909,7 +1019,9 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     strlcpy(buf,rangeName,bufSize) ;
     char* token = strtok(buf,",") ;
     while(token) {
-      RooAbsReal* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+      RooNLLVar* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+      nllComp->enableBatchMode(batchMode) ;
+      nllComp->setUseThreads(useThreads) ;
       nllList.add(*nllComp) ;
       token = strtok(0,",") ;
     }
@@ -997,6 +1109,9 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
 ///                                    Strategy 3 = RooFit::Hybrid --> Follow strategy 0 for all RooSimultaneous components, except those with less than
 ///                                                 30 dataset entries, for which strategy 2 is followed.
 ///
+/// NumThreads(int num, int strat)  -- Parallelize NLL calculation in num partitions calculated by threads of the implicit multi-threading
+///                                    pool (see ROOT::EnableImplicitMT()) rather than in forked processes. Strategies as for NumCPU
+///
 /// SplitRange(Bool_t flag)         -- Use separate fit ranges in a simultaneous fit. Actual range name for each
 ///                                    subsample is assumed to by rangeName_{indexState} where indexState
 ///                                    is the state of the master index category of the simultaneous fit
@@ -1007,6 +1122,7 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
 /// ExternalConstraints(const RooArgSet& ) -- Include given external constraints to likelihood
 /// Offset(Bool_t)                  -- Offset likelihood by initial value (so that starting value of FCN in minuit is zero). This
 ///                                    can improve numeric stability in simultaneously fits with components with large likelihood values
+/// BatchMode(Bool_t)               -- Evaluate the p.d.f for batches of events rather than event by event (off by default)
 ///
 /// Options to control flow of fit procedure
 /// ----------------------------------------
@@ -1083,7 +1199,7 @@ RooFitResult* RooAbsPdf::fitTo(RooAbsData& data, const RooLinkedList& cmdList)
   RooCmdConfig pc(Form("RooAbsPdf::fitTo(%s)",GetName())) ;
 
   RooLinkedList fitCmdList(cmdList) ;
-  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag,OffsetLikelihood") ;
+  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag,OffsetLikelihood,BatchMode,NumThreads") ;
 
   pc.defineString("fitOpt","FitOptions",0,"") ;
   pc.defineInt("optConst","Optimize",0,2) ;
@@ -2934,6 +3050,18 @@ Double_t RooAbsPdf::expectedEvents(const RooArgSet*) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative of expectedEvents(nset) with respect to param. This
+/// default implementation takes a finite difference.
+
+Double_t RooAbsPdf::expectedEventsDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const
+{
+  if (!canBeExtended() || !dependsOnValue(param)) return 0 ;
+  return numericDerivative(param,[&]{ return expectedEvents(nset) ; }) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Change global level of verbosity for p.d.f. evaluations
 
@@ -103,9 +103,16 @@
 #include "TVector.h"
 
 #include <sstream>
+#include <algorithm>
+#include <mutex>
 
 using namespace std ;
 
+namespace {
+  // Serializes the logging of evaluation errors by partitions of test statistics calculated in threads
+  std::recursive_mutex evalErrorMutex ;
+}
+
 ClassImp(RooAbsReal);
 ;
 
@@ -125,7 +132,8 @@ map<const RooAbsArg*,pair<string,list<RooAbsReal::EvalError> > > RooAbsReal::_ev
 /// coverity[UNINIT_CTOR]
 /// Default constructor
 
-RooAbsReal::RooAbsReal() : _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
+RooAbsReal::RooAbsReal() : _derivParam(0), _derivNormSet(0), _derivDirtyStamp(0), _derivStamp(0), _derivValue(0),
+  _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
 {
 }
 
@@ -136,7 +144,9 @@ RooAbsReal::RooAbsReal() : _specIntegratorConfig(0), _treeVar(kFALSE), _selectCo
 
 RooAbsReal::RooAbsReal(const char *name, const char *title, const char *unit) :
   RooAbsArg(name,title), _plotMin(0), _plotMax(0), _plotBins(100),
-  _value(0),  _unit(unit), _forceNumInt(kFALSE), _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
+  _value(0),  _unit(unit), _forceNumInt(kFALSE),
+  _derivParam(0), _derivNormSet(0), _derivDirtyStamp(0), _derivStamp(0), _derivValue(0),
+  _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
 {
   setValueDirty() ;
   setShapeDirty() ;
@@ -151,7 +161,9 @@ RooAbsReal::RooAbsReal(const char *name, const char *title, const char *unit) :
 RooAbsReal::RooAbsReal(const char *name, const char *title, Double_t inMinVal,
 		       Double_t inMaxVal, const char *unit) :
   RooAbsArg(name,title), _plotMin(inMinVal), _plotMax(inMaxVal), _plotBins(100),
-  _value(0), _unit(unit), _forceNumInt(kFALSE), _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
+  _value(0), _unit(unit), _forceNumInt(kFALSE),
+  _derivParam(0), _derivNormSet(0), _derivDirtyStamp(0), _derivStamp(0), _derivValue(0),
+  _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
 {
   setValueDirty() ;
   setShapeDirty() ;
@@ -167,7 +179,8 @@ RooAbsReal::RooAbsReal(const char *name, const char *title, Double_t inMinVal,
 RooAbsReal::RooAbsReal(const RooAbsReal& other, const char* name) :
   RooAbsArg(other,name), _plotMin(other._plotMin), _plotMax(other._plotMax),
   _plotBins(other._plotBins), _value(other._value), _unit(other._unit), _label(other._label),
-  _forceNumInt(other._forceNumInt), _treeVar(other._treeVar), _selectComp(other._selectComp), _lastNSet(0)
+  _forceNumInt(other._forceNumInt), _derivParam(0), _derivNormSet(0), _derivDirtyStamp(0), _derivStamp(0), _derivValue(0),
+  _treeVar(other._treeVar), _selectComp(other._selectComp), _lastNSet(0)
 {
   if (other._specIntegratorConfig) {
     _specIntegratorConfig = new RooNumIntConfig(*other._specIntegratorConfig) ;
@@ -264,6 +277,186 @@ Double_t RooAbsReal::getValV(const RooArgSet* nset) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill output with the values of this function for the events [first,first+nEvents)
+/// of data, normalized to set as in getVal(set). The observables of this function
+/// must be attached to data, as they are in the test statistics.
+///
+/// The values are taken from the data when this function is stored in, or
+/// cached with, the dataset, and are constant if the function does not depend
+/// on the observables of data. Otherwise the function is evaluated with
+/// evaluateBatch(), falling back to loading and evaluating each event in turn
+/// if no batch evaluation is available. Either way, the values are identical
+/// to those obtained by getVal(set) after data.get(i).
+
+void RooAbsReal::getValBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents, const RooArgSet* nset) const
+{
+  if (nEvents<=0) return ;
+  if (getValBatchFromData(output,data,first,nEvents,nset)) return ;
+
+  if (nset && nset!=_lastNSet) {
+    ((RooAbsReal*) this)->setProxyNormSet(nset) ;
+    _lastNSet = (RooArgSet*) nset ;
+  }
+
+  if (hideOffset() || !evaluateBatch(output,data,first,nEvents)) {
+    getValBatchPerEvent(output,data,first,nEvents,nset) ;
+    return ;
+  }
+
+  // Redo invalid values event by event, so that errors are logged as usual
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    if (TMath::IsNaN(output[i])) {
+      data.get(first+i) ;
+      output[i] = getVal(nset) ;
+    }
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill output with the values of this function for the events [first,first+nEvents)
+/// without evaluating it, if the values are stored in data or do not depend on
+/// the event. Return kFALSE if the function needs to be evaluated.
+
+Bool_t RooAbsReal::getValBatchFromData(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents, const RooArgSet* nset) const
+{
+  const Double_t* column = data.getBatch(*this,first,nEvents) ;
+  if (column) {
+    std::copy(column,column+nEvents,output) ;
+    return kTRUE ;
+  }
+
+  if (!dependsOn(*data.get())) {
+    std::fill(output,output+nEvents,getVal(nset)) ;
+    return kTRUE ;
+  }
+
+  return kFALSE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill output with the values of this function for the events [first,first+nEvents),
+/// loading each event of data and calling getVal()
+
+void RooAbsReal::getValBatchPerEvent(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents, const RooArgSet* nset) const
+{
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    data.get(first+i) ;
+    output[i] = getVal(nset) ;
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative of getVal(nset) with respect to param.
+///
+/// The derivative is calculated by evaluateDerivative(), which classes can
+/// implement analytically in terms of the derivatives of their servers. The
+/// result is cached until the value of this object changes. The finite
+/// differences calculated for other objects by numericDerivative() do not
+/// propagate dirty states, and therefore do not invalidate the cache.
+
+Double_t RooAbsReal::getDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const
+{
+  if (&param==this) return 1 ;
+
+  // Leaf nodes and nodes with constant value do not depend on param
+  if (_serverList.GetSize()==0) return 0 ;
+  if (_operMode==AClean) {
+    if (!getAttribute("CacheAndTrack")) return 0 ;
+
+    // Nodes cached in a dataset that track parameter changes are calculated
+    // from their servers, leaving the cached value untouched
+    Double_t tmp = _value ;
+    _operMode = ADirty ;
+    _fast = kFALSE ;
+    Double_t ret = evaluateDerivative(param,nset) ;
+    _operMode = AClean ;
+    _fast = kTRUE ;
+    _value = tmp ;
+    return ret ;
+  }
+
+  Bool_t useCache = (_operMode==Auto && !inhibitDirty()) ;
+  if (useCache && _derivParam==&param && _derivNormSet==nset &&
+      (_derivDirtyStamp==_valueDirtyStamp || lastValueChangeStamp()<=_derivStamp)) {
+    return _derivValue ;
+  }
+
+  Double_t ret = evaluateDerivative(param,nset) ;
+
+  if (useCache) {
+    _derivParam = &param ;
+    _derivNormSet = nset ;
+    _derivDirtyStamp = _valueDirtyStamp ;
+    _derivStamp = currentDirtyStamp() ;
+    _derivValue = ret ;
+  }
+  return ret ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative of getVal(nset) with respect to param. This default
+/// implementation takes a finite difference of the value of this object, see
+/// numericDerivative(). Classes for which the derivative can be expressed in terms
+/// of the derivatives of their servers should override this function.
+
+Double_t RooAbsReal::evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const
+{
+  if (!dependsOnValue(param)) return 0 ;
+  return numericDerivative(param,[&]{ return getVal(nset) ; }) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative of func with respect to param by a central finite
+/// difference. The step is 1e-5 relative to the value of param, and the
+/// difference is taken one-sided at the limits of the range of param.
+///
+/// If propagate is false, param is shifted with the dirty state propagation
+/// inhibited, such that func recalculates all values it depends on and the
+/// objects that are not evaluated by func, like the normalization integrals
+/// of the p.d.f.s evaluated in a likelihood, keep their values. After
+/// restoring param, func is evaluated once more to restore the values of
+/// the objects it recalculated. This is the cheaper option for the
+/// derivatives of single nodes, which are calculated for every event.
+/// If propagate is true, the shifts of param propagate the dirty states as
+/// usual, which is more efficient for functions that evaluate a large graph,
+/// like a test statistic.
+
+Double_t RooAbsReal::numericDerivative(const RooAbsRealLValue& param, const std::function<Double_t()>& func, Bool_t propagate)
+{
+  RooAbsRealLValue& var = const_cast<RooAbsRealLValue&>(param) ;
+  const Double_t x = var.getVal() ;
+  const Double_t h = 1e-5*(fabs(x)+1) ;
+  const Double_t xhi = var.hasMax() ? std::min(x+h,var.getMax()) : x+h ;
+  const Double_t xlo = var.hasMin() ? std::max(x-h,var.getMin()) : x-h ;
+  if (xhi<=xlo) return 0 ;
+
+  Bool_t origState = _inhibitDirty() ;
+  if (!propagate) _inhibitDirty() = kTRUE ;
+  var.setVal(xhi) ;
+  const Double_t fhi = func() ;
+  var.setVal(xlo) ;
+  const Double_t flo = func() ;
+  var.setVal(x) ;
+  if (!propagate) {
+    func() ;
+    _inhibitDirty() = origState ;
+  }
+
+  return (fhi-flo)/(xhi-xlo) ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooAbsReal::numEvalErrorItems()
@@ -3579,6 +3772,8 @@ void RooAbsReal::logEvalError(const RooAbsReal* originator, const char* origName
     return ;
   }
 
+  std::lock_guard<std::recursive_mutex> lock(evalErrorMutex) ;
+
   if (_evalErrorMode==CountErrors) {
     _evalErrorCount++ ;
     return ;
@@ -3634,6 +3829,8 @@ void RooAbsReal::logEvalError(const char* message, const char* serverValueString
     return ;
   }
 
+  std::lock_guard<std::recursive_mutex> lock(evalErrorMutex) ;
+
   if (_evalErrorMode==CountErrors) {
     _evalErrorCount++ ;
     return ;
@@ -3707,6 +3904,7 @@ void RooAbsReal::logEvalError(const char* message, const char* serverValueString
 
 void RooAbsReal::clearEvalErrorLog()
 {
+  std::lock_guard<std::recursive_mutex> lock(evalErrorMutex) ;
   if (_evalErrorMode==PrintErrors) {
     return ;
   } else if (_evalErrorMode==CollectErrors) {
@@ -3727,6 +3925,7 @@ void RooAbsReal::clearEvalErrorLog()
 
 void RooAbsReal::printEvalErrors(ostream& os, Int_t maxPerNode)
 {
+  std::lock_guard<std::recursive_mutex> lock(evalErrorMutex) ;
   if (_evalErrorMode == CountErrors) {
     os << _evalErrorCount << " errors counted" << endl ;
   }
@@ -3769,6 +3968,7 @@ void RooAbsReal::printEvalErrors(ostream& os, Int_t maxPerNode)
 
 Int_t RooAbsReal::numEvalErrors()
 {
+  std::lock_guard<std::recursive_mutex> lock(evalErrorMutex) ;
   if (_evalErrorMode==CountErrors) {
     return _evalErrorCount ;
   }
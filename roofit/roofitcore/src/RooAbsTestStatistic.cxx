@@ -31,7 +31,9 @@ statistic values for the PDF components of the simultaneous PDF and
 organizes multi-processor parallel calculation of test statistic
 values. For the latter, the test statistic value is calculated in
 partitions in parallel executing processes and a posteriori
-combined in the main thread.
+combined in the main thread. Alternatively, see setUseThreads(), the
+partitions can be calculated by tasks in the threads of the implicit
+multi-threading pool of the current process.
 **/
 
 
@@ -39,9 +41,11 @@ combined in the main thread.
 #include "Riostream.h"
 
 #include "RooAbsTestStatistic.h"
+#include "RooAbsOptTestStatistic.h"
 #include "RooAbsPdf.h"
 #include "RooSimultaneous.h"
 #include "RooAbsData.h"
+#include "RooDataSet.h"
 #include "RooArgSet.h"
 #include "RooRealVar.h"
 #include "RooNLLVar.h"
@@ -51,7 +55,14 @@ combined in the main thread.
 #include "TTimeStamp.h"
 #include "RooProdPdf.h"
 #include "RooRealSumPdf.h"
+#include "RooLinkedTreeDataStore.h"
 #include <string>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 using namespace std;
 
@@ -64,7 +75,7 @@ RooAbsTestStatistic::RooAbsTestStatistic() :
   _func(0), _data(0), _projDeps(0), _splitRange(0), _simCount(0),
   _verbose(kFALSE), _init(kFALSE), _gofOpMode(Slave), _nEvents(0), _setNum(0),
   _numSets(0), _extSet(0), _nGof(0), _gofArray(0), _nCPU(1), _mpfeArray(0),
-  _mpinterl(RooFit::BulkPartition), _doOffset(kFALSE), _offset(0),
+  _useThreads(kFALSE), _threadsWarm(kFALSE), _mpinterl(RooFit::BulkPartition), _doOffset(kFALSE), _offset(0),
   _offsetCarry(0), _evalCarry(0)
 {
 }
@@ -102,6 +113,8 @@ RooAbsTestStatistic::RooAbsTestStatistic(const char *name, const char *title, Ro
   _gofArray(0),
   _nCPU(nCPU),
   _mpfeArray(0),
+  _useThreads(kFALSE),
+  _threadsWarm(kFALSE),
   _mpinterl(interleave),
   _doOffset(kFALSE),
   _offset(0),
@@ -113,6 +126,14 @@ RooAbsTestStatistic::RooAbsTestStatistic(const char *name, const char *title, Ro
   _paramSet.add(*params) ;
   delete params ;
 
+  // The readers of a linked tree cannot share it between threads or processes
+  if ((_nCPU>1 || _nCPU==-1) && dynamic_cast<const RooLinkedTreeDataStore*>(data.store())) {
+    coutW(Eval) << "RooAbsTestStatistic::ctor(" << GetName() << ") WARNING: the events of dataset " << data.GetName()
+		<< " are read from a linked tree, which cannot be shared by parallel calculations. Calculating serially,"
+		<< " call convertToVectorStore() on the dataset to calculate in parallel" << endl ;
+    _nCPU = 1 ;
+  }
+
   if (_nCPU>1 || _nCPU==-1) {
 
     if (_nCPU==-1) {
@@ -161,6 +182,8 @@ RooAbsTestStatistic::RooAbsTestStatistic(const RooAbsTestStatistic& other, const
   _gofSplitMode(other._gofSplitMode),
   _nCPU(other._nCPU),
   _mpfeArray(0),
+  _useThreads(other._useThreads),
+  _threadsWarm(kFALSE),
   _mpinterl(other._mpinterl),
   _doOffset(other._doOffset),
   _offset(other._offset),
@@ -206,12 +229,12 @@ RooAbsTestStatistic::RooAbsTestStatistic(const RooAbsTestStatistic& other, const
 
 RooAbsTestStatistic::~RooAbsTestStatistic()
 {
-  if (MPMaster == _gofOpMode && _init) {
+  if (MPMaster == _gofOpMode && _init && !_useThreads) {
     for (Int_t i = 0; i < _nCPU; ++i) delete _mpfeArray[i];
     delete[] _mpfeArray ;
   }
 
-  if (SimMaster == _gofOpMode && _init) {
+  if ((SimMaster == _gofOpMode || (MPMaster == _gofOpMode && _useThreads)) && _init) {
     for (Int_t i = 0; i < _nGof; ++i) delete _gofArray[i];
     delete[] _gofArray ;
   }
@@ -227,7 +250,7 @@ RooAbsTestStatistic::~RooAbsTestStatistic()
 /// is calculated from on a RooSimultaneous, the test statistic calculation
 /// is performed separately on each simultaneous p.d.f component and associated
 /// data and then combined. If the test statistic calculation is parallelized
-/// partitions are calculated in nCPU processes and a posteriori combined.
+/// partitions are calculated in nCPU processes, or threads, and a posteriori combined.
 
 Double_t RooAbsTestStatistic::evaluate() const
 {
@@ -268,15 +291,40 @@ Double_t RooAbsTestStatistic::evaluate() const
     return ret ;
 
   } else if (MPMaster == _gofOpMode) {
-    
-    // Start calculations in parallel
-    for (Int_t i = 0; i < _nCPU; ++i) _mpfeArray[i]->calculate();
 
+    std::vector<Double_t> vals(_nCPU), carries(_nCPU) ;
+    if (_useThreads) {
+      // Calculate partitions in threads of the implicit MT pool. The first calculation after
+      // a reconfiguration is done serially, as it creates normalization integrals and caches.
+      // Component selection is forced on so that RooAddPdf & co. do not toggle it concurrently
+      Bool_t tmp = _globalSelectComp ;
+      globalSelectComp(kTRUE) ;
+      auto calcPartition = [&](Int_t i) {
+	vals[i] = _gofArray[i]->getValV() ;
+	carries[i] = _gofArray[i]->getCarry() ;
+      } ;
+#ifdef R__USE_IMT
+      if (_threadsWarm && ROOT::IsImplicitMTEnabled()) {
+	ROOT::TThreadExecutor pool ;
+	pool.Foreach(calcPartition, ROOT::TSeqI(_nCPU)) ;
+      } else
+#endif
+      for (Int_t i = 0; i < _nCPU; ++i) calcPartition(i) ;
+      globalSelectComp(tmp) ;
+      _threadsWarm = kTRUE ;
+    } else {
+      // Start calculations in parallel
+      for (Int_t i = 0; i < _nCPU; ++i) _mpfeArray[i]->calculate();
+      for (Int_t i = 0; i < _nCPU; ++i) {
+	vals[i] = _mpfeArray[i]->getValV() ;
+	carries[i] = _mpfeArray[i]->getCarry() ;
+      }
+    }
 
     Double_t sum(0), carry = 0.;
     for (Int_t i = 0; i < _nCPU; ++i) {
-      Double_t y = _mpfeArray[i]->getValV();
-      carry += _mpfeArray[i]->getCarry();
+      Double_t y = vals[i];
+      carry += carries[i];
       y -= carry;
       const Double_t t = sum + y;
       carry = (t - sum) - y;
@@ -291,30 +339,7 @@ Double_t RooAbsTestStatistic::evaluate() const
 
     // Evaluate as straight FUNC
     Int_t nFirst(0), nLast(_nEvents), nStep(1) ;
-    
-    switch (_mpinterl) {
-    case RooFit::BulkPartition:
-      nFirst = _nEvents * _setNum / _numSets ;
-      nLast  = _nEvents * (_setNum+1) / _numSets ;
-      nStep  = 1 ;
-      break;
-      
-    case RooFit::Interleave:
-      nFirst = _setNum ;
-      nLast  = _nEvents ;
-      nStep  = _numSets ;
-      break ;
-      
-    case RooFit::SimComponents:
-      nFirst = 0 ;
-      nLast  = _nEvents ;
-      nStep  = 1 ;
-      break ;
-      
-    case RooFit::Hybrid:
-      throw(std::string("this should never happen")) ;
-      break ;
-    }
+    partitionRange(nFirst,nLast,nStep) ;
 
     Double_t ret = evaluatePartition(nFirst,nLast,nStep);
 
@@ -331,6 +356,104 @@ Double_t RooAbsTestStatistic::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Determine the range of events [nFirst,nLast) and the step size with which
+/// they are processed by this partition of the test statistic
+
+void RooAbsTestStatistic::partitionRange(Int_t& nFirst, Int_t& nLast, Int_t& nStep) const
+{
+  switch (_mpinterl) {
+  case RooFit::BulkPartition:
+    nFirst = _nEvents * _setNum / _numSets ;
+    nLast  = _nEvents * (_setNum+1) / _numSets ;
+    nStep  = 1 ;
+    break;
+
+  case RooFit::Interleave:
+    nFirst = _setNum ;
+    nLast  = _nEvents ;
+    nStep  = _numSets ;
+    break ;
+
+  case RooFit::SimComponents:
+    nFirst = 0 ;
+    nLast  = _nEvents ;
+    nStep  = 1 ;
+    break ;
+
+  case RooFit::Hybrid:
+    throw(std::string("this should never happen")) ;
+    break ;
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative of the test statistic with respect to param. The
+/// derivatives of the components of a simultaneous test statistic and of the
+/// partitions calculated in threads are added up. Partitions calculated in
+/// forked processes can only be differentiated numerically as a whole. For a
+/// single partition, the derivative is calculated by evaluatePartitionDerivative().
+
+Double_t RooAbsTestStatistic::evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const
+{
+  // One-time Initialization
+  if (!_init) {
+    const_cast<RooAbsTestStatistic*>(this)->initialize() ;
+  }
+
+  if (SimMaster == _gofOpMode) {
+
+    Double_t ret(0) ;
+    for (Int_t i = 0 ; i < _nGof; ++i) {
+      if (_mpinterl == RooFit::BulkPartition || _mpinterl == RooFit::Interleave ||
+	  i % _numSets == _setNum || (_mpinterl==RooFit::Hybrid && _gofSplitMode[i] != RooFit::SimComponents )) {
+	ret += _gofArray[i]->getDerivative(param) ;
+      }
+    }
+    if (numSets()==1) {
+      ret /= globalNormalization() ;
+    }
+    return ret ;
+
+  } else if (MPMaster == _gofOpMode) {
+
+    if (!_useThreads) {
+      return RooAbsReal::evaluateDerivative(param,nset) ;
+    }
+    Double_t ret(0) ;
+    for (Int_t i = 0; i < _nCPU; ++i) {
+      ret += _gofArray[i]->getDerivative(param) ;
+    }
+    return ret ;
+
+  } else {
+
+    Int_t nFirst(0), nLast(_nEvents), nStep(1) ;
+    partitionRange(nFirst,nLast,nStep) ;
+
+    Double_t ret = evaluatePartitionDerivative(param,nFirst,nLast,nStep) ;
+    if (numSets()==1) {
+      ret /= globalNormalization() ;
+    }
+    return ret ;
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative of evaluatePartition() with respect to param. This
+/// default implementation takes a finite difference of the whole partition.
+
+Double_t RooAbsTestStatistic::evaluatePartitionDerivative(const RooAbsRealLValue& param, Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const
+{
+  return numericDerivative(param,[&]{ return evaluatePartition(firstEvent,lastEvent,stepSize) ; },kTRUE) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// One-time initialization of the test statistic. Setup
 /// infrastructure for simultaneous p.d.f processing and/or
@@ -340,7 +463,9 @@ Bool_t RooAbsTestStatistic::initialize()
 {
   if (_init) return kFALSE;
   
-  if (MPMaster == _gofOpMode) {
+  if (MPMaster == _gofOpMode && _useThreads) {
+    initThreadMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
+  } else if (MPMaster == _gofOpMode) {
     initMPMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
   } else if (SimMaster == _gofOpMode) {
     initSimMode((RooSimultaneous*)_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
@@ -356,13 +481,14 @@ Bool_t RooAbsTestStatistic::initialize()
 
 Bool_t RooAbsTestStatistic::redirectServersHook(const RooAbsCollection& newServerList, Bool_t mustReplaceAll, Bool_t nameChange, Bool_t)
 {
-  if (SimMaster == _gofOpMode && _gofArray) {
+  if ((SimMaster == _gofOpMode || MPMaster == _gofOpMode) && _gofArray) {
     // Forward to slaves
     for (Int_t i = 0; i < _nGof; ++i) {
       if (_gofArray[i]) {
 	_gofArray[i]->recursiveRedirectServers(newServerList,mustReplaceAll,nameChange);
       }
     }
+    _threadsWarm = kFALSE ;
   } else if (MPMaster == _gofOpMode&& _mpfeArray) {
     // Forward to slaves
     for (Int_t i = 0; i < _nCPU; ++i) {
@@ -383,7 +509,7 @@ Bool_t RooAbsTestStatistic::redirectServersHook(const RooAbsCollection& newServe
 
 void RooAbsTestStatistic::printCompactTreeHook(ostream& os, const char* indent)
 {
-  if (SimMaster == _gofOpMode) {
+  if (SimMaster == _gofOpMode || (MPMaster == _gofOpMode && _useThreads && _gofArray)) {
     // Forward to slaves
     os << indent << "RooAbsTestStatistic begin GOF contents" << endl ;
     for (Int_t i = 0; i < _nGof; ++i) {
@@ -417,6 +543,11 @@ void RooAbsTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool_t
 	if (_gofArray[i]) _gofArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
       }
     }
+  } else if (MPMaster == _gofOpMode && _useThreads) {
+    for (Int_t i = 0; i < _nGof; ++i) {
+      _gofArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
+    }
+    _threadsWarm = kFALSE ;
   } else if (MPMaster == _gofOpMode) {
     for (Int_t i = 0; i < _nCPU; ++i) {
       _mpfeArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
@@ -478,6 +609,60 @@ void RooAbsTestStatistic::initMPMode(RooAbsReal* real, RooAbsData* data, const R
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Initialize multi-threaded calculation mode. Create a component test statistic for
+/// each partition in this process. Each of them owns a clone of the function, and with
+/// it its own evaluation caches, while all share the parameters of this test statistic,
+/// which are only read during the calculation. The data is cloned once, by the first
+/// partition, and the others read its entries through a view (see partitionView()).
+
+void RooAbsTestStatistic::initThreadMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName)
+{
+  _nGof = _nCPU ;
+  _gofArray = new pRooAbsTestStatistic[_nGof] ;
+
+  for (Int_t i = 0; i < _nGof; ++i) {
+    ccoutD(Eval) << "RooAbsTestStatistic::initThreadMode: creating slave calculator #" << i << endl;
+    // With a fit range, each partition reduces the data to the range itself
+    RooDataSet* view = (i > 0 && !(rangeName && strlen(rangeName))) ? partitionView() : 0 ;
+    _gofArray[i] = create(Form("%s_GOF%d",GetName(),i),Form("%s_GOF%d",GetTitle(),i),*real,view?*view:*data,*projDeps,rangeName,addCoefRangeName,1,_mpinterl,_verbose,_splitRange) ;
+    delete view ;
+    _gofArray[i]->_useThreads = kTRUE ;
+    _gofArray[i]->recursiveRedirectServers(_paramSet) ;
+    _gofArray[i]->setMPSet(i,_nGof) ;
+  }
+  _threadsWarm = kFALSE ;
+
+#ifdef R__USE_IMT
+  if (!ROOT::IsImplicitMTEnabled()) {
+    coutW(Eval) << "RooAbsTestStatistic::initThreadMode(" << GetName() << ") WARNING: implicit multi-threading is not enabled, "
+		<< "partitions will be calculated sequentially. Call ROOT::EnableImplicitMT() to calculate them in parallel" << endl ;
+  }
+#else
+  coutW(Eval) << "RooAbsTestStatistic::initThreadMode(" << GetName() << ") WARNING: ROOT was built without implicit multi-threading, "
+	      << "partitions will be calculated sequentially" << endl ;
+#endif
+  coutI(Eval) << "RooAbsTestStatistic::initThreadMode: created " << _nGof << " slave calculators." << endl;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a view of all entries of the data of the first thread partition, or 0 if it
+/// cannot be viewed. The test statistic of another partition created from the view
+/// copies only the view, and shares the entries with the first partition, which must
+/// outlive it. It still selects its events with setMPSet(), so that the partitions
+/// keep their interleaving and the extended term is added once.
+
+RooDataSet* RooAbsTestStatistic::partitionView() const
+{
+  RooAbsOptTestStatistic* gof0 = dynamic_cast<RooAbsOptTestStatistic*>(_gofArray[0]) ;
+  const RooDataSet* data0 = gof0 ? dynamic_cast<const RooDataSet*>(&gof0->data()) : 0 ;
+  return data0 ? data0->viewClone(0,data0->numEntries()) : 0 ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Initialize simultaneous p.d.f processing mode. Strip simultaneous
 /// p.d.f into individual components, split dataset in subset
@@ -563,6 +748,7 @@ void RooAbsTestStatistic::initSimMode(RooSimultaneous* simpdf, RooAbsData* data,
 			      rangeName,addCoefRangeName,_nCPU,_mpinterl,_verbose,_splitRange,binnedL);
       }
       _gofArray[n]->setSimCount(_nGof);
+      _gofArray[n]->_useThreads = _useThreads;
       // *** END HERE
 
       // Fill per-component split mode with Bulk Partition for now so that Auto will map to bulk-splitting of all components
@@ -653,6 +839,20 @@ Bool_t RooAbsTestStatistic::setData(RooAbsData& indata, Bool_t cloneData)
     }
     break;
   case MPMaster:
+    if (_useThreads) {
+      // Forward to slaves, which own their data. All but the first take a view of the data of the first
+      initialize() ;
+      for (Int_t i = 0; i < _nGof; ++i) {
+	RooDataSet* view = (i > 0 && _rangeName.empty()) ? partitionView() : 0 ;
+	if (view) {
+	  _gofArray[i]->setDataSlave(*view, kFALSE, kTRUE);
+	} else {
+	  _gofArray[i]->setData(indata, cloneData);
+	}
+      }
+      _threadsWarm = kFALSE ;
+      break;
+    }
     // Not supported
     coutF(DataHandling) << "RooAbsTestStatistic::setData(" << GetName() << ") FATAL: setData() is not supported in multi-processor mode" << endl;
     throw string("RooAbsTestStatistic::setData is not supported in MPMaster mode");
@@ -690,7 +890,11 @@ void RooAbsTestStatistic::enableOffsetting(Bool_t flag)
   case MPMaster:    
     _doOffset = flag;
     for (Int_t i = 0; i < _nCPU; ++i) {
-      _mpfeArray[i]->enableOffsetting(flag);
+      if (_useThreads) {
+	_gofArray[i]->enableOffsetting(flag);
+      } else {
+	_mpfeArray[i]->enableOffsetting(flag);
+      }
     }
     break;
   }
@@ -699,3 +903,23 @@ void RooAbsTestStatistic::enableOffsetting(Bool_t flag)
 
 Double_t RooAbsTestStatistic::getCarry() const
 { return _evalCarry; }
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// If flag is true, partitions of a test statistic constructed with nCPU>1 are
+/// calculated by tasks in the threads of the implicit multi-threading pool of this
+/// process (see ROOT::EnableImplicitMT()) rather than in nCPU forked server processes.
+/// This avoids the cost of forking and of the communication of every parameter change
+/// between the processes, and the processes' copies of the workspace. The first
+/// calculation after each reconfiguration is done sequentially. This must be called
+/// before the first calculation of the test statistic.
+
+void RooAbsTestStatistic::setUseThreads(Bool_t flag)
+{
+  if (_init) {
+    coutE(Eval) << "RooAbsTestStatistic::setUseThreads(" << GetName() << ") ERROR: test statistic is already initialized, ignoring request" << endl ;
+    return ;
+  }
+  _useThreads = flag ;
+}
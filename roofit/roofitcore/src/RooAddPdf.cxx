@@ -772,8 +772,9 @@ void RooAddPdf::updateCoefficients(CacheElem& cache, const RooArgSet* nset) cons
   // Adjust coefficients for given projection
   Double_t coefSum(0) ;
   for (i=0 ; i<_pdfList.getSize() ; i++) {
+    // Only toggle the global selection if needed, it is set by test statistics calculated in threads
     Bool_t _tmp = _globalSelectComp ;
-    RooAbsPdf::globalSelectComp(kTRUE) ;    
+    if (!_tmp) RooAbsPdf::globalSelectComp(kTRUE) ;    
 
     RooAbsReal* pp = ((RooAbsReal*)cache._projList.at(i)) ; 
     RooAbsReal* sn = ((RooAbsReal*)cache._suppProjList.at(i)) ; 
@@ -789,7 +790,7 @@ void RooAddPdf::updateCoefficients(CacheElem& cache, const RooArgSet* nset) cons
 // 	 << "ALEX:   r2 = " << r2->GetName() << " = " << r2->getVal() <<  endl 
 // 	 << "ALEX: proj = (" << pp->getVal() << "/" << sn->getVal() << ")*(" << r2->getVal() << "/" << r1->getVal() << ") = " << proj << endl ;
     
-    RooAbsPdf::globalSelectComp(_tmp) ;
+    if (!_tmp) RooAbsPdf::globalSelectComp(kFALSE) ;
 
     _coefCache[i] *= proj ;
     coefSum += _coefCache[i] ;
@@ -860,6 +861,136 @@ Double_t RooAddPdf::evaluate() const
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative with respect to param from the derivatives of the
+/// component p.d.f.s and of the coefficients. The analytical calculation is
+/// done if the coefficients need no projection or supplemental normalization,
+/// otherwise the derivative is calculated numerically.
+
+Double_t RooAddPdf::evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const 
+{
+  if (nset==0 || nset->getSize()==0) {
+    return RooAbsPdf::evaluateDerivative(param,nset) ;
+  }
+
+  CacheElem* cache = getProjCache(nset) ;
+  if (cache->_needSupNorm || ((_projectCoefs || _normRange.Length()>0) && cache->_projList.getSize()>0)) {
+    return RooAbsPdf::evaluateDerivative(param,nset) ;
+  }
+  updateCoefficients(*cache,nset) ;
+
+  // Derivatives of the coefficients, following the cases of updateCoefficients()
+  Int_t i ;
+  std::vector<Double_t> coefDeriv(_pdfList.getSize(),0.) ;
+  if (_allExtendable || _haveLastCoef) {
+
+    // coef[i] = a[i] / SUM(a)
+    const RooArgSet* enset = _refCoefNorm.getSize()>0 ? &_refCoefNorm : nset ;
+    Double_t coefSum(0), coefSumDeriv(0) ;
+    RooFIter it = _allExtendable ? _pdfList.fwdIterator() : _coefList.fwdIterator() ; i=0 ;
+    RooAbsArg* arg ;
+    while((arg=it.next())) {
+      if (_allExtendable) {
+	coefSum += ((RooAbsPdf*)arg)->expectedEvents(enset) ;
+	coefDeriv[i] = ((RooAbsPdf*)arg)->expectedEventsDerivative(param,enset) ;
+      } else {
+	coefSum += ((RooAbsReal*)arg)->getVal(nset) ;
+	coefDeriv[i] = ((RooAbsReal*)arg)->getDerivative(param,nset) ;
+      }
+      coefSumDeriv += coefDeriv[i] ;
+      i++ ;
+    }
+    if (coefSum==0.) {
+      return RooAbsPdf::evaluateDerivative(param,nset) ;
+    }
+    for (i=0 ; i<_pdfList.getSize() ; i++) {
+      coefDeriv[i] = (coefDeriv[i] - _coefCache[i]*coefSumDeriv) / coefSum ;
+    }
+
+  } else {
+
+    // coef[i] = coef[i] ; coef[n] = 1-SUM(coef[0...n-1])
+    Double_t lastCoefDeriv(0) ;
+    RooFIter it=_coefList.fwdIterator() ; i=0 ;
+    RooAbsReal* coef ;
+    while((coef=(RooAbsReal*)it.next())) {
+      coefDeriv[i] = coef->getDerivative(param,nset) ;
+      lastCoefDeriv -= coefDeriv[i] ;
+      i++ ;
+    }
+    coefDeriv[_coefList.getSize()] = lastCoefDeriv ;
+  }
+
+  // Product rule for the coef/pdf pairs
+  Double_t deriv(0) ;
+  RooFIter pi = _pdfList.fwdIterator() ; i=0 ;
+  RooAbsPdf* pdf ;
+  while((pdf = (RooAbsPdf*)pi.next())) {
+    if (pdf->isSelectedComp()) {
+      if (coefDeriv[i]!=0) deriv += coefDeriv[i]*pdf->getVal(nset) ;
+      if (_coefCache[i]!=0) deriv += _coefCache[i]*pdf->getDerivative(param,nset) ;
+    }
+    i++ ;
+  }
+
+  return deriv ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the sum of the components for the events [first,first+nEvents)
+/// of data in one go, see RooAbsReal::getValBatch(). This is only done if the
+/// coefficients are the same for all events, i.e. if neither the coefficients
+/// nor their projection integrals depend on the observables of data.
+
+Bool_t RooAddPdf::evaluateBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents) const
+{
+  const RooArgSet* nset = _normSet ; 
+  if (nset==0 || nset->getSize()==0) {
+    if (_refCoefNorm.getSize()!=0) {
+      nset = &_refCoefNorm ;
+    }
+  }
+
+  CacheElem* cache = getProjCache(nset) ;
+  if (cache->_needSupNorm) return kFALSE ;
+
+  const RooArgSet& obs = *data.get() ;
+  const RooArgList* coefLists[5] = { &_coefList, &cache->_projList, &cache->_suppProjList,
+				     &cache->_refRangeProjList, &cache->_rangeProjList } ;
+  for (Int_t j=0 ; j<5 ; j++) {
+    RooFIter ci = coefLists[j]->fwdIterator() ;
+    RooAbsArg* arg ;
+    while((arg = ci.next())) {
+      if (arg->dependsOn(obs)) return kFALSE ;
+    }
+  }
+
+  updateCoefficients(*cache,nset) ;
+
+  // Do running sum of coef/pdf pairs, in the same order as evaluate()
+  std::vector<Double_t> pdfVal(nEvents) ;
+  std::fill(output,output+nEvents,0.) ;
+  RooAbsPdf* pdf ;
+  Int_t i(0) ;
+  RooFIter pi = _pdfList.fwdIterator() ;
+  while((pdf = (RooAbsPdf*)pi.next())) {
+    if (pdf->isSelectedComp()) {
+      pdf->getValBatch(&pdfVal[0],data,first,nEvents,nset) ;
+      const Double_t coef = _coefCache[i] ;
+      for (Int_t k=0 ; k<nEvents ; k++) {
+	output[k] += pdfVal[k]*coef ;
+      }
+    }
+    i++ ;
+  }
+
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset error counter to given value, limiting the number
 /// of future error messages for this pdf to 'resetValue'
@@ -1111,6 +1242,36 @@ Double_t RooAddPdf::expectedEvents(const RooArgSet* nset) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative of expectedEvents(nset) with respect to param, which
+/// is calculated numerically if the expected events are corrected for ranges
+
+Double_t RooAddPdf::expectedEventsDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const 
+{
+  CacheElem* cache = getProjCache(nset) ;
+  if (cache->_rangeProjList.getSize()>0) {
+    return RooAbsPdf::expectedEventsDerivative(param,nset) ;
+  }
+
+  Double_t deriv(0) ;
+  if (_allExtendable) {
+    RooFIter iter = _pdfList.fwdIterator() ;
+    RooAbsPdf* pdf ;
+    while((pdf=(RooAbsPdf*)iter.next())) {
+      deriv += pdf->expectedEventsDerivative(param,nset) ;
+    }
+  } else {
+    RooFIter citer = _coefList.fwdIterator() ;
+    RooAbsReal* coef ;
+    while((coef=(RooAbsReal*)citer.next())) {
+      deriv += coef->getDerivative(param,nset) ;
+    }
+  }
+  return deriv ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Interface function used by test statistics to freeze choice of observables
 /// for interpretation of fraction coefficients
@@ -179,6 +179,24 @@ Double_t RooAddition::evaluate() const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative of the sum with respect to param, which is the sum of
+/// the derivatives of the terms
+
+Double_t RooAddition::evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* /*nset*/) const
+{
+  Double_t sum(0);
+  const RooArgSet* nset = _set.nset() ;
+
+  RooFIter setIter = _set.fwdIterator() ;
+  RooAbsReal* comp ;
+  while((comp=(RooAbsReal*)setIter.next())) {
+    sum += comp->getDerivative(param,nset) ;
+  }
+  return sum ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the default error level for MINUIT error analysis
 /// If the addition contains one or more RooNLLVars and 
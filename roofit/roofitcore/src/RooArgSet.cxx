@@ -43,6 +43,7 @@
 #include <iomanip>
 #include <fstream>
 #include <list>
+#include <mutex>
 #include "TClass.h"
 #include "RooErrorHandler.h"
 #include "RooArgSet.h"
@@ -77,11 +78,20 @@ struct POOLDATA
 
 static std::list<POOLDATA> _memPoolList ;
 
+// Protects the memory pool, RooArgSets are also created and deleted by the
+// threads that evaluate test statistics in parallel
+static std::recursive_mutex& memPoolMutex()
+{
+  static std::recursive_mutex poolMutex ;
+  return poolMutex ;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Clear memoery pool on exit to avoid reported memory leaks
 
 void RooArgSet::cleanup()
 {
+  std::lock_guard<std::recursive_mutex> lock(memPoolMutex()) ;
   std::list<POOLDATA>::iterator iter = _memPoolList.begin() ;
   while(iter!=_memPoolList.end()) {
     free(iter->_base) ;
@@ -104,6 +114,7 @@ void RooArgSet::cleanup()
 void* RooArgSet::operator new (size_t bytes)
 {
   //cout << " RooArgSet::operator new(" << bytes << ")" << endl ;
+  std::lock_guard<std::recursive_mutex> lock(memPoolMutex()) ;
 
   if (!_poolBegin || _poolCur+(sizeof(RooArgSet)) >= _poolEnd) {
 
@@ -180,6 +191,7 @@ void* RooArgSet::operator new (size_t bytes, void* ptr) noexcept
 
 void RooArgSet::operator delete (void* ptr)
 {
+  std::lock_guard<std::recursive_mutex> lock(memPoolMutex()) ;
   // Decrease use count in pool that ptr is on
   for (std::list<POOLDATA>::iterator poolIter =  _memPoolList.begin() ; poolIter!=_memPoolList.end() ; ++poolIter) {
     if ((char*)ptr > (char*)poolIter->_base && (char*)ptr < (char*)poolIter->_base + POOLSIZE) {
@@ -78,6 +78,7 @@ RooDataHist::RooDataHist() : _pbinvCacheMgr(0,10)
   _curWgtErrHi = 0 ;
   _curWgtErrLo = 0 ;
   _cache_sum_valid = 0 ;
+  _nonEmptyBinsValid = kFALSE ;
   TRACE_CREATE
 }
 
@@ -101,7 +102,7 @@ RooDataHist::RooDataHist() : _pbinvCacheMgr(0,10)
 /// data hist as function of the threshold category instead of the real variable.
 
 RooDataHist::RooDataHist(const char *name, const char *title, const RooArgSet& vars, const char* binningName) : 
-  RooAbsData(name,title,vars), _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0)
+  RooAbsData(name,title,vars), _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0), _nonEmptyBinsValid(kFALSE)
 {
   // Initialize datastore
   _dstore = (defaultStorageType==Tree) ? ((RooAbsDataStore*) new RooTreeDataStore(name,title,_vars)) : 
@@ -139,7 +140,7 @@ RooDataHist::RooDataHist(const char *name, const char *title, const RooArgSet& v
 /// all missing dimensions will be projected.
 
 RooDataHist::RooDataHist(const char *name, const char *title, const RooArgSet& vars, const RooAbsData& data, Double_t wgt) :
-  RooAbsData(name,title,vars), _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0)
+  RooAbsData(name,title,vars), _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0), _nonEmptyBinsValid(kFALSE)
 {
   // Initialize datastore
   _dstore = (defaultStorageType==Tree) ? ((RooAbsDataStore*) new RooTreeDataStore(name,title,_vars)) : 
@@ -167,7 +168,7 @@ RooDataHist::RooDataHist(const char *name, const char *title, const RooArgSet& v
 RooDataHist::RooDataHist(const char *name, const char *title, const RooArgList& vars, RooCategory& indexCat, 
 			 map<string,TH1*> histMap, Double_t wgt) :
   RooAbsData(name,title,RooArgSet(vars,&indexCat)), 
-  _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0)
+  _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0), _nonEmptyBinsValid(kFALSE)
 {
   // Initialize datastore
   _dstore = (defaultStorageType==Tree) ? ((RooAbsDataStore*) new RooTreeDataStore(name,title,_vars)) : 
@@ -193,7 +194,7 @@ RooDataHist::RooDataHist(const char *name, const char *title, const RooArgList&
 RooDataHist::RooDataHist(const char *name, const char *title, const RooArgList& vars, RooCategory& indexCat, 
 			 map<string,RooDataHist*> dhistMap, Double_t wgt) :
   RooAbsData(name,title,RooArgSet(vars,&indexCat)), 
-  _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0)
+  _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0), _nonEmptyBinsValid(kFALSE)
 {
   // Initialize datastore
   _dstore = (defaultStorageType==Tree) ? ((RooAbsDataStore*) new RooTreeDataStore(name,title,_vars)) : 
@@ -214,7 +215,7 @@ RooDataHist::RooDataHist(const char *name, const char *title, const RooArgList&
 /// values are set accordingly on the arguments in 'vars'
 
 RooDataHist::RooDataHist(const char *name, const char *title, const RooArgList& vars, const TH1* hist, Double_t wgt) :
-  RooAbsData(name,title,vars), _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0)
+  RooAbsData(name,title,vars), _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0), _nonEmptyBinsValid(kFALSE)
 {
   // Initialize datastore
   _dstore = (defaultStorageType==Tree) ? ((RooAbsDataStore*) new RooTreeDataStore(name,title,_vars)) : 
@@ -272,7 +273,7 @@ RooDataHist::RooDataHist(const char *name, const char *title, const RooArgList&
 RooDataHist::RooDataHist(const char *name, const char *title, const RooArgList& vars, const RooCmdArg& arg1, const RooCmdArg& arg2, const RooCmdArg& arg3,
 			 const RooCmdArg& arg4,const RooCmdArg& arg5,const RooCmdArg& arg6,const RooCmdArg& arg7,const RooCmdArg& arg8) :
   RooAbsData(name,title,RooArgSet(vars,(RooAbsArg*)RooCmdConfig::decodeObjOnTheFly("RooDataHist::RooDataHist", "IndexCat",0,0,arg1,arg2,arg3,arg4,arg5,arg6,arg7,arg8))), 
-  _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0)
+  _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0), _nonEmptyBinsValid(kFALSE)
 {
   // Initialize datastore
   _dstore = (defaultStorageType==Tree) ? ((RooAbsDataStore*) new RooTreeDataStore(name,title,_vars)) : 
@@ -894,7 +895,7 @@ void RooDataHist::checkBinBounds() const
 /// Copy constructor
 
 RooDataHist::RooDataHist(const RooDataHist& other, const char* newname) :
-  RooAbsData(other,newname), RooDirItem(), _idxMult(other._idxMult), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(other._pbinvCacheMgr,0), _cache_sum_valid(0)
+  RooAbsData(other,newname), RooDirItem(), _idxMult(other._idxMult), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(other._pbinvCacheMgr,0), _cache_sum_valid(0), _nonEmptyBinsValid(kFALSE)
 {
   Int_t i ;
 
@@ -952,7 +953,7 @@ RooDataHist::RooDataHist(const RooDataHist& other, const char* newname) :
 RooDataHist::RooDataHist(const char* name, const char* title, RooDataHist* h, const RooArgSet& varSubset, 
 			 const RooFormulaVar* cutVar, const char* cutRange, Int_t nStart, Int_t nStop, Bool_t copyCache) :
   RooAbsData(name,title,varSubset),
-  _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0)
+  _wgt(0), _binValid(0), _curWeight(0), _curVolume(1), _pbinv(0), _pbinvCacheMgr(0,10), _cache_sum_valid(0), _nonEmptyBinsValid(kFALSE)
 {
   // Initialize datastore
   _dstore = new RooTreeDataStore(name,title,*h->_dstore,_vars,cutVar,cutRange,nStart,nStop,copyCache) ;
@@ -1428,6 +1429,8 @@ void RooDataHist::add(const RooArgSet& row, Double_t wgt, Double_t sumw2)
   _errHi[idx] = -1 ;
 
   _cache_sum_valid = kFALSE ;
+  _nonEmptyBinsValid = kFALSE ;
+  _contentVersion++ ;
 }
 
 
@@ -1448,6 +1451,8 @@ void RooDataHist::set(const RooArgSet& row, Double_t wgt, Double_t wgtErrLo, Dou
   _errHi[idx] = wgtErrHi ;  
 
   _cache_sum_valid = kFALSE ;
+  _nonEmptyBinsValid = kFALSE ;
+  _contentVersion++ ;
 }
 
 
@@ -1471,6 +1476,8 @@ void RooDataHist::set(Double_t wgt, Double_t wgtErr)
   _sumw2[_curIndex] = wgtErr*wgtErr ;
 
   _cache_sum_valid = kFALSE ;
+  _nonEmptyBinsValid = kFALSE ;
+  _contentVersion++ ;
 }
 
 
@@ -1492,6 +1499,8 @@ void RooDataHist::set(const RooArgSet& row, Double_t wgt, Double_t wgtErr)
   _sumw2[idx] = wgtErr*wgtErr ;
 
   _cache_sum_valid = kFALSE ;
+  _nonEmptyBinsValid = kFALSE ;
+  _contentVersion++ ;
 }
 
 
@@ -1545,6 +1554,8 @@ void RooDataHist::add(const RooAbsData& dset, const RooFormulaVar* cutVar, Doubl
   } 
 
   _cache_sum_valid = kFALSE ;
+  _nonEmptyBinsValid = kFALSE ;
+  _contentVersion++ ;
 }
 
 
@@ -1920,6 +1931,8 @@ void RooDataHist::reset()
   _curVolume = 1 ;
 
   _cache_sum_valid = kFALSE ;
+  _nonEmptyBinsValid = kFALSE ;
+  _contentVersion++ ;
 
 }
 
@@ -1966,6 +1979,22 @@ Double_t RooDataHist::binVolume(const RooArgSet& coord)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the binning of the histogram in the observable with the name of
+/// var, or zero if var is not an observable of the histogram.
+
+const RooAbsBinning* RooDataHist::getBinning(const RooAbsArg& var) const
+{
+  checkInit() ;
+  RooFIter iter = _vars.fwdIterator() ;
+  RooAbsArg* arg ;
+  for (Int_t i=0 ; (arg=iter.next()) ; i++) {
+    if (!strcmp(arg->GetName(),var.GetName())) return _lvbins[i] ;
+  }
+  return 0 ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set all the event weight of all bins to the specified value
 
@@ -1976,6 +2005,8 @@ void RooDataHist::setAllWeights(Double_t value)
   }
 
   _cache_sum_valid = kFALSE ;
+  _nonEmptyBinsValid = kFALSE ;
+  _contentVersion++ ;
 }
 
 
@@ -2077,6 +2108,7 @@ void RooDataHist::cacheValidEntries()
     }
   }
   delete iter ;
+  _nonEmptyBinsValid = kFALSE ;
 
 }
 
@@ -2097,6 +2129,62 @@ Bool_t RooDataHist::valid() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the indices of the bins that have a non-zero weight and are valid
+/// within the current range definitions (see cacheValidEntries()), in
+/// increasing order. Only these bins contribute to a likelihood, which
+/// allows to skip the empty bins of sparsely filled histograms. The list
+/// is cached until the weights or the valid entries are changed.
+
+const std::vector<Int_t>& RooDataHist::nonEmptyBins() const
+{
+  checkInit() ;
+
+  if (!_nonEmptyBinsValid) {
+    _nonEmptyBins.clear() ;
+    for (Int_t i=0 ; i<_arrSize ; i++) {
+      if (_wgt[i]!=0 && (!_binValid || _binValid[i])) {
+	_nonEmptyBins.push_back(i) ;
+      }
+    }
+    _nonEmptyBinsValid = kTRUE ;
+  }
+
+  return _nonEmptyBins ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the coordinates of the centers of bins [first,first+nEvents) of
+/// observable real, or the values of a cached function of the observables,
+/// from the data store.
+
+const Double_t* RooDataHist::getBatch(const RooAbsReal& real, Int_t first, Int_t nEvents) const
+{
+  if (first<0 || first+nEvents>_arrSize) return 0 ;
+  return RooAbsData::getBatch(real,first,nEvents) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill weights with the weights of bins [first,first+nEvents). Bins that are
+/// not valid within the current range definitions have a weight of zero.
+
+Bool_t RooDataHist::getWeightBatch(Double_t* weights, Int_t first, Int_t nEvents) const
+{
+  checkInit() ;
+  if (first<0 || first+nEvents>_arrSize) return kFALSE ;
+
+  for (Int_t k=0 ; k<nEvents ; k++) {
+    weights[k] = (!_binValid || _binValid[first+k]) ? _wgt[first+k] : 0. ;
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns true if datasets contains entries with a non-integer weight
 
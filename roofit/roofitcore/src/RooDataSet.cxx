@@ -50,6 +50,7 @@ or RooStringVar objects
 #include "RooTreeDataStore.h"
 #include "RooVectorDataStore.h"
 #include "RooCompositeDataStore.h"
+#include "RooLinkedTreeDataStore.h"
 #include "RooTreeData.h"
 #include "RooSentinel.h"
 #include "RooTrace.h"
@@ -203,6 +204,14 @@ RooDataSet::RooDataSet() : _wgtVar(0)
 ///                                imported. 
 /// ImportFromFile(const char* fileName, const char* treeName) -- Import tree with given name from file with given name.
 ///
+/// LinkTree(TTree&)            -- Read the events from the given TTree when they are needed instead of copying
+///                                them, so that datasets larger than the available memory can be used. The tree
+///                                must remain live for the duration of this dataset, which is read-only. Written
+///                                to a file, its events are stored like those of a regular dataset. Likelihoods
+///                                are calculated serially, use convertToVectorStore() first to parallelize them.
+///                                Cuts and ranges are applied once at construction.
+///                                LinkTree() and Import() are mutually exclusive.
+///
 /// Import(RooDataSet&)         -- Import contents of given RooDataSet. Only observables that are common with
 ///                                the definition of this dataset will be imported
 ///
@@ -244,6 +253,7 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
   RooCmdConfig pc(Form("RooDataSet::ctor(%s)",GetName())) ;
   pc.defineInt("ownLinked","OwnLinked",0) ;
   pc.defineObject("impTree","ImportTree",0) ;
+  pc.defineObject("lnkTree","LinkTree",0) ;
   pc.defineObject("impData","ImportData",0) ;
   pc.defineObject("indexCat","IndexCat",0) ;
   pc.defineObject("impSliceData","ImportDataSlice",0,0,kTRUE) ; // array
@@ -264,6 +274,8 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
   pc.defineSet("errorSet","StoreError",0) ;
   pc.defineSet("asymErrSet","StoreAsymError",0) ;
   pc.defineMutex("ImportTree","ImportData","ImportDataSlice","LinkDataSlice","ImportFromFile") ;
+  pc.defineMutex("LinkTree","ImportTree","ImportData","ImportDataSlice","LinkDataSlice") ;
+  pc.defineMutex("LinkTree","ImportFromFile","StoreError","StoreAsymError") ;
   pc.defineMutex("CutSpec","CutVar") ;
   pc.defineMutex("WeightVarName","WeightVar") ;
   pc.defineDependency("ImportDataSlice","IndexCat") ;
@@ -286,6 +298,7 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
 
   // Extract relevant objects
   TTree* impTree = static_cast<TTree*>(pc.getObject("impTree")) ;
+  TTree* lnkTree = static_cast<TTree*>(pc.getObject("lnkTree")) ;
   RooDataSet* impData = static_cast<RooDataSet*>(pc.getObject("impData")) ;
   RooFormulaVar* cutVar = static_cast<RooFormulaVar*>(pc.getObject("cutVar")) ;
   const char* cutSpec = pc.getString("cutSpec","",kTRUE) ;
@@ -358,6 +371,26 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
     // Create composite datastore
     _dstore = new RooCompositeDataStore(name,title,_vars,*icat,storeMap) ;
         
+  } else if (lnkTree) {
+
+    // Case 2 --- Read events from tree on demand
+    if (wgtVar) {
+      wgtVarName = wgtVar->GetName() ;
+    }
+
+    if (cutSpec && *cutSpec) {
+      RooFormulaVar cutVarTmp(cutSpec,cutSpec,_vars) ;
+      _dstore = new RooLinkedTreeDataStore(name,title,_vars,*lnkTree,&cutVarTmp,cutRange,wgtVarName) ;
+    } else {
+      _dstore = new RooLinkedTreeDataStore(name,title,_vars,*lnkTree,cutVar,cutRange,wgtVarName) ;
+    }
+    storageType = RooAbsData::LinkedTree ;
+
+    appendToDir(this,kTRUE) ;
+
+    // Initialize RooDataSet with optional weight variable
+    initialize(wgtVarName) ;
+
   } else {
 
     if (wgtVar) {
@@ -871,6 +904,23 @@ RooArgSet RooDataSet::addWgtVar(const RooArgSet& origVars, const RooAbsArg* wgtV
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Protected constructor of a view of the entries [firstEntry,lastEntry) of vstore
+
+RooDataSet::RooDataSet(const char *name, const char *title, const RooVectorDataStore& vstore, 
+		       const RooArgSet& vars, Int_t firstEntry, Int_t lastEntry, const char* wgtVarName) :
+  RooAbsData(name,title,vars)
+{
+  storageType = RooAbsData::Vector ;
+  _dstore = new RooVectorDataStore(vstore,_vars,firstEntry,lastEntry,name) ;
+
+  appendToDir(this,kTRUE) ;
+  initialize(wgtVarName) ;
+  TRACE_CREATE
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return a clone of this dataset containing only the cached variables
 
@@ -1000,6 +1050,23 @@ RooDataHist* RooDataSet::binnedClone(const char* newName, const char* newTitle)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return a dataset with the entries [firstEntry,lastEntry) of this dataset,
+/// which shares them with this dataset instead of copying them. This dataset
+/// must not be modified or deleted while the view exists. Returns 0 if the
+/// entries are not stored in a RooVectorDataStore that can be viewed.
+
+RooDataSet* RooDataSet::viewClone(Int_t firstEntry, Int_t lastEntry, const char* newName) const
+{
+  RooVectorDataStore* vstore = dynamic_cast<RooVectorDataStore*>(_dstore) ;
+  if (!vstore || !vstore->canView()) {
+    return 0 ;
+  }
+  return new RooDataSet(newName?newName:GetName(),GetTitle(),*vstore,_vars,firstEntry,lastEntry,_wgtVar?_wgtVar->GetName():0) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return event weight of current event
 
@@ -108,6 +108,20 @@ void RooExpensiveObjectCache::cleanup()
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the mutex that protects the contents of all caches. The cache methods
+/// lock it themselves, but callers that use a retrieved object must hold it
+/// until they are done with it, as another thread (e.g. in the thread mode of
+/// the test statistics) may replace the object by registering a new one.
+
+std::recursive_mutex& RooExpensiveObjectCache::mutex()
+{
+  static std::recursive_mutex cacheMutex ;
+  return cacheMutex ;
+}
+
+
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Register object associated with given name and given associated parameters with given values in cache.
@@ -134,6 +148,7 @@ Bool_t RooExpensiveObjectCache::registerObject(const char* ownerName, const char
 
 Bool_t RooExpensiveObjectCache::registerObject(const char* ownerName, const char* objectName, TObject& cacheObject, TIterator* parIter) 
 {
+  std::lock_guard<std::recursive_mutex> lock(mutex()) ;
   // Delete any previous object
   ExpensiveObject* eo = _map[objectName] ;
   Int_t olduid(-1) ;
@@ -156,6 +171,7 @@ Bool_t RooExpensiveObjectCache::registerObject(const char* ownerName, const char
 
 const TObject* RooExpensiveObjectCache::retrieveObject(const char* name, TClass* tc, const RooArgSet& params) 
 {
+  std::lock_guard<std::recursive_mutex> lock(mutex()) ;
   ExpensiveObject* eo = _map[name] ;
 
   // If no cache element found, return 0 ;
@@ -178,6 +194,7 @@ const TObject* RooExpensiveObjectCache::retrieveObject(const char* name, TClass*
 
 const TObject* RooExpensiveObjectCache::getObj(Int_t uid) 
 {
+  std::lock_guard<std::recursive_mutex> lock(mutex()) ;
   for (std::map<TString,ExpensiveObject*>::iterator iter = _map.begin() ; iter !=_map.end() ; iter++) {
     if (iter->second->uid() == uid) {
       return iter->second->payload() ;
@@ -194,6 +211,7 @@ const TObject* RooExpensiveObjectCache::getObj(Int_t uid)
 
 Bool_t RooExpensiveObjectCache::clearObj(Int_t uid) 
 {
+  std::lock_guard<std::recursive_mutex> lock(mutex()) ;
   for (std::map<TString,ExpensiveObject*>::iterator iter = _map.begin() ; iter !=_map.end() ; iter++) {
     if (iter->second->uid() == uid) {
       _map.erase(iter->first) ;
@@ -211,6 +229,7 @@ Bool_t RooExpensiveObjectCache::clearObj(Int_t uid)
 
 Bool_t RooExpensiveObjectCache::setObj(Int_t uid, TObject* obj) 
 {
+  std::lock_guard<std::recursive_mutex> lock(mutex()) ;
   for (std::map<TString,ExpensiveObject*>::iterator iter = _map.begin() ; iter !=_map.end() ; iter++) {
     if (iter->second->uid() == uid) {
       iter->second->setPayload(obj) ;
@@ -227,6 +246,7 @@ Bool_t RooExpensiveObjectCache::setObj(Int_t uid, TObject* obj)
 
 void RooExpensiveObjectCache::clearAll() 
 {
+  std::lock_guard<std::recursive_mutex> lock(mutex()) ;
   _map.clear() ;
 }
 
@@ -371,6 +391,7 @@ void RooExpensiveObjectCache::ExpensiveObject::print()
 
 void RooExpensiveObjectCache::importCacheObjects(RooExpensiveObjectCache& other, const char* ownerName, Bool_t verbose) 
 {
+  std::lock_guard<std::recursive_mutex> lock(mutex()) ;
   map<TString,ExpensiveObject*>::const_iterator iter = other._map.begin() ;
   while(iter!=other._map.end()) {
     if (string(ownerName)==iter->second->ownerName()) {      
@@ -120,9 +120,10 @@ Double_t RooExtendPdf::expectedEvents(const RooArgSet* nset) const
   // Optionally multiply with fractional normalization
   if (_rangeName) {
 
-    globalSelectComp(kTRUE) ;
+    Bool_t tmp = _globalSelectComp ;
+    if (!tmp) globalSelectComp(kTRUE) ;
     Double_t fracInt = pdf.getNormObj(nset,nset,_rangeName)->getVal() ;
-    globalSelectComp(kFALSE) ;
+    if (!tmp) globalSelectComp(kFALSE) ;
 
 
     if ( fracInt == 0. || _n == 0.) {
@@ -58,6 +58,11 @@
  // do RooMsgService::instance().addStream(RooMsgService::INFO,Topic("Caching")) 
  // to see these message on stdout
  //
+ // If the cache has observables other than the convolution observable, one
+ // convolution is calculated for each of their bins. With implicit multi-threading
+ // enabled (ROOT::EnableImplicitMT()), the FFTs of these slices are calculated
+ // in parallel. Sampling the input p.d.f.s is always done sequentially.
+ //
  // Multi-dimensional convolutions are not supported yet, but will be in the future
  // as FFTW can calculate them
  //
@@ -122,8 +127,21 @@
 #include "TClass.h"
 #include "TSystem.h"
 
+#include <algorithm>
+#include <mutex>
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
 using namespace std ;
 
+namespace {
+  // The FFTW planner is not thread safe
+  std::mutex fftPlanMutex ;
+}
+
 ClassImp(RooFFTConvPdf); 
 
 
@@ -362,9 +380,16 @@ RooArgList RooFFTConvPdf::FFTCacheElem::containedArgs(Action a)
 
 RooFFTConvPdf::FFTCacheElem::~FFTCacheElem() 
 { 
-  delete fftr2c1 ; 
-  delete fftr2c2 ; 
-  delete fftc2r ; 
+  {
+    // Destroying the plans also goes through the FFTW planner
+    lock_guard<mutex> lock(fftPlanMutex) ;
+    delete fftr2c1 ; 
+    delete fftr2c2 ; 
+    delete fftc2r ; 
+    for (vector<TVirtualFFT*>::iterator iter = fftPool.begin() ; iter!=fftPool.end() ; ++iter) {
+      delete *iter ;
+    }
+  }
 
   delete pdf1Clone ;
   delete pdf2Clone ;
@@ -428,15 +453,11 @@ void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const
   }
   delete iter ;
 
+  // Collect the bin numbers of all slice positions
+  vector<Int_t> sliceBins ;
   Bool_t loop(kTRUE) ;
   while(loop) {
-    // Set current slice position
-    for (Int_t j=0 ; j<n ; j++) { obsLV[j]->setBin(binCur[j],binningName()) ; }
-
-//     cout << "filling slice: bin of obsLV[0] = " << obsLV[0]->getBin() << endl ;
-
-    // Fill current slice
-    fillCacheSlice((FFTCacheElem&)cache,otherObs) ;
+    sliceBins.insert(sliceBins.end(),binCur,binCur+n) ;
 
     // Determine which iterator to increment
     while(binCur[curObs]==binMax[curObs]) {
@@ -458,6 +479,23 @@ void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const
     
   }
 
+  // Fill all slices, with the FFTs in parallel if implicit multi-threading is enabled
+  Bool_t parallel(kFALSE) ;
+#ifdef R__USE_IMT
+  parallel = ROOT::IsImplicitMTEnabled() ;
+#endif
+  if (parallel && sliceBins.size()>(UInt_t)n) {
+    fillCacheSlices((FFTCacheElem&)cache,otherObs,obsLV,sliceBins) ;
+  } else {
+    for (UInt_t k=0 ; k<sliceBins.size() ; k+=n) {
+      // Set current slice position
+      for (Int_t j=0 ; j<n ; j++) { obsLV[j]->setBin(sliceBins[k+j],binningName()) ; }
+
+      // Fill current slice
+      fillCacheSlice((FFTCacheElem&)cache,otherObs) ;
+    }
+  }
+
   delete[] obsLV ;
   delete[] binMax ;
   delete[] binCur ;
@@ -469,6 +507,100 @@ void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const
 /// Fill a slice of cachePdf with the output of the FFT convolution calculation
 
 void RooFFTConvPdf::fillCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos) const 
+{
+  Int_t N,N2,totalShift ;
+  Double_t *input1, *input2 ;
+  scanSlice(aux,slicePos,input1,input2,N,N2,totalShift) ;
+
+  // Retrieve previously defined FFT transformation plans
+  if (!aux.fftr2c1) {
+    lock_guard<mutex> lock(fftPlanMutex) ;
+    aux.fftr2c1 = TVirtualFFT::FFT(1, &N2, "R2CK");
+    aux.fftr2c2 = TVirtualFFT::FFT(1, &N2, "R2CK");
+    aux.fftc2r  = TVirtualFFT::FFT(1, &N2, "C2RK");
+  }
+
+  fftConvolve(aux.fftr2c1,aux.fftr2c2,aux.fftc2r,input1,input2,N2) ;
+
+  // Store FFT result in cache
+  storeSlice(aux,slicePos,aux.fftc2r->GetPointsReal(),N,N2,totalShift) ;
+
+  // Delete input arrays
+  delete[] input1 ;
+  delete[] input2 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the slices of cachePdf at the bins 'sliceBins' of the slice
+/// observables 'obsLV', which are the elements of 'slicePos'. The input
+/// p.d.f.s are sampled sequentially, the FFTs of the slices are calculated in
+/// parallel. Each thread uses its own set of FFT plans, which are kept in the
+/// cache element for subsequent fills. Only the FFTs are sped up: the time
+/// spent sampling the p.d.f.s, often the larger part, is unchanged.
+
+void RooFFTConvPdf::fillCacheSlices(FFTCacheElem& aux, const RooArgSet& slicePos, RooAbsLValue** obsLV, const vector<Int_t>& sliceBins) const
+{
+  Int_t n = slicePos.getSize() ;
+  Int_t nSlice = sliceBins.size()/n ;
+  Int_t N(0),N2(0),totalShift(0) ;
+
+  // Sample input p.d.f.s of all slices
+  vector<Double_t*> input1(nSlice), input2(nSlice) ;
+  for (Int_t s=0 ; s<nSlice ; s++) {
+    for (Int_t j=0 ; j<n ; j++) { obsLV[j]->setBin(sliceBins[s*n+j],binningName()) ; }
+    scanSlice(aux,slicePos,input1[s],input2[s],N,N2,totalShift) ;
+  }
+
+  // Create FFT plans for all threads
+  Int_t nThread(1) ;
+#ifdef R__USE_IMT
+  nThread = min(nSlice,(Int_t)ROOT::GetImplicitMTPoolSize()) ;
+#endif
+  if (aux.fftPool.size()<3*(UInt_t)nThread) {
+    lock_guard<mutex> lock(fftPlanMutex) ;
+    while (aux.fftPool.size()<3*(UInt_t)nThread) {
+      aux.fftPool.push_back(TVirtualFFT::FFT(1, &N2, "R2CK")) ;
+      aux.fftPool.push_back(TVirtualFFT::FFT(1, &N2, "R2CK")) ;
+      aux.fftPool.push_back(TVirtualFFT::FFT(1, &N2, "C2RK")) ;
+    }
+  }
+
+  // Calculate convolutions, thread i takes slices i, i+nThread, ...
+  vector<Double_t> output(nSlice*N2) ;
+  auto convolve = [&](Int_t i) {
+    TVirtualFFT** fft = &aux.fftPool[3*i] ;
+    for (Int_t s=i ; s<nSlice ; s+=nThread) {
+      fftConvolve(fft[0],fft[1],fft[2],input1[s],input2[s],N2) ;
+      const Double_t* out = fft[2]->GetPointsReal() ;
+      copy(out,out+N2,output.begin()+s*N2) ;
+    }
+  } ;
+#ifdef R__USE_IMT
+  ROOT::TThreadExecutor pool ;
+  pool.Foreach(convolve, ROOT::TSeqI(nThread)) ;
+#else
+  for (Int_t i=0 ; i<nThread ; i++) convolve(i) ;
+#endif
+
+  // Store FFT results in cache
+  for (Int_t s=0 ; s<nSlice ; s++) {
+    for (Int_t j=0 ; j<n ; j++) { obsLV[j]->setBin(sliceBins[s*n+j],binningName()) ; }
+    storeSlice(aux,slicePos,&output[s*N2],N,N2,totalShift) ;
+    delete[] input1[s] ;
+    delete[] input2[s] ;
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Sample both input p.d.f.s at slice position 'slicePos'. The caller takes
+/// ownership of the returned arrays 'input1' and 'input2' of length N2.
+
+void RooFFTConvPdf::scanSlice(FFTCacheElem& aux, const RooArgSet& slicePos, Double_t*& input1, Double_t*& input2, 
+			      Int_t& N, Int_t& N2, Int_t& totalShift) const 
 {
   // Extract histogram that is the basis of the RooHistPdf
   RooDataHist& cacheHist = *aux.hist() ;
@@ -484,50 +616,58 @@ void RooFFTConvPdf::fillCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos)
   //
   // 
 
-  Int_t N,N2,binShift1,binShift2 ;
+  Int_t binShift1,binShift2 ;
   
   RooRealVar* histX = (RooRealVar*) cacheHist.get()->find(_x.arg().GetName()) ;
   if (_bufStrat==Extend) histX->setBinning(*aux.scanBinning) ;
-  Double_t* input1 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf1Clone,cacheHist,slicePos,N,N2,binShift1,_shift1) ;
-  Double_t* input2 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf2Clone,cacheHist,slicePos,N,N2,binShift2,_shift2) ;
+  input1 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf1Clone,cacheHist,slicePos,N,N2,binShift1,_shift1) ;
+  input2 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf2Clone,cacheHist,slicePos,N,N2,binShift2,_shift2) ;
   if (_bufStrat==Extend) histX->setBinning(*aux.histBinning) ;
 
+  totalShift = binShift1 + (N2-N)/2 ;
+}
 
 
 
-  // Retrieve previously defined FFT transformation plans
-  if (!aux.fftr2c1) {
-    aux.fftr2c1 = TVirtualFFT::FFT(1, &N2, "R2CK");
-    aux.fftr2c2 = TVirtualFFT::FFT(1, &N2, "R2CK");
-    aux.fftc2r  = TVirtualFFT::FFT(1, &N2, "C2RK");
-  }
-  
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the cyclical convolution of the arrays 'input1' and 'input2' of
+/// length N2 with the given FFT plans. The result is the real output of 'fftc2r'.
+
+void RooFFTConvPdf::fftConvolve(TVirtualFFT* fftr2c1, TVirtualFFT* fftr2c2, TVirtualFFT* fftc2r, Double_t* input1, Double_t* input2, Int_t N2)
+{
   // Real->Complex FFT Transform on p.d.f. 1 sampling
-  aux.fftr2c1->SetPoints(input1);
-  aux.fftr2c1->Transform();
+  fftr2c1->SetPoints(input1);
+  fftr2c1->Transform();
 
   // Real->Complex FFT Transform on p.d.f 2 sampling
-  aux.fftr2c2->SetPoints(input2);
-  aux.fftr2c2->Transform();
+  fftr2c2->SetPoints(input2);
+  fftr2c2->Transform();
 
   // Loop over first half +1 of complex output results, multiply 
   // and set as input of reverse transform
   for (Int_t i=0 ; i<N2/2+1 ; i++) {
     Double_t re1,re2,im1,im2 ;
-    aux.fftr2c1->GetPointComplex(i,re1,im1) ;
-    aux.fftr2c2->GetPointComplex(i,re2,im2) ;
+    fftr2c1->GetPointComplex(i,re1,im1) ;
+    fftr2c2->GetPointComplex(i,re2,im2) ;
     Double_t re = re1*re2 - im1*im2 ;
     Double_t im = re1*im2 + re2*im1 ;
     TComplex t(re,im) ;
-    aux.fftc2r->SetPointComplex(i,t) ;
+    fftc2r->SetPointComplex(i,t) ;
   }
 
   // Reverse Complex->Real FFT transform product
-  aux.fftc2r->Transform() ;
+  fftc2r->Transform() ;
+}
 
-  Int_t totalShift = binShift1 + (N2-N)/2 ;
 
-  // Store FFT result in cache
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store the convolution 'output' of length N2 in the slice of cachePdf at
+/// position 'slicePos'
+
+void RooFFTConvPdf::storeSlice(FFTCacheElem& aux, const RooArgSet& slicePos, const Double_t* output, Int_t N, Int_t N2, Int_t totalShift) const 
+{
+  RooDataHist& cacheHist = *aux.hist() ;
 
   TIterator* iter = const_cast<RooDataHist&>(cacheHist).sliceIterator(const_cast<RooAbsReal&>(_x.arg()),slicePos) ;
   for (Int_t i =0 ; i<N ; i++) {
@@ -538,16 +678,9 @@ void RooFFTConvPdf::fillCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos)
     while (j>=N2) j-= N2 ;
 
     iter->Next() ;
-    cacheHist.set(aux.fftc2r->GetPointReal(j)) ;    
+    cacheHist.set(output[j]) ;    
   }
   delete iter ;
-
-  // cacheHist.dump2() ;
-
-  // Delete input arrays
-  delete[] input1 ;
-  delete[] input2 ;
-
 }
 
 
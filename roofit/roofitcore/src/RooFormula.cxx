@@ -52,7 +52,7 @@ ClassImp(RooFormula);
 /// Default constructor
 /// coverity[UNINIT_CTOR]
 
-RooFormula::RooFormula() : ROOT::v5::TFormula(), _nset(0)
+RooFormula::RooFormula() : ROOT::v5::TFormula(), _nset(0), _shiftCode(-1), _shift(0)
 {
 }
 
@@ -61,7 +61,7 @@ RooFormula::RooFormula() : ROOT::v5::TFormula(), _nset(0)
 /// Constructor with expression string and list of RooAbsArg variables
 
 RooFormula::RooFormula(const char* name, const char* formula, const RooArgList& list) : 
-  ROOT::v5::TFormula(), _isOK(kTRUE), _compiled(kFALSE)
+  ROOT::v5::TFormula(), _isOK(kTRUE), _compiled(kFALSE), _shiftCode(-1), _shift(0)
 {
   SetName(name) ;
   SetTitle(formula) ;
@@ -87,7 +87,7 @@ RooFormula::RooFormula(const char* name, const char* formula, const RooArgList&
 /// Copy constructor
 
 RooFormula::RooFormula(const RooFormula& other, const char* name) : 
-  ROOT::v5::TFormula(), RooPrintable(other), _isOK(other._isOK), _compiled(kFALSE) 
+  ROOT::v5::TFormula(), RooPrintable(other), _isOK(other._isOK), _compiled(kFALSE), _shiftCode(-1), _shift(0)
 {
   SetName(name?name:other.GetName()) ;
   SetTitle(other.GetTitle()) ;
@@ -251,6 +251,46 @@ Double_t RooFormula::eval(const RooArgSet* nset)
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the derivative of the formula with respect to param by the chain
+/// rule. The partial derivatives of the expression are finite differences in
+/// the real-valued variables, which only require the compiled expression to
+/// be evaluated again. They are multiplied with the derivatives of these
+/// variables with respect to param.
+
+Double_t RooFormula::evalDerivative(const RooAbsRealLValue& param, const RooArgSet* nset)
+{
+  if (!_compiled) {
+    _isOK = !Compile() ;
+    _compiled = kTRUE ;
+  }
+  if (!_isOK) return 0. ;
+
+  _nset = (RooArgSet*) nset ;
+
+  Double_t deriv(0) ;
+  for (Int_t code=0 ; code<_useList.GetSize() ; code++) {
+    if (_useIsCat[code]) continue ;
+
+    const RooAbsReal* absReal = (const RooAbsReal*)(_useList.At(code)) ;
+    Double_t argDeriv = absReal->getDerivative(param,_nset) ;
+    if (argDeriv==0) continue ;
+
+    Double_t h = 1e-5*(fabs(absReal->getVal(_nset))+1) ;
+    _shiftCode = code ;
+    _shift = h ;
+    Double_t fhi = EvalPar(0,0) ;
+    _shift = -h ;
+    Double_t flo = EvalPar(0,0) ;
+    _shiftCode = -1 ;
+
+    deriv += argDeriv*(fhi-flo)/(2*h) ;
+  }
+  return deriv ;
+}
+
+
 Double_t
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -278,6 +318,9 @@ RooFormula::DefinedValue(Int_t code)
 
     // Process as real 
     const RooAbsReal *absReal= (const RooAbsReal*)(arg);  
+    if (code==_shiftCode) {
+      return absReal->getVal(_nset) + _shift ;
+    }
     return absReal->getVal(_nset) ;
     
   }
@@ -130,6 +130,17 @@ Double_t RooFormulaVar::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative with respect to param from the partial derivatives
+/// of the formula expression, see RooFormula::evalDerivative()
+
+Double_t RooFormulaVar::evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const
+{
+  return formula().evalDerivative(param,nset?nset:_lastNSet) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Check if given value is valid
 
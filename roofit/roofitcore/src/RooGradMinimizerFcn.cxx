@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * Project: RooFit                                                           *
+ * Package: RooFitCore                                                       *
+ * @(#)root/roofitcore:$Id$
+ *                                                                           *
+ * Redistribution and use in source and binary forms,                        *
+ * with or without modification, are permitted according to the terms        *
+ * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+ *****************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// RooGradMinimizerFcn is an interface class to ROOT::Math::IMultiGradFunction
+// for RooMinimizer. It evaluates the function with a RooMinimizerFcn, and
+// provides the derivatives calculated by RooAbsReal::getDerivative(), such
+// that the minimizer does not need to calculate a numerical gradient. It is
+// used when the analytical gradient is enabled with
+// RooMinimizer::setAnalyticalGradient().
+//
+
+#ifndef __ROOFIT_NOROOMINIMIZER
+
+#include "RooFit.h"
+#include "RooGradMinimizerFcn.h"
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor from a RooMinimizerFcn, of which a copy is made
+
+RooGradMinimizerFcn::RooGradMinimizerFcn(const RooMinimizerFcn& fcn) :
+  _fcn(new RooMinimizerFcn(fcn))
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor
+
+RooGradMinimizerFcn::RooGradMinimizerFcn(const RooGradMinimizerFcn& other) : ROOT::Math::IBaseFunctionMultiDim(other),
+  ROOT::Math::IMultiGradFunction(other),
+  _fcn(new RooMinimizerFcn(*other._fcn))
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor
+
+RooGradMinimizerFcn::~RooGradMinimizerFcn()
+{
+  delete _fcn ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+ROOT::Math::IBaseFunctionMultiDim* RooGradMinimizerFcn::Clone() const
+{
+  return new RooGradMinimizerFcn(*this) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the function at the parameter values x
+
+double RooGradMinimizerFcn::DoEval(const double* x) const
+{
+  return (*_fcn)(x) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative with respect to parameter icoord at the parameter values x
+
+double RooGradMinimizerFcn::DoDerivative(const double* x, unsigned int icoord) const
+{
+  return _fcn->EvalDerivative(x,icoord) ;
+}
+
+#endif
@@ -195,7 +195,21 @@ RooHistFunc::~RooHistFunc()
 
 Double_t RooHistFunc::evaluate() const
 {
-  // Transfer values from   
+  if (!transferObservables()) {
+    return 0 ;
+  }
+
+  Double_t ret =  _dataHist->weight(_histObsList,_intOrder,kFALSE,_cdfBoundaries) ;  
+  return ret ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Transfer the values of the function observables to the histogram
+/// observables. Return false if a value is outside the range of the histogram.
+
+Bool_t RooHistFunc::transferObservables() const
+{
   if (_depList.getSize()>0) {
     _histObsIter->Reset() ;
     _pdfObsIter->Reset() ;
@@ -206,14 +220,26 @@ Double_t RooHistFunc::evaluate() const
 	parg->syncCache() ;
 	harg->copyCache(parg,kTRUE) ;
 	if (!harg->inRange(0)) {
-	  return 0 ;
+	  return kFALSE ;
 	}
       }
     }
   }
+  return kTRUE ;
+}
 
-  Double_t ret =  _dataHist->weight(_histObsList,_intOrder,kFALSE,_cdfBoundaries) ;  
-  return ret ;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the index of the histogram bin that contains the current values
+/// of the observables, or -1 if they are outside the range of the histogram.
+/// Without interpolation, the value of the function is the weight of this bin.
+
+Int_t RooHistFunc::getBin() const
+{
+  if (!transferObservables()) {
+    return -1 ;
+  }
+  return _dataHist->getIndex(_histObsList) ;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
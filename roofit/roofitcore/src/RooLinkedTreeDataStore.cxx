@@ -0,0 +1,762 @@
+/*****************************************************************************
+ * Project: RooFit                                                           *
+ * Package: RooFitCore                                                       *
+ * @(#)root/roofitcore:$Id$
+ * Authors:                                                                  *
+ *   WV, Wouter Verkerke, UC Santa Barbara, verkerke@slac.stanford.edu       *
+ *   DK, David Kirkby,    UC Irvine,         dkirkby@uci.edu                 *
+ *                                                                           *
+ * Copyright (c) 2000-2005, Regents of the University of California          *
+ *                          and Stanford University. All rights reserved.    *
+ *                                                                           *
+ * Redistribution and use in source and binary forms,                        *
+ * with or without modification, are permitted according to the terms        *
+ * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+ *****************************************************************************/
+
+/**
+\file RooLinkedTreeDataStore.cxx
+\class RooLinkedTreeDataStore
+\ingroup Roofitcore
+
+RooLinkedTreeDataStore is a read-only data store that reads its events
+from an external TTree (or TChain) instead of copying them. The tree is
+scanned once at construction to apply the selection cut and the range
+and validity checks of the observables. Only one bit per tree entry is
+kept to remember the selection. The values of the events are read from
+the tree in chunks of chunkSize() events, one column per observable, so
+that the memory footprint does not depend on the number of events.
+
+The tree is not owned by the store and must outlive it. The store itself
+cannot be written to a file; a RooAbsData using it writes its events as
+a vector store instead (RooAbsData::LinkedTree storage type). To hold the
+events in memory, use RooAbsData::convertToVectorStore() or copy them to
+a regular dataset, e.g. with RooAbsData::reduce(). The constant-term
+optimization of the likelihood does not cache function values with the
+events of a linked tree. Test statistics are calculated serially for a
+linked tree, as its readers in threads or forked processes (NumThreads()
+and NumCPU() in fits) would share the tree and its file.
+**/
+
+#include "RooFit.h"
+#include "RooMsgService.h"
+#include "RooLinkedTreeDataStore.h"
+
+#include "Riostream.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TBuffer.h"
+#include "RooFormulaVar.h"
+#include "RooRealVar.h"
+#include "RooAbsCategory.h"
+#include "RooTrace.h"
+
+#include <algorithm>
+using namespace std ;
+
+ClassImp(RooLinkedTreeDataStore);
+;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+RooLinkedTreeDataStore::RooLinkedTreeDataStore() :
+  _wgtVar(0),
+  _tree(0),
+  _nEntries(0),
+  _sumWeight(0),
+  _chunkSize(65536),
+  _wgtColumn(-1),
+  _treeNumber(-1),
+  _curChunk(-1),
+  _curWgt(1)
+{
+  TRACE_CREATE
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Construct a store of the events of 'tree' that pass the selection
+/// 'select', have all observables in the range 'rangeName' (if given) and
+/// have valid values of all observables. Only branches of the tree with the
+/// name of an observable are read. Observables without branch keep their
+/// current value for all events. If 'wgtVarName' is given, the variable
+/// of that name holds the event weights.
+
+RooLinkedTreeDataStore::RooLinkedTreeDataStore(const char* name, const char* title, const RooArgSet& vars, TTree& tree,
+					       const RooFormulaVar* select, const char* rangeName, const char* wgtVarName) :
+  RooAbsDataStore(name,title,varsNoWeight(vars,wgtVarName)),
+  _varsww(vars),
+  _wgtVar(weightVar(vars,wgtVarName)),
+  _tree(&tree),
+  _nEntries(0),
+  _sumWeight(0),
+  _chunkSize(65536),
+  _wgtColumn(-1),
+  _treeNumber(-1),
+  _curChunk(-1),
+  _curWgt(1)
+{
+  initColumns() ;
+
+  // Check which columns are read from the tree
+  if (_tree->LoadTree(0)>=0) {
+    attachLeaves() ;
+    for (vector<Column>::iterator iter = _columns.begin() ; iter!=_columns.end() ; ++iter) {
+      if (!iter->_leaf) {
+	coutW(DataHandling) << "RooLinkedTreeDataStore::ctor(" << GetName() << ") WARNING: tree " << _tree->GetName()
+			    << " has no scalar branch " << iter->_branch << ", using constant value " << iter->_const << endl ;
+      } else if (_tree->GetCurrentFile()) {
+	// Let the tree cache prefetch the baskets of the columns
+	_tree->AddBranchToCache(iter->_branch.c_str(),kTRUE) ;
+      }
+    }
+  }
+
+  selectEntries(select,rangeName) ;
+
+  coutI(DataHandling) << "RooLinkedTreeDataStore::ctor(" << GetName() << ") linked " << _nEntries << " of "
+		      << _tree->GetEntries() << " entries of tree " << _tree->GetName() << endl ;
+  TRACE_CREATE
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Utility function for constructors
+/// Return RooArgSet that is copy of allVars minus variable matching wgtName if specified
+
+RooArgSet RooLinkedTreeDataStore::varsNoWeight(const RooArgSet& allVars, const char* wgtName)
+{
+  RooArgSet ret(allVars) ;
+  if(wgtName) {
+    RooAbsArg* wgt = allVars.find(wgtName) ;
+    if (wgt) {
+      ret.remove(*wgt,kTRUE,kTRUE) ;
+    }
+  }
+  return ret ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Utility function for constructors
+/// Return pointer to weight variable if it is defined
+
+RooRealVar* RooLinkedTreeDataStore::weightVar(const RooArgSet& allVars, const char* wgtName)
+{
+  if(wgtName) {
+    RooRealVar* wgt = dynamic_cast<RooRealVar*>(allVars.find(wgtName)) ;
+    return wgt ;
+  }
+  return 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor. The copy shares the tree and the selection of the
+/// original, but has its own buffers.
+
+RooLinkedTreeDataStore::RooLinkedTreeDataStore(const RooLinkedTreeDataStore& other, const char* newname) :
+  RooAbsDataStore(other,newname),
+  _varsww(other._varsww),
+  _wgtVar(other._wgtVar),
+  _tree(other._tree),
+  _selected(other._selected),
+  _chunkStart(other._chunkStart),
+  _nEntries(other._nEntries),
+  _sumWeight(other._sumWeight),
+  _chunkSize(other._chunkSize),
+  _wgtColumn(-1),
+  _treeNumber(-1),
+  _curChunk(-1),
+  _curWgt(other._curWgt)
+{
+  initColumns() ;
+  for (UInt_t i=0 ; i<_columns.size() && i<other._columns.size() ; i++) {
+    _columns[i]._const = other._columns[i]._const ;
+  }
+  TRACE_CREATE
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor loading the events into the variables 'vars'. Columns
+/// are matched by name, variables without a column in 'other' are read from
+/// the tree if it has a branch of that name.
+
+RooLinkedTreeDataStore::RooLinkedTreeDataStore(const RooLinkedTreeDataStore& other, const RooArgSet& vars, const char* newname) :
+  RooAbsDataStore(other,varsNoWeight(vars,other._wgtVar?other._wgtVar->GetName():0),newname),
+  _varsww(vars),
+  _wgtVar(other._wgtVar?weightVar(vars,other._wgtVar->GetName()):0),
+  _tree(other._tree),
+  _selected(other._selected),
+  _chunkStart(other._chunkStart),
+  _nEntries(other._nEntries),
+  _sumWeight(other._sumWeight),
+  _chunkSize(other._chunkSize),
+  _wgtColumn(-1),
+  _treeNumber(-1),
+  _curChunk(-1),
+  _curWgt(other._curWgt)
+{
+  initColumns() ;
+  for (vector<Column>::iterator iter = _columns.begin() ; iter!=_columns.end() ; ++iter) {
+    for (vector<Column>::const_iterator oiter = other._columns.begin() ; oiter!=other._columns.end() ; ++oiter) {
+      if (oiter->_branch==iter->_branch) {
+	iter->_const = oiter->_const ;
+	break ;
+      }
+    }
+  }
+  TRACE_CREATE
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor
+
+RooLinkedTreeDataStore::~RooLinkedTreeDataStore()
+{
+  TRACE_DESTROY
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create one column per variable in _varsww. The column of a variable
+/// that is neither real-valued nor a category is never read.
+
+void RooLinkedTreeDataStore::initColumns()
+{
+  _columns.clear() ;
+  _wgtColumn = -1 ;
+
+  RooFIter iter = _varsww.fwdIterator() ;
+  RooAbsArg* arg ;
+  while((arg=iter.next())) {
+    Column col ;
+    col._branch = arg->GetName() ;
+    col._real = dynamic_cast<RooAbsReal*>(arg) ;
+    col._cat = dynamic_cast<RooAbsCategory*>(arg) ;
+    if (col._real) {
+      col._const = col._real->getVal() ;
+    } else if (col._cat) {
+      col._const = col._cat->getIndex() ;
+    } else {
+      col._active = kFALSE ;
+    }
+    if (arg==_wgtVar) {
+      _wgtColumn = _columns.size() ;
+    }
+    _columns.push_back(col) ;
+  }
+
+  _treeNumber = -1 ;
+  _curChunk = -1 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look up the leaves of the columns in the tree currently loaded by
+/// _tree. Only branches with a single scalar leaf are read.
+
+void RooLinkedTreeDataStore::attachLeaves() const
+{
+  TTree* t = _tree->GetTree() ;
+  for (vector<Column>::iterator iter = _columns.begin() ; iter!=_columns.end() ; ++iter) {
+    iter->_leaf = 0 ;
+    TBranch* branch = t ? t->GetBranch(iter->_branch.c_str()) : 0 ;
+    if (!branch || branch->GetListOfLeaves()->GetEntries()!=1) continue ;
+    TLeaf* leaf = (TLeaf*) branch->GetListOfLeaves()->At(0) ;
+    if (leaf->GetLeafCount() || leaf->GetLen()!=1) continue ;
+    iter->_leaf = leaf ;
+  }
+  _treeNumber = _tree->GetTreeNumber() ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Scan the tree and remember which entries are events of the store
+
+void RooLinkedTreeDataStore::selectEntries(const RooFormulaVar* select, const char* rangeName)
+{
+  // Redirect formula servers to the variables of the store
+  RooFormulaVar* selectClone(0) ;
+  if (select) {
+    selectClone = (RooFormulaVar*) select->cloneTree() ;
+    selectClone->recursiveRedirectServers(_varsww) ;
+    selectClone->setOperMode(RooAbsArg::ADirty,kTRUE) ;
+  }
+
+  for (vector<Column>::iterator iter = _columns.begin() ; iter!=_columns.end() ; ++iter) {
+    iter->_values.resize(1) ;
+  }
+
+  Long64_t nTree = _tree->GetEntries() ;
+  _selected.assign(nTree,false) ;
+  _nEntries = 0 ;
+  _sumWeight = 0 ;
+  Double_t carry(0) ;
+
+  RooAbsArg* arg ;
+  for (Long64_t entry=0 ; entry<nTree ; entry++) {
+    if (!readEntry(entry,0)) break ;
+
+    // Check that all values are valid and in range
+    Bool_t allValid = loadSlot(0) ;
+    RooFIter iter = _varsww.fwdIterator() ;
+    while(allValid && (arg=iter.next())) {
+      if (!arg->isValid() || (rangeName && !arg->inRange(rangeName))) {
+	allValid=kFALSE ;
+      }
+    }
+    if (!allValid) continue ;
+
+    // Does this event pass the cuts?
+    if (selectClone && selectClone->getVal()==0) continue ;
+
+    _selected[entry] = true ;
+    _nEntries++ ;
+
+    // Kahan summation of the weights
+    Double_t y = _curWgt - carry ;
+    Double_t t = _sumWeight + y ;
+    carry = (t - _sumWeight) - y ;
+    _sumWeight = t ;
+  }
+
+  // Nothing to remember if all entries are selected
+  if (_nEntries==nTree) {
+    vector<bool>().swap(_selected) ;
+  }
+
+  delete selectClone ;
+  initChunks() ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Find the first tree entry of each chunk
+
+void RooLinkedTreeDataStore::initChunks()
+{
+  _chunkStart.clear() ;
+  if (_selected.empty()) {
+    for (Int_t i=0 ; i<_nEntries ; i+=_chunkSize) {
+      _chunkStart.push_back(i) ;
+    }
+  } else {
+    Int_t n(0) ;
+    for (Long64_t entry=0 ; entry<(Long64_t)_selected.size() ; entry++) {
+      if (!_selected[entry]) continue ;
+      if (n%_chunkSize==0) {
+	_chunkStart.push_back(entry) ;
+      }
+      n++ ;
+    }
+  }
+  _curChunk = -1 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the number of events read from the tree at a time. Multiples of the
+/// batch size of the likelihood evaluation allow to evaluate all batches
+/// directly on the column buffers.
+
+void RooLinkedTreeDataStore::setChunkSize(Int_t nEvents)
+{
+  _chunkSize = nEvents>0 ? nEvents : 1 ;
+  for (vector<Column>::iterator iter = _columns.begin() ; iter!=_columns.end() ; ++iter) {
+    vector<Double_t>().swap(iter->_values) ;
+  }
+  initChunks() ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the active columns of the given tree entry into buffer position 'slot'
+
+Bool_t RooLinkedTreeDataStore::readEntry(Long64_t entry, Int_t slot) const
+{
+  Long64_t local = _tree->LoadTree(entry) ;
+  if (local<0) return kFALSE ;
+  if (_tree->GetTreeNumber()!=_treeNumber) {
+    attachLeaves() ;
+  }
+
+  for (vector<Column>::iterator iter = _columns.begin() ; iter!=_columns.end() ; ++iter) {
+    if (!iter->_active) continue ;
+    if (iter->_leaf) {
+      iter->_leaf->GetBranch()->GetEntry(local) ;
+      iter->_values[slot] = iter->_leaf->GetValue() ;
+    } else {
+      iter->_values[slot] = iter->_const ;
+    }
+  }
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the events of the given chunk into the column buffers
+
+void RooLinkedTreeDataStore::loadChunk(Int_t chunk) const
+{
+  for (vector<Column>::iterator iter = _columns.begin() ; iter!=_columns.end() ; ++iter) {
+    if (iter->_values.size()<(UInt_t)_chunkSize) {
+      iter->_values.resize(_chunkSize) ;
+    }
+  }
+
+  Int_t n = min(_chunkSize,_nEntries-chunk*_chunkSize) ;
+  Long64_t entry = _chunkStart[chunk] ;
+  for (Int_t slot=0 ; slot<n ; entry++) {
+    if (!_selected.empty() && !_selected[entry]) continue ;
+    if (!readEntry(entry,slot)) {
+      coutE(DataHandling) << "RooLinkedTreeDataStore::loadChunk(" << GetName() << ") ERROR: cannot read entry "
+			  << entry << " of tree " << _tree->GetName() << endl ;
+      break ;
+    }
+    slot++ ;
+  }
+  _curChunk = chunk ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Load the values at buffer position 'slot' into the variables. Return
+/// false if a category index is not defined.
+
+Bool_t RooLinkedTreeDataStore::loadSlot(Int_t slot) const
+{
+  for (vector<Column>::iterator iter = _columns.begin() ; iter!=_columns.end() ; ++iter) {
+    if (!iter->_active) continue ;
+    if (iter->_real) {
+      iter->_real->_value = iter->_values[slot] ;
+      if (_doDirtyProp) iter->_real->setValueDirty() ;
+    } else {
+      const RooCatType* type = iter->_cat->lookupType((Int_t)iter->_values[slot]) ;
+      if (!type) return kFALSE ;
+      iter->_cat->_value = *type ;
+      if (_doDirtyProp) iter->_cat->setValueDirty() ;
+    }
+  }
+
+  _curWgt = _wgtColumn>=0 ? _columns[_wgtColumn]._values[slot] : 1. ;
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Load the n-th data point (n='index') into the variables of this data
+/// store, reading its chunk from the tree if needed
+
+const RooArgSet* RooLinkedTreeDataStore::get(Int_t index) const
+{
+  if (index<0 || index>=_nEntries) return 0 ;
+
+  Int_t chunk = index/_chunkSize ;
+  if (chunk!=_curChunk) {
+    loadChunk(chunk) ;
+  }
+  loadSlot(index-chunk*_chunkSize) ;
+
+  return &_vars ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the weight of the n-th data point (n='index')
+
+Double_t RooLinkedTreeDataStore::weight(Int_t index) const
+{
+  get(index) ;
+  return weight() ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the weight of the current data point
+
+Double_t RooLinkedTreeDataStore::weight() const
+{
+  return _curWgt ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Weight errors are not stored in trees, return zero
+
+Double_t RooLinkedTreeDataStore::weightError(RooAbsData::ErrorType /*etype*/) const
+{
+  return 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Weight errors are not stored in trees, return zero
+
+void RooLinkedTreeDataStore::weightError(Double_t& lo, Double_t& hi, RooAbsData::ErrorType /*etype*/) const
+{
+  lo=0 ;
+  hi=0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the values of the events [first,first+nEvents) in the
+/// column that get() loads into 'real'. Return zero if there is no such
+/// column or if the events are not in the same chunk.
+
+const Double_t* RooLinkedTreeDataStore::getBatch(const RooAbsReal& real, Int_t first, Int_t nEvents) const
+{
+  if (first<0 || nEvents<=0 || first+nEvents>_nEntries) return 0 ;
+
+  Int_t chunk = first/_chunkSize ;
+  if ((first+nEvents-1)/_chunkSize!=chunk) return 0 ;
+
+  for (vector<Column>::const_iterator iter = _columns.begin() ; iter!=_columns.end() ; ++iter) {
+    if (iter->_real==&real && iter->_active) {
+      if (chunk!=_curChunk) {
+	loadChunk(chunk) ;
+      }
+      return &iter->_values[first-chunk*_chunkSize] ;
+    }
+  }
+  return 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill weights with the weights of the events [first,first+nEvents)
+
+Bool_t RooLinkedTreeDataStore::getWeightBatch(Double_t* weights, Int_t first, Int_t nEvents) const
+{
+  if (first<0 || nEvents<=0 || first+nEvents>_nEntries) return kFALSE ;
+
+  if (_wgtColumn<0) {
+    fill_n(weights,nEvents,1.) ;
+    return kTRUE ;
+  }
+
+  const Double_t* wgt = getBatch(*_wgtVar,first,nEvents) ;
+  if (!wgt) return kFALSE ;
+  copy(wgt,wgt+nEvents,weights) ;
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Load values into the variables of external set 'extObs' instead of the
+/// variables of this store. The weight is always loaded into the weight
+/// variable of the store.
+
+void RooLinkedTreeDataStore::attachBuffers(const RooArgSet& extObs)
+{
+  RooFIter iter = _varsww.fwdIterator() ;
+  RooAbsArg* arg ;
+  for (Int_t i=0 ; (arg=iter.next()) ; i++) {
+    RooAbsArg* extArg = extObs.find(arg->GetName()) ;
+    if (!extArg || i==_wgtColumn) continue ;
+    Column& col = _columns[i] ;
+    if (col._real && dynamic_cast<RooAbsReal*>(extArg)) {
+      col._real = (RooAbsReal*) extArg ;
+    } else if (col._cat && dynamic_cast<RooAbsCategory*>(extArg)) {
+      col._cat = (RooAbsCategory*) extArg ;
+    }
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Load values into the variables of this store again
+
+void RooLinkedTreeDataStore::resetBuffers()
+{
+  RooFIter iter = _varsww.fwdIterator() ;
+  RooAbsArg* arg ;
+  for (Int_t i=0 ; (arg=iter.next()) ; i++) {
+    Column& col = _columns[i] ;
+    if (col._real) {
+      col._real = (RooAbsReal*) arg ;
+    } else if (col._cat) {
+      col._cat = (RooAbsCategory*) arg ;
+    }
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Function values cannot be cached with the events of a tree that is not
+/// owned. All nodes in 'varSet' are removed, so that they are evaluated for
+/// each event.
+
+void RooLinkedTreeDataStore::cacheArgs(const RooAbsArg* /*owner*/, RooArgSet& varSet, const RooArgSet* /*nset*/, Bool_t /*skipZeroWeights*/)
+{
+  if (varSet.getSize()>0) {
+    coutI(Optimization) << "RooLinkedTreeDataStore::cacheArgs(" << GetName() << ") " << varSet.getSize()
+			<< " constant expressions are not cached with the events of linked tree, they are recalculated for each event" << endl ;
+  }
+  varSet.removeAll() ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// (De)activate the reading of the columns of the variables in 'set'. The
+/// branches of inactive columns are not read from the tree.
+
+void RooLinkedTreeDataStore::setArgStatus(const RooArgSet& set, Bool_t active)
+{
+  RooFIter iter = _varsww.fwdIterator() ;
+  RooAbsArg* arg ;
+  for (Int_t i=0 ; (arg=iter.next()) ; i++) {
+    Column& col = _columns[i] ;
+    if (i==_wgtColumn || (!col._real && !col._cat) || !set.find(arg->GetName())) continue ;
+    if (col._active!=active) {
+      col._active = active ;
+      _curChunk = -1 ;
+    }
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Observables are matched to branches by the name they had when the store
+/// was created, so they can be renamed freely
+
+Bool_t RooLinkedTreeDataStore::changeObservableName(const char* /*from*/, const char* /*to*/)
+{
+  return kFALSE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Events cannot be added to a linked tree
+
+Int_t RooLinkedTreeDataStore::fill()
+{
+  coutE(DataHandling) << "RooLinkedTreeDataStore::fill(" << GetName() << ") ERROR: store is read-only, copy the events to a regular dataset first" << endl ;
+  return 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Columns cannot be added to a linked tree
+
+RooAbsArg* RooLinkedTreeDataStore::addColumn(RooAbsArg& /*var*/, Bool_t /*adjustRange*/)
+{
+  coutE(DataHandling) << "RooLinkedTreeDataStore::addColumn(" << GetName() << ") ERROR: store is read-only, copy the events to a regular dataset first" << endl ;
+  return 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Columns cannot be added to a linked tree
+
+RooArgSet* RooLinkedTreeDataStore::addColumns(const RooArgList& /*varList*/)
+{
+  coutE(DataHandling) << "RooLinkedTreeDataStore::addColumns(" << GetName() << ") ERROR: store is read-only, copy the events to a regular dataset first" << endl ;
+  return 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Linked trees cannot be merged
+
+RooAbsDataStore* RooLinkedTreeDataStore::merge(const RooArgSet& /*allvars*/, list<RooAbsDataStore*> /*dstoreList*/)
+{
+  coutE(DataHandling) << "RooLinkedTreeDataStore::merge(" << GetName() << ") ERROR: store is read-only, copy the events to a regular dataset first" << endl ;
+  return 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Events cannot be appended to a linked tree
+
+void RooLinkedTreeDataStore::append(RooAbsDataStore& /*other*/)
+{
+  coutE(DataHandling) << "RooLinkedTreeDataStore::append(" << GetName() << ") ERROR: store is read-only, copy the events to a regular dataset first" << endl ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Events cannot be loaded into a linked tree
+
+void RooLinkedTreeDataStore::loadValues(const RooAbsDataStore* /*tds*/, const RooFormulaVar* /*select*/, const char* /*rangeName*/, Int_t /*nStart*/, Int_t /*nStop*/)
+{
+  coutE(DataHandling) << "RooLinkedTreeDataStore::loadValues(" << GetName() << ") ERROR: store is read-only, copy the events to a regular dataset first" << endl ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Unlink the tree
+
+void RooLinkedTreeDataStore::reset()
+{
+  _tree = 0 ;
+  vector<bool>().swap(_selected) ;
+  _chunkStart.clear() ;
+  _nEntries = 0 ;
+  _sumWeight = 0 ;
+  _curChunk = -1 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream an object of class RooLinkedTreeDataStore. The events are not
+/// written, a store read back is empty. Datasets write their events as a
+/// vector store instead (see RooAbsData::Streamer()).
+
+void RooLinkedTreeDataStore::Streamer(TBuffer &R__b)
+{
+  if (R__b.IsReading()) {
+    R__b.ReadClassBuffer(RooLinkedTreeDataStore::Class(),this);
+    _tree = 0 ;
+    _nEntries = 0 ;
+    _sumWeight = 0 ;
+    _chunkSize = 65536 ;
+    _wgtColumn = -1 ;
+    _treeNumber = -1 ;
+    _curChunk = -1 ;
+    _curWgt = 1 ;
+  } else {
+    coutE(DataHandling) << "RooLinkedTreeDataStore::Streamer(" << GetName() << ") ERROR: the events of a linked tree are not written,"
+			<< " write the dataset or copy them to a regular dataset first, e.g. with reduce()" << endl ;
+    R__b.WriteClassBuffer(RooLinkedTreeDataStore::Class(),this);
+  }
+}
@@ -121,6 +121,7 @@ RooMinimizer::RooMinimizer(RooAbsReal& function)
   _verbose = kFALSE ;
   _profile = kFALSE ;
   _profileStart = kFALSE ;
+  _gradient = kFALSE ;
   _printLevel = 1 ;
   _minimizerType = "Minuit"; // default minimizer
 
@@ -208,6 +209,82 @@ void RooMinimizer::setMaxFunctionCalls(Int_t n)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Give the minimizer the derivatives calculated by RooAbsReal::getDerivative()
+/// instead of letting it calculate a numerical gradient. Whether this is faster
+/// depends on the function, as the nodes without analytical derivatives are
+/// differentiated numerically for every event. The benchmark
+/// test/fitGradientTime.cxx compares both options on typical likelihoods.
+
+void RooMinimizer::setAnalyticalGradient(Bool_t flag)
+{
+  _gradient = flag ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Minimize the function with the fitter. If the analytical gradient is
+/// enabled with setAnalyticalGradient(), the minimizer is given the
+/// derivatives of the function calculated by RooAbsReal::getDerivative()
+/// instead of calculating a numerical gradient itself.
+
+bool RooMinimizer::fitFcn() const
+{
+  if (!_gradient) {
+    return _theFitter->FitFCN(*_fcn) ;
+  }
+  RooGradMinimizerFcn gradFcn(*_fcn) ;
+  return _theFitter->FitFCN(gradFcn) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the function minimized by the fitter, or the function of this
+/// minimizer if the fitter has not been used yet
+
+const RooMinimizerFcn* RooMinimizer::fitterFcn() const
+{
+  const ROOT::Math::IMultiGenFunction* fcn = fitter()->GetFCN() ;
+  if (!fcn) return _fcn ;
+  const RooGradMinimizerFcn* gradFcn = dynamic_cast<const RooGradMinimizerFcn*>(fcn) ;
+  return gradFcn ? gradFcn->fcn() : (const RooMinimizerFcn*) fcn ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the function minimized by the fitter, or the function of this
+/// minimizer if the fitter has not been used yet
+
+RooMinimizerFcn* RooMinimizer::fitterFcn()
+{
+  ROOT::Math::IMultiGenFunction* fcn = fitter()->GetFCN() ;
+  if (!fcn) return _fcn ;
+  RooGradMinimizerFcn* gradFcn = dynamic_cast<RooGradMinimizerFcn*>(fcn) ;
+  return gradFcn ? gradFcn->fcn() : (RooMinimizerFcn*) fcn ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivatives of the numerical gradient in threads of the
+/// implicit multi-threading pool (see ROOT::EnableImplicitMT()). Up to
+/// nClones+1 derivatives are calculated concurrently, each using its own
+/// clone of the minimized function. A value of zero restores the sequential
+/// calculation. Only effective with the Minuit2 minimizer, which computes the
+/// gradient in parallel for functions that declare themselves thread safe
+/// (ROOT::Math::IBaseFunctionMultiDim::IsThreadSafe()), as the function does
+/// when it has clones.
+
+void RooMinimizer::setParallelGradient(Int_t nClones)
+{
+  _fcn->SetNumClones(nClones) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the level for MINUIT error analysis to the given
 /// value. This function overrides the default value
@@ -321,7 +398,7 @@ Int_t RooMinimizer::minimize(const char* type, const char* alg)
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::CollectErrors) ;
   RooAbsReal::clearEvalErrorLog() ;
 
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -350,7 +427,7 @@ Int_t RooMinimizer::migrad()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"migrad");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -513,7 +590,7 @@ Int_t RooMinimizer::seek()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"seek");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -542,7 +619,7 @@ Int_t RooMinimizer::simplex()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"simplex");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -571,7 +648,7 @@ Int_t RooMinimizer::improve()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"migradimproved");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -28,6 +28,7 @@
 
 #include "TIterator.h"
 #include "TClass.h"
+#include "TMath.h"
 
 #include "RooAbsArg.h"
 #include "RooAbsPdf.h"
@@ -38,8 +39,82 @@
 
 #include "RooMinimizer.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
 using namespace std;
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Pool of the functions that DoEval() can evaluate. The first function is
+/// the minimized function itself, the others are clones of it that allow
+/// concurrent calls of DoEval(), e.g. from the parallel numerical gradient
+/// of Minuit2. Each function is used by one thread at a time. The value of
+/// a clone is corrected by a constant shift, such that it reproduces the
+/// value of the original function, including its likelihood offset.
+
+class RooMinimizerFcn::ClonePool {
+public:
+
+  ClonePool() : _nActive(0) {}
+  ~ClonePool() { clear() ; }
+
+  void clear() {
+    for (UInt_t i=1 ; i<_funcs.size() ; i++) {
+      delete _funcs[i] ;
+    }
+    _funcs.clear() ;
+    _params.clear() ;
+    _shifts.clear() ;
+    _free.clear() ;
+  }
+
+  void add(RooAbsReal* func, const std::vector<RooRealVar*>& params) {
+    _funcs.push_back(func) ;
+    _params.push_back(params) ;
+    _shifts.push_back(0) ;
+    // Keep the original function on top of the free list, so that serial
+    // callers always evaluate it
+    _free.insert(_free.begin(),_funcs.size()-1) ;
+  }
+
+  UInt_t size() const { return _funcs.size() ; }
+
+  Int_t acquire() {
+    std::unique_lock<std::mutex> lock(_mutex) ;
+    _cond.wait(lock,[this]{ return !_free.empty() ; }) ;
+    Int_t i = _free.back() ;
+    _free.pop_back() ;
+    // Offsets are not hidden as long as any function is evaluated
+    if (_nActive++ == 0) RooAbsReal::setHideOffset(kFALSE) ;
+    return i ;
+  }
+
+  void release(Int_t i) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex) ;
+      _free.push_back(i) ;
+      if (--_nActive == 0) RooAbsReal::setHideOffset(kTRUE) ;
+    }
+    _cond.notify_one() ;
+  }
+
+  std::vector<RooAbsReal*> _funcs ;              // Functions, the first one is the original
+  std::vector<std::vector<RooRealVar*> > _params ; // Floating parameters of the clones
+  std::vector<Double_t> _shifts ;                // Shifts of the values of the clones
+  std::mutex _logMutex ;                          // Serializes bookkeeping and logging in DoEval()
+
+private:
+
+  std::vector<Int_t> _free ;
+  Int_t _nActive ;
+  std::mutex _mutex ;
+  std::condition_variable _cond ;
+};
+
+
 RooMinimizerFcn::RooMinimizerFcn(RooAbsReal *funct, RooMinimizer* context,
 			   bool verbose) :
   _funct(funct), _context(context),
@@ -47,7 +122,8 @@ RooMinimizerFcn::RooMinimizerFcn(RooAbsReal *funct, RooMinimizer* context,
   _maxFCN(-1e30), _numBadNLL(0),  
   _printEvalErrors(10), _doEvalErrorWall(kTRUE),
   _nDim(0), _logfile(0),
-  _verbose(verbose)
+  _verbose(verbose),
+  _nClones(0), _clones(new ClonePool), _ownClones(kTRUE)
 { 
 
   _evalCounter = 0 ;
@@ -90,6 +166,7 @@ RooMinimizerFcn::RooMinimizerFcn(RooAbsReal *funct, RooMinimizer* context,
   _initFloatParamList = (RooArgList*) _floatParamList->snapshot(kFALSE) ;
   _initConstParamList = (RooArgList*) _constParamList->snapshot(kFALSE) ;
 
+  _clones->add(_funct,std::vector<RooRealVar*>()) ;
 }
 
 
@@ -105,7 +182,10 @@ RooMinimizerFcn::RooMinimizerFcn(const RooMinimizerFcn& other) : ROOT::Math::IBa
   _nDim(other._nDim),
   _logfile(other._logfile),
   _verbose(other._verbose),
-  _floatParamVec(other._floatParamVec)
+  _floatParamVec(other._floatParamVec),
+  _nClones(other._nClones),
+  _clones(other._clones),
+  _ownClones(kFALSE)
 {  
   _floatParamList = new RooArgList(*other._floatParamList) ;
   _constParamList = new RooArgList(*other._constParamList) ;
@@ -120,6 +200,7 @@ RooMinimizerFcn::~RooMinimizerFcn()
   delete _initFloatParamList;
   delete _constParamList;
   delete _initConstParamList;
+  if (_ownClones) delete _clones;
 }
 
 
@@ -372,6 +453,8 @@ Bool_t RooMinimizerFcn::Synchronize(std::vector<ROOT::Fit::ParameterSettings>& p
 
   updateFloatVec() ;
 
+  if (_ownClones) synchronizeClones(constStatChange || constValChange, optConst) ;
+
   return 0 ;  
 
 }
@@ -516,19 +599,162 @@ void RooMinimizerFcn::updateFloatVec()
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the number of clones of the minimized function that are made to
+/// allow concurrent calls of DoEval(). The clones are (re)built at the next
+/// call of Synchronize().
+
+void RooMinimizerFcn::SetNumClones(Int_t nClones)
+{
+  _nClones = nClones>0 ? nClones : 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build the clones of the minimized function if their number or the
+/// constant parameters changed, and calibrate their shifts at the current
+/// values of the floating parameters
+
+void RooMinimizerFcn::synchronizeClones(Bool_t rebuild, Bool_t optConst)
+{
+  if (rebuild || _clones->size()!=UInt_t(_nClones+1)) {
+    _clones->clear() ;
+    _clones->add(_funct,std::vector<RooRealVar*>()) ;
+
+    for (Int_t i=0 ; i<_nClones ; i++) {
+      RooAbsReal* clone = (RooAbsReal*) _funct->cloneTree() ;
+      RooArgSet* cloneParams = clone->getVariables() ;
+      std::vector<RooRealVar*> params(_nDim) ;
+      Bool_t ok(kTRUE) ;
+      for (Int_t index=0 ; index<_nDim ; index++) {
+	params[index] = dynamic_cast<RooRealVar*>(cloneParams->find(_floatParamVec[index]->GetName())) ;
+	if (!params[index]) ok = kFALSE ;
+      }
+      delete cloneParams ;
+      if (!ok) {
+	oocoutW(_context,Minimization) << "RooMinimizerFcn::synchronize: cannot find parameters in clone of " 
+				       << _funct->GetName() << ", function will not be evaluated concurrently" << endl ;
+	delete clone ;
+	break ;
+      }
+      if (optConst) {
+	clone->constOptimizeTestStatistic(RooAbsArg::Activate) ;
+      }
+      _clones->add(clone,params) ;
+    }
+  }
+
+  if (_clones->size()<2) return ;
+
+  // Calibrate the shifts of the clones at the current parameter values
+  RooAbsReal::setHideOffset(kFALSE) ;
+  Double_t ref = _funct->getVal() ;
+  for (UInt_t i=1 ; i<_clones->size() ; i++) {
+    RooAbsReal* clone = _clones->_funcs[i] ;
+    if (clone->isOffsetting()!=_funct->isOffsetting()) {
+      clone->enableOffsetting(_funct->isOffsetting()) ;
+    }
+    for (Int_t index=0 ; index<_nDim ; index++) {
+      _clones->_params[i][index]->setVal(((RooRealVar*)_floatParamVec[index])->getVal()) ;
+    }
+    _clones->_shifts[i] = ref - clone->getVal() ;
+  }
+  RooAbsReal::setHideOffset(kTRUE) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative of the function with respect to the floating parameter
+/// with index icoord at the parameter values x, as calculated by
+/// RooAbsReal::getDerivative(). If the derivative cannot be calculated because
+/// of evaluation errors, the errors are reported and a finite difference of
+/// DoEval() is returned instead, such that the minimizer sees the same
+/// handling of evaluation errors as for the function values, e.g. the wall
+/// at the maximum function value.
+
+Double_t RooMinimizerFcn::EvalDerivative(const double* x, unsigned int icoord) const
+{
+  // Take a function that is not evaluated by another thread
+  Int_t ifunc = _clones->acquire() ;
+  RooAbsReal* func = _clones->_funcs[ifunc] ;
+
+  for (int index = 0; index < _nDim; index++) {
+    if (ifunc==0) {
+      SetPdfParamVal(index,x[index]);
+    } else {
+      _clones->_params[ifunc][index]->setVal(x[index]) ;
+    }
+  }
+
+  const RooAbsRealLValue* param = ifunc==0 ? static_cast<RooAbsRealLValue*>(_floatParamVec[icoord]) : _clones->_params[ifunc][icoord] ;
+  Double_t deriv = func->getDerivative(*param) ;
+  _clones->release(ifunc) ;
+
+  {
+    std::lock_guard<std::mutex> lock(_clones->_logMutex) ;
+
+    if (!RooAbsPdf::evalError() && RooAbsReal::numEvalErrors()==0 && !TMath::IsNaN(deriv)) {
+      return deriv ;
+    }
+
+    if (_printEvalErrors>=0) {
+      oocoutW(_context,Minimization) << "RooMinimizerFcn: Derivative with respect to " << _floatParamVec[icoord]->GetName()
+				     << " has error status, using a finite difference of the function instead. Error log follows" << endl ;
+      RooAbsReal::printEvalErrors(ooccoutW(_context,Minimization),_printEvalErrors) ;
+      ooccoutW(_context,Minimization) << endl ;
+    }
+    RooAbsPdf::clearEvalError() ;
+    RooAbsReal::clearEvalErrorLog() ;
+  }
+
+  // Central difference, one-sided at the limits of the parameter
+  RooRealVar* par = static_cast<RooRealVar*>(_floatParamVec[icoord]) ;
+  std::vector<double> xs(x,x+_nDim) ;
+  const double h = 1e-5*(fabs(x[icoord])+1) ;
+  const double xhi = par->hasMax() ? std::min(x[icoord]+h,par->getMax()) : x[icoord]+h ;
+  const double xlo = par->hasMin() ? std::max(x[icoord]-h,par->getMin()) : x[icoord]-h ;
+  if (xhi<=xlo) return 0 ;
+
+  xs[icoord] = xhi ;
+  const double fhi = DoEval(&xs[0]) ;
+  xs[icoord] = xlo ;
+  const double flo = DoEval(&xs[0]) ;
+  SetPdfParamVal(icoord,x[icoord]) ;
+
+  return (fhi-flo)/(xhi-xlo) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+
 double RooMinimizerFcn::DoEval(const double *x) const 
 {
 
+  // Take a function that is not evaluated by another thread
+  Int_t ifunc = _clones->acquire() ;
+  RooAbsReal* func = _clones->_funcs[ifunc] ;
+
   // Set the parameter values for this iteration
   for (int index = 0; index < _nDim; index++) {
-    if (_logfile) (*_logfile) << x[index] << " " ;
-    SetPdfParamVal(index,x[index]);
+    if (ifunc==0) {
+      SetPdfParamVal(index,x[index]);
+    } else {
+      _clones->_params[ifunc][index]->setVal(x[index]) ;
+    }
   }
 
   // Calculate the function for these parameters  
-  RooAbsReal::setHideOffset(kFALSE) ;
-  double fvalue = _funct->getVal();
-  RooAbsReal::setHideOffset(kTRUE) ;
+  double fvalue = func->getVal() + _clones->_shifts[ifunc] ;
+  _clones->release(ifunc) ;
+
+  std::lock_guard<std::mutex> lock(_clones->_logMutex) ;
+
+  if (_logfile) {
+    for (int index = 0; index < _nDim; index++) (*_logfile) << x[index] << " " ;
+  }
 
   if (RooAbsPdf::evalError() || RooAbsReal::numEvalErrors()>0 || fvalue>1e30) {
 
@@ -542,15 +768,11 @@ double RooMinimizerFcn::DoEval(const double *x) const
         oocoutW(_context,Minimization) << "RooMinimizerFcn: Minimized function has error status but is ignored" << endl ;
       } 
 
-      TIterator* iter = _floatParamList->createIterator() ;
-      RooRealVar* var ;
-      Bool_t first(kTRUE) ;
       ooccoutW(_context,Minimization) << "Parameter values: " ;
-      while((var=(RooRealVar*)iter->Next())) {
-        if (first) { first = kFALSE ; } else ooccoutW(_context,Minimization) << ", " ;
-        ooccoutW(_context,Minimization) << var->GetName() << "=" << var->getVal() ;
+      for (int index = 0; index < _nDim; index++) {
+        if (index>0) ooccoutW(_context,Minimization) << ", " ;
+        ooccoutW(_context,Minimization) << _floatParamVec[index]->GetName() << "=" << x[index] ;
       }
-      delete iter ;
       ooccoutW(_context,Minimization) << endl ;
       
       RooAbsReal::printEvalErrors(ooccoutW(_context,Minimization),_printEvalErrors) ;
@@ -583,4 +805,3 @@ double RooMinimizerFcn::DoEval(const double *x) const
 }
 
 #endif
-
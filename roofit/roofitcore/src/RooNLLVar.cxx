@@ -28,6 +28,7 @@ In extended mode, a (Nexpect - Nobserved*log(NExpected) term is added
 **/
 
 #include <algorithm>
+#include <cmath>
 
 #include "RooFit.h"
 #include "Riostream.h"
@@ -43,6 +44,7 @@ In extended mode, a (Nexpect - Nobserved*log(NExpected) term is added
 #include "RooRealSumPdf.h"
 #include "RooRealVar.h"
 #include "RooProdPdf.h"
+#include "RooDataHist.h"
 
 ClassImp(RooNLLVar);
 ;
@@ -63,6 +65,7 @@ RooArgSet RooNLLVar::_emptySet ;
 ///  ConditionalObservables() | Define conditional observables
 ///  Verbose()                | Verbose output of GOF framework classes
 ///  CloneData()              | Clone input dataset for internal use (default is kTRUE)
+///  BatchMode()              | Evaluate the p.d.f for batches of events (default is kFALSE), see enableBatchMode()
 
 RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbsData& indata,
 		     const RooCmdArg& arg1, const RooCmdArg& arg2,const RooCmdArg& arg3,
@@ -82,6 +85,7 @@ RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbs
   RooCmdConfig pc("RooNLLVar::RooNLLVar") ;
   pc.allowUndefined() ;
   pc.defineInt("extended","Extended",0,kFALSE) ;
+  pc.defineInt("batchMode","BatchMode",0,kFALSE) ;
 
   pc.process(arg1) ;  pc.process(arg2) ;  pc.process(arg3) ;
   pc.process(arg4) ;  pc.process(arg5) ;  pc.process(arg6) ;
@@ -89,6 +93,7 @@ RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbs
 
   _extended = pc.getInt("extended") ;
   _weightSq = kFALSE ;
+  _batchMode = pc.getInt("batchMode") ;
   _first = kTRUE ;
   _offset = 0.;
   _offsetCarry = 0.;
@@ -110,6 +115,7 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
   RooAbsOptTestStatistic(name,title,pdf,indata,RooArgSet(),rangeName,addCoefRangeName,nCPU,interleave,verbose,splitRange,cloneData),
   _extended(extended),
   _weightSq(kFALSE),
+  _batchMode(kFALSE),
   _first(kTRUE), _offsetSaveW2(0.), _offsetCarrySaveW2(0.)
 {
   // If binned likelihood flag is set, pdf is a RooRealSumPdf representing a yield vector
@@ -122,23 +128,9 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
     // The Active label will disable pdf integral calculations
     _binnedPdf->setAttribute("BinnedLikelihoodActive") ;
 
-    RooArgSet* obs = _funcClone->getObservables(_dataClone) ;
-    if (obs->getSize()!=1) {
+    if (!cacheBinVolumes()) {
+      _binnedPdf->setAttribute("BinnedLikelihoodActive",kFALSE) ;
       _binnedPdf = 0 ;
-    } else {
-      RooRealVar* var = (RooRealVar*) obs->first() ;
-      std::list<Double_t>* boundaries = _binnedPdf->binBoundaries(*var,var->getMin(),var->getMax()) ;
-      std::list<Double_t>::iterator biter = boundaries->begin() ;
-      _binw.resize(boundaries->size()-1) ;
-      Double_t lastBound = (*biter) ;
-      biter++ ;
-      int ibin=0 ;
-      while (biter!=boundaries->end()) {
-	_binw[ibin] = (*biter) - lastBound ;
-	lastBound = (*biter) ;
-	ibin++ ;
-	biter++ ;
-      }
     }
   }
 }
@@ -155,6 +147,7 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
   RooAbsOptTestStatistic(name,title,pdf,indata,projDeps,rangeName,addCoefRangeName,nCPU,interleave,verbose,splitRange,cloneData),
   _extended(extended),
   _weightSq(kFALSE),
+  _batchMode(kFALSE),
   _first(kTRUE), _offsetSaveW2(0.), _offsetCarrySaveW2(0.)
 {
   // If binned likelihood flag is set, pdf is a RooRealSumPdf representing a yield vector
@@ -162,26 +155,9 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
   _binnedPdf = binnedL ? (RooRealSumPdf*)_funcClone : 0 ;
 
   // Retrieve and cache bin widths needed to convert unnormalized binnedPdf values back to yields
-  if (_binnedPdf) {
-
-    RooArgSet* obs = _funcClone->getObservables(_dataClone) ;
-    if (obs->getSize()!=1) {
-      _binnedPdf = 0 ;
-    } else {
-      RooRealVar* var = (RooRealVar*) obs->first() ;
-      std::list<Double_t>* boundaries = _binnedPdf->binBoundaries(*var,var->getMin(),var->getMax()) ;
-      std::list<Double_t>::iterator biter = boundaries->begin() ;
-      _binw.resize(boundaries->size()-1) ;
-      Double_t lastBound = (*biter) ;
-      biter++ ;
-      int ibin=0 ;
-      while (biter!=boundaries->end()) {
-	_binw[ibin] = (*biter) - lastBound ;
-	lastBound = (*biter) ;
-	ibin++ ;
-	biter++ ;
-      }
-    }
+  if (_binnedPdf && !cacheBinVolumes()) {
+    _binnedPdf->setAttribute("BinnedLikelihoodActive",kFALSE) ;
+    _binnedPdf = 0 ;
   }
 }
 
@@ -194,6 +170,7 @@ RooNLLVar::RooNLLVar(const RooNLLVar& other, const char* name) :
   RooAbsOptTestStatistic(other,name),
   _extended(other._extended),
   _weightSq(other._weightSq),
+  _batchMode(other._batchMode),
   _first(kTRUE), _offsetSaveW2(other._offsetSaveW2),
   _offsetCarrySaveW2(other._offsetCarrySaveW2),
   _binw(other._binw) {
@@ -202,6 +179,98 @@ RooNLLVar::RooNLLVar(const RooNLLVar& other, const char* name) :
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the bin boundaries of binning are those in boundaries,
+/// within a relative tolerance.
+
+Bool_t RooNLLVar::sameBoundaries(const std::list<Double_t>& boundaries, const RooAbsBinning* binning)
+{
+  if (!binning || Int_t(boundaries.size())!=binning->numBoundaries()) return kFALSE ;
+  const Double_t* bounds = binning->array() ;
+  Int_t i(0) ;
+  for (std::list<Double_t>::const_iterator iter=boundaries.begin() ; iter!=boundaries.end() ; ++iter, ++i) {
+    if (std::abs(*iter-bounds[i]) > 1e-10*(std::abs(*iter)+std::abs(bounds[i])+1e-300)) return kFALSE ;
+  }
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Cache the volumes of the bins of the binned likelihood, which convert the
+/// unnormalized values of the binned p.d.f back to yields. For a single
+/// observable, these are the widths of the bins of the p.d.f. For several
+/// observables, the dataset must be a RooDataHist, and the volumes of its
+/// bins are used. If the dataset is a RooDataHist, its bin boundaries must
+/// be those of the p.d.f in each observable. Return kFALSE if the binned
+/// likelihood cannot be used.
+
+Bool_t RooNLLVar::cacheBinVolumes()
+{
+  RooArgSet* obs = _funcClone->getObservables(_dataClone) ;
+  RooDataHist* dhist = dynamic_cast<RooDataHist*>(_dataClone) ;
+
+  Bool_t ok(obs->getSize()>0) ;
+  Int_t nBins(1) ;
+  _binw.clear() ;
+
+  RooFIter iter = obs->fwdIterator() ;
+  RooAbsArg* arg ;
+  while (ok && (arg=iter.next())) {
+    RooRealVar* var = dynamic_cast<RooRealVar*>(arg) ;
+    std::list<Double_t>* boundaries = var ? _binnedPdf->binBoundaries(*var,var->getMin(),var->getMax()) : 0 ;
+    if (!boundaries || boundaries->size()<2) {
+      delete boundaries ;
+      ok = kFALSE ;
+      continue ;
+    }
+    nBins *= boundaries->size()-1 ;
+
+    // The bins of the dataset must be those of the p.d.f
+    const RooAbsBinning* binning = dhist ? dhist->getBinning(*var) : 0 ;
+    if (dhist && !sameBoundaries(*boundaries,binning)) {
+      coutW(Fitting) << "RooNLLVar::cacheBinVolumes(" << GetName() << ") the binning of " << var->GetName()
+		     << " in dataset " << _dataClone->GetName() << " differs from the one of the p.d.f "
+		     << _funcClone->GetName() << ", the binned likelihood is not used" << std::endl ;
+      delete boundaries ;
+      ok = kFALSE ;
+      continue ;
+    }
+
+    if (obs->getSize()==1) {
+      std::list<Double_t>::iterator biter = boundaries->begin() ;
+      _binw.resize(boundaries->size()-1) ;
+      Double_t lastBound = (*biter) ;
+      biter++ ;
+      int ibin=0 ;
+      while (biter!=boundaries->end()) {
+	_binw[ibin] = (*biter) - lastBound ;
+	lastBound = (*biter) ;
+	ibin++ ;
+	biter++ ;
+      }
+    }
+    delete boundaries ;
+  }
+
+  if (ok && obs->getSize()>1) {
+    if (!dhist || dhist->numEntries()!=nBins) {
+      ok = kFALSE ;
+    } else {
+      _binw.resize(nBins) ;
+      for (Int_t i=0 ; i<nBins ; i++) {
+	dhist->get(i) ;
+	_binw[i] = dhist->binVolume() ;
+      }
+    }
+  }
+
+  delete obs ;
+  return ok ;
+}
+
+
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Destructor
@@ -224,10 +293,10 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
       std::swap(_offsetCarry, _offsetCarrySaveW2);
     }
     setValueDirty();
-  } else if ( _gofOpMode==MPMaster) {
+  } else if ( _gofOpMode==MPMaster && !_useThreads) {
     for (Int_t i=0 ; i<_nCPU ; i++)
       _mpfeArray[i]->applyNLLWeightSquared(flag);
-  } else if ( _gofOpMode==SimMaster) {
+  } else if ( _gofOpMode==SimMaster || _gofOpMode==MPMaster) {
     for (Int_t i=0 ; i<_nGof ; i++)
       ((RooNLLVar*)_gofArray[i])->applyWeightSquared(flag);
   }
@@ -235,6 +304,34 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the p.d.f for batches of events with RooAbsPdf::getValBatch()
+/// rather than event by event. This is only done for unbinned likelihoods of
+/// datasets that provide their columns contiguously in memory, i.e. that use
+/// the vector storage, and for partitions that are not interleaved. For
+/// binned datasets, batches span ranges of bins that are mostly filled.
+/// Events where the p.d.f is zero, negative, Not-a-Number or suspiciously
+/// large are recomputed with getLogVal() so that evaluation errors are
+/// reported as usual.
+
+void RooNLLVar::enableBatchMode(Bool_t flag)
+{
+  _batchMode = flag ;
+  if (!_init) return ;
+
+  if (_gofOpMode==Slave) {
+    setValueDirty() ;
+  } else if ( _gofOpMode==MPMaster && !_useThreads) {
+    for (Int_t i=0 ; i<_nCPU ; i++)
+      _mpfeArray[i]->enableNLLBatchMode(flag);
+  } else if ( _gofOpMode==SimMaster || _gofOpMode==MPMaster) {
+    for (Int_t i=0 ; i<_nGof ; i++)
+      ((RooNLLVar*)_gofArray[i])->enableBatchMode(flag);
+  }
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Calculate and return likelihood on subset of data from firstEvent to lastEvent
 /// processed with a step size of 'stepSize'. If this an extended likelihood and
@@ -287,7 +384,7 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
       } else {
 
-	Double_t term = -1*(-mu + N*log(mu) - TMath::LnGamma(N+1)) ;
+	Double_t term = -1*(-mu + N*log(mu) - binLogFactorial(i,N)) ;
 
 	// Kahan summation of sumWeight
 	Double_t y = eventWeight - sumWeightCarry;
@@ -306,28 +403,41 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
   } else {
 
-    for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
+    // Binned datasets only need the bins with a non-zero weight
+    RooDataHist* dhist = dynamic_cast<RooDataHist*>(_dataClone) ;
+    if (dhist) {
 
-      _dataClone->get(i) ;
+      std::vector<Int_t> bins ;
+      partitionBins(*dhist,firstEvent,lastEvent,stepSize,bins) ;
+      evaluatePartitionBins(*dhist,bins,result,carry,sumWeight,sumWeightCarry) ;
 
-      if (!_dataClone->valid()) continue;
+    // Process the events in batches if requested, otherwise one by one
+    } else if (!_batchMode || stepSize!=1 ||
+	       !evaluatePartitionBatch(firstEvent,lastEvent,result,carry,sumWeight,sumWeightCarry)) {
 
-      Double_t eventWeight = _dataClone->weight();
-      if (0. == eventWeight * eventWeight) continue ;
-      if (_weightSq) eventWeight = _dataClone->weightSquared() ;
+      for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
 
-      Double_t term = -eventWeight * pdfClone->getLogVal(_normSet);
+        _dataClone->get(i) ;
 
+        if (!_dataClone->valid()) continue;
 
-      Double_t y = eventWeight - sumWeightCarry;
-      Double_t t = sumWeight + y;
-      sumWeightCarry = (t - sumWeight) - y;
-      sumWeight = t;
+        Double_t eventWeight = _dataClone->weight();
+        if (0. == eventWeight * eventWeight) continue ;
+        if (_weightSq) eventWeight = _dataClone->weightSquared() ;
 
-      y = term - carry;
-      t = result + y;
-      carry = (t - result) - y;
-      result = t;
+        Double_t term = -eventWeight * pdfClone->getLogVal(_normSet);
+
+
+        Double_t y = eventWeight - sumWeightCarry;
+        Double_t t = sumWeight + y;
+        sumWeightCarry = (t - sumWeight) - y;
+        sumWeight = t;
+
+        y = term - carry;
+        t = result + y;
+        carry = (t - result) - y;
+        result = t;
+      }
     }
 
     // include the extended maximum likelihood term, if requested
@@ -425,4 +535,276 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative of evaluatePartition() with respect to param from
+/// the derivatives of the p.d.f value and of the expected number of events,
+/// so that the likelihood is differentiated in one pass over the events. The
+/// events and bins that evaluatePartition() skips or flags as errors do not
+/// contribute, and the offset and the term of simultaneous p.d.f.s are
+/// constant.
+
+Double_t RooNLLVar::evaluatePartitionDerivative(const RooAbsRealLValue& param, Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const
+{
+  Int_t i ;
+  Double_t result(0), carry(0);
+
+  RooAbsPdf* pdfClone = (RooAbsPdf*) _funcClone ;
+
+  _dataClone->store()->recalculateCache( _projDeps, firstEvent, lastEvent, stepSize,(_binnedPdf?kFALSE:kTRUE) ) ;
+
+  if (_binnedPdf) {
+
+    for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
+
+      _dataClone->get(i) ;
+
+      if (!_dataClone->valid()) continue;
+
+      // Derivative of -log(Poisson(N|mu)) for this bin
+      Double_t N = _dataClone->weight() ;
+      Double_t mu = _binnedPdf->getVal()*_binw[i] ;
+      if ((mu<=0 && N>0) || (fabs(mu)<1e-10 && fabs(N)<1e-10)) continue ;
+
+      Double_t term = _binnedPdf->getDerivative(param)*_binw[i]*(1 - N/mu) ;
+
+      Double_t y = term - carry;
+      Double_t t = result + y;
+      carry = (t - result) - y;
+      result = t;
+    }
+
+  } else {
+
+    // Binned datasets only need the bins with a non-zero weight
+    RooDataHist* dhist = dynamic_cast<RooDataHist*>(_dataClone) ;
+    std::vector<Int_t> bins ;
+    if (dhist) {
+      partitionBins(*dhist,firstEvent,lastEvent,stepSize,bins) ;
+    }
+    Int_t nEvents = dhist ? Int_t(bins.size()) : (lastEvent-firstEvent+stepSize-1)/stepSize ;
+
+    for (Int_t k=0 ; k<nEvents ; k++) {
+
+      i = dhist ? bins[k] : firstEvent+k*stepSize ;
+      _dataClone->get(i) ;
+
+      if (!_dataClone->valid()) continue;
+
+      Double_t eventWeight = _dataClone->weight();
+      if (0. == eventWeight * eventWeight) continue ;
+      if (_weightSq) eventWeight = _dataClone->weightSquared() ;
+
+      Double_t prob = pdfClone->getVal(_normSet) ;
+      if (prob<=0 || TMath::IsNaN(prob)) continue ;
+
+      Double_t term = -eventWeight * pdfClone->getDerivative(param,_normSet) / prob ;
+
+      Double_t y = term - carry;
+      Double_t t = result + y;
+      carry = (t - result) - y;
+      result = t;
+    }
+
+    // include the extended maximum likelihood term, if requested
+    if(_extended && _setNum==_extSet) {
+      Double_t extra(0) ;
+      if (_weightSq) {
+
+	// Derivative of the extended term with W^2 weighting of evaluatePartition()
+	Double_t sumW2(0), sumW2carry(0);
+	for (i=0 ; i<_dataClone->numEntries() ; i++) {
+	  _dataClone->get(i);
+	  Double_t y = _dataClone->weightSquared() - sumW2carry;
+	  Double_t t = sumW2 + y;
+	  sumW2carry = (t - sumW2) - y;
+	  sumW2 = t;
+	}
+
+	Double_t expected = pdfClone->expectedEvents(_dataClone->get()) ;
+	if (expected>0) {
+	  Double_t expectedDeriv = pdfClone->expectedEventsDerivative(param,_dataClone->get()) ;
+	  extra = expectedDeriv*sumW2/_dataClone->sumEntries() - sumW2*expectedDeriv/expected ;
+	}
+      } else {
+	extra = pdfClone->extendedTermDerivative(param,_dataClone->sumEntries(),_dataClone->get()) ;
+      }
+
+      Double_t y = extra - carry;
+      Double_t t = result + y;
+      carry = (t - result) - y;
+      result = t;
+    }
+  }
+
+  return result ;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the terms of the events from firstEvent to lastEvent to the likelihood,
+/// evaluating the p.d.f for batches of events at a time. The sums are done in
+/// the same order and with the same Kahan summation as in evaluatePartition(),
+/// so the result is identical to the event by event calculation. Return kFALSE
+/// without touching the sums if the dataset cannot provide batches of events.
+
+Bool_t RooNLLVar::evaluatePartitionBatch(Int_t firstEvent, Int_t lastEvent, Double_t& result, Double_t& carry,
+					 Double_t& sumWeight, Double_t& sumWeightCarry) const
+{
+  const Int_t batchSize = 1024 ;
+  if (lastEvent<=firstEvent) return kFALSE ;
+
+  RooAbsPdf* pdfClone = (RooAbsPdf*) _funcClone ;
+  std::vector<Double_t> weights(std::min(batchSize,lastEvent-firstEvent)) ;
+  std::vector<Double_t> probs(weights.size()) ;
+
+  for (Int_t begin=firstEvent ; begin<lastEvent ; begin+=batchSize) {
+    Int_t nEvents = std::min(batchSize,lastEvent-begin) ;
+
+    // The data either provides all batches or none
+    if (!_dataClone->getWeightBatch(&weights[0],begin,nEvents)) {
+      return kFALSE ;
+    }
+    pdfClone->getValBatch(&probs[0],*_dataClone,begin,nEvents,_normSet) ;
+
+    for (Int_t k=0 ; k<nEvents ; k++) {
+
+      Double_t eventWeight = weights[k] ;
+      if (0. == eventWeight * eventWeight) continue ;
+      if (_weightSq) eventWeight *= eventWeight ;
+
+      // Let getLogVal() handle values that need to be reported
+      Double_t prob = probs[k] ;
+      Double_t logProb ;
+      if (prob>0 && fabs(prob)<=1e6) {
+	logProb = log(prob) ;
+      } else {
+	_dataClone->get(begin+k) ;
+	logProb = pdfClone->getLogVal(_normSet) ;
+      }
+      Double_t term = -eventWeight * logProb ;
+
+      Double_t y = eventWeight - sumWeightCarry;
+      Double_t t = sumWeight + y;
+      sumWeightCarry = (t - sumWeight) - y;
+      sumWeight = t;
+
+      y = term - carry;
+      t = result + y;
+      carry = (t - result) - y;
+      result = t;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill bins with the indices of the bins of dhist with a non-zero weight that
+/// belong to the partition of events from firstEvent to lastEvent processed
+/// with a step size of 'stepSize', in increasing order.
+
+void RooNLLVar::partitionBins(const RooDataHist& dhist, Int_t firstEvent, Int_t lastEvent, Int_t stepSize,
+			      std::vector<Int_t>& bins) const
+{
+  const std::vector<Int_t>& nonEmpty = dhist.nonEmptyBins() ;
+  std::vector<Int_t>::const_iterator iter = std::lower_bound(nonEmpty.begin(),nonEmpty.end(),firstEvent) ;
+  for ( ; iter!=nonEmpty.end() && *iter<lastEvent ; ++iter) {
+    if ((*iter-firstEvent)%stepSize==0) {
+      bins.push_back(*iter) ;
+    }
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the likelihood terms of the given bins of dhist to result, and their
+/// weights to sumWeight, with Kahan summation. The bins must have a non-zero
+/// weight and be given in increasing order, see partitionBins(). In batch mode,
+/// chunks of up to 1024 bins are evaluated with one call to
+/// RooAbsPdf::getValBatch() over the range of bins they span, if at least half
+/// of that range is filled. Chunks of sparsely filled bins, and all bins if
+/// weights are squared, are evaluated bin by bin.
+
+void RooNLLVar::evaluatePartitionBins(const RooDataHist& dhist, const std::vector<Int_t>& bins, Double_t& result, Double_t& carry,
+				      Double_t& sumWeight, Double_t& sumWeightCarry) const
+{
+  const Int_t batchSize = 1024 ;
+
+  RooAbsPdf* pdfClone = (RooAbsPdf*) _funcClone ;
+  std::vector<Double_t> weights ;
+  std::vector<Double_t> probs ;
+
+  for (Int_t begin=0 ; begin<Int_t(bins.size()) ; begin+=batchSize) {
+    Int_t end = std::min(begin+batchSize,Int_t(bins.size())) ;
+    Int_t first = bins[begin] ;
+    Int_t nBins = bins[end-1]-first+1 ;
+
+    Bool_t batch = _batchMode && !_weightSq && nBins<=2*(end-begin) ;
+    if (batch) {
+      weights.resize(nBins) ;
+      probs.resize(nBins) ;
+      batch = dhist.getWeightBatch(&weights[0],first,nBins) ;
+    }
+    if (batch) {
+      pdfClone->getValBatch(&probs[0],dhist,first,nBins,_normSet) ;
+    }
+
+    for (Int_t k=begin ; k<end ; k++) {
+
+      Int_t i = bins[k] ;
+      Double_t eventWeight ;
+      Double_t logProb ;
+
+      // Let getLogVal() handle values that need to be reported
+      if (batch && probs[i-first]>0 && fabs(probs[i-first])<=1e6) {
+	eventWeight = weights[i-first] ;
+	logProb = log(probs[i-first]) ;
+      } else {
+	dhist.get(i) ;
+	eventWeight = _weightSq ? dhist.weightSquared() : dhist.weight() ;
+	logProb = pdfClone->getLogVal(_normSet) ;
+      }
+      Double_t term = -eventWeight * logProb ;
+
+      Double_t y = eventWeight - sumWeightCarry;
+      Double_t t = sumWeight + y;
+      sumWeightCarry = (t - sumWeight) - y;
+      sumWeight = t;
+
+      y = term - carry;
+      t = result + y;
+      carry = (t - result) - y;
+      result = t;
+    }
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return log(N!) for the weight N of bin i of the binned likelihood. The
+/// value is cached per bin, and recalculated only if the weight of the bin
+/// has changed.
+
+Double_t RooNLLVar::binLogFactorial(Int_t i, Double_t N) const
+{
+  if (Int_t(_binN.size())!=_dataClone->numEntries()) {
+    // log(0!) = 0
+    _binN.assign(_dataClone->numEntries(),0.) ;
+    _binLogFact.assign(_dataClone->numEntries(),0.) ;
+  }
+  if (_binN[i]!=N) {
+    _binN[i] = N ;
+    _binLogFact[i] = TMath::LnGamma(N+1) ;
+  }
+  return _binLogFact[i] ;
+}
+
+
+
 
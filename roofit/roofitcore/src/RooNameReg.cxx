@@ -31,6 +31,7 @@ fast searches and comparisons.
 #include "RooNameReg.h"
 #include "RooNameReg.h"
 #include <iostream>
+#include <mutex>
 using namespace std ;
 
 ClassImp(RooNameReg);
@@ -38,6 +39,18 @@ ClassImp(RooNameReg);
 
 RooNameReg* RooNameReg::_instance = 0 ;
 
+namespace {
+
+// Protects the registry, which the partitions of a test statistic in thread
+// mode may look up and extend concurrently
+std::mutex& registryMutex()
+{
+  static std::mutex regMutex ;
+  return regMutex ;
+}
+
+}
+
 
 RooNameReg::RooNameReg(Int_t hashSize) : TNamed("RooNameReg","RooFit Name Registry"), _htable(hashSize) {} 
 
@@ -95,6 +108,8 @@ const TNamed* RooNameReg::constPtr(const char* inStr)
 
 //   cout << "RooNameReg::constPtr(inStr=" << inStr << ") _htable entries = " << _htable.entries() << endl ;
 
+  std::lock_guard<std::mutex> lock(registryMutex()) ;
+
   // See if name is already registered ;
   TNamed* t = (TNamed*) _htable.find(inStr) ;
   if (t) return t ;
@@ -147,5 +162,6 @@ const TNamed* RooNameReg::known(const char* inStr)
   // Handle null pointer case explicitly
   if (inStr==0) return 0 ;
   if (_instance==0) return 0;
+  std::lock_guard<std::mutex> lock(registryMutex()) ;
   return (const TNamed*) _instance->_htable.find(inStr) ;
 }
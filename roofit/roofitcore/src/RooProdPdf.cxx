@@ -560,6 +560,113 @@ Double_t RooProdPdf::calculate(const RooProdPdf::CacheElem& cache, Bool_t /*verb
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative with respect to param by applying the product rule
+/// to the terms of calculate(), and the normalization of this p.d.f (see
+/// RooAbsPdf::normalizedDerivative()). If the running product drops below the
+/// cutoff value, the derivative is taken to be zero.
+
+Double_t RooProdPdf::evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const
+{
+  // Select the terms for nset and synchronize the normalization
+  Double_t value = getVal(nset) ;
+
+  Int_t code ;
+  CacheElem* cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  if (!cache) {
+    RooArgList *plist(0) ;
+    RooLinkedList *nlist(0) ;
+    getPartIntList(_curNormSet,0,plist,nlist,code) ;
+    cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  }
+
+  Double_t rawDeriv(0) ;
+  if (cache->_isRearranged) {
+
+    Double_t num = cache->_rearrangedNum->getVal() ;
+    Double_t den = cache->_rearrangedDen->getVal() ;
+    rawDeriv = (cache->_rearrangedNum->getDerivative(param)*den - num*cache->_rearrangedDen->getDerivative(param)) / (den*den) ;
+
+  } else {
+
+    std::vector<Double_t> piVal, piDeriv ;
+    RooAbsReal* partInt;
+    RooArgSet* normSet;
+    RooFIter plIter = cache->_partList.fwdIterator();
+    RooFIter nlIter = cache->_normList.fwdIterator();
+    Double_t prod = 1.0;
+    for (partInt = (RooAbsReal*) plIter.next(),
+	normSet = (RooArgSet*) nlIter.next(); partInt && normSet;
+      partInt = (RooAbsReal*) plIter.next(),
+      normSet = (RooArgSet*) nlIter.next()) {
+      const RooArgSet* piNormSet = normSet->getSize() > 0 ? normSet : 0 ;
+      piVal.push_back(partInt->getVal(piNormSet)) ;
+      prod *= piVal.back() ;
+      if (prod <= _cutOff) return 0 ;
+      piDeriv.push_back(partInt->getDerivative(param,piNormSet)) ;
+    }
+
+    for (UInt_t i=0 ; i<piVal.size() ; i++) {
+      if (piDeriv[i]==0) continue ;
+      Double_t term = piDeriv[i] ;
+      for (UInt_t j=0 ; j<piVal.size() ; j++) {
+	if (j!=i) term *= piVal[j] ;
+      }
+      rawDeriv += term ;
+    }
+  }
+
+  return normalizedDerivative(param,nset,value,rawDeriv) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the running product of the p.d.f terms for the events
+/// [first,first+nEvents) of data in one go, see RooAbsReal::getValBatch().
+/// As in calculate(), terms are no longer multiplied in once the product
+/// has dropped below the cutoff value.
+
+Bool_t RooProdPdf::evaluateBatch(Double_t* output, const RooAbsData& data, Int_t first, Int_t nEvents) const
+{
+  // The normalization set of the cache is the one last passed to getValV()
+  if (_curNormSet!=_normSet) return kFALSE ;
+
+  Int_t code ;
+  CacheElem* cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  if (!cache) {
+    RooArgList *plist(0) ;
+    RooLinkedList *nlist(0) ;
+    getPartIntList(_curNormSet,0,plist,nlist,code) ;
+    cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  }
+  if (cache->_isRearranged) return kFALSE ;
+
+  std::vector<Double_t> piVal(nEvents) ;
+  std::fill(output,output+nEvents,1.0) ;
+  RooAbsReal* partInt;
+  RooArgSet* normSet;
+  RooFIter plIter = cache->_partList.fwdIterator();
+  RooFIter nlIter = cache->_normList.fwdIterator();
+  Bool_t firstTerm(kTRUE) ;
+  for (partInt = (RooAbsReal*) plIter.next(),
+	 normSet = (RooArgSet*) nlIter.next(); partInt && normSet;
+       partInt = (RooAbsReal*) plIter.next(),
+	 normSet = (RooArgSet*) nlIter.next()) {
+    partInt->getValBatch(&piVal[0],data,first,nEvents,normSet->getSize() > 0 ? normSet : 0) ;
+    for (Int_t k=0 ; k<nEvents ; k++) {
+      if (firstTerm || output[k] > _cutOff) {
+	output[k] *= piVal[k] ;
+      }
+    }
+    firstTerm = kFALSE ;
+  }
+
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Factorize product in irreducible terms for given choice of integration/normalization
 
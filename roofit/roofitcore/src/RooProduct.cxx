@@ -386,6 +386,42 @@ Double_t RooProduct::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative of the product with respect to param, applying the
+/// product rule to the real-valued components
+
+Double_t RooProduct::evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* /*nset*/) const
+{
+  const RooArgSet* nset = _compRSet.nset() ;
+  std::vector<Double_t> vals, derivs ;
+  RooFIter compRIter = _compRSet.fwdIterator() ;
+  RooAbsReal* rcomp ;
+  while((rcomp=(RooAbsReal*)compRIter.next())) {
+    vals.push_back(rcomp->getVal(nset)) ;
+    derivs.push_back(rcomp->getDerivative(param,nset)) ;
+  }
+
+  Double_t deriv(0) ;
+  for (UInt_t i=0 ; i<vals.size() ; i++) {
+    if (derivs[i]==0) continue ;
+    Double_t term = derivs[i] ;
+    for (UInt_t j=0 ; j<vals.size() ; j++) {
+      if (j!=i) term *= vals[j] ;
+    }
+    deriv += term ;
+  }
+
+  RooFIter compCIter = _compCSet.fwdIterator() ;
+  RooAbsCategory* ccomp ;
+  while((ccomp=(RooAbsCategory*)compCIter.next())) {
+    deriv *= ccomp->getIndex() ;
+  }
+
+  return deriv ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Forward the plot sampling hint from the p.d.f. that defines the observable obs  
 
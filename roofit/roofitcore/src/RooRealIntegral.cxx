@@ -892,13 +892,18 @@ Double_t RooRealIntegral::evaluate() const
   case Hybrid: 
     {      
       // Cache numeric integrals in >1d expensive object cache
-      RooDouble* cacheVal(0) ;
+      Bool_t cached(kFALSE) ;
       if ((_cacheNum && _intList.getSize()>0) || _intList.getSize()>=_cacheAllNDim) {
-	cacheVal = (RooDouble*) expensiveObjectCache().retrieveObject(GetName(),RooDouble::Class(),parameters())  ;
+	// Copy the value under the cache lock, another thread may replace the cached object
+	std::lock_guard<std::recursive_mutex> lock(RooExpensiveObjectCache::mutex()) ;
+	RooDouble* cacheVal = (RooDouble*) expensiveObjectCache().retrieveObject(GetName(),RooDouble::Class(),parameters())  ;
+	if (cacheVal) {
+	  retVal = *cacheVal ;
+	  cached = kTRUE ;
+	}
       }
 
-      if (cacheVal) {
-	retVal = *cacheVal ;
+      if (cached) {
 	//	cout << "using cached value of integral" << GetName() << endl ;
       } else {
 
@@ -929,6 +934,12 @@ Double_t RooRealIntegral::evaluate() const
 	_intList=_saveInt ;
 	_sumList=_saveSum ;
 
+	// If the caller inhibits dirty state propagation, the restored values do not
+	// propagate and the integrand still holds its value at the last integration point
+	if (origState) {
+	  _function.arg().getVal(_funcNormSet) ;
+	}
+
 	// Cache numeric integrals in >1d expensive object cache
 	if ((_cacheNum && _intList.getSize()>0) || _intList.getSize()>=_cacheAllNDim) {
 	  RooDouble* val = new RooDouble(retVal) ;
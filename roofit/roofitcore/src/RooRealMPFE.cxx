@@ -361,6 +361,17 @@ void RooRealMPFE::serverLoop()
       }
       break ;
 
+    case EnableNLLBatch:
+      {
+      Bool_t flag ;
+      *_pipe >> flag;
+      if (_verboseServer) cout << "RooRealMPFE::serverLoop(" << GetName()
+			       << ") IPC fromClient> EnableNLLBatch " << (flag?1:0) << endl ;
+
+      doEnableNLLBatch(flag) ;
+      }
+      break ;
+
     case EnableOffset:
       {
       Bool_t flag ;
@@ -725,6 +736,34 @@ void RooRealMPFE::doApplyNLLW2(Bool_t flag)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Control batch evaluation of the likelihood on both client and server side
+
+void RooRealMPFE::enableNLLBatchMode(Bool_t flag)
+{
+#ifndef _WIN32
+  if (_state==Client) {
+    int msg = EnableNLLBatch ;
+    *_pipe << msg << flag;
+    if (_verboseServer) cout << "RooRealMPFE::enableNLLBatchMode(" << GetName()
+			     << ") IPC toServer> EnableNLLBatch " << (flag?1:0) << endl ;
+  }
+#endif // _WIN32
+  doEnableNLLBatch(flag) ;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RooRealMPFE::doEnableNLLBatch(Bool_t flag)
+{
+  RooNLLVar* nll = dynamic_cast<RooNLLVar*>(_arg.absArg()) ;
+  if (nll) {
+    nll->enableBatchMode(flag) ;
+  }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Control verbose messaging related to inter process communication
 /// on both client and server side
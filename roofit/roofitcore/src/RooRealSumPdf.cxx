@@ -277,6 +277,51 @@ Double_t RooRealSumPdf::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivative with respect to param of the sum of coefficient and
+/// function products, and apply the normalization (see RooAbsPdf::normalizedDerivative())
+
+Double_t RooRealSumPdf::evaluateDerivative(const RooAbsRealLValue& param, const RooArgSet* nset) const 
+{
+  Double_t value = getVal(nset) ;
+  if (value<=0 && (_doFloor || _doFloorGlobal)) {
+    return 0 ;
+  }
+
+  Double_t rawDeriv(0) ;
+
+  RooFIter funcIter = _funcList.fwdIterator() ;
+  RooFIter coefIter = _coefList.fwdIterator() ;
+  RooAbsReal* coef ;
+  RooAbsReal* func ;
+
+  // N funcs, N-1 coefficients 
+  Double_t lastCoef(1), lastCoefDeriv(0) ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    func = (RooAbsReal*)funcIter.next() ;
+    Double_t coefVal = coef->getVal() ;
+    Double_t coefDeriv = coef->getDerivative(param) ;
+    if (func->isSelectedComp()) {
+      if (coefVal) rawDeriv += func->getDerivative(param)*coefVal ;
+      if (coefDeriv) rawDeriv += func->getVal()*coefDeriv ;
+    }
+    lastCoef -= coefVal ;
+    lastCoefDeriv -= coefDeriv ;
+  }
+
+  if (!_haveLastCoef) {
+    func = (RooAbsReal*) funcIter.next() ;
+    if (func->isSelectedComp()) {
+      rawDeriv += func->getDerivative(param)*lastCoef ;
+      if (lastCoefDeriv) rawDeriv += func->getVal()*lastCoefDeriv ;
+    }
+  }
+
+  return normalizedDerivative(param,nset,value,rawDeriv) ;
+}
+
+
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Check if FUNC is valid for given normalization set.
@@ -604,6 +604,9 @@ void RooTreeDataStore::loadValues(const RooAbsDataStore *ads, const RooFormulaVa
       _varsww.assignValueOnly(((RooTreeDataStore*)ads)->_varsww) ;
     } else {
       _varsww.assignValueOnly(*ads->get()) ;
+      if (_wgtVar && ads->isWeighted() && !ads->get()->find(_wgtVar->GetName())) {
+	_wgtVar->setVal(ads->weight()) ;
+      }
     }
 
     destIter->Reset() ;
@@ -27,6 +27,7 @@ use a TTree as internal storage mechanism
 #include "RooMsgService.h"
 #include "RooVectorDataStore.h"
 #include "RooTreeDataStore.h"
+#include "RooLinkedTreeDataStore.h"
 
 #include "Riostream.h"
 #include "TTree.h"
@@ -280,6 +281,56 @@ RooVectorDataStore::RooVectorDataStore(const RooTreeDataStore& other, const RooA
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor reading all events of a store that links them from a tree
+
+RooVectorDataStore::RooVectorDataStore(const RooLinkedTreeDataStore& other, const RooArgSet& vars, const char* newname) :
+  RooAbsDataStore(other,varsNoWeight(vars,other._wgtVar?other._wgtVar->GetName():0),newname),
+  _varsww(vars),
+  _wgtVar(weightVar(vars,other._wgtVar?other._wgtVar->GetName():0)),
+  _nReal(0),
+  _nRealF(0),
+  _nCat(0),
+  _nEntries(0),	   
+  _firstReal(0),
+  _firstRealF(0),
+  _firstCat(0),
+  _sumWeight(0),
+  _sumWeightCarry(0),
+  _extWgtArray(0),
+  _extWgtErrLoArray(0),
+  _extWgtErrHiArray(0),
+  _extSumW2Array(0),
+  _curWgt(1),
+  _curWgtErrLo(0),
+  _curWgtErrHi(0),
+  _curWgtErr(0),
+  _cache(0),
+  _cacheOwner(0),
+  _forcedUpdate(kFALSE)
+{
+  TIterator* iter = _varsww.createIterator() ;
+  RooAbsArg* arg ;
+  while((arg=(RooAbsArg*)iter->Next())) {
+    arg->attachToVStore(*this) ;
+  }
+  delete iter ;
+
+  setAllBuffersNative() ;
+  
+  // now copy the events of the linked tree here
+  reserve(other.numEntries());
+  for (Int_t i=0 ; i<other.numEntries() ; i++) {
+    other.get(i) ;
+    _varsww = other._varsww ;
+    fill() ;
+  }
+  TRACE_CREATE
+  
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Clone ctor, must connect internal storage to given new external set of vars
 
@@ -353,6 +404,89 @@ RooVectorDataStore::RooVectorDataStore(const RooVectorDataStore& other, const Ro
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// View ctor, connects the given new external set of vars to the entries
+/// [firstEntry,lastEntry) of other without copying them. The view can only be
+/// read, and other must neither be modified nor deleted while the view exists.
+/// Copies of the view are views of the same entries. Stores with errors on
+/// real values (see canView()) cannot be viewed, and the cache of other is
+/// not part of the view.
+
+RooVectorDataStore::RooVectorDataStore(const RooVectorDataStore& other, const RooArgSet& vars, Int_t firstEntry, Int_t lastEntry, const char* newname) :
+  RooAbsDataStore(other,varsNoWeight(vars,other._wgtVar?other._wgtVar->GetName():0),newname),
+  _varsww(vars),
+  _wgtVar(other._wgtVar?weightVar(vars,other._wgtVar->GetName()):0),
+  _nReal(0),	 
+  _nRealF(0),
+  _nCat(0),
+  _nEntries(lastEntry-firstEntry),	 
+  _sumWeight(other._sumWeight),
+  _sumWeightCarry(other._sumWeightCarry),
+  _extWgtArray(other._extWgtArray?other._extWgtArray+firstEntry:0),
+  _extWgtErrLoArray(other._extWgtErrLoArray?other._extWgtErrLoArray+firstEntry:0),
+  _extWgtErrHiArray(other._extWgtErrHiArray?other._extWgtErrHiArray+firstEntry:0),
+  _extSumW2Array(other._extSumW2Array?other._extSumW2Array+firstEntry:0),
+  _curWgt(other._curWgt),
+  _curWgtErrLo(other._curWgtErrLo),
+  _curWgtErrHi(other._curWgtErrHi),
+  _curWgtErr(other._curWgtErr),
+  _cache(0),
+  _cacheOwner(0),
+  _forcedUpdate(kFALSE)
+{
+  if (!other.canView()) {
+    coutE(InputArguments) << "RooVectorDataStore::RooVectorDataStore(" << GetName() << ") ERROR: cannot create a view of "
+			  << other.GetName() << " which stores errors" << endl ;
+    throw std::string("RooVectorDataStore::RooVectorDataStore() ERROR, cannot create a view of a store with errors") ;
+  }
+  if (firstEntry<0 || lastEntry>other._nEntries || firstEntry>lastEntry) {
+    coutE(InputArguments) << "RooVectorDataStore::RooVectorDataStore(" << GetName() << ") ERROR: entries [" << firstEntry << ","
+			  << lastEntry << ") are not in " << other.GetName() << endl ;
+    throw std::string("RooVectorDataStore::RooVectorDataStore() ERROR, entries of view out of range") ;
+  }
+
+  vector<RealVector*>::const_iterator oiter = other._realStoreList.begin() ;
+  for (; oiter!=other._realStoreList.end() ; ++oiter) {
+    RooAbsReal* real = (RooAbsReal*) vars.find((*oiter)->bufArg()->GetName()) ;
+    if (real) {
+      _realStoreList.push_back(new RealVector(**oiter,real,firstEntry)) ;
+      real->attachToVStore(*this) ;
+      _nReal++ ;
+    }
+  }
+
+  vector<CatVector*>::const_iterator citer = other._catStoreList.begin() ;
+  for (; citer!=other._catStoreList.end() ; ++citer) {
+    RooAbsCategory* cat = (RooAbsCategory*) vars.find((*citer)->bufArg()->GetName()) ;
+    if (cat) {
+      _catStoreList.push_back(new CatVector(**citer,cat,firstEntry)) ;
+      cat->attachToVStore(*this) ;
+      _nCat++ ;
+    }
+  }
+
+  setAllBuffersNative() ;
+
+  _firstReal = _realStoreList.size()>0 ? &_realStoreList.front() : 0 ;
+  _firstRealF = 0 ;
+  _firstCat = _catStoreList.size()>0 ? &_catStoreList.front() : 0 ;
+
+  // Sum up the weights of a part of other
+  if (_nEntries!=other._nEntries) {
+    _sumWeight = _sumWeightCarry = 0 ;
+    for (Int_t i=0 ; i<_nEntries ; i++) {
+      get(i) ;
+      Double_t y = weight() - _sumWeightCarry;
+      Double_t t = _sumWeight + y;
+      _sumWeightCarry = (t - _sumWeight) - y;
+      _sumWeight = t;
+    }
+  }
+  TRACE_CREATE
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RooVectorDataStore::RooVectorDataStore(const char *name, const char *title, RooAbsDataStore& tds, 
@@ -642,6 +776,55 @@ Double_t RooVectorDataStore::weight() const
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the values of the events [first,first+nEvents) in the
+/// column whose buffer is the value of 'real', i.e. the column that get() would
+/// load into real. Columns of the function cache are searched as well. Return
+/// zero if no such column exists.
+
+const Double_t* RooVectorDataStore::getBatch(const RooAbsReal& real, Int_t first, Int_t nEvents) const
+{
+  if (first<0 || first+nEvents>_nEntries) return 0 ;
+
+  const Double_t* buf = &real._value ;
+  for (std::vector<RealVector*>::const_iterator iter = _realStoreList.begin() ; iter!=_realStoreList.end() ; ++iter) {
+    if ((*iter)->_buf==buf) {
+      return (*iter)->_vec0 + first ;
+    }
+  }
+  for (std::vector<RealFullVector*>::const_iterator iter = _realfStoreList.begin() ; iter!=_realfStoreList.end() ; ++iter) {
+    if ((*iter)->_buf==buf) {
+      return (*iter)->_vec0 + first ;
+    }
+  }
+
+  return _cache ? _cache->getBatch(real,first,nEvents) : 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill weights with the weights of the events [first,first+nEvents), as
+/// they would be returned by weight() after loading each event
+
+Bool_t RooVectorDataStore::getWeightBatch(Double_t* weights, Int_t first, Int_t nEvents) const
+{
+  if (first<0 || first+nEvents>_nEntries) return kFALSE ;
+
+  if (_extWgtArray) {
+    std::copy(_extWgtArray+first,_extWgtArray+first+nEvents,weights) ;
+  } else if (_wgtVar) {
+    const Double_t* wgt = getBatch(*_wgtVar,first,nEvents) ;
+    if (!wgt) return kFALSE ;
+    std::copy(wgt,wgt+nEvents,weights) ;
+  } else {
+    std::fill(weights,weights+nEvents,_curWgt) ;
+  }
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Double_t RooVectorDataStore::weightError(RooAbsData::ErrorType etype) const 
@@ -807,6 +990,9 @@ void RooVectorDataStore::loadValues(const RooAbsDataStore *ads, const RooFormula
       }
     } else {
       _varsww.assignValueOnly(*ads->get()) ;
+      if (_wgtVar && ads->isWeighted() && !ads->get()->find(_wgtVar->GetName())) {
+	_wgtVar->setVal(ads->weight()) ;
+      }
     }
 
     destIter->Reset() ;
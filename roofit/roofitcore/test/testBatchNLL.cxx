@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+
+#include "RooAbsPdf.h"
+#include "RooAbsReal.h"
+#include "RooAddPdf.h"
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooDataSet.h"
+#include "RooExponential.h"
+#include "RooFitResult.h"
+#include "RooGaussian.h"
+#include "RooGlobalFunc.h"
+#include "RooMsgService.h"
+#include "RooPolynomial.h"
+#include "RooProdPdf.h"
+#include "RooRandom.h"
+#include "RooRealVar.h"
+
+#include <cmath>
+#include <memory>
+
+namespace {
+
+struct Observables {
+   RooRealVar x{"x", "x", -10, 10};
+   RooRealVar y{"y", "y", -10, 10};
+   RooRealVar w{"w", "w", 0, 5};
+};
+
+// Events spread over the whole range of the observables, so the tails of the p.d.f.s are probed.
+std::unique_ptr<RooDataSet> MakeData(Observables &obs, Bool_t weighted)
+{
+   RooRandom::randomGenerator()->SetSeed(4321);
+   std::unique_ptr<RooDataSet> data;
+   if (weighted) {
+      data.reset(new RooDataSet("data", "", RooArgSet(obs.x, obs.y, obs.w), RooFit::WeightVar(obs.w)));
+   } else {
+      data.reset(new RooDataSet("data", "", RooArgSet(obs.x, obs.y)));
+   }
+   for (Int_t i = 0; i < 3000; ++i) {
+      obs.x.setVal(RooRandom::randomGenerator()->Uniform(-10, 10));
+      obs.y.setVal(RooRandom::randomGenerator()->Gaus(0, 3));
+      if (std::abs(obs.y.getVal()) >= 10)
+         continue;
+      if (weighted) {
+         obs.w.setVal(RooRandom::randomGenerator()->Uniform(0.2, 2));
+         data->add(RooArgSet(obs.x, obs.y), obs.w.getVal());
+      } else {
+         data->add(RooArgSet(obs.x, obs.y));
+      }
+   }
+   return data;
+}
+
+// The NLL values must be the same with and without batch evaluation, for
+// values of param over its whole range.
+void CheckNLL(RooAbsPdf &pdf, RooAbsData &data, RooRealVar &param, Bool_t extended = kFALSE)
+{
+   std::unique_ptr<RooAbsReal> scalar(pdf.createNLL(data, RooFit::Extended(extended)));
+   std::unique_ptr<RooAbsReal> batch(pdf.createNLL(data, RooFit::Extended(extended), RooFit::BatchMode()));
+   const Double_t start = param.getVal();
+   for (Int_t i = 0; i < 7; ++i) {
+      param.setVal(param.getMin() + (i + 0.5) * (param.getMax() - param.getMin()) / 7);
+      EXPECT_DOUBLE_EQ(batch->getVal(), scalar->getVal())
+         << pdf.GetName() << " " << param.GetName() << " = " << param.getVal();
+   }
+   param.setVal(start);
+}
+
+class BatchNLL : public ::testing::TestWithParam<bool> {
+protected:
+   void SetUp() override { RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING); }
+   void TearDown() override { RooMsgService::instance().setGlobalKillBelow(RooFit::INFO); }
+};
+
+} // namespace
+
+TEST_P(BatchNLL, Gaussian)
+{
+   Observables obs;
+   std::unique_ptr<RooDataSet> data = MakeData(obs, GetParam());
+   RooRealVar mean("mean", "mean", -2, 2);
+   RooRealVar sigma("sigma", "sigma", 3, 1, 6);
+   RooGaussian gauss("gauss", "", obs.x, mean, sigma);
+   CheckNLL(gauss, *data, mean);
+   CheckNLL(gauss, *data, sigma);
+}
+
+TEST_P(BatchNLL, Exponential)
+{
+   Observables obs;
+   std::unique_ptr<RooDataSet> data = MakeData(obs, GetParam());
+   RooRealVar c("c", "c", -0.1, -0.5, 0.5);
+   RooExponential expo("expo", "", obs.x, c);
+   CheckNLL(expo, *data, c);
+}
+
+TEST_P(BatchNLL, Polynomial)
+{
+   Observables obs;
+   std::unique_ptr<RooDataSet> data = MakeData(obs, GetParam());
+   RooRealVar a1("a1", "a1", 0.01, -0.02, 0.02);
+   RooRealVar a2("a2", "a2", 0.002, 0.001, 0.01);
+   RooPolynomial poly("poly", "", obs.x, RooArgList(a1, a2));
+   CheckNLL(poly, *data, a1);
+   CheckNLL(poly, *data, a2);
+}
+
+TEST_P(BatchNLL, AddPdf)
+{
+   Observables obs;
+   std::unique_ptr<RooDataSet> data = MakeData(obs, GetParam());
+   RooRealVar mean("mean", "mean", 0, -2, 2);
+   RooRealVar sigma("sigma", "sigma", 3, 1, 6);
+   RooRealVar c("c", "c", -0.1, -0.5, 0.5);
+   RooGaussian gauss("gauss", "", obs.x, mean, sigma);
+   RooExponential expo("expo", "", obs.x, c);
+
+   RooRealVar frac("frac", "frac", 0.4, 0, 1);
+   RooAddPdf sum("sum", "", gauss, expo, frac);
+   CheckNLL(sum, *data, frac);
+   CheckNLL(sum, *data, mean);
+
+   RooRealVar nSig("nSig", "nSig", 1000, 0, 5000);
+   RooRealVar nBkg("nBkg", "nBkg", 2000, 0, 5000);
+   RooAddPdf extSum("extSum", "", RooArgList(gauss, expo), RooArgList(nSig, nBkg));
+   CheckNLL(extSum, *data, nSig, kTRUE);
+   CheckNLL(extSum, *data, c, kTRUE);
+}
+
+TEST_P(BatchNLL, ProdPdf)
+{
+   Observables obs;
+   std::unique_ptr<RooDataSet> data = MakeData(obs, GetParam());
+   RooRealVar meanX("meanX", "meanX", 0, -2, 2);
+   RooRealVar sigmaX("sigmaX", "sigmaX", 2, 1, 4);
+   RooRealVar meanY("meanY", "meanY", 0, -2, 2);
+   RooRealVar sigmaY("sigmaY", "sigmaY", 3, 1, 6);
+   RooGaussian gaussX("gaussX", "", obs.x, meanX, sigmaX);
+   RooGaussian gaussY("gaussY", "", obs.y, meanY, sigmaY);
+
+   RooProdPdf prod("prod", "", gaussX, gaussY);
+   CheckNLL(prod, *data, meanX);
+   CheckNLL(prod, *data, sigmaY);
+
+   // The events in the tails of gaussX are below the cutoff, the second
+   // factor must then be ignored by both evaluations.
+   RooProdPdf prodCut("prodCut", "", gaussX, gaussY, 1e-3);
+   CheckNLL(prodCut, *data, meanY);
+   CheckNLL(prodCut, *data, sigmaX);
+}
+
+TEST_P(BatchNLL, Fit)
+{
+   Observables obs;
+   std::unique_ptr<RooDataSet> data = MakeData(obs, GetParam());
+   RooRealVar mean("mean", "mean", 0.5, -2, 2);
+   RooRealVar sigma("sigma", "sigma", 3, 1, 6);
+   RooRealVar c("c", "c", -0.1, -0.5, 0.5);
+   RooGaussian gauss("gauss", "", obs.y, mean, sigma);
+   RooExponential expo("expo", "", obs.x, c);
+   RooProdPdf prod("prod", "", gauss, expo);
+
+   RooArgSet params(mean, sigma, c);
+   std::unique_ptr<RooArgSet> start(static_cast<RooArgSet *>(params.snapshot()));
+   std::unique_ptr<RooFitResult> scalar(
+      prod.fitTo(*data, RooFit::Save(), RooFit::PrintLevel(-1), RooFit::SumW2Error(kFALSE)));
+   params = *start;
+   std::unique_ptr<RooFitResult> batch(prod.fitTo(*data, RooFit::Save(), RooFit::PrintLevel(-1),
+                                                  RooFit::SumW2Error(kFALSE), RooFit::BatchMode()));
+
+   ASSERT_EQ(scalar->status(), 0);
+   ASSERT_EQ(batch->status(), 0);
+   EXPECT_DOUBLE_EQ(batch->minNll(), scalar->minNll());
+   for (Int_t i = 0; i < scalar->floatParsFinal().getSize(); ++i) {
+      const RooRealVar &p1 = static_cast<const RooRealVar &>(scalar->floatParsFinal()[i]);
+      const RooRealVar &p2 = static_cast<const RooRealVar &>(batch->floatParsFinal()[i]);
+      EXPECT_DOUBLE_EQ(p2.getVal(), p1.getVal()) << p1.GetName();
+      EXPECT_DOUBLE_EQ(p2.getError(), p1.getError()) << p1.GetName();
+   }
+}
+
+INSTANTIATE_TEST_CASE_P(Data, BatchNLL, ::testing::Values(false, true));
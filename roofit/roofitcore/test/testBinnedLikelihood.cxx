@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooBinning.h"
+#include "RooDataHist.h"
+#include "RooHistFunc.h"
+#include "RooNLLVar.h"
+#include "RooRealSumPdf.h"
+#include "RooRealVar.h"
+#include "TMath.h"
+
+#include <memory>
+
+namespace {
+
+// Two samples in two observables with variable bins, added like in HistFactory models.
+struct Model {
+   RooRealVar x{"x", "x", 0, 4};
+   RooRealVar y{"y", "y", 0, 6};
+   RooRealVar mu{"mu", "mu", 1.2, 0, 5};
+   RooRealVar one{"one", "one", 1.};
+   std::unique_ptr<RooDataHist> sigHist, bkgHist;
+   std::unique_ptr<RooHistFunc> sig, bkg;
+   std::unique_ptr<RooRealSumPdf> pdf;
+
+   Model()
+   {
+      Double_t xBounds[] = {0, 0.5, 1.5, 2.5, 4};
+      x.setBinning(RooBinning(4, xBounds));
+      y.setBins(3);
+      sigHist.reset(new RooDataHist("sigHist", "", RooArgSet(x, y)));
+      bkgHist.reset(new RooDataHist("bkgHist", "", RooArgSet(x, y)));
+      for (Int_t i = 0; i < sigHist->numEntries(); ++i) {
+         sigHist->get(i);
+         sigHist->set(1. + i % 4);
+         bkgHist->get(i);
+         bkgHist->set(10. + 3 * i);
+      }
+      sig.reset(new RooHistFunc("sig", "", RooArgSet(x, y), *sigHist));
+      bkg.reset(new RooHistFunc("bkg", "", RooArgSet(x, y), *bkgHist));
+      pdf.reset(new RooRealSumPdf("pdf", "", RooArgList(*sig, *bkg), RooArgList(mu, one), kTRUE));
+      pdf->setAttribute("BinnedLikelihood");
+   }
+
+   // Observed events in the bins of the histogram data
+   std::unique_ptr<RooDataHist> Data()
+   {
+      std::unique_ptr<RooDataHist> data(new RooDataHist("data", "", RooArgSet(x, y)));
+      for (Int_t i = 0; i < data->numEntries(); ++i) {
+         data->get(i);
+         data->set(Double_t(7 + (5 * i) % 11));
+      }
+      return data;
+   }
+
+   std::unique_ptr<RooNLLVar> NLL(RooDataHist &data, Bool_t binnedL)
+   {
+      return std::unique_ptr<RooNLLVar>(new RooNLLVar("nll", "", *pdf, data, kTRUE, 0, 0, 1, RooFit::BulkPartition,
+                                                      kFALSE, kFALSE, kTRUE, binnedL));
+   }
+};
+
+} // namespace
+
+TEST(BinnedLikelihood, TwoObservables)
+{
+   Model m;
+   std::unique_ptr<RooDataHist> data = m.Data();
+   std::unique_ptr<RooNLLVar> nll = m.NLL(*data, kTRUE);
+
+   for (Double_t mu = 0.5; mu < 3; mu += 0.5) {
+      m.mu.setVal(mu);
+      // Sum of log-Poisson terms, the yields are the bin contents of the samples
+      Double_t expected = 0;
+      for (Int_t i = 0; i < data->numEntries(); ++i) {
+         data->get(i);
+         Double_t n = data->weight();
+         m.sigHist->get(i);
+         m.bkgHist->get(i);
+         Double_t yield = (mu * m.sigHist->weight() + m.bkgHist->weight()) * data->binVolume();
+         expected += yield - n * std::log(yield) + TMath::LnGamma(n + 1);
+      }
+      EXPECT_NEAR(nll->getVal(), expected, 1e-9 * std::abs(expected)) << "mu " << mu;
+   }
+}
+
+TEST(BinnedLikelihood, DifferentDataBinning)
+{
+   Model m;
+   // The data have twice as many bins in x as the samples, the binned
+   // likelihood must not be used.
+   m.x.setBins(8);
+   std::unique_ptr<RooDataHist> data = m.Data();
+   std::unique_ptr<RooNLLVar> binned = m.NLL(*data, kTRUE);
+   m.pdf->setAttribute("BinnedLikelihood", kFALSE);
+   std::unique_ptr<RooNLLVar> unbinned = m.NLL(*data, kFALSE);
+
+   for (Double_t mu = 0.5; mu < 3; mu += 0.5) {
+      m.mu.setVal(mu);
+      EXPECT_DOUBLE_EQ(binned->getVal(), unbinned->getVal()) << "mu " << mu;
+   }
+}
@@ -0,0 +1,186 @@
+#include "gtest/gtest.h"
+
+#include "RooAbsPdf.h"
+#include "RooAddPdf.h"
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooDataHist.h"
+#include "RooDataSet.h"
+#include "RooDerivative.h"
+#include "RooExponential.h"
+#include "RooFormulaVar.h"
+#include "RooGaussian.h"
+#include "RooGlobalFunc.h"
+#include "RooHistFunc.h"
+#include "RooMsgService.h"
+#include "RooNLLVar.h"
+#include "RooProdPdf.h"
+#include "RooProduct.h"
+#include "RooRandom.h"
+#include "RooRealSumPdf.h"
+#include "RooRealVar.h"
+
+#include <cmath>
+#include <memory>
+
+namespace {
+
+// Central finite difference of func with respect to var
+Double_t FiniteDifference(RooAbsReal &func, RooRealVar &var)
+{
+   const Double_t x = var.getVal();
+   const Double_t h = 1e-4 * (std::abs(x) + 1);
+   var.setVal(x + h);
+   const Double_t fhi = func.getVal();
+   var.setVal(x - h);
+   const Double_t flo = func.getVal();
+   var.setVal(x);
+   return (fhi - flo) / (2 * h);
+}
+
+// Compare the derivatives of the normalized p.d.f with the ones of RooDerivative
+// at several values of the observable, and check that the values are unchanged.
+void CheckPdf(RooAbsPdf &pdf, RooRealVar &x, const RooArgList &params)
+{
+   RooArgSet nset(x);
+   for (Int_t ip = 0; ip < params.getSize(); ++ip) {
+      RooRealVar &param = static_cast<RooRealVar &>(params[ip]);
+      std::unique_ptr<RooDerivative> deriv(pdf.derivative(param, nset, 1));
+      for (Double_t xv = x.getMin() + 0.3; xv < x.getMax(); xv += 1.1) {
+         x.setVal(xv);
+         const Double_t value = pdf.getVal(nset);
+         const Double_t expected = deriv->getVal();
+         EXPECT_NEAR(pdf.getDerivative(param, &nset), expected, 1e-5 * (std::abs(expected) + value))
+            << pdf.GetName() << " d/d" << param.GetName() << " at x = " << xv;
+         EXPECT_DOUBLE_EQ(pdf.getVal(nset), value) << pdf.GetName() << " at x = " << xv;
+      }
+   }
+}
+
+// Compare the derivatives of a likelihood with finite differences
+void CheckNLL(RooAbsReal &nll, const RooArgList &params)
+{
+   for (Int_t ip = 0; ip < params.getSize(); ++ip) {
+      RooRealVar &param = static_cast<RooRealVar &>(params[ip]);
+      const Double_t value = nll.getVal();
+      const Double_t expected = FiniteDifference(nll, param);
+      EXPECT_NEAR(nll.getDerivative(param), expected, 1e-4 * (std::abs(expected) + 1)) << "d/d" << param.GetName();
+      EXPECT_DOUBLE_EQ(nll.getVal(), value);
+   }
+}
+
+class Derivative : public ::testing::Test {
+protected:
+   void SetUp() override { RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING); }
+   void TearDown() override { RooMsgService::instance().setGlobalKillBelow(RooFit::INFO); }
+};
+
+} // namespace
+
+TEST_F(Derivative, FormulaVar)
+{
+   RooRealVar a("a", "a", 1.3, -5, 5);
+   RooRealVar b("b", "b", 0.4, -5, 5);
+   RooFormulaVar inner("inner", "@0*@1", RooArgList(a, b));
+   RooFormulaVar f("f", "@0*@0+sin(@1)+@2", RooArgList(a, b, inner));
+   for (Double_t av = -2; av < 2; av += 0.7) {
+      a.setVal(av);
+      EXPECT_NEAR(f.getDerivative(a), 2 * av + b.getVal(), 1e-6) << "a = " << av;
+      EXPECT_NEAR(f.getDerivative(b), std::cos(b.getVal()) + av, 1e-6) << "a = " << av;
+   }
+}
+
+TEST_F(Derivative, AddPdf)
+{
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar mean("mean", "mean", 4, 0, 10);
+   RooRealVar sigma("sigma", "sigma", 1.5, 0.5, 5);
+   RooRealVar c("c", "c", -0.3, -2, 0.);
+   RooRealVar frac("frac", "frac", 0.3, 0, 1);
+   RooGaussian gauss("gauss", "", x, mean, sigma);
+   RooExponential expo("expo", "", x, c);
+   RooAddPdf sum("sum", "", gauss, expo, frac);
+   CheckPdf(sum, x, RooArgList(frac, mean, sigma, c));
+}
+
+TEST_F(Derivative, ProdPdf)
+{
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar y("y", "y", 0, 10);
+   RooRealVar mean("mean", "mean", 4, 0, 10);
+   RooRealVar sigma("sigma", "sigma", 1.5, 0.5, 5);
+   RooRealVar c("c", "c", -0.3, -2, 0.);
+   RooGaussian gauss("gauss", "", x, mean, sigma);
+   RooExponential expo("expo", "", y, c);
+   RooProdPdf prod("prod", "", gauss, expo);
+   y.setVal(2.5);
+   RooArgSet nset(x, y);
+   for (RooRealVar *param : {&mean, &sigma, &c}) {
+      std::unique_ptr<RooDerivative> deriv(prod.derivative(*param, nset, 1));
+      for (Double_t xv = 0.3; xv < 10; xv += 1.1) {
+         x.setVal(xv);
+         const Double_t expected = deriv->getVal();
+         EXPECT_NEAR(prod.getDerivative(*param, &nset), expected, 1e-5 * (std::abs(expected) + prod.getVal(nset)))
+            << "d/d" << param->GetName() << " at x = " << xv;
+      }
+   }
+}
+
+TEST_F(Derivative, RealSumPdf)
+{
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar a("a", "a", 0.5, 0, 2);
+   RooRealVar b("b", "b", 0.1, -1, 1);
+   RooFormulaVar lin("lin", "1+@0*@1", RooArgList(b, x));
+   RooFormulaVar quad("quad", "@0*@0", RooArgList(x));
+   RooRealVar one("one", "one", 1);
+   RooRealSumPdf sum("sum", "", RooArgList(lin, quad), RooArgList(one, a));
+   CheckPdf(sum, x, RooArgList(a, b));
+}
+
+TEST_F(Derivative, UnbinnedExtendedNLL)
+{
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar mean("mean", "mean", 4, 0, 10);
+   RooRealVar sigma("sigma", "sigma", 1.5, 0.5, 5);
+   RooRealVar c("c", "c", -0.3, -2, 0.);
+   RooRealVar nSig("nSig", "nSig", 300, 0, 2000);
+   RooRealVar nBkg("nBkg", "nBkg", 700, 0, 2000);
+   RooGaussian gauss("gauss", "", x, mean, sigma);
+   RooExponential expo("expo", "", x, c);
+   RooAddPdf sum("sum", "", RooArgList(gauss, expo), RooArgList(nSig, nBkg));
+
+   RooRandom::randomGenerator()->SetSeed(1234);
+   std::unique_ptr<RooDataSet> data(sum.generate(x, 1000));
+   mean.setVal(4.3);
+   nSig.setVal(350);
+   std::unique_ptr<RooAbsReal> nll(sum.createNLL(*data, RooFit::Extended()));
+   CheckNLL(*nll, RooArgList(mean, sigma, c, nSig, nBkg));
+}
+
+TEST_F(Derivative, BinnedNLL)
+{
+   RooRealVar x("x", "x", 0, 10);
+   x.setBins(10);
+   RooDataHist sigHist("sigHist", "", x);
+   RooDataHist bkgHist("bkgHist", "", x);
+   RooDataHist data("data", "", x);
+   for (Int_t i = 0; i < 10; ++i) {
+      x.setBin(i);
+      sigHist.set(x, 5. + 20 * std::exp(-0.5 * (i - 4) * (i - 4)));
+      bkgHist.set(x, 40. - 3 * i);
+      data.set(x, 50. + (7 * i) % 13);
+   }
+   RooHistFunc sig("sig", "", x, sigHist);
+   RooHistFunc bkg("bkg", "", x, bkgHist);
+   RooRealVar mu("mu", "mu", 1.2, 0, 5);
+   RooRealVar alpha("alpha", "alpha", 0.1, -3, 3);
+   RooFormulaVar bkgNorm("bkgNorm", "1+0.1*@0", RooArgList(alpha));
+   RooProduct sigScaled("sigScaled", "", RooArgList(mu, sig));
+   RooRealVar one("one", "one", 1);
+   RooRealSumPdf model("model", "", RooArgList(sigScaled, bkg), RooArgList(one, bkgNorm), kTRUE);
+   model.setAttribute("BinnedLikelihood");
+
+   RooNLLVar nll("nll", "", model, data, kTRUE, 0, 0, 1, RooFit::BulkPartition, kFALSE, kFALSE, kTRUE, kTRUE);
+   CheckNLL(nll, RooArgList(mu, alpha));
+}
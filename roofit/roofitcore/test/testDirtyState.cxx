@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+
+#include "RooArgList.h"
+#include "RooFormulaVar.h"
+#include "RooRealVar.h"
+
+namespace {
+
+// Diamond-shaped graph: x feeds a and b, which both feed top. Besides the
+// value links of the formulas, the nodes are linked for shape propagation.
+class DirtyState : public ::testing::Test {
+protected:
+   RooRealVar x{"x", "x", 1., 0., 10.};
+   RooFormulaVar a{"a", "x+1", RooArgList(x)};
+   RooFormulaVar b{"b", "2*x", RooArgList(x)};
+   RooFormulaVar top{"top", "a*b", RooArgList(a, b)};
+
+   void SetUp() override
+   {
+      a.addServer(x, kFALSE, kTRUE);
+      b.addServer(x, kFALSE, kTRUE);
+      top.addServer(a, kFALSE, kTRUE);
+      top.addServer(b, kFALSE, kTRUE);
+      Clear();
+   }
+
+   // Evaluate the graph, which clears the value dirty flags, and clear the shape dirty flags
+   void Clear()
+   {
+      top.getVal();
+      a.clearShapeDirty();
+      b.clearShapeDirty();
+      top.clearShapeDirty();
+      ASSERT_FALSE(a.isValueDirty() || b.isValueDirty() || top.isValueDirty());
+   }
+};
+
+} // namespace
+
+TEST_F(DirtyState, ValueDirty)
+{
+   // Each propagation reaches top, also through both paths of the diamond
+   for (Int_t i = 0; i < 3; ++i) {
+      x.setValueDirty();
+      EXPECT_TRUE(a.isValueDirty());
+      EXPECT_TRUE(b.isValueDirty());
+      EXPECT_TRUE(top.isValueDirty());
+      EXPECT_FALSE(a.isShapeDirty() || b.isShapeDirty() || top.isShapeDirty());
+      Clear();
+   }
+
+   a.setValueDirty();
+   EXPECT_TRUE(a.isValueDirty());
+   EXPECT_FALSE(b.isValueDirty());
+   EXPECT_TRUE(top.isValueDirty());
+   Clear();
+
+   x.setVal(2.);
+   EXPECT_TRUE(top.isValueDirty());
+   EXPECT_DOUBLE_EQ(top.getVal(), 3. * 4.);
+}
+
+TEST_F(DirtyState, ShapeDirty)
+{
+   for (Int_t i = 0; i < 3; ++i) {
+      x.setShapeDirty();
+      EXPECT_TRUE(a.isShapeDirty());
+      EXPECT_TRUE(b.isShapeDirty());
+      EXPECT_TRUE(top.isShapeDirty());
+      // A shape change also invalidates the values of the clients
+      EXPECT_TRUE(a.isValueDirty());
+      EXPECT_TRUE(b.isValueDirty());
+      EXPECT_TRUE(top.isValueDirty());
+      Clear();
+   }
+
+   b.setShapeDirty();
+   EXPECT_FALSE(a.isShapeDirty());
+   EXPECT_TRUE(b.isShapeDirty());
+   EXPECT_TRUE(top.isShapeDirty());
+   EXPECT_FALSE(a.isValueDirty());
+   EXPECT_TRUE(top.isValueDirty());
+}
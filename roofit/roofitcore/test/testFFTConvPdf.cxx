@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooFFTConvPdf.h"
+#include "RooFormulaVar.h"
+#include "RooGaussian.h"
+#include "RooMsgService.h"
+#include "RooRealVar.h"
+#include "TROOT.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Values on a grid of (x,y) of the convolution of a Gaussian whose mean and
+// width depend on y with a Gaussian resolution, conditional on y. The cache
+// has one slice per bin of y, which are filled in parallel with implicit
+// multi-threading.
+std::vector<Double_t> ConvolutionValues()
+{
+   RooRealVar x("x", "x", -10, 10);
+   RooRealVar y("y", "y", 0, 1);
+   x.setBins(1000, "cache");
+   y.setBins(20, "cache");
+   RooFormulaVar mean("mean", "2*y-1", RooArgList(y));
+   RooFormulaVar width("width", "0.5+y", RooArgList(y));
+   RooGaussian model("model", "", x, mean, width);
+   RooRealVar mres("mres", "mres", 0.2);
+   RooRealVar sres("sres", "sres", 0.8);
+   RooGaussian resolution("resolution", "", x, mres, sres);
+   RooFFTConvPdf conv("conv", "", x, model, resolution);
+   conv.setCacheObservables(RooArgSet(y));
+
+   std::vector<Double_t> values;
+   const RooArgSet normSet(x);
+   for (Double_t yv = 0.025; yv < 1; yv += 0.05) {
+      y.setVal(yv);
+      for (Double_t xv = -6; xv <= 6; xv += 0.5) {
+         x.setVal(xv);
+         values.push_back(conv.getVal(normSet));
+      }
+   }
+   return values;
+}
+
+} // namespace
+
+TEST(RooFFTConvPdf, ParallelSlices)
+{
+   RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING);
+   const std::vector<Double_t> serial = ConvolutionValues();
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT(4);
+#endif
+   const std::vector<Double_t> parallel = ConvolutionValues();
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+   RooMsgService::instance().setGlobalKillBelow(RooFit::INFO);
+
+   ASSERT_EQ(parallel.size(), serial.size());
+   for (size_t i = 0; i < serial.size(); ++i) {
+      EXPECT_NEAR(parallel[i], serial[i], 1e-10 * std::abs(serial[i]) + 1e-14) << "point " << i;
+   }
+}
@@ -0,0 +1,230 @@
+#include "gtest/gtest.h"
+
+#include "RooAbsReal.h"
+#include "RooArgSet.h"
+#include "RooCategory.h"
+#include "RooDataHist.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooGlobalFunc.h"
+#include "RooLinkedTreeDataStore.h"
+#include "RooMsgService.h"
+#include "RooRealVar.h"
+#include "RooVectorDataStore.h"
+#include "TMemFile.h"
+#include "TRandom3.h"
+#include "TTree.h"
+
+#include <cmath>
+#include <memory>
+
+namespace {
+
+// Tree with values partly outside the ranges of the observables and
+// category indices partly undefined, the linked and imported datasets
+// must drop the same entries.
+struct Events {
+   RooRealVar x{"x", "x", -3, 3};
+   RooRealVar y{"y", "y", 0, 10};
+   RooRealVar w{"w", "w", 0, 5};
+   RooCategory c{"c", "c"};
+   std::unique_ptr<TTree> tree;
+
+   Events()
+   {
+      c.defineType("A", 0);
+      c.defineType("B", 1);
+      tree.reset(new TTree("events", "events"));
+      tree->SetDirectory(nullptr);
+      Double_t xv, yv, wv;
+      Int_t cv;
+      tree->Branch("x", &xv, "x/D");
+      tree->Branch("y", &yv, "y/D");
+      tree->Branch("w", &wv, "w/D");
+      tree->Branch("c", &cv, "c/I");
+      TRandom3 rnd(1234);
+      for (Int_t i = 0; i < 1000; ++i) {
+         xv = rnd.Gaus(0, 1.5);
+         yv = rnd.Uniform(-1, 11);
+         wv = rnd.Uniform(0.1, 2);
+         cv = rnd.Integer(3);
+         tree->Fill();
+      }
+   }
+
+   RooArgSet Vars(Bool_t weighted) { return weighted ? RooArgSet(x, y, c, w) : RooArgSet(x, y, c); }
+};
+
+RooLinkedTreeDataStore &LinkedStore(RooDataSet &data)
+{
+   return *static_cast<RooLinkedTreeDataStore *>(data.store());
+}
+
+// Compare all events of two datasets, in order and in reverse order
+void CheckEqual(const RooAbsData &data, const RooAbsData &ref)
+{
+   ASSERT_EQ(data.numEntries(), ref.numEntries());
+   EXPECT_DOUBLE_EQ(data.sumEntries(), ref.sumEntries());
+   EXPECT_EQ(data.isWeighted(), ref.isWeighted());
+   for (Int_t n = 0; n < 2 * ref.numEntries(); ++n) {
+      const Int_t i = n < ref.numEntries() ? n : 2 * ref.numEntries() - 1 - n;
+      const RooArgSet *row = data.get(i);
+      const RooArgSet *refRow = ref.get(i);
+      for (RooFIter it = refRow->fwdIterator(); RooAbsArg *refArg = it.next();) {
+         const RooAbsArg *arg = row->find(refArg->GetName());
+         ASSERT_TRUE(arg != nullptr) << refArg->GetName();
+         if (const RooAbsReal *refReal = dynamic_cast<const RooAbsReal *>(refArg)) {
+            EXPECT_EQ(static_cast<const RooAbsReal *>(arg)->getVal(), refReal->getVal())
+               << refArg->GetName() << " of event " << i;
+         } else {
+            EXPECT_EQ(static_cast<const RooAbsCategory *>(arg)->getIndex(),
+                      static_cast<const RooAbsCategory *>(refArg)->getIndex())
+               << refArg->GetName() << " of event " << i;
+         }
+      }
+      EXPECT_EQ(data.weight(), ref.weight()) << "event " << i;
+   }
+}
+
+class LinkedTreeDataStore : public ::testing::Test {
+protected:
+   void SetUp() override { RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING); }
+   void TearDown() override { RooMsgService::instance().setGlobalKillBelow(RooFit::INFO); }
+};
+
+} // namespace
+
+TEST_F(LinkedTreeDataStore, Selection)
+{
+   Events ev;
+   ev.x.setRange("central", -1, 1);
+   RooDataSet linked("linked", "", ev.Vars(kFALSE), RooFit::LinkTree(*ev.tree), RooFit::Cut("y<7"),
+                     RooFit::CutRange("central"));
+   RooDataSet ref("ref", "", ev.Vars(kFALSE), RooFit::Import(*ev.tree), RooFit::Cut("y<7"),
+                  RooFit::CutRange("central"));
+   EXPECT_GT(ref.numEntries(), 0);
+   EXPECT_LT(ref.numEntries(), 1000);
+   CheckEqual(linked, ref);
+}
+
+TEST_F(LinkedTreeDataStore, ChunkBoundaries)
+{
+   Events ev;
+   RooDataSet linked("linked", "", ev.Vars(kFALSE), RooFit::LinkTree(*ev.tree), RooFit::Cut("x>-1"));
+   RooDataSet ref("ref", "", ev.Vars(kFALSE), RooFit::Import(*ev.tree), RooFit::Cut("x>-1"));
+   for (Int_t chunkSize : {1, 7, 64, 100000}) {
+      LinkedStore(linked).setChunkSize(chunkSize);
+      CheckEqual(linked, ref);
+   }
+}
+
+TEST_F(LinkedTreeDataStore, Batches)
+{
+   Events ev;
+   RooDataSet linked("linked", "", ev.Vars(kTRUE), RooFit::LinkTree(*ev.tree), RooFit::WeightVar(ev.w));
+   RooDataSet ref("ref", "", ev.Vars(kTRUE), RooFit::Import(*ev.tree), RooFit::WeightVar(ev.w));
+   RooLinkedTreeDataStore &store = LinkedStore(linked);
+   store.setChunkSize(16);
+   const RooAbsReal &x = static_cast<const RooAbsReal &>((*linked.get())["x"]);
+
+   for (Int_t first : {0, 3, 16, 40}) {
+      const Double_t *values = store.getBatch(x, first, 8);
+      Double_t weights[8];
+      ASSERT_TRUE(values != nullptr) << "first " << first;
+      ASSERT_TRUE(store.getWeightBatch(weights, first, 8)) << "first " << first;
+      for (Int_t i = 0; i < 8; ++i) {
+         ref.get(first + i);
+         EXPECT_EQ(values[i], ref.get()->getRealValue("x")) << "event " << first + i;
+         EXPECT_EQ(weights[i], ref.weight()) << "event " << first + i;
+      }
+   }
+   // A batch may not span two chunks
+   EXPECT_TRUE(store.getBatch(x, 12, 8) == nullptr);
+}
+
+TEST_F(LinkedTreeDataStore, Weights)
+{
+   Events ev;
+   RooDataSet linked("linked", "", ev.Vars(kTRUE), RooFit::LinkTree(*ev.tree), RooFit::WeightVar(ev.w),
+                     RooFit::Cut("c==1"));
+   RooDataSet ref("ref", "", ev.Vars(kTRUE), RooFit::Import(*ev.tree), RooFit::WeightVar(ev.w), RooFit::Cut("c==1"));
+   EXPECT_TRUE(linked.isWeighted());
+   CheckEqual(linked, ref);
+}
+
+TEST_F(LinkedTreeDataStore, Reduce)
+{
+   Events ev;
+   RooDataSet linked("linked", "", ev.Vars(kTRUE), RooFit::LinkTree(*ev.tree), RooFit::WeightVar(ev.w));
+   RooDataSet ref("ref", "", ev.Vars(kTRUE), RooFit::Import(*ev.tree), RooFit::WeightVar(ev.w));
+   std::unique_ptr<RooAbsData> reduced(linked.reduce(RooFit::SelectVars(RooArgSet(ev.x, ev.c)), RooFit::Cut("x<0.5")));
+   std::unique_ptr<RooAbsData> refReduced(ref.reduce(RooFit::SelectVars(RooArgSet(ev.x, ev.c)), RooFit::Cut("x<0.5")));
+   EXPECT_TRUE(dynamic_cast<RooLinkedTreeDataStore *>(reduced->store()) == nullptr);
+   CheckEqual(*reduced, *refReduced);
+}
+
+TEST_F(LinkedTreeDataStore, Binning)
+{
+   Events ev;
+   ev.x.setBins(12);
+   ev.y.setBins(5);
+   RooDataSet linked("linked", "", RooArgSet(ev.x, ev.y, ev.w), RooFit::LinkTree(*ev.tree), RooFit::WeightVar(ev.w));
+   RooDataSet ref("ref", "", RooArgSet(ev.x, ev.y, ev.w), RooFit::Import(*ev.tree), RooFit::WeightVar(ev.w));
+   std::unique_ptr<RooDataHist> hist(linked.binnedClone());
+   std::unique_ptr<RooDataHist> refHist(ref.binnedClone());
+   CheckEqual(*hist, *refHist);
+}
+
+TEST_F(LinkedTreeDataStore, ConvertToVectorStore)
+{
+   Events ev;
+   RooDataSet linked("linked", "", ev.Vars(kTRUE), RooFit::LinkTree(*ev.tree), RooFit::WeightVar(ev.w),
+                     RooFit::Cut("y>2"));
+   RooDataSet ref("ref", "", ev.Vars(kTRUE), RooFit::Import(*ev.tree), RooFit::WeightVar(ev.w), RooFit::Cut("y>2"));
+   EXPECT_TRUE(linked.tree() == nullptr);
+   std::unique_ptr<TTree> cloned(linked.GetClonedTree());
+   ASSERT_TRUE(cloned != nullptr);
+   EXPECT_EQ(cloned->GetEntries(), ref.numEntries());
+
+   linked.convertToVectorStore();
+   EXPECT_TRUE(dynamic_cast<RooVectorDataStore *>(linked.store()) != nullptr);
+   CheckEqual(linked, ref);
+}
+
+// A dataset linked to a tree is written with its events
+TEST_F(LinkedTreeDataStore, Write)
+{
+   Events ev;
+   RooDataSet linked("linked", "", ev.Vars(kTRUE), RooFit::LinkTree(*ev.tree), RooFit::WeightVar(ev.w),
+                     RooFit::Cut("x>0"));
+   TMemFile file("testLinkedTreeDataStore.root", "RECREATE");
+   file.WriteTObject(&linked, "linked");
+   EXPECT_TRUE(dynamic_cast<RooLinkedTreeDataStore *>(linked.store()) != nullptr);
+
+   std::unique_ptr<RooDataSet> read(static_cast<RooDataSet *>(file.Get("linked")));
+   ASSERT_TRUE(read != nullptr);
+   EXPECT_TRUE(dynamic_cast<RooLinkedTreeDataStore *>(read->store()) == nullptr);
+   CheckEqual(*read, linked);
+}
+
+// Test statistics of a linked tree are calculated serially
+TEST_F(LinkedTreeDataStore, Parallel)
+{
+   Events ev;
+   RooDataSet linked("linked", "", RooArgSet(ev.x, ev.w), RooFit::LinkTree(*ev.tree), RooFit::WeightVar(ev.w));
+   RooDataSet ref("ref", "", RooArgSet(ev.x, ev.w), RooFit::Import(*ev.tree), RooFit::WeightVar(ev.w));
+   RooRealVar mean("mean", "mean", 0.2, -1, 1);
+   RooRealVar sigma("sigma", "sigma", 1.2, 0.5, 3);
+   RooGaussian gauss("gauss", "", ev.x, mean, sigma);
+
+   RooMsgService::instance().setGlobalKillBelow(RooFit::ERROR);
+   std::unique_ptr<RooAbsReal> threads(gauss.createNLL(linked, RooFit::NumThreads(2)));
+   std::unique_ptr<RooAbsReal> processes(gauss.createNLL(linked, RooFit::NumCPU(2)));
+   std::unique_ptr<RooAbsReal> serial(gauss.createNLL(ref));
+   for (Double_t m = -0.8; m < 1; m += 0.4) {
+      mean.setVal(m);
+      const Double_t expected = serial->getVal();
+      EXPECT_NEAR(threads->getVal(), expected, 1e-10 * std::abs(expected)) << "mean " << m;
+      EXPECT_NEAR(processes->getVal(), expected, 1e-10 * std::abs(expected)) << "mean " << m;
+   }
+}
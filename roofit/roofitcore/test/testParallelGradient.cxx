@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+
+#include "Math/Factory.h"
+#include "Math/IFunction.h"
+#include "Math/IOptions.h"
+#include "Math/Minimizer.h"
+#include "Math/MinimizerOptions.h"
+#include "RooAddPdf.h"
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooDataSet.h"
+#include "RooExponential.h"
+#include "RooFitResult.h"
+#include "RooGaussian.h"
+#include "RooGlobalFunc.h"
+#include "RooMinimizer.h"
+#include "RooMsgService.h"
+#include "RooRandom.h"
+#include "RooRealVar.h"
+#include "TROOT.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Quadratic function with its minimum at x[i] = 0.1*i, which records the
+// largest number of calls running concurrently.
+class Quadratic : public ROOT::Math::IBaseFunctionMultiDim {
+public:
+   Quadratic(unsigned int ndim, bool threadSafe) : fNDim(ndim), fThreadSafe(threadSafe), fInside(0), fMaxInside(0) {}
+
+   ROOT::Math::IBaseFunctionMultiDim *Clone() const override { return new Quadratic(fNDim, fThreadSafe); }
+   unsigned int NDim() const override { return fNDim; }
+   bool IsThreadSafe() const override { return fThreadSafe; }
+
+   int MaxConcurrentCalls() const { return fMaxInside; }
+
+private:
+   double DoEval(const double *x) const override
+   {
+      int inside = ++fInside;
+      int maxInside = fMaxInside;
+      while (inside > maxInside && !fMaxInside.compare_exchange_weak(maxInside, inside)) {
+      }
+      double f = 0;
+      for (unsigned int i = 0; i < fNDim; ++i)
+         f += (i + 1) * (x[i] - 0.1 * i) * (x[i] - 0.1 * i);
+      // Slow the evaluation down, so that concurrent calls overlap
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+      --fInside;
+      return f;
+   }
+
+   unsigned int fNDim;
+   bool fThreadSafe;
+   mutable std::atomic<int> fInside;
+   mutable std::atomic<int> fMaxInside;
+};
+
+// Minimize func with Minuit2 and check the minimum
+void Minimize(Quadratic &func)
+{
+   std::unique_ptr<ROOT::Math::Minimizer> min(ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad"));
+   ASSERT_TRUE(min != nullptr);
+   min->SetFunction(func);
+   for (unsigned int i = 0; i < func.NDim(); ++i)
+      min->SetVariable(i, "x" + std::to_string(i), 1., 0.1);
+   ASSERT_TRUE(min->Minimize());
+   for (unsigned int i = 0; i < func.NDim(); ++i)
+      EXPECT_NEAR(min->X()[i], 0.1 * i, 1e-4) << "x" << i;
+}
+
+class ParallelGradient : public ::testing::Test {
+protected:
+   void SetUp() override
+   {
+      RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING);
+#ifdef R__USE_IMT
+      ROOT::EnableImplicitMT(4);
+#endif
+   }
+   void TearDown() override
+   {
+#ifdef R__USE_IMT
+      ROOT::DisableImplicitMT();
+#endif
+      RooMsgService::instance().setGlobalKillBelow(RooFit::INFO);
+   }
+};
+
+} // namespace
+
+// A function that does not declare itself thread safe is never called concurrently
+TEST_F(ParallelGradient, NotThreadSafe)
+{
+   Quadratic func(8, false);
+   Minimize(func);
+   EXPECT_EQ(func.MaxConcurrentCalls(), 1);
+}
+
+TEST_F(ParallelGradient, ThreadSafe)
+{
+   Quadratic func(8, true);
+   Minimize(func);
+#ifdef R__USE_IMT
+   EXPECT_GT(func.MaxConcurrentCalls(), 1);
+#endif
+}
+
+// The ParallelGradient option of Minuit2 switches the parallel gradient off
+TEST_F(ParallelGradient, OptionOff)
+{
+   ROOT::Math::IOptions &opts = ROOT::Math::MinimizerOptions::Default("Minuit2");
+   opts.SetValue("ParallelGradient", 0);
+   Quadratic func(8, true);
+   Minimize(func);
+   opts.SetValue("ParallelGradient", 1);
+   EXPECT_EQ(func.MaxConcurrentCalls(), 1);
+}
+
+// A fit with clones of the likelihood gives the same result as a sequential one
+TEST_F(ParallelGradient, RooMinimizer)
+{
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar mean("mean", "mean", 4, 0, 10);
+   RooRealVar sigma("sigma", "sigma", 1, 0.2, 5);
+   RooRealVar c("c", "c", -0.3, -2, 0.);
+   RooRealVar nSig("nSig", "nSig", 1500, 0, 10000);
+   RooRealVar nBkg("nBkg", "nBkg", 3500, 0, 10000);
+   RooGaussian gauss("gauss", "", x, mean, sigma);
+   RooExponential expo("expo", "", x, c);
+   RooAddPdf model("model", "", RooArgList(gauss, expo), RooArgList(nSig, nBkg));
+
+   RooRandom::randomGenerator()->SetSeed(1234);
+   std::unique_ptr<RooDataSet> data(model.generate(x, 5000));
+   std::unique_ptr<RooAbsReal> nll(model.createNLL(*data, RooFit::Extended()));
+   RooArgSet params(mean, sigma, c, nSig, nBkg);
+   mean.setVal(4.4);
+   sigma.setVal(1.3);
+   std::unique_ptr<RooArgSet> start(static_cast<RooArgSet *>(params.snapshot()));
+
+   std::unique_ptr<RooFitResult> results[2];
+   for (Int_t nClones = 0; nClones < 2; ++nClones) {
+      params = *start;
+      RooMinimizer m(*nll);
+      m.setPrintLevel(-1);
+      m.setParallelGradient(3 * nClones);
+      m.minimize("Minuit2", "Migrad");
+      m.hesse();
+      results[nClones].reset(m.save());
+   }
+   params = *start;
+
+   ASSERT_EQ(results[0]->status(), 0);
+   ASSERT_EQ(results[1]->status(), 0);
+   EXPECT_NEAR(results[1]->minNll(), results[0]->minNll(), 1e-6);
+   for (Int_t i = 0; i < results[0]->floatParsFinal().getSize(); ++i) {
+      const RooRealVar &p1 = static_cast<const RooRealVar &>(results[0]->floatParsFinal()[i]);
+      const RooRealVar &p2 = static_cast<const RooRealVar &>(results[1]->floatParsFinal()[i]);
+      EXPECT_NEAR(p2.getVal(), p1.getVal(), 1e-3 * p1.getError()) << p1.GetName();
+      EXPECT_NEAR(p2.getError(), p1.getError(), 1e-3 * p1.getError()) << p1.GetName();
+   }
+}
@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+
+#include "RooAbsPdf.h"
+#include "RooAbsReal.h"
+#include "RooAddPdf.h"
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooDataSet.h"
+#include "RooExponential.h"
+#include "RooFitResult.h"
+#include "RooGaussian.h"
+#include "RooGenericPdf.h"
+#include "RooGlobalFunc.h"
+#include "RooMsgService.h"
+#include "RooRandom.h"
+#include "RooRealVar.h"
+#include "TROOT.h"
+
+#include <cmath>
+#include <memory>
+
+namespace {
+
+// The NLL must be the same in thread mode and serially, for values of
+// param over its whole range.
+void CheckNLL(RooAbsPdf &pdf, RooAbsData &data, RooRealVar &param, Bool_t extended)
+{
+   std::unique_ptr<RooAbsReal> serial(pdf.createNLL(data, RooFit::Extended(extended)));
+   std::unique_ptr<RooAbsReal> threads(pdf.createNLL(data, RooFit::Extended(extended), RooFit::NumThreads(4)));
+   const Double_t start = param.getVal();
+   for (Int_t i = 0; i < 7; ++i) {
+      param.setVal(param.getMin() + (i + 0.5) * (param.getMax() - param.getMin()) / 7);
+      const Double_t expected = serial->getVal();
+      EXPECT_NEAR(threads->getVal(), expected, 1e-10 * std::abs(expected))
+         << pdf.GetName() << " " << param.GetName() << " = " << param.getVal();
+   }
+   param.setVal(start);
+}
+
+// Fit the p.d.f serially and in thread mode and compare the results
+void CheckFit(RooAbsPdf &pdf, RooAbsData &data, const RooArgSet &params, Bool_t extended)
+{
+   RooArgSet floating(params);
+   std::unique_ptr<RooArgSet> start(static_cast<RooArgSet *>(floating.snapshot()));
+   std::unique_ptr<RooFitResult> serial(
+      pdf.fitTo(data, RooFit::Save(), RooFit::PrintLevel(-1), RooFit::Extended(extended)));
+   floating = *start;
+   std::unique_ptr<RooFitResult> threads(pdf.fitTo(data, RooFit::Save(), RooFit::PrintLevel(-1),
+                                                   RooFit::Extended(extended), RooFit::NumThreads(4)));
+   floating = *start;
+
+   ASSERT_EQ(serial->status(), 0);
+   ASSERT_EQ(threads->status(), 0);
+   EXPECT_NEAR(threads->minNll(), serial->minNll(), 1e-6 * std::abs(serial->minNll()));
+   for (Int_t i = 0; i < serial->floatParsFinal().getSize(); ++i) {
+      const RooRealVar &p1 = static_cast<const RooRealVar &>(serial->floatParsFinal()[i]);
+      const RooRealVar &p2 = static_cast<const RooRealVar &>(threads->floatParsFinal()[i]);
+      EXPECT_NEAR(p2.getVal(), p1.getVal(), 1e-3 * p1.getError()) << p1.GetName();
+      EXPECT_NEAR(p2.getError(), p1.getError(), 1e-3 * p1.getError()) << p1.GetName();
+   }
+}
+
+class ThreadNLL : public ::testing::Test {
+protected:
+   void SetUp() override
+   {
+      RooMsgService::instance().setGlobalKillBelow(RooFit::ERROR);
+#ifdef R__USE_IMT
+      ROOT::EnableImplicitMT(4);
+#endif
+   }
+   void TearDown() override
+   {
+#ifdef R__USE_IMT
+      ROOT::DisableImplicitMT();
+#endif
+      RooMsgService::instance().setGlobalKillBelow(RooFit::INFO);
+   }
+};
+
+} // namespace
+
+TEST_F(ThreadNLL, ExtendedAddPdf)
+{
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar mean("mean", "mean", 4, 0, 10);
+   RooRealVar sigma("sigma", "sigma", 1, 0.2, 5);
+   RooRealVar c("c", "c", -0.3, -2, 0.);
+   RooRealVar nSig("nSig", "nSig", 1500, 0, 10000);
+   RooRealVar nBkg("nBkg", "nBkg", 3500, 0, 10000);
+   RooGaussian gauss("gauss", "", x, mean, sigma);
+   RooExponential expo("expo", "", x, c);
+   RooAddPdf model("model", "", RooArgList(gauss, expo), RooArgList(nSig, nBkg));
+
+   RooRandom::randomGenerator()->SetSeed(1234);
+   std::unique_ptr<RooDataSet> data(model.generate(x, 5000));
+   mean.setVal(4.4);
+   sigma.setVal(1.3);
+
+   CheckNLL(model, *data, mean, kTRUE);
+   CheckNLL(model, *data, nSig, kTRUE);
+   CheckFit(model, *data, RooArgSet(mean, sigma, c, nSig, nBkg), kTRUE);
+}
+
+// The normalization of the p.d.f is a numerical 2D integral, whose values are
+// stored in the expensive object cache by all threads.
+TEST_F(ThreadNLL, NumericIntegral)
+{
+   RooRealVar x("x", "x", -5, 5);
+   RooRealVar y("y", "y", -5, 5);
+   RooRealVar a("a", "a", 0.8, 0.2, 3);
+   RooRealVar rho("rho", "rho", 0.3, -0.8, 0.8);
+   RooGenericPdf model("model", "", "exp(-0.5*(x*x+y*y-2*rho*x*y)/(a*a))", RooArgList(x, y, a, rho));
+
+   RooRandom::randomGenerator()->SetSeed(4321);
+   std::unique_ptr<RooDataSet> data(model.generate(RooArgSet(x, y), 2000));
+   a.setVal(1.1);
+   rho.setVal(0.1);
+
+   CheckNLL(model, *data, a, kFALSE);
+   CheckNLL(model, *data, rho, kFALSE);
+   CheckFit(model, *data, RooArgSet(a, rho), kFALSE);
+}
+
+// The partitions read the entries of the data of the first one through a view,
+// also after the data was replaced.
+TEST_F(ThreadNLL, SetData)
+{
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar mean("mean", "mean", 4, 0, 10);
+   RooRealVar sigma("sigma", "sigma", 1, 0.2, 5);
+   RooGaussian gauss("gauss", "", x, mean, sigma);
+
+   RooRandom::randomGenerator()->SetSeed(2345);
+   std::unique_ptr<RooDataSet> data1(gauss.generate(x, 1000));
+   mean.setVal(5.);
+   std::unique_ptr<RooDataSet> data2(gauss.generate(x, 3000));
+
+   std::unique_ptr<RooAbsReal> serial(gauss.createNLL(*data1));
+   std::unique_ptr<RooAbsReal> threads(gauss.createNLL(*data1, RooFit::NumThreads(4)));
+   EXPECT_NEAR(threads->getVal(), serial->getVal(), 1e-10 * std::abs(serial->getVal()));
+
+   serial->setData(*data2);
+   threads->setData(*data2);
+   data1.reset();
+   EXPECT_NEAR(threads->getVal(), serial->getVal(), 1e-10 * std::abs(serial->getVal()));
+}
+
+TEST(RooDataSet, ViewClone)
+{
+   RooRealVar x("x", "x", 0, 10);
+   RooRealVar w("w", "w", 0, 5);
+   RooDataSet data("data", "", RooArgSet(x, w), RooFit::WeightVar(w));
+   for (Int_t i = 0; i < 100; ++i) {
+      x.setVal(0.1 * i);
+      data.add(RooArgSet(x), 1. + (i % 3));
+   }
+
+   std::unique_ptr<RooDataSet> view(data.viewClone(20, 50));
+   ASSERT_NE(view, nullptr);
+   ASSERT_EQ(view->numEntries(), 30);
+   Double_t sumw = 0;
+   for (Int_t i = 0; i < 30; ++i) {
+      const Double_t value = data.get(20 + i)->getRealValue("x");
+      sumw += data.weight();
+      EXPECT_DOUBLE_EQ(view->get(i)->getRealValue("x"), value);
+      EXPECT_DOUBLE_EQ(view->weight(), data.weight());
+   }
+   EXPECT_DOUBLE_EQ(view->sumEntries(), sumw);
+
+   // A copy of the view is a view of the same entries
+   std::unique_ptr<RooDataSet> copy(static_cast<RooDataSet *>(view->Clone()));
+   EXPECT_EQ(copy->numEntries(), 30);
+   EXPECT_DOUBLE_EQ(copy->get(29)->getRealValue("x"), data.get(49)->getRealValue("x"));
+}
@@ -232,12 +232,20 @@ class ToyMCSampler: public TestStatSampler {
       // calling with argument or NULL deactivates proof
       void SetProofConfig(ProofConfig *pc = NULL) { fProofConfig = pc; }
 
+      // generate the toys in nWorkers processes forked from this one; calling
+      // with 0 or 1 deactivates, ignored if a ProofConfig is given
+      void SetNWorkers(Int_t nWorkers = 0) { fNWorkers = nWorkers; }
+      Int_t GetNWorkers(void) const { return fNWorkers; }
+
       void SetProtoData(const RooDataSet* d) { fProtoData = d; }
 
    protected:
 
       const RooArgList* EvaluateAllTestStatistics(RooAbsData& data, const RooArgSet& poi, DetailedOutputAggregator& detOutAgg);
 
+      // parallel run in forked processes
+      RooDataSet* GetSamplingDistributionsMultiProcess(RooArgSet& paramPoint);
+
       // helper for GenerateToyData
       RooAbsData* Generate(RooAbsPdf &pdf, RooArgSet &observables, const RooDataSet *protoData=NULL, int forceEvents=0) const;
 
@@ -277,6 +285,7 @@ class ToyMCSampler: public TestStatSampler {
       const RooDataSet *fProtoData; // in dev
 
       ProofConfig *fProofConfig;   //!
+      Int_t fNWorkers;   //! number of processes for parallel runs without PROOF
 
       mutable NuisanceParametersSampler *fNuisanceParametersSampler; //!
 
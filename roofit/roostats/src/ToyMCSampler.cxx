@@ -28,6 +28,11 @@ TestStatistic.
 For parallel runs, ToyMCSampler can be given an instance of ProofConfig
 and then run in parallel using proof or proof-lite. Internally, it uses
 ToyMCStudy with the RooStudyManager.
+
+Alternatively, SetNWorkers() runs the toys in processes forked from the
+current one with ROOT::TProcessExecutor. Each worker has its own copy of
+the model and its own seed for RooRandom, and the sampling distributions
+of the workers are merged.
 */
 
 #include "RooStats/ToyMCSampler.h"
@@ -50,6 +55,10 @@ ToyMCStudy with the RooStudyManager.
 #include "RooCategory.h"
 
 #include "TMath.h"
+#include "TList.h"
+#include "TParameter.h"
+
+#include "ROOT/TProcessExecutor.hxx"
 
 
 using namespace RooFit;
@@ -176,6 +185,7 @@ ToyMCSampler::ToyMCSampler() : fSamplingDistName("SD"), fNToys(1)
    fProtoData = NULL;
 
    fProofConfig = NULL;
+   fNWorkers = 0;
    fNuisanceParametersSampler = NULL;
 
    _allVars = NULL ;
@@ -217,6 +227,7 @@ ToyMCSampler::ToyMCSampler(TestStatistic &ts, Int_t ntoys) :
    fProtoData = NULL;
 
    fProofConfig = NULL;
+   fNWorkers = 0;
    fNuisanceParametersSampler = NULL;
 
    _allVars = NULL ;
@@ -329,9 +340,13 @@ RooDataSet* ToyMCSampler::GetSamplingDistributions(RooArgSet& paramPointIn)
 {
 
    // ======= S I N G L E   R U N ? =======
-   if(!fProofConfig)
+   if(!fProofConfig && fNWorkers < 2)
       return GetSamplingDistributionsSingleWorker(paramPointIn);
 
+   // ======= F O R K E D   P R O C E S S E S ? =======
+   if(!fProofConfig)
+      return GetSamplingDistributionsMultiProcess(paramPointIn);
+
    // ======= P A R A L L E L   R U N =======
    if (!CheckConfig()){
       oocoutE((TObject*)NULL, InputArguments)
@@ -372,6 +387,80 @@ RooDataSet* ToyMCSampler::GetSamplingDistributions(RooArgSet& paramPointIn)
    return output;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Run the toys in fNWorkers processes forked from this one. Each worker
+/// generates its share of the toys with GetSamplingDistributionsSingleWorker(),
+/// on its own copy of the model and with its own seed for RooRandom.
+/// The seeds are drawn from RooRandom here, so that runs are reproducible;
+/// they are never 0, which would make TRandom3 use a time-based seed.
+
+RooDataSet* ToyMCSampler::GetSamplingDistributionsMultiProcess(RooArgSet& paramPointIn)
+{
+   if (!CheckConfig()){
+      oocoutE((TObject*)NULL, InputArguments)
+         << "Bad COnfiguration in ToyMCSampler "
+         << endl;
+      return nullptr;
+   }
+
+   // turn adaptive sampling off if given
+   if(fToysInTails) {
+      fToysInTails = 0;
+      oocoutW((TObject*)NULL, InputArguments)
+         << "Adaptive sampling in ToyMCSampler is not supported for parallel runs."
+         << endl;
+   }
+
+   const Int_t nWorkers = fNWorkers;
+   const Int_t totToys = fNToys;
+   std::vector<UInt_t> seeds(nWorkers);
+   for (Int_t i = 0; i < nWorkers; ++i)
+      seeds[i] = 1 + RooRandom::randomGenerator()->Integer(TMath::Limits<unsigned int>::Max() - 1);
+
+   // runs in the forked process: changes to this object are not seen by the parent
+   auto worker = [&](int i) -> TList* {
+      RooRandom::randomGenerator()->SetSeed(seeds[i]);
+      // split the toys such that the total number is kept
+      fNToys = totToys / nWorkers + (i < totToys % nWorkers ? 1 : 0);
+      // the results are received in any order: send the worker number along
+      TList* output = new TList();
+      output->Add(new TParameter<Int_t>("worker", i));
+      if (RooDataSet* result = GetSamplingDistributionsSingleWorker(paramPointIn)) output->Add(result);
+      return output;
+   };
+
+   ROOT::TProcessExecutor pool(nWorkers);
+   std::vector<TList*> results = pool.Map(worker, ROOT::TSeq<int>(nWorkers));
+
+   // put the results back in the order of the workers
+   std::vector<RooDataSet*> ordered(nWorkers, nullptr);
+   for (auto output : results) {
+      if (!output) continue;
+      auto index = dynamic_cast<TParameter<Int_t>*>(output->FindObject("worker"));
+      auto result = dynamic_cast<RooDataSet*>(output->At(1));
+      const Int_t i = index ? index->GetVal() : -1;
+      if (result && i >= 0 && i < nWorkers && !ordered[i]) {
+         output->Remove(result);
+         ordered[i] = result;
+      }
+      output->Delete();
+      delete output;
+   }
+
+   // merge the sampling distributions of the workers
+   RooDataSet* output = nullptr;
+   for (auto result : ordered) {
+      if (!result) continue;
+      if (!output) {
+         output = result;
+      } else {
+         output->append(*result);
+         delete result;
+      }
+   }
+   return output;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// This is the main function for serial runs. It is called automatically
 /// from inside GetSamplingDistribution when no ProofConfig is given.
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+
+#include "RooArgSet.h"
+#include "RooDataSet.h"
+#include "RooExtendPdf.h"
+#include "RooGaussian.h"
+#include "RooRandom.h"
+#include "RooRealVar.h"
+#include "RooStats/NumEventsTestStat.h"
+#include "RooStats/SamplingDistribution.h"
+#include "RooStats/ToyMCSampler.h"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Generate ntoys toys of an extended Gaussian with nWorkers processes, starting from seed.
+std::vector<Double_t> RunToys(Int_t ntoys, Int_t nWorkers, UInt_t seed)
+{
+   RooRealVar x("x", "x", -5, 5);
+   RooRealVar mu("mu", "mu", 0, -2, 2);
+   RooRealVar sigma("sigma", "sigma", 1);
+   RooRealVar nexp("nexp", "nexp", 50, 0, 100);
+   RooGaussian gauss("gauss", "gauss", x, mu, sigma);
+   RooExtendPdf pdf("pdf", "pdf", gauss, nexp);
+
+   RooStats::NumEventsTestStat ts(pdf);
+   RooStats::ToyMCSampler sampler(ts, ntoys);
+   RooArgSet obs(x);
+   RooArgSet poi(mu);
+   sampler.SetPdf(pdf);
+   sampler.SetObservables(obs);
+   sampler.SetParametersForTestStat(poi);
+   sampler.SetNWorkers(nWorkers);
+
+   RooRandom::randomGenerator()->SetSeed(seed);
+   std::unique_ptr<RooStats::SamplingDistribution> dist(sampler.GetSamplingDistribution(poi));
+   if (!dist)
+      return {};
+   return dist->GetSamplingDistribution();
+}
+
+} // namespace
+
+TEST(ToyMCSampler, MultiProcess)
+{
+   // The toys are split between the workers, keeping the total number.
+   std::vector<Double_t> toys1 = RunToys(21, 2, 1234);
+   ASSERT_EQ(toys1.size(), 21u);
+
+   // The seeds of the workers are drawn from RooRandom: same seed, same toys.
+   std::vector<Double_t> toys2 = RunToys(21, 2, 1234);
+   EXPECT_EQ(toys1, toys2);
+
+   // The toys are random: they differ for another seed.
+   std::vector<Double_t> toys3 = RunToys(21, 2, 4321);
+   ASSERT_EQ(toys3.size(), 21u);
+   EXPECT_NE(toys1, toys3);
+}
+
+TEST(ToyMCSampler, MultiProcessName)
+{
+   RooRealVar x("x", "x", -5, 5);
+   RooRealVar mu("mu", "mu", 0, -2, 2);
+   RooRealVar sigma("sigma", "sigma", 1);
+   RooRealVar nexp("nexp", "nexp", 50, 0, 100);
+   RooGaussian gauss("gauss", "gauss", x, mu, sigma);
+   RooExtendPdf pdf("pdf", "pdf", gauss, nexp);
+
+   RooStats::NumEventsTestStat ts(pdf);
+   RooStats::ToyMCSampler sampler(ts, 9);
+   RooArgSet obs(x);
+   RooArgSet poi(mu);
+   sampler.SetPdf(pdf);
+   sampler.SetObservables(obs);
+   sampler.SetParametersForTestStat(poi);
+   sampler.SetNWorkers(3);
+   // The name of the merged results is the one of the sampling distribution, whatever it contains.
+   sampler.SetSamplingDistName("ts_worker_2");
+
+   std::unique_ptr<RooDataSet> data(sampler.GetSamplingDistributions(poi));
+   ASSERT_NE(data, nullptr);
+   EXPECT_EQ(data->numEntries(), 9);
+   EXPECT_STREQ(data->GetName(), "ts_worker_2");
+}
@@ -0,0 +1,223 @@
+// @(#)root/test:$Id$
+// Benchmark of the dirty state propagation of RooFit on HistFactory models.
+//
+// The program builds a HistFactory model with several channels, which share
+// a signal strength, overall and shape systematics, and have a statistical
+// uncertainty per bin, in the same way as the models of stressHistFactory.
+// For every floating parameter of the likelihood it measures the time to
+// change its value, which only propagates the dirty flags, and the time to
+// recalculate the likelihood after the change. As a reference, the likelihood
+// is also recalculated with dirty state tracking switched off
+// (RooAbsArg::setDirtyInhibit()), where every node of the expression graph is
+// evaluated again. The likelihoods calculated incrementally and from scratch
+// must agree, which is the only condition for failure: the times are printed
+// for comparison between builds, not checked.
+//
+// Usage: dirtyStateTime [-n ntimes] [-c nchannels] [-b nbins]
+
+#include "RooAbsArg.h"
+#include "RooAbsData.h"
+#include "RooAbsPdf.h"
+#include "RooArgSet.h"
+#include "RooGlobalFunc.h"
+#include "RooMsgService.h"
+#include "RooRealVar.h"
+#include "RooWorkspace.h"
+#include "RooStats/HistFactory/Channel.h"
+#include "RooStats/HistFactory/HistoToWorkspaceFactoryFast.h"
+#include "RooStats/HistFactory/Measurement.h"
+#include "RooStats/HistFactory/Sample.h"
+#include "RooStats/HistFactory/Systematics.h"
+#include "RooStats/ModelConfig.h"
+#include "TError.h"
+#include "TH1.h"
+#include "TMath.h"
+#include "TStopwatch.h"
+#include "TString.h"
+
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace RooStats::HistFactory;
+
+namespace {
+
+// Histogram of a falling background, a peak or a variation of them in channel ichan
+TH1 *MakeHisto(const char *name, Int_t nbins, Int_t ichan, Double_t peak, Double_t background, Double_t scale)
+{
+   TH1 *hist = new TH1D(TString::Format("%s_%d", name, ichan), "", nbins, 0, 1);
+   hist->SetDirectory(0);
+   for (Int_t i = 1; i <= nbins; ++i) {
+      const Double_t x = hist->GetBinCenter(i);
+      const Double_t content =
+         scale * (peak * TMath::Gaus(x, 0.3 + 0.05 * ichan, 0.1) + background * TMath::Exp(-(1 + 0.2 * ichan) * x));
+      hist->SetBinContent(i, content);
+      hist->SetBinError(i, 0.05 * content);
+   }
+   return hist;
+}
+
+// Measurement of a signal strength in nchan channels of nbins bins, which owns the histograms
+Measurement *MakeMeasurement(Int_t nchan, Int_t nbins)
+{
+   Measurement *meas = new Measurement("meas", "");
+   meas->SetPOI("SigXsecOverSM");
+   meas->SetLumi(1.0);
+   meas->SetLumiRelErr(0.1);
+   meas->AddConstantParam("Lumi");
+   meas->SetExportOnly(kTRUE);
+
+   for (Int_t ichan = 0; ichan < nchan; ++ichan) {
+      TH1 *data = MakeHisto("data", nbins, ichan, 120, 800, 1);
+      TH1 *sigHist = MakeHisto("signal", nbins, ichan, 100, 0, 1);
+      TH1 *bkg1Hist = MakeHisto("background1", nbins, ichan, 0, 500, 1);
+      TH1 *bkg2Hist = MakeHisto("background2", nbins, ichan, 20, 300, 1);
+      TH1 *bkg2Low = MakeHisto("background2_low", nbins, ichan, 10, 300, 0.95);
+      TH1 *bkg2High = MakeHisto("background2_high", nbins, ichan, 30, 300, 1.05);
+
+      Channel chan(TString::Format("channel%d", ichan).Data());
+      chan.SetData(data);
+      chan.SetStatErrorConfig(0.01, "Poisson");
+
+      Sample signal("signal");
+      signal.SetHisto(sigHist);
+      signal.AddNormFactor("SigXsecOverSM", 1, 0, 3);
+      signal.AddOverallSys("syst1", 0.95, 1.05);
+      chan.AddSample(signal);
+
+      Sample background1("background1");
+      background1.SetHisto(bkg1Hist);
+      background1.ActivateStatError();
+      background1.AddOverallSys("syst2", 0.95, 1.05);
+      chan.AddSample(background1);
+
+      Sample background2("background2");
+      background2.SetHisto(bkg2Hist);
+      background2.ActivateStatError();
+      background2.AddOverallSys("syst3", 0.95, 1.05);
+      HistoSys shape("shape");
+      shape.SetHistoLow(bkg2Low);
+      shape.SetHistoHigh(bkg2High);
+      background2.AddHistoSys(shape);
+      chan.AddSample(background2);
+
+      meas->AddChannel(chan);
+   }
+   return meas;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+   Int_t ntimes = 10;
+   Int_t nchan = 5;
+   Int_t nbins = 20;
+
+   for (int i = 1; i < argc; ++i) {
+      if (!strcmp(argv[i], "-n") && i + 1 < argc)
+         ntimes = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+         nchan = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+         nbins = atoi(argv[++i]);
+      else {
+         printf("Usage: %s [-n ntimes] [-c nchannels] [-b nbins]\n", argv[0]);
+         return 1;
+      }
+   }
+   if (ntimes < 1)
+      ntimes = 1;
+   if (nchan < 1)
+      nchan = 1;
+   if (nbins < 1)
+      nbins = 1;
+
+   RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING);
+   gErrorIgnoreLevel = kWarning;
+
+   std::unique_ptr<Measurement> meas(MakeMeasurement(nchan, nbins));
+   std::unique_ptr<RooWorkspace> ws(HistoToWorkspaceFactoryFast::MakeCombinedModel(*meas));
+   RooStats::ModelConfig *mc = static_cast<RooStats::ModelConfig *>(ws->obj("ModelConfig"));
+   RooAbsData *data = ws->data("obsData");
+   if (!mc || !mc->GetPdf() || !data) {
+      printf("dirtyStateTime: FAILED, the model could not be built\n");
+      return 1;
+   }
+
+   std::unique_ptr<RooAbsReal> nll(
+      mc->GetPdf()->createNLL(*data, RooFit::Constrain(*mc->GetNuisanceParameters())));
+   std::unique_ptr<RooArgSet> allParams(nll->getParameters(*data));
+   std::vector<RooRealVar *> params;
+   for (RooFIter it = allParams->fwdIterator(); RooAbsArg *arg = it.next();) {
+      RooRealVar *param = dynamic_cast<RooRealVar *>(arg);
+      if (param && !param->isConstant())
+         params.push_back(param);
+   }
+   printf("dirtyStateTime: %d channels of %d bins, %d nodes, %d floating parameters\n", nchan, nbins,
+          (Int_t)ws->components().getSize(), (Int_t)params.size());
+
+   // The value of each parameter after its change
+   std::vector<Double_t> shifted;
+   for (RooRealVar *param : params) {
+      const Double_t delta = 0.01 * (param->getMax() - param->getMin());
+      shifted.push_back(param->getVal() + delta <= param->getMax() ? param->getVal() + delta
+                                                                    : param->getVal() - delta);
+   }
+
+   // Only propagate the dirty flags
+   TStopwatch timer;
+   timer.Start(kTRUE);
+   for (Int_t n = 0; n < ntimes; ++n) {
+      for (size_t i = 0; i < params.size(); ++i) {
+         const Double_t start = params[i]->getVal();
+         params[i]->setVal(shifted[i]);
+         params[i]->setVal(start);
+      }
+   }
+   timer.Stop();
+   const Double_t propagation = timer.RealTime();
+
+   // Recalculate the likelihood incrementally, and with all nodes evaluated again
+   std::vector<Double_t> values[2];
+   Double_t evaluation[2];
+   for (Int_t full = 0; full < 2; ++full) {
+      RooAbsArg::setDirtyInhibit(full);
+      nll->getVal();
+      timer.Start(kTRUE);
+      for (Int_t n = 0; n < ntimes; ++n) {
+         for (size_t i = 0; i < params.size(); ++i) {
+            const Double_t start = params[i]->getVal();
+            params[i]->setVal(shifted[i]);
+            const Double_t value = nll->getVal();
+            if (n == 0)
+               values[full].push_back(value);
+            params[i]->setVal(start);
+            nll->getVal();
+         }
+      }
+      timer.Stop();
+      evaluation[full] = timer.RealTime();
+   }
+   RooAbsArg::setDirtyInhibit(kFALSE);
+
+   const Int_t nchanges = 2 * ntimes * params.size();
+   printf("dirtyStateTime: per parameter change %.2fus to propagate the dirty flags, %.2fus to recalculate the "
+          "likelihood, %.2fus to recalculate it without dirty state tracking\n",
+          1e6 * propagation / nchanges, 1e6 * evaluation[0] / nchanges, 1e6 * evaluation[1] / nchanges);
+
+   Bool_t ok = kTRUE;
+   for (size_t i = 0; i < params.size(); ++i) {
+      if (TMath::Abs(values[0][i] - values[1][i]) > 1e-9 * (TMath::Abs(values[1][i]) + 1)) {
+         printf("dirtyStateTime: %s = %g, NLL %.10g recalculated incrementally, %.10g from scratch\n",
+                params[i]->GetName(), shifted[i], values[0][i], values[1][i]);
+         ok = kFALSE;
+      }
+   }
+   if (!ok)
+      printf("dirtyStateTime: FAILED, the incrementally recalculated likelihoods differ\n");
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+// @(#)root/test:$Id$
+// Benchmark of the analytical gradient of RooFit likelihoods.
+//
+// The program minimizes two likelihoods with Minuit2, once with the numerical
+// gradient of Minuit2 and once with the derivatives of
+// RooAbsReal::getDerivative() (RooMinimizer::setAnalyticalGradient()), and
+// reports the fastest time and the number of function calls of both. The
+// first likelihood is an unbinned, extended fit of a peak on an exponential
+// background, for which the derivatives of the peak and the background are
+// finite differences of single p.d.f.s. The second one is a binned
+// likelihood of histogram templates with analytical derivatives. The program
+// fails if a minimization does not converge or if the minima found with the
+// two gradients differ. The times and the numbers of calls are only printed.
+//
+// Usage: fitGradientTime [-n ntimes] [-e nevents]
+
+#include "RooAddPdf.h"
+#include "RooArgList.h"
+#include "RooArgSet.h"
+#include "RooDataHist.h"
+#include "RooDataSet.h"
+#include "RooExponential.h"
+#include "RooFormulaVar.h"
+#include "RooGaussian.h"
+#include "RooGlobalFunc.h"
+#include "RooHistFunc.h"
+#include "RooMinimizer.h"
+#include "RooMsgService.h"
+#include "RooNLLVar.h"
+#include "RooProduct.h"
+#include "RooRandom.h"
+#include "RooRealSumPdf.h"
+#include "RooRealVar.h"
+#include "TMath.h"
+#include "TStopwatch.h"
+
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+struct Timing {
+   Double_t best = -1;
+   Int_t calls = 0;
+   Double_t minNll = 0;
+   std::unique_ptr<RooArgSet> result;
+};
+
+// Minimize nll ntimes from the start values of params, with or without the analytical gradient
+Bool_t Minimize(RooAbsReal &nll, RooArgSet &params, Bool_t gradient, Int_t ntimes, Timing &timing)
+{
+   std::unique_ptr<RooArgSet> start(static_cast<RooArgSet *>(params.snapshot()));
+   TStopwatch timer;
+   for (Int_t i = 0; i < ntimes; ++i) {
+      params = *start;
+      RooMinimizer m(nll);
+      m.setPrintLevel(-1);
+      m.setAnalyticalGradient(gradient);
+      timer.Start(kTRUE);
+      Int_t status = m.minimize("Minuit2", "Migrad");
+      timer.Stop();
+      if (status != 0)
+         return kFALSE;
+      if (timing.best < 0 || timer.RealTime() < timing.best)
+         timing.best = timer.RealTime();
+      timing.calls = m.evalCounter();
+   }
+   timing.minNll = nll.getVal();
+   timing.result.reset(static_cast<RooArgSet *>(params.snapshot()));
+   params = *start;
+   return kTRUE;
+}
+
+// Run both minimizations and compare them, return false on failure
+Bool_t Compare(const char *name, RooAbsReal &nll, RooArgSet &params, Int_t ntimes)
+{
+   Timing numerical, analytical;
+   if (!Minimize(nll, params, kFALSE, ntimes, numerical) || !Minimize(nll, params, kTRUE, ntimes, analytical)) {
+      printf("fitGradientTime: FAILED, %s: minimization failed\n", name);
+      return kFALSE;
+   }
+   printf("fitGradientTime: %s numerical gradient best %.3fs, %d calls; analytical gradient best %.3fs, %d calls\n",
+          name, numerical.best, numerical.calls, analytical.best, analytical.calls);
+
+   Bool_t ok = TMath::Abs(numerical.minNll - analytical.minNll) < 1e-3;
+   for (RooFIter it = numerical.result->fwdIterator(); RooAbsArg *arg = it.next();) {
+      RooRealVar *p1 = static_cast<RooRealVar *>(arg);
+      RooRealVar *p2 = static_cast<RooRealVar *>(analytical.result->find(arg->GetName()));
+      if (TMath::Abs(p1->getVal() - p2->getVal()) > 1e-3 * (TMath::Abs(p1->getVal()) + 1)) {
+         printf("fitGradientTime: %s %s = %g with the numerical gradient, %g with the analytical gradient\n", name,
+                p1->GetName(), p1->getVal(), p2->getVal());
+         ok = kFALSE;
+      }
+   }
+   if (!ok)
+      printf("fitGradientTime: FAILED, %s: the minima differ (NLL %.6f and %.6f)\n", name, numerical.minNll,
+             analytical.minNll);
+   return ok;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+   Int_t ntimes = 3;
+   Int_t nevents = 20000;
+
+   for (int i = 1; i < argc; ++i) {
+      if (!strcmp(argv[i], "-n") && i + 1 < argc)
+         ntimes = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-e") && i + 1 < argc)
+         nevents = atoi(argv[++i]);
+      else {
+         printf("Usage: %s [-n ntimes] [-e nevents]\n", argv[0]);
+         return 1;
+      }
+   }
+   if (ntimes < 1)
+      ntimes = 1;
+
+   RooMsgService::instance().setGlobalKillBelow(RooFit::WARNING);
+   Bool_t ok = kTRUE;
+
+   // Unbinned extended fit of a peak on a background
+   {
+      RooRealVar x("x", "x", 0, 10);
+      RooRealVar mean("mean", "mean", 4, 0, 10);
+      RooRealVar sigma("sigma", "sigma", 1, 0.2, 5);
+      RooRealVar c("c", "c", -0.3, -2, 0.);
+      RooRealVar nSig("nSig", "nSig", 0.3 * nevents, 0, 2 * nevents);
+      RooRealVar nBkg("nBkg", "nBkg", 0.7 * nevents, 0, 2 * nevents);
+      RooGaussian gauss("gauss", "", x, mean, sigma);
+      RooExponential expo("expo", "", x, c);
+      RooAddPdf model("model", "", RooArgList(gauss, expo), RooArgList(nSig, nBkg));
+
+      RooRandom::randomGenerator()->SetSeed(1234);
+      std::unique_ptr<RooDataSet> data(model.generate(x, nevents));
+      RooArgSet params(mean, sigma, c, nSig, nBkg);
+      mean.setVal(4.5);
+      sigma.setVal(1.4);
+      std::unique_ptr<RooAbsReal> nll(model.createNLL(*data, RooFit::Extended()));
+      ok &= Compare("unbinned", *nll, params, ntimes);
+   }
+
+   // Binned likelihood of templates with a signal strength and background variations
+   {
+      RooRealVar x("x", "x", 0, 100);
+      x.setBins(100);
+      RooDataHist sigHist("sigHist", "", x);
+      RooDataHist bkgHist("bkgHist", "", x);
+      RooDataHist bkgVar("bkgVar", "", x);
+      RooDataHist data("data", "", x);
+      for (Int_t i = 0; i < 100; ++i) {
+         x.setBin(i);
+         Double_t sig = 0.01 * nevents * TMath::Gaus(i, 50, 8);
+         Double_t bkg = 0.02 * nevents * TMath::Exp(-0.02 * i);
+         sigHist.set(x, sig);
+         bkgHist.set(x, bkg);
+         bkgVar.set(x, 0.1 * bkg * (i - 50) / 50.);
+         data.set(x, TMath::Nint(1.2 * sig + bkg));
+      }
+      RooHistFunc sig("sig", "", x, sigHist);
+      RooHistFunc bkg("bkg", "", x, bkgHist);
+      RooHistFunc var("var", "", x, bkgVar);
+      RooRealVar mu("mu", "mu", 1, 0, 5);
+      RooRealVar alpha("alpha", "alpha", 0, -3, 3);
+      RooRealVar bkgNorm("bkgNorm", "bkgNorm", 1, 0.5, 1.5);
+      RooProduct bkgScaled("bkgScaled", "", RooArgList(bkgNorm, bkg));
+      RooRealVar one("one", "one", 1);
+      RooRealSumPdf model("model", "", RooArgList(sig, bkgScaled, var), RooArgList(mu, one, alpha), kTRUE);
+      model.setAttribute("BinnedLikelihood");
+
+      RooNLLVar nll("nll", "", model, data, kTRUE, 0, 0, 1, RooFit::BulkPartition, kFALSE, kFALSE, kTRUE, kTRUE);
+      RooArgSet params(mu, alpha, bkgNorm);
+      ok &= Compare("binned", nll, params, ntimes);
+   }
+
+   return ok ? 0 : 1;
+}
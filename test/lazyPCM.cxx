@@ -0,0 +1,57 @@
+// @(#)root/test:$Id$
+// Test of the deferred reading of the TProtoClasses of the ROOT PCMs.
+//
+// Run with ROOT_LAZY_PCM set, the program asks TClass::GetClass for classes
+// that are described by the PCM of libSmatrix, which is autoloaded. Their
+// LinkDef spells them without the default template arguments, so the name
+// they are listed under in the autoparse map differs from the normalized name
+// of the TClassTable. The TProtoClass of each class must nevertheless be
+// found, and the TClass built from it.
+//
+// Usage: lazyPCM
+
+#include "TClass.h"
+#include "TClassTable.h"
+#include "TProtoClass.h"
+#include "TSystem.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int main()
+{
+   if (!gSystem->Getenv("ROOT_LAZY_PCM")) {
+      printf("lazyPCM: FAILED, ROOT_LAZY_PCM is not set\n");
+      return 1;
+   }
+
+   const char *classNames[] = {"ROOT::Math::SMatrix<double,3,3>", "ROOT::Math::SMatrix<double,4,4>"};
+   Bool_t ok = kTRUE;
+   for (const char *name : classNames) {
+      TClass *cl = TClass::GetClass(name);
+      if (!cl) {
+         printf("lazyPCM: FAILED, no TClass for %s\n", name);
+         ok = kFALSE;
+         continue;
+      }
+      if (!strcmp(cl->GetName(), name)) {
+         printf("lazyPCM: FAILED, the normalized name of %s is not different\n", name);
+         ok = kFALSE;
+      }
+      if (cl->HasInterpreterInfoInMemory()) {
+         printf("lazyPCM: FAILED, the TClass of %s was not built from its TProtoClass\n", cl->GetName());
+         ok = kFALSE;
+      }
+      if (!TClassTable::GetProtoNorm(cl->GetName())) {
+         printf("lazyPCM: FAILED, no TProtoClass for %s (normalized %s)\n", name, cl->GetName());
+         ok = kFALSE;
+      }
+      if (cl->GetState() != TClass::kHasTClassInit || !cl->GetListOfDataMembers()->GetSize()) {
+         printf("lazyPCM: FAILED, the TClass of %s is incomplete\n", cl->GetName());
+         ok = kFALSE;
+      }
+   }
+   if (ok)
+      printf("lazyPCM: OK\n");
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// @(#)root/test:$Id$
+// Comparison of the start-up time of a ROOT session with and without
+// deferred reading of the TProtoClasses of the ROOT PCMs.
+//
+// The program starts `root.exe -b -l -q` (or the given command) a number of
+// times with ROOT_LAZY_PCM unset, then set, alternating the two so that a
+// change of the machine load affects both. It reports the fastest and the
+// average wall-clock time of each, and fails if the fastest start-up with
+// ROOT_LAZY_PCM is not faster than the fastest one without it. With -t it
+// also fails if the fastest lazy start-up takes longer than the threshold.
+//
+// Usage: startupTime [-n ntimes] [-t threshold_seconds] [-c command]
+
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char **argv)
+{
+   Int_t ntimes = 5;
+   Double_t threshold = -1.;
+   TString command = "root.exe -b -l -q";
+
+   for (int i = 1; i < argc; ++i) {
+      if (!strcmp(argv[i], "-n") && i + 1 < argc)
+         ntimes = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+         threshold = atof(argv[++i]);
+      else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+         command = argv[++i];
+      else {
+         printf("Usage: %s [-n ntimes] [-t threshold_seconds] [-c command]\n", argv[0]);
+         return 1;
+      }
+   }
+   if (ntimes < 1)
+      ntimes = 1;
+
+   const char *modes[2] = {"eager", "lazy"};
+   TStopwatch timer;
+   Double_t best[2] = {-1, -1}, total[2] = {0, 0};
+   for (Int_t i = 0; i < ntimes; ++i) {
+      for (Int_t lazy = 0; lazy < 2; ++lazy) {
+         if (lazy)
+            gSystem->Setenv("ROOT_LAZY_PCM", "1");
+         else
+            gSystem->Unsetenv("ROOT_LAZY_PCM");
+         timer.Start(kTRUE);
+         Int_t status = gSystem->Exec(command);
+         timer.Stop();
+         if (status != 0) {
+            printf("startupTime: FAILED, '%s' returned %d (%s PCM reading)\n", command.Data(), status, modes[lazy]);
+            return 1;
+         }
+         Double_t elapsed = timer.RealTime();
+         total[lazy] += elapsed;
+         if (best[lazy] < 0 || elapsed < best[lazy])
+            best[lazy] = elapsed;
+      }
+   }
+   gSystem->Unsetenv("ROOT_LAZY_PCM");
+
+   for (Int_t lazy = 0; lazy < 2; ++lazy)
+      printf("startupTime: '%s' with %s PCM reading best %.3fs, average %.3fs over %d runs\n", command.Data(),
+             modes[lazy], best[lazy], total[lazy] / ntimes, ntimes);
+   if (best[1] >= best[0]) {
+      printf("startupTime: FAILED, the start-up with ROOT_LAZY_PCM is not faster\n");
+      return 1;
+   }
+   if (threshold > 0 && best[1] > threshold) {
+      printf("startupTime: FAILED, start-up time exceeds the threshold of %.3fs\n", threshold);
+      return 1;
+   }
+   return 0;
+}
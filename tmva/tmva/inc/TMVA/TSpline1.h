@@ -47,6 +47,7 @@ namespace TMVA {
       TSpline1( const TString& title, TGraph* theGraph );
       virtual ~TSpline1( void );
 
+      using TSpline::Eval;
       virtual  Double_t Eval( Double_t x ) const;
 
       // dummy implementations
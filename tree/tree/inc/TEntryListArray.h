@@ -78,6 +78,7 @@ public:
       TEntryList::SetTree(tree);   // will take treename and filename from the tree and call the method above
    }
    virtual void        Subtract(const TEntryList *elist);
+   virtual void        Intersect(const TEntryList *elist);
    virtual TList* GetSubLists() const {
       return fSubLists;
    };
@@ -165,6 +166,7 @@ public:
       TEntryList::SetTree(tree);   // will take treename and filename from the tree and call the method above
    }
    virtual void        Subtract(const TEntryList *elist);
+   virtual void        Intersect(const TEntryList *elist);
    virtual TList* GetSubLists() const {
       return fSubLists;
    };
@@ -691,6 +691,36 @@ void TEntryListArray::Subtract(const TEntryList *elist)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all the entries of this entry list that are not contained in elist.
+/// The sublists of the removed entries are removed too; the sublists of the
+/// remaining entries are not modified.
+
+void TEntryListArray::Intersect(const TEntryList *elist)
+{
+   if (!elist) return;
+
+   if (fLists) { // This list is splitted
+      TEntryListArray* e = 0;
+      TIter next(fLists);
+      fN = 0; // reset fN to set it to the sum of fN in each list
+      while ((e = (TEntryListArray*) next())) {
+         e->Intersect(elist);
+         fN += e->GetN();
+      }
+   } else {
+      TEntryList::Intersect(elist);
+      if (fSubLists) {
+         TEntryListArray *e = 0;
+         TIter next(fSubLists);
+         while ((e = (TEntryListArray*) next())) {
+            if (!Contains(e->fEntry))
+               RemoveSubList(e);
+         }
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// If a list for a tree with such name and filename exists, sets it as the current sublist
 /// If not, creates this list and sets it as the current sublist
@@ -38,6 +38,12 @@ End_Macro
  - __Merge__() - adds all entries from one block to the other. If the first block
              uses array representation, it's changed to bits representation only
              if the total number of passing entries is still less than kBlockSize
+ - __Subtract__(), __Intersect__() - remove the entries which are, resp. are not,
+             in the other block
+
+The set operations and the scans of the bits representation work on whole
+words: the bits of the two blocks are combined word by word and counted
+with a population count, and Next() skips the empty words.
  - __GetEntry(n)__ - returns n-th non-zero entry.
  - __Next__()      - return next non-zero entry. In case of representation 1), Next()
                  is faster than GetEntry()
@@ -45,6 +51,9 @@ End_Macro
 
 #include "TEntryListBlock.h"
 #include "TString.h"
+#include "ROOT/TBitUtils.hxx"
+
+#include <string.h>
 
 ClassImp(TEntryListBlock);
 
@@ -242,10 +251,11 @@ Int_t TEntryListBlock::Contains(Int_t entry)
 
 Int_t TEntryListBlock::Merge(TEntryListBlock *block)
 {
-   Int_t i, j;
+   Int_t i;
    if (block->GetNPassed() == 0) return GetNPassed();
    if (GetNPassed() == 0){
       //this block is empty
+      delete [] fIndices;
       fN = block->fN;
       fIndices = new UShort_t[fN];
       for (i=0; i<fN; i++)
@@ -259,39 +269,15 @@ Int_t TEntryListBlock::Merge(TEntryListBlock *block)
       return fNPassed;
    }
    if (fType==0){
-      //stored as bits
-      if (block->fType == 0){
-         for (i=0; i<kBlockSize*16; i++){
-            if (block->Contains(i))
-               Enter(i);
-         }
-      } else {
-         if (block->fPassing){
-            //the other block stores entries that pass
-            for (i=0; i<block->fNPassed; i++){
-               Enter(block->fIndices[i]);
-            }
-         } else {
-            //the other block stores entries that don't pass
-            if (block->fNPassed==0){
-               for (i=0; i<kBlockSize*16; i++){
-                  Enter(i);
-               }
-            }
-            for (j=0; j<block->fIndices[0]; j++)
-               Enter(j);
-            for (i=0; i<block->fNPassed-1; i++){
-               for (j=block->fIndices[i]+1; j<block->fIndices[i+1]; j++){
-                  Enter(j);
-               }
-            }
-            for (j=block->fIndices[block->fNPassed-1]+1; j<kBlockSize*16; j++)
-               Enter(j);
-         }
-      }
+      //stored as bits, add the other block word by word
+      UShort_t bits[kBlockSize];
+      block->GetBits(bits);
+      for (i=0; i<kBlockSize; i++)
+         fIndices[i] |= bits[i];
+      fNPassed = ROOT::Internal::PopCount(fIndices, kBlockSize*sizeof(UShort_t));
    } else {
       //stored as a list
-      if (GetNPassed() + block->GetNPassed() > kBlockSize){
+      if (GetNPassed() + block->GetNPassed() > kBlockSize || block->fType == 0){
          //change to bits
          UShort_t *bits = new UShort_t[kBlockSize];
          Transform(1, bits);
@@ -326,34 +312,6 @@ Int_t TEntryListBlock::Merge(TEntryListBlock *block)
             fIndices = newlist;
             fNPassed = newpos;
             fN = fNPassed;
-         } else {
-            //second block is stored as bits
-
-            Int_t en = block->fNPassed;
-            Int_t newsize = fNPassed + en;
-            UShort_t *newlist = new UShort_t[newsize];
-            Int_t newpos, current;
-            newpos = current = 0;
-            for (i=0; i<kBlockSize*16; i++){
-               if (!block->Contains(i)) continue;
-               while(current < fNPassed && fIndices[current]<i){
-                  newlist[newpos] = fIndices[current];
-                  current++;
-                  newpos++;
-               }
-               if (fIndices[current]==i) current++;
-               newlist[newpos] = i;
-               newpos++;
-            }
-            while(current<fNPassed){
-               newlist[newpos] = fIndices[current];
-               newpos++;
-               current++;
-            }
-            delete [] fIndices;
-            fIndices = newlist;
-            fNPassed = newpos;
-            fN = fNPassed;
          }
       }
    }
@@ -363,6 +321,83 @@ Int_t TEntryListBlock::Merge(TEntryListBlock *block)
    return GetNPassed();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the entries of the other block from this one.
+/// Returns the resulting number of entries in the block
+
+Int_t TEntryListBlock::Subtract(TEntryListBlock *block)
+{
+   if (GetNPassed() == 0 || block->GetNPassed() == 0) return GetNPassed();
+   UShort_t *bits = new UShort_t[kBlockSize];
+   GetBits(bits);
+   UShort_t other[kBlockSize];
+   block->GetBits(other);
+   for (Int_t i=0; i<kBlockSize; i++)
+      bits[i] &= ~other[i];
+   SetBits(bits);
+   OptimizeStorage();
+   return GetNPassed();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Keep only the entries which are also in the other block.
+/// Returns the resulting number of entries in the block
+
+Int_t TEntryListBlock::Intersect(TEntryListBlock *block)
+{
+   if (GetNPassed() == 0) return 0;
+   UShort_t *bits = new UShort_t[kBlockSize];
+   GetBits(bits);
+   UShort_t other[kBlockSize];
+   block->GetBits(other);
+   for (Int_t i=0; i<kBlockSize; i++)
+      bits[i] &= other[i];
+   SetBits(bits);
+   OptimizeStorage();
+   return GetNPassed();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill bits, an array of kBlockSize UShort_ts, with the bits representation
+/// of the entries of this block, whatever its current representation.
+
+void TEntryListBlock::GetBits(UShort_t *bits) const
+{
+   if (fType==0 && fIndices) {
+      memcpy(bits, fIndices, kBlockSize*sizeof(UShort_t));
+      return;
+   }
+   //without indices, either no entry or all entries pass
+   memset(bits, fPassing ? 0 : 0xFF, kBlockSize*sizeof(UShort_t));
+   if (!fIndices) return;
+   for (Int_t i=0; i<fNPassed; i++){
+      Int_t ibite = fIndices[i]>>4;
+      Int_t ibit = fIndices[i] & 15;
+      if (fPassing)
+         bits[ibite] |= 1<<ibit;
+      else
+         bits[ibite] &= (0xFFFF^(1<<ibit));
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Replace the content of this block by the bits representation in bits, an
+/// array of kBlockSize UShort_ts which is adopted.
+
+void TEntryListBlock::SetBits(UShort_t *bits)
+{
+   if (fIndices)
+      delete [] fIndices;
+   fIndices = bits;
+   fType = 0;
+   fN = kBlockSize;
+   fPassing = 1;
+   fNPassed = ROOT::Internal::PopCount(bits, kBlockSize*sizeof(UShort_t));
+   fCurrent = 0;
+   fLastIndexQueried = -1;
+   fLastIndexReturned = -1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns the number of entries, passing the selection.
 /// In case, when the block stores entries that pass (fPassing=1) returns fNPassed
@@ -387,16 +422,18 @@ Int_t TEntryListBlock::GetEntry(Int_t entry)
    else {
       Int_t i=0; Int_t j=0; Int_t entries_found=0;
       if (fType==0){
-         if ((fIndices[i] & (1<<j))!=0)
-            entries_found++;
-         while (entries_found<entry+1){
-            if (j==15){i++; j=0;}
-            else j++;
-            if ((fIndices[i] & (1<<j))!=0)
-               entries_found++;
+         //skip the words before the one holding the entry
+         Int_t nword = ROOT::Internal::PopCount(fIndices[i]);
+         while (entries_found+nword < entry+1){
+            entries_found += nword;
+            if (++i >= kBlockSize) return -1;
+            nword = ROOT::Internal::PopCount(fIndices[i]);
          }
+         ULong64_t word = fIndices[i];
+         for (j=entries_found; j<entry; j++)
+            word &= word-1;
          fLastIndexQueried = entry;
-         fLastIndexReturned = i*16+j;
+         fLastIndexReturned = i*16+ROOT::Internal::CountTrailingZeros(word);
          return fLastIndexReturned;
       }
       if (fType==1){
@@ -453,19 +490,19 @@ Int_t TEntryListBlock::Next()
    }
 
    if (fType==0) {
-      //bits
-      Int_t i=0;
-      Int_t j=0;
+      //bits, skipping the empty words
       fLastIndexReturned++;
-      i = fLastIndexReturned>>4;
-      j = fLastIndexReturned & 15;
-      Bool_t result=(fIndices[i] & (1<<j))!=0;
-      while (result==0){
-         if (j==15) {j=0; i++;}
-         else j++;
-         result = (fIndices[i] & (1<<j))!=0;
+      Int_t i = fLastIndexReturned>>4;
+      Int_t j = fLastIndexReturned & 15;
+      ULong64_t word = fIndices[i] >> j;
+      if (word) {
+         fLastIndexReturned += ROOT::Internal::CountTrailingZeros(word);
+      } else {
+         do {
+            i++;
+         } while (fIndices[i]==0);
+         fLastIndexReturned = i*16 + ROOT::Internal::CountTrailingZeros(fIndices[i]);
       }
-      fLastIndexReturned = i*16+j;
       fLastIndexQueried++;
       return fLastIndexReturned;
 
@@ -567,19 +604,13 @@ void TEntryListBlock::Transform(Bool_t dir, UShort_t *indexnew)
    Int_t ilist = 0;
    Int_t ibite, ibit;
    if (!dir) {
-         for (i=0; i<kBlockSize*16; i++){
-            ibite = i >> 4;
-            ibit = i & 15;
-            Bool_t result = (fIndices[ibite] & (1<<ibit))!=0;
-            if (result && fPassing){
-               //fill with the entries that pass
-               indexnew[ilist] = i;
-               ilist++;
-            }
-            else if (!result && !fPassing){
-               //fill with the entries that don't pass
-               indexnew[ilist] = i;
+         //fill with the entries that pass, or with those that don't pass
+         for (ibite=0; ibite<kBlockSize; ibite++){
+            ULong64_t word = fPassing ? fIndices[ibite] : (fIndices[ibite] ^ 0xFFFF);
+            while (word){
+               indexnew[ilist] = ibite*16 + ROOT::Internal::CountTrailingZeros(word);
                ilist++;
+               word &= word-1;
             }
          }
       if (fIndices)
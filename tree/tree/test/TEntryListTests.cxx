@@ -0,0 +1,170 @@
+#include "gtest/gtest.h"
+#include "TEntryList.h"
+#include "TEntryListBlock.h"
+
+#include <functional>
+
+namespace {
+
+const Int_t kBlockEntries = TEntryListBlock::kBlockSize * 16;
+
+// Fill the block with the entries for which pass is true and let it choose its representation.
+void FillBlock(TEntryListBlock &block, const std::function<bool(Int_t)> &pass)
+{
+   for (Int_t i = 0; i < kBlockEntries; ++i)
+      if (pass(i))
+         block.Enter(i);
+   block.OptimizeStorage();
+}
+
+// Check the content of the block, both through Contains() and through the iteration with Next() and GetEntry().
+void CheckBlock(TEntryListBlock &block, const std::function<bool(Int_t)> &pass)
+{
+   Int_t n = 0;
+   for (Int_t i = 0; i < kBlockEntries; ++i) {
+      EXPECT_EQ(block.Contains(i) != 0, pass(i)) << "entry " << i;
+      if (pass(i))
+         ++n;
+   }
+   EXPECT_EQ(block.GetNPassed(), n);
+
+   block.ResetIndices();
+   Int_t entry = n ? block.GetEntry(0) : -1;
+   for (Int_t i = 0; i < n; ++i) {
+      ASSERT_TRUE(pass(entry)) << "entry " << entry;
+      if (i + 1 < n) {
+         Int_t next = block.Next();
+         EXPECT_GT(next, entry);
+         entry = next;
+      }
+   }
+   block.ResetIndices();
+   for (Int_t i = n - 1; i >= 0; i -= 997)
+      EXPECT_TRUE(pass(block.GetEntry(i)));
+}
+
+bool Multiple3(Int_t i) { return i % 3 == 0; }
+bool Multiple5(Int_t i) { return i % 5 == 0; }
+bool Small(Int_t i) { return i < 300 || (i > 40000 && i % 1000 == 7); }
+bool Most(Int_t i) { return i % 1000 != 1; }
+
+} // namespace
+
+TEST(TEntryListBlock, Representations)
+{
+   TEntryListBlock bits, list, inverted;
+   FillBlock(bits, Multiple3);
+   FillBlock(list, Small);
+   FillBlock(inverted, Most);
+   EXPECT_EQ(bits.GetType(), 0);
+   EXPECT_EQ(list.GetType(), 1);
+   CheckBlock(bits, Multiple3);
+   CheckBlock(list, Small);
+   CheckBlock(inverted, Most);
+}
+
+TEST(TEntryListBlock, Subtract)
+{
+   const std::function<bool(Int_t)> preds[] = {Multiple3, Multiple5, Small, Most};
+   for (auto &p1 : preds) {
+      for (auto &p2 : preds) {
+         TEntryListBlock b1, b2;
+         FillBlock(b1, p1);
+         FillBlock(b2, p2);
+         auto expected = [&](Int_t i) { return p1(i) && !p2(i); };
+         Int_t n = b1.Subtract(&b2);
+         EXPECT_EQ(n, b1.GetNPassed());
+         CheckBlock(b1, expected);
+         CheckBlock(b2, p2);
+      }
+   }
+}
+
+TEST(TEntryListBlock, Intersect)
+{
+   const std::function<bool(Int_t)> preds[] = {Multiple3, Multiple5, Small, Most};
+   for (auto &p1 : preds) {
+      for (auto &p2 : preds) {
+         TEntryListBlock b1, b2;
+         FillBlock(b1, p1);
+         FillBlock(b2, p2);
+         auto expected = [&](Int_t i) { return p1(i) && p2(i); };
+         Int_t n = b1.Intersect(&b2);
+         EXPECT_EQ(n, b1.GetNPassed());
+         CheckBlock(b1, expected);
+         CheckBlock(b2, p2);
+      }
+   }
+}
+
+TEST(TEntryListBlock, Merge)
+{
+   TEntryListBlock b1, b2;
+   FillBlock(b1, Multiple3);
+   FillBlock(b2, Small);
+   b1.Merge(&b2);
+   CheckBlock(b1, [](Int_t i) { return Multiple3(i) || Small(i); });
+}
+
+TEST(TEntryList, SubtractIntersect)
+{
+   // Spread the entries over several blocks.
+   const Long64_t n = 3 * kBlockEntries + 123;
+   TEntryList l1, l2, l3;
+   for (Long64_t i = 0; i < n; ++i) {
+      if (i % 3 == 0)
+         l1.Enter(i);
+      if (i % 2 == 0)
+         l2.Enter(i);
+   }
+   l3.Add(&l1);
+
+   l1.Subtract(&l2);
+   l3.Intersect(&l2);
+   Long64_t n1 = 0, n3 = 0;
+   for (Long64_t i = 0; i < n; ++i) {
+      EXPECT_EQ(l1.Contains(i) != 0, i % 3 == 0 && i % 2 != 0) << "entry " << i;
+      EXPECT_EQ(l3.Contains(i) != 0, i % 6 == 0) << "entry " << i;
+      n1 += (i % 3 == 0 && i % 2 != 0);
+      n3 += (i % 6 == 0);
+   }
+   EXPECT_EQ(l1.GetN(), n1);
+   EXPECT_EQ(l3.GetN(), n3);
+
+   Long64_t previous = -1;
+   for (Long64_t i = 0; i < l3.GetN(); ++i) {
+      Long64_t entry = i ? l3.Next() : l3.GetEntry(0);
+      EXPECT_EQ(entry % 6, 0);
+      EXPECT_GT(entry, previous);
+      previous = entry;
+   }
+
+   // A null list leaves the list unchanged.
+   l1.Subtract(nullptr);
+   l1.Intersect(nullptr);
+   EXPECT_EQ(l1.GetN(), n1);
+}
+
+TEST(TEntryList, SubLists)
+{
+   TEntryList l1, l2;
+   l1.SetTree("t", "a.root");
+   for (Long64_t i = 0; i < 1000; ++i)
+      l1.Enter(i);
+   TEntryList sub2;
+   sub2.SetTree("t", "b.root");
+   for (Long64_t i = 0; i < 1000; ++i)
+      sub2.Enter(i);
+   l1.Add(&sub2);
+
+   l2.SetTree("t", "a.root");
+   for (Long64_t i = 0; i < 1000; i += 4)
+      l2.Enter(i);
+
+   // Subtract() only changes the sublist for the same tree, Intersect() empties the others.
+   TEntryList l3(l1);
+   l1.Subtract(&l2);
+   EXPECT_EQ(l1.GetN(), 2000 - 250);
+   l3.Intersect(&l2);
+   EXPECT_EQ(l3.GetN(), 250);
+}